@@ -0,0 +1,613 @@
+/*! \file   loadgen.c
+    \brief  Synthetic RCA load generator for the FEMC socket server
+
+    This is a stand alone client that replays a synthetic but realistic mix of
+    RCA requests against the FEMC socket server and reports throughput and
+    latency as a single JSON document, so that runs of different firmware
+    revisions can be compared directly.
+
+    The request mix is drawn from a map of the RCAs actually served by the
+    firmware:
+        - cartridge bias monitors (SIS, SIS magnet, LNA)
+        - cartridge LO monitors (YTO, photomixer, PLL)
+        - cartridge temperature sensors
+        - power distribution and IF switch monitors
+        - cryostat temperatures and vacuum gauges
+        - FETIM interlock sensors and state
+        - special RCAs (version, error count, FE mode, ESN count)
+    plus a small set of harmless control RCAs.
+
+    The intended target is the firmware built with 'make sim', which runs the
+    complete message path on the simulated hardware backend:
+
+        make sim loadgen
+        (cd ini_files && ../bin/main_sim) &
+        bin/loadgen -n 100000 -m 0.9 -b 3,6,7 -o results.json
+
+    Options:
+        -H host     server address (default 127.0.0.1)
+        -p port     server port (default 2000)
+        -n count    requests per worker (default 10000)
+        -t seconds  run for a fixed time instead of a fixed count
+        -w count    warmup requests per worker, not measured (default 100)
+        -c workers  concurrent connections (default 1)
+        -m ratio    fraction of monitor requests, 0.0-1.0 (default 0.9)
+        -b bands    band spread, e.g. "1-10" or "3,6,7" (default 1-10)
+        -z skew     probability of hitting the first listed band (default: uniform)
+        -g weights  group weights, e.g. "bias=4,lo=3,ctemp=2,cryo=2,fetim=1,special=1"
+        -s seed     random seed (default 1)
+        -o file     JSON output file (default stdout)
+
+    \note   The firmware serves one client at a time: with more than one worker
+            the extra connections wait in the listen backlog and the reported
+            latency includes that queueing. */
+
+/* Includes */
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Defines */
+#define REQUEST_SIZE 18    // Size of a request frame sent to the server
+#define REPLY_SIZE 13      // Size of a reply frame received from the server
+#define REPLY_SIZE_BYTE 4  // Offset of the payload size in the reply
+#define REPLY_DATA_BYTE 5  // Offset of the payload in the reply
+#define MAX_WORKERS 64
+#define MAX_BANDS 10
+#define REPLY_TIMEOUT_MS 2000
+#define CONNECT_RETRIES 50
+
+#define MONITOR 0
+#define CONTROL 1
+
+/* RCA groups */
+#define GROUP_BIAS 0
+#define GROUP_LO 1
+#define GROUP_CTEMP 2
+#define GROUP_PD_IF 3
+#define GROUP_CRYO 4
+#define GROUP_FETIM 5
+#define GROUP_SPECIAL 6
+#define GROUPS_NUMBER 7
+
+static const char *groupNames[GROUPS_NUMBER] = {"bias", "lo", "ctemp", "pdif", "cryo", "fetim", "special"};
+
+/* Typedefs */
+//! RCA map entry
+/*! Each entry describes a family of RCAs: the base RCA is offset by the band
+    (if \p bandStride is not zero) and by a random index in each of the two
+    fan-out dimensions (polarization, sideband, sensor number...). */
+typedef struct {
+    const char *name;
+    unsigned char group;
+    unsigned char type;      // MONITOR or CONTROL
+    unsigned char size;      // Control payload size
+    unsigned long rca;       // Base RCA
+    unsigned long bandStride;
+    struct {
+        unsigned int count;  // Number of instances (0 or 1 -> not used)
+        unsigned long stride;
+    } dim[2];
+} RCA_ENTRY;
+
+//! Single measurement
+typedef struct {
+    float latencyUs;
+    unsigned char group;
+    unsigned char type;
+    unsigned char statusError;  // The monitor status byte was not NO_ERROR
+} SAMPLE;
+
+//! Worker state
+typedef struct {
+    int id;
+    unsigned int seed;
+    SAMPLE *samples;
+    unsigned long samplesNumber;
+    unsigned long samplesSize;
+    unsigned long transportErrors;
+    unsigned long timeouts;
+    unsigned long reconnects;
+} WORKER;
+
+/* RCA map */
+#define BAND_STRIDE 0x1000
+#define POL {2, 0x400}
+#define SB {2, 0x80}
+#define NONE {0, 0}
+
+static const RCA_ENTRY rcaMap[] = {
+    /* Cartridge bias */
+    {"sis_voltage", GROUP_BIAS, MONITOR, 0, 0x00008, BAND_STRIDE, {POL, SB}},
+    {"sis_current", GROUP_BIAS, MONITOR, 0, 0x00010, BAND_STRIDE, {POL, SB}},
+    {"sis_open_loop", GROUP_BIAS, MONITOR, 0, 0x00018, BAND_STRIDE, {POL, SB}},
+    {"sis_magnet_voltage", GROUP_BIAS, MONITOR, 0, 0x00020, BAND_STRIDE, {POL, SB}},
+    {"sis_magnet_current", GROUP_BIAS, MONITOR, 0, 0x00030, BAND_STRIDE, {POL, SB}},
+    {"lna_drain_voltage", GROUP_BIAS, MONITOR, 0, 0x00040, BAND_STRIDE, {POL, {3, 0x4}}},
+    {"lna_drain_current", GROUP_BIAS, MONITOR, 0, 0x00041, BAND_STRIDE, {POL, {3, 0x4}}},
+    {"lna_gate_voltage", GROUP_BIAS, MONITOR, 0, 0x00042, BAND_STRIDE, {POL, {3, 0x4}}},
+    {"set_sis_voltage", GROUP_BIAS, CONTROL, 4, 0x10008, BAND_STRIDE, {POL, SB}},
+    {"set_lna_led_enable", GROUP_BIAS, CONTROL, 1, 0x10100, BAND_STRIDE, {POL, NONE}},
+    /* Cartridge LO */
+    {"yto_coarse_tune", GROUP_LO, MONITOR, 0, 0x00800, BAND_STRIDE, {NONE, NONE}},
+    {"photomixer_voltage", GROUP_LO, MONITOR, 0, 0x00814, BAND_STRIDE, {NONE, NONE}},
+    {"photomixer_current", GROUP_LO, MONITOR, 0, 0x00818, BAND_STRIDE, {NONE, NONE}},
+    {"pll_lock_detect_voltage", GROUP_LO, MONITOR, 0, 0x00820, BAND_STRIDE, {NONE, NONE}},
+    {"pll_correction_voltage", GROUP_LO, MONITOR, 0, 0x00821, BAND_STRIDE, {NONE, NONE}},
+    {"pll_assembly_temp", GROUP_LO, MONITOR, 0, 0x00822, BAND_STRIDE, {NONE, NONE}},
+    {"pll_if_total_power", GROUP_LO, MONITOR, 0, 0x00825, BAND_STRIDE, {NONE, NONE}},
+    /* Cartridge temperatures */
+    {"cartridge_temp", GROUP_CTEMP, MONITOR, 0, 0x00880, BAND_STRIDE, {{6, 0x10}, NONE}},
+    /* Power distribution and IF switch */
+    {"pd_channel_voltage", GROUP_PD_IF, MONITOR, 0, 0x0A000, 0x10, {{6, 0x2}, NONE}},
+    {"pd_channel_current", GROUP_PD_IF, MONITOR, 0, 0x0A001, 0x10, {{6, 0x2}, NONE}},
+    {"pd_powered_modules", GROUP_PD_IF, MONITOR, 0, 0x0A0A0, 0, {NONE, NONE}},
+    {"if_attenuation", GROUP_PD_IF, MONITOR, 0, 0x0B001, 0, {{4, 0x4}, NONE}},
+    {"if_assembly_temp", GROUP_PD_IF, MONITOR, 0, 0x0B002, 0, {{4, 0x4}, NONE}},
+    {"if_band_select", GROUP_PD_IF, MONITOR, 0, 0x0B010, 0, {NONE, NONE}},
+    {"set_if_attenuation", GROUP_PD_IF, CONTROL, 1, 0x1B001, 0, {{4, 0x4}, NONE}},
+    /* Cryostat */
+    {"cryostat_temp", GROUP_CRYO, MONITOR, 0, 0x0C000, 0, {{13, 0x4}, NONE}},
+    {"vacuum_pressure", GROUP_CRYO, MONITOR, 0, 0x0C044, 0, {{2, 0x1}, NONE}},
+    {"supply_current_230v", GROUP_CRYO, MONITOR, 0, 0x0C048, 0, {NONE, NONE}},
+    /* FETIM interlock */
+    {"interlock_temp", GROUP_FETIM, MONITOR, 0, 0x0E000, 0, {{5, 0x1}, NONE}},
+    {"interlock_flow", GROUP_FETIM, MONITOR, 0, 0x0E008, 0, {{2, 0x4}, NONE}},
+    {"interlock_single_fail", GROUP_FETIM, MONITOR, 0, 0x0E010, 0, {NONE, NONE}},
+    {"interlock_state", GROUP_FETIM, MONITOR, 0, 0x0E024, 0, {{5, 0x4}, NONE}},
+    /* Special */
+    {"arcom_version_info", GROUP_SPECIAL, MONITOR, 0, 0x20002, 0, {NONE, NONE}},
+    {"esns_found", GROUP_SPECIAL, MONITOR, 0, 0x2000A, 0, {NONE, NONE}},
+    {"errors_number", GROUP_SPECIAL, MONITOR, 0, 0x2000C, 0, {NONE, NONE}},
+    {"fe_mode", GROUP_SPECIAL, MONITOR, 0, 0x2000E, 0, {NONE, NONE}},
+};
+
+#define RCA_MAP_SIZE (sizeof(rcaMap) / sizeof(rcaMap[0]))
+
+/* Configuration */
+static const char *host = "127.0.0.1";
+static int port = 2000;
+static unsigned long requests = 10000;
+static double duration = 0.0;
+static unsigned long warmup = 100;
+static int workersNumber = 1;
+static double monitorRatio = 0.9;
+static int bands[MAX_BANDS];
+static int bandsNumber = 0;
+static double bandSkew = -1.0;
+static double groupWeights[GROUPS_NUMBER] = {4.0, 3.0, 2.0, 1.0, 2.0, 1.0, 1.0};
+static unsigned int seed = 1;
+static const char *outputFile = NULL;
+
+/* Cumulative weights for the monitor and control draws */
+static double monitorCdf[RCA_MAP_SIZE];
+static double controlCdf[RCA_MAP_SIZE];
+static double monitorTotal = 0.0;
+static double controlTotal = 0.0;
+
+static volatile int running = 1;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double uniform(unsigned int *state) {
+    return rand_r(state) / (RAND_MAX + 1.0);
+}
+
+/* Parse a band spread specification ("1-10", "3,6,7", "2-4,9") */
+static int parseBands(const char *spec) {
+    char *copy = strdup(spec), *save = NULL;
+    bandsNumber = 0;
+    for (char *tok = strtok_r(copy, ",", &save); tok != NULL; tok = strtok_r(NULL, ",", &save)) {
+        int first, last;
+        if (sscanf(tok, "%d-%d", &first, &last) != 2) {
+            last = first = atoi(tok);
+        }
+        for (int band = first; band <= last; band++) {
+            if (band < 1 || band > MAX_BANDS || bandsNumber == MAX_BANDS) {
+                free(copy);
+                return -1;
+            }
+            bands[bandsNumber++] = band - 1;
+        }
+    }
+    free(copy);
+    return bandsNumber > 0 ? 0 : -1;
+}
+
+/* Parse group weights ("bias=4,fetim=0") */
+static int parseWeights(const char *spec) {
+    char *copy = strdup(spec), *save = NULL;
+    for (char *tok = strtok_r(copy, ",", &save); tok != NULL; tok = strtok_r(NULL, ",", &save)) {
+        char *eq = strchr(tok, '=');
+        int group;
+        if (eq == NULL) {
+            free(copy);
+            return -1;
+        }
+        *eq = '\0';
+        for (group = 0; group < GROUPS_NUMBER && strcmp(tok, groupNames[group]) != 0; group++)
+            ;
+        if (group == GROUPS_NUMBER) {
+            free(copy);
+            return -1;
+        }
+        groupWeights[group] = atof(eq + 1);
+    }
+    free(copy);
+    return 0;
+}
+
+/* Spread each group weight evenly over its entries of the given type */
+static void buildCdfs(void) {
+    int perGroup[GROUPS_NUMBER][2] = {{0}};
+    for (unsigned int i = 0; i < RCA_MAP_SIZE; i++) {
+        perGroup[rcaMap[i].group][rcaMap[i].type]++;
+    }
+    for (unsigned int i = 0; i < RCA_MAP_SIZE; i++) {
+        double weight = groupWeights[rcaMap[i].group] / perGroup[rcaMap[i].group][rcaMap[i].type];
+        if (rcaMap[i].type == MONITOR) {
+            monitorTotal += weight;
+        } else {
+            controlTotal += weight;
+        }
+        monitorCdf[i] = monitorTotal;
+        controlCdf[i] = controlTotal;
+    }
+}
+
+/* Draw the next request */
+static const RCA_ENTRY *nextRequest(unsigned int *state, unsigned long *rca) {
+    int control = controlTotal > 0.0 && uniform(state) >= monitorRatio;
+    const double *cdf = control ? controlCdf : monitorCdf;
+    double pick = uniform(state) * (control ? controlTotal : monitorTotal);
+    unsigned int i = 0;
+
+    while (i < RCA_MAP_SIZE - 1 && (cdf[i] <= pick || rcaMap[i].type != (control ? CONTROL : MONITOR))) {
+        i++;
+    }
+
+    *rca = rcaMap[i].rca;
+    if (rcaMap[i].bandStride != 0) {
+        int band;
+        if (bandSkew >= 0.0 && uniform(state) < bandSkew) {
+            band = bands[0];
+        } else {
+            band = bands[rand_r(state) % bandsNumber];
+        }
+        *rca += band * rcaMap[i].bandStride;
+    }
+    for (int d = 0; d < 2; d++) {
+        if (rcaMap[i].dim[d].count > 1) {
+            *rca += (rand_r(state) % rcaMap[i].dim[d].count) * rcaMap[i].dim[d].stride;
+        }
+    }
+    return &rcaMap[i];
+}
+
+static int connectServer(void) {
+    struct sockaddr_in addr;
+    struct timeval timeout = {REPLY_TIMEOUT_MS / 1000, (REPLY_TIMEOUT_MS % 1000) * 1000};
+    int one = 1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host, &addr.sin_addr) != 1) {
+        fprintf(stderr, "loadgen: invalid address %s\n", host);
+        return -1;
+    }
+
+    for (int retry = 0; retry < CONNECT_RETRIES && running; retry++) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+            return fd;
+        }
+        close(fd);
+        usleep(100000);
+    }
+    return -1;
+}
+
+/* Send one request and wait for its reply.
+   Returns 0 on success, -1 on transport error, -2 on timeout. */
+static int transaction(int fd, const RCA_ENTRY *entry, unsigned long rca, unsigned char *reply) {
+    unsigned char request[REQUEST_SIZE] = {0};
+    int received = 0;
+
+    request[4] = (rca >> 24) & 0xFF;
+    request[5] = (rca >> 16) & 0xFF;
+    request[6] = (rca >> 8) & 0xFF;
+    request[7] = rca & 0xFF;
+    request[8] = entry->type;
+    request[9] = entry->type == CONTROL ? entry->size : 0;
+    /* Control payloads are all zero: 0.0 V, disable, 0 dB */
+
+    if (write(fd, request, REQUEST_SIZE) != REQUEST_SIZE) {
+        return -1;
+    }
+    while (received < REPLY_SIZE) {
+        int x = read(fd, reply + received, REPLY_SIZE - received);
+        if (x < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return -2;
+        }
+        if (x <= 0) {
+            return -1;
+        }
+        received += x;
+    }
+    return 0;
+}
+
+static void storeSample(WORKER *worker, double latency, const RCA_ENTRY *entry, unsigned char statusError) {
+    if (worker->samplesNumber == worker->samplesSize) {
+        worker->samplesSize = worker->samplesSize ? 2 * worker->samplesSize : 65536;
+        worker->samples = realloc(worker->samples, worker->samplesSize * sizeof(SAMPLE));
+        if (worker->samples == NULL) {
+            fprintf(stderr, "loadgen: out of memory\n");
+            exit(1);
+        }
+    }
+    worker->samples[worker->samplesNumber].latencyUs = latency * 1e6;
+    worker->samples[worker->samplesNumber].group = entry->group;
+    worker->samples[worker->samplesNumber].type = entry->type;
+    worker->samples[worker->samplesNumber].statusError = statusError;
+    worker->samplesNumber++;
+}
+
+static void *workerThread(void *arg) {
+    WORKER *worker = (WORKER *)arg;
+    unsigned char reply[REPLY_SIZE];
+    unsigned long done = 0;
+    double stop = duration > 0.0 ? now() + duration : 0.0;
+    int fd = connectServer();
+
+    if (fd < 0) {
+        worker->transportErrors++;
+        return NULL;
+    }
+
+    for (unsigned long sent = 0; running; sent++) {
+        unsigned long rca;
+        const RCA_ENTRY *entry = nextRequest(&worker->seed, &rca);
+        double start = now();
+        int ret = transaction(fd, entry, rca, reply);
+        double end = now();
+
+        if (ret != 0) {
+            /* The reply stream is out of sync: start over on a new connection */
+            if (ret == -2) {
+                worker->timeouts++;
+            } else {
+                worker->transportErrors++;
+            }
+            close(fd);
+            worker->reconnects++;
+            if ((fd = connectServer()) < 0) {
+                return NULL;
+            }
+        } else if (sent >= warmup) {
+            /* Monitor replies carry the firmware status in the last byte */
+            unsigned char size = reply[REPLY_SIZE_BYTE];
+            unsigned char statusError = entry->type == MONITOR && entry->rca < 0x20000 && size > 0 &&
+                                        size <= 8 && reply[REPLY_DATA_BYTE + size - 1] != 0;
+            storeSample(worker, end - start, entry, statusError);
+            done++;
+        }
+
+        if (duration > 0.0 ? (sent >= warmup && end >= stop) : done >= requests) {
+            break;
+        }
+    }
+    close(fd);
+    return NULL;
+}
+
+static int compareSamples(const void *a, const void *b) {
+    float x = ((const SAMPLE *)a)->latencyUs, y = ((const SAMPLE *)b)->latencyUs;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const SAMPLE *sorted, unsigned long number, double p) {
+    if (number == 0) {
+        return 0.0;
+    }
+    unsigned long index = (unsigned long)(p * (number - 1) + 0.5);
+    return sorted[index].latencyUs;
+}
+
+static void printLatency(FILE *out, const SAMPLE *sorted, unsigned long number) {
+    double sum = 0.0;
+    for (unsigned long i = 0; i < number; i++) {
+        sum += sorted[i].latencyUs;
+    }
+    fprintf(out,
+            "{\"min\": %.2f, \"mean\": %.2f, \"p50\": %.2f, \"p90\": %.2f, \"p99\": %.2f, \"p999\": %.2f, "
+            "\"max\": %.2f}",
+            number ? sorted[0].latencyUs : 0.0, number ? sum / number : 0.0, percentile(sorted, number, 0.50),
+            percentile(sorted, number, 0.90), percentile(sorted, number, 0.99), percentile(sorted, number, 0.999),
+            number ? sorted[number - 1].latencyUs : 0.0);
+}
+
+static void usage(const char *name) {
+    fprintf(stderr,
+            "usage: %s [-H host] [-p port] [-n count | -t seconds] [-w warmup] [-c workers] [-m monitor_ratio]\n"
+            "       [-b bands] [-z skew] [-g group=weight,...] [-s seed] [-o file]\n",
+            name);
+    exit(2);
+}
+
+int main(int argc, char *argv[]) {
+    WORKER workers[MAX_WORKERS];
+    pthread_t tid[MAX_WORKERS];
+    SAMPLE *all, *group;
+    unsigned long total = 0, statusErrors = 0, transportErrors = 0, timeouts = 0, reconnects = 0;
+    unsigned long perType[2] = {0, 0};
+    double start, elapsed;
+    FILE *out = stdout;
+    int opt;
+
+    parseBands("1-10");
+
+    while ((opt = getopt(argc, argv, "H:p:n:t:w:c:m:b:z:g:s:o:h")) != -1) {
+        switch (opt) {
+            case 'H':
+                host = optarg;
+                break;
+            case 'p':
+                port = atoi(optarg);
+                break;
+            case 'n':
+                requests = strtoul(optarg, NULL, 0);
+                break;
+            case 't':
+                duration = atof(optarg);
+                break;
+            case 'w':
+                warmup = strtoul(optarg, NULL, 0);
+                break;
+            case 'c':
+                workersNumber = atoi(optarg);
+                if (workersNumber < 1 || workersNumber > MAX_WORKERS) {
+                    usage(argv[0]);
+                }
+                break;
+            case 'm':
+                monitorRatio = atof(optarg);
+                if (monitorRatio < 0.0 || monitorRatio > 1.0) {
+                    usage(argv[0]);
+                }
+                break;
+            case 'b':
+                if (parseBands(optarg) != 0) {
+                    usage(argv[0]);
+                }
+                break;
+            case 'z':
+                bandSkew = atof(optarg);
+                break;
+            case 'g':
+                if (parseWeights(optarg) != 0) {
+                    usage(argv[0]);
+                }
+                break;
+            case 's':
+                seed = strtoul(optarg, NULL, 0);
+                break;
+            case 'o':
+                outputFile = optarg;
+                break;
+            default:
+                usage(argv[0]);
+        }
+    }
+
+    buildCdfs();
+    if (monitorTotal <= 0.0) {
+        fprintf(stderr, "loadgen: no monitor RCA left with the given group weights\n");
+        return 1;
+    }
+
+    start = now();
+    for (int i = 0; i < workersNumber; i++) {
+        memset(&workers[i], 0, sizeof(WORKER));
+        workers[i].id = i;
+        workers[i].seed = seed + 7919 * i;
+        pthread_create(&tid[i], NULL, workerThread, &workers[i]);
+    }
+    for (int i = 0; i < workersNumber; i++) {
+        pthread_join(tid[i], NULL);
+    }
+    elapsed = now() - start;
+
+    for (int i = 0; i < workersNumber; i++) {
+        total += workers[i].samplesNumber;
+        transportErrors += workers[i].transportErrors;
+        timeouts += workers[i].timeouts;
+        reconnects += workers[i].reconnects;
+    }
+
+    all = malloc((total ? total : 1) * sizeof(SAMPLE));
+    group = malloc((total ? total : 1) * sizeof(SAMPLE));
+    total = 0;
+    for (int i = 0; i < workersNumber; i++) {
+        memcpy(all + total, workers[i].samples, workers[i].samplesNumber * sizeof(SAMPLE));
+        total += workers[i].samplesNumber;
+        free(workers[i].samples);
+    }
+    for (unsigned long i = 0; i < total; i++) {
+        statusErrors += all[i].statusError;
+        perType[all[i].type]++;
+    }
+    qsort(all, total, sizeof(SAMPLE), compareSamples);
+
+    if (outputFile != NULL && (out = fopen(outputFile, "w")) == NULL) {
+        fprintf(stderr, "loadgen: cannot open %s: %s\n", outputFile, strerror(errno));
+        return 1;
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"tool\": \"loadgen\",\n");
+    fprintf(out, "  \"target\": \"%s:%d\",\n", host, port);
+    fprintf(out, "  \"workers\": %d,\n", workersNumber);
+    fprintf(out, "  \"monitor_ratio\": %.3f,\n", monitorRatio);
+    fprintf(out, "  \"bands\": [");
+    for (int i = 0; i < bandsNumber; i++) {
+        fprintf(out, "%s%d", i ? ", " : "", bands[i] + 1);
+    }
+    fprintf(out, "],\n");
+    fprintf(out, "  \"band_skew\": %.3f,\n", bandSkew);
+    fprintf(out, "  \"seed\": %u,\n", seed);
+    fprintf(out, "  \"requests\": %lu,\n", total);
+    fprintf(out, "  \"monitors\": %lu,\n", perType[MONITOR]);
+    fprintf(out, "  \"controls\": %lu,\n", perType[CONTROL]);
+    fprintf(out, "  \"status_errors\": %lu,\n", statusErrors);
+    fprintf(out, "  \"transport_errors\": %lu,\n", transportErrors);
+    fprintf(out, "  \"timeouts\": %lu,\n", timeouts);
+    fprintf(out, "  \"reconnects\": %lu,\n", reconnects);
+    fprintf(out, "  \"elapsed_s\": %.3f,\n", elapsed);
+    fprintf(out, "  \"req_per_s\": %.1f,\n", elapsed > 0.0 ? total / elapsed : 0.0);
+    fprintf(out, "  \"latency_us\": ");
+    printLatency(out, all, total);
+    fprintf(out, ",\n  \"groups\": {\n");
+    for (int g = 0, first = 1; g < GROUPS_NUMBER; g++) {
+        unsigned long number = 0;
+        for (unsigned long i = 0; i < total; i++) {
+            if (all[i].group == g) {
+                group[number++] = all[i];
+            }
+        }
+        if (number == 0) {
+            continue;
+        }
+        fprintf(out, "%s    \"%s\": {\"requests\": %lu, \"latency_us\": ", first ? "" : ",\n", groupNames[g], number);
+        printLatency(out, group, number);
+        fprintf(out, "}");
+        first = 0;
+    }
+    fprintf(out, "\n  }\n}\n");
+
+    if (out != stdout) {
+        fclose(out);
+    }
+    free(all);
+    free(group);
+
+    return transportErrors + timeouts > 0 ? 1 : 0;
+}
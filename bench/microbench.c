@@ -0,0 +1,444 @@
+/*! \file   microbench.c
+    \brief  Microbenchmarks for the firmware hot paths
+
+    This program links the firmware objects built for the simulated hardware
+    backend (see 'make sim') and times the code paths that dominate the
+    monitor traffic:
+        - cartridge temperature conversion (temperatureConversion and the
+          per band batch cartridgeTempsConversion)
+        - cryostat TVO and PRT polynomial conversion (cryostatTempConversion
+          and the all sensors batch cryostatTempsConversion)
+        - vacuum sensors pressure conversion (cryostatPressureConversion)
+        - LO PA limits table lookup (findMaxSafeLoPaEntry)
+        - CAN message dispatch for representative RCAs (CANMessageHandler)
+        - serial mux access on the simulated registers (serialAccess)
+        - configuration file parsing on the shipped INI files (ReadCfg)
+
+    Every benchmark is calibrated so that one repetition lasts at least the
+    target time, then repeated a number of times. The median time per
+    operation is reported together with the minimum, maximum and spread of the
+    repetitions, as a JSON document on stdout that can be compared between
+    builds. The process is pinned to a single CPU to reduce the noise.
+
+    Before timing anything, the approximated conversions are checked against
+    the reference math library evaluation over their whole input range. The
+    program fails if the error exceeds the documented bound.
+
+    Usage:
+        make bench
+        bin/microbench [-d ini_dir] [-r reps] [-t target_ms] [-f filter] [-c cpu] [-o file]
+
+    Options:
+        -d dir      directory containing the INI files (default ini_files)
+        -r reps     number of measured repetitions (default 11)
+        -t ms       minimum duration of one repetition (default 20)
+        -f filter   only run the benchmarks whose name contains filter
+        -c cpu      CPU to pin the process to, -1 to disable (default 0)
+        -o file     JSON output file (default stdout) */
+
+/* Includes */
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <math.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "biasSerialInterface.h"
+#include "cryostatSerialInterface.h"
+#include "error_local.h"
+#include "frontend.h"
+#include "globalDefinitions.h"
+#include "globalOperations.h"
+#include "ini.h"
+#include "packet.h"
+#include "serialInterface.h"
+#include "version.h"
+
+/* Globals normally provided by main.c */
+CAN_MESSAGE CANMessage;
+unsigned char currentClass = 0;
+
+/* Defines */
+#define MAX_REPS 101
+#define INPUTS_NUMBER 1024  // Size of the input vectors (power of 2)
+#define INPUTS_MASK (INPUTS_NUMBER - 1)
+#define BENCH_BAND BAND6       // Band used for the cartridge benchmarks
+#define PA_TABLE_ENTRIES 128   // Size of the synthetic PA limits table
+#define PA_TABLE_YTO_STEP 32   // YTO step between PA limits entries
+
+/* Typedefs */
+typedef struct {
+    const char *name;
+    void (*run)(unsigned long iterations);
+    unsigned long rca;  // RCA for the dispatch benchmarks
+} BENCHMARK;
+
+/* Statics */
+static volatile float sink;  // Keep the results alive
+static float voltages[INPUTS_NUMBER];
+static float cryoVoltages[INPUTS_NUMBER];
+static unsigned int ytoWords[INPUTS_NUMBER];
+static unsigned long dispatchRca;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Benchmarks */
+static void benchTemperatureConversion(unsigned long iterations) {
+    float acc = 0.0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        acc += temperatureConversion(voltages[i & INPUTS_MASK]);
+    }
+    sink = acc;
+}
+
+static void benchCartridgeTempsConversion(unsigned long iterations) {
+    for (unsigned long i = 0; i < iterations; i++) {
+        cartridgeTempsConversion(BENCH_BAND, &voltages[(i * CARTRIDGE_TEMP_SENSORS_NUMBER) & (INPUTS_MASK & ~7)]);
+    }
+    sink = frontend.cartridge[BENCH_BAND].cartridgeTemp[0].temp;
+}
+
+static void benchTvoConversion(unsigned long iterations) {
+    float acc = 0.0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        acc += cryostatTempConversion(i % TVO_SENSORS_NUMBER, cryoVoltages[i & INPUTS_MASK]);
+    }
+    sink = acc;
+}
+
+static void benchPrtConversion(unsigned long iterations) {
+    float acc = 0.0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        acc += cryostatTempConversion(TVO_SENSORS_NUMBER + (i & 3), cryoVoltages[i & INPUTS_MASK]);
+    }
+    sink = acc;
+}
+
+static void benchCryostatTempsConversion(unsigned long iterations) {
+    float temperature[CRYOSTAT_TEMP_SENSORS_NUMBER], acc = 0.0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        cryostatTempsConversion(&cryoVoltages[(i * CRYOSTAT_TEMP_SENSORS_NUMBER) & (INPUTS_MASK & ~15)], temperature);
+        acc += temperature[0];
+    }
+    sink = acc;
+}
+
+static void benchPressureConversion(unsigned long iterations) {
+    float acc = 0.0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        acc += cryostatPressureConversion(i & 1, 10.0 * (voltages[i & INPUTS_MASK] - 0.08) / 1.6);
+    }
+    sink = acc;
+}
+
+static void benchFindMaxSafeLoPaEntry(unsigned long iterations) {
+    float acc = 0.0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        MAX_SAFE_LO_PA_ENTRY entry;
+        findMaxSafeLoPaEntry(ytoWords[i & INPUTS_MASK], BENCH_BAND, &entry);
+        acc += entry.maxVD0;
+    }
+    sink = acc;
+}
+
+static void benchDispatch(unsigned long iterations) {
+    for (unsigned long i = 0; i < iterations; i++) {
+        CAN_ADDRESS = dispatchRca;
+        CAN_SIZE = CAN_MONITOR;
+        CANMessageHandler();
+    }
+    sink = CAN_SIZE;
+}
+
+static void benchSerialRead(unsigned long iterations) {
+    int reg = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        serialAccess(CRYO_HRDW_REV_READ, &reg, CRYO_HRDW_REV_REG_SIZE, CRYO_HRDW_REV_REG_SHIFT_SIZE,
+                     CRYO_HRDW_REV_REG_SHIFT_DIR, SERIAL_READ, CRYO_MODULE, 0);
+    }
+    sink = reg;
+}
+
+static void benchSerialWrite(unsigned long iterations) {
+    long long reg = 0;
+    for (unsigned long i = 0; i < iterations; i++) {
+        reg = i & 0x7FF;
+        serialAccess(CRYO_PARALLEL_WRITE(CRYO_AREG), (int *)&reg, CRYO_AREG_SIZE, CRYO_AREG_SHIFT_SIZE,
+                     CRYO_AREG_SHIFT_DIR, SERIAL_WRITE, CRYO_MODULE, 0);
+    }
+    sink = reg;
+}
+
+static void benchReadCfgTvoCoeffs(unsigned long iterations) {
+    float coeff[TVO_COEFFS_NUMBER];
+    CFG_STRUCT dataIn = {.Name = "TVO_COEFFS", .VarType = Cfg_F_Array, .DataPtr = coeff};
+    for (unsigned long i = 0; i < iterations; i++) {
+        ReadCfg("CRYO.INI", "SHIELD_TOP_12K", &dataIn);
+    }
+    sink = coeff[0];
+}
+
+static void benchReadCfgSensorOffset(unsigned long iterations) {
+    float offset = 0.0;
+    CFG_STRUCT dataIn = {.Name = "OFFSET", .VarType = Cfg_Float, .DataPtr = &offset};
+    for (unsigned long i = 0; i < iterations; i++) {
+        ReadCfg("CART6.INI", "POL1_MIXER", &dataIn);
+    }
+    sink = offset;
+}
+
+static void benchReadCfgMissingKey(unsigned long iterations) {
+    unsigned char entries = 0;
+    CFG_STRUCT dataIn = {.Name = "ENTRIES", .VarType = Cfg_Byte, .DataPtr = &entries};
+    for (unsigned long i = 0; i < iterations; i++) {
+        ReadCfg("WCA6.INI", "PA_LIMITS", &dataIn);
+    }
+    sink = entries;
+}
+
+static BENCHMARK benchmarks[] = {
+    {"temperatureConversion", benchTemperatureConversion, 0},
+    {"cartridgeTempsConversion", benchCartridgeTempsConversion, 0},
+    {"cryostatTempConversion/tvo", benchTvoConversion, 0},
+    {"cryostatTempConversion/prt", benchPrtConversion, 0},
+    {"cryostatTempsConversion", benchCryostatTempsConversion, 0},
+    {"cryostatPressureConversion", benchPressureConversion, 0},
+    {"findMaxSafeLoPaEntry", benchFindMaxSafeLoPaEntry, 0},
+    {"dispatch/sis_voltage", benchDispatch, 0x00008},
+    {"dispatch/lna_drain_voltage", benchDispatch, 0x00440},
+    {"dispatch/pll_lock_detect_voltage", benchDispatch, 0x00820},
+    {"dispatch/cartridge_temp", benchDispatch, 0x00880},
+    {"dispatch/pd_channel_voltage", benchDispatch, 0x0A000},
+    {"dispatch/if_attenuation", benchDispatch, 0x0B001},
+    {"dispatch/cryostat_temp", benchDispatch, 0x0C000},
+    {"dispatch/vacuum_pressure", benchDispatch, 0x0C044},
+    {"dispatch/interlock_temp", benchDispatch, 0x0E000},
+    {"dispatch/fe_mode", benchDispatch, 0x2000E},
+    {"serialAccess/read", benchSerialRead, 0},
+    {"serialAccess/write", benchSerialWrite, 0},
+    {"ReadCfg/tvo_coeffs", benchReadCfgTvoCoeffs, 0},
+    {"ReadCfg/sensor_offset", benchReadCfgSensorOffset, 0},
+    {"ReadCfg/missing_key", benchReadCfgMissingKey, 0},
+};
+
+#define BENCHMARKS_NUMBER (sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+/* Deterministic inputs shared by all the builds */
+static void prepareInputs(void) {
+    unsigned int state = 12345;
+    for (int i = 0; i < INPUTS_NUMBER; i++) {
+        /* Cover the whole calibration curve plus a few out of range values */
+        voltages[i] = 0.08 + 1.6 * (rand_r(&state) / (float)RAND_MAX);
+        /* TVO resistance 1 - 10 kOhm scaled by 1000, PRT 20 - 300 Ohm */
+        cryoVoltages[i] = 0.2 + 2.0 * (rand_r(&state) / (float)RAND_MAX);
+        ytoWords[i] = rand_r(&state) % 4096;
+    }
+}
+
+/* Put the firmware in the state expected by the benchmarks */
+static int prepareFirmware(const char *dir) {
+    int console, devNull;
+
+    if (chdir(dir) != 0) {
+        perror(dir);
+        return ERROR;
+    }
+
+    /* Keep the startup report out of the results */
+    fflush(stdout);
+    console = dup(STDOUT_FILENO);
+    devNull = open("/dev/null", O_WRONLY);
+    dup2(devNull, STDOUT_FILENO);
+    close(devNull);
+
+    if (initialization() == ERROR) {
+        dup2(console, STDOUT_FILENO);
+        return ERROR;
+    }
+
+    /* A powered cartridge, so that the cartridge RCAs reach the monitor
+       functions instead of stopping at the state check. */
+    frontend.cartridge[BENCH_BAND].available = AVAILABLE;
+    frontend.cartridge[BENCH_BAND].state = CARTRIDGE_READY;
+
+    /* The shipped WCA files carry no PA limits: build a synthetic table. */
+    loResetPaLimitsTable(BENCH_BAND);
+    for (unsigned int entry = 0; entry < PA_TABLE_ENTRIES; entry++) {
+        loAddPaLimitsEntry(BENCH_BAND, 2, entry * PA_TABLE_YTO_STEP, 0.5 + 2.0 * entry / PA_TABLE_ENTRIES);
+    }
+
+    fflush(stdout);
+    dup2(console, STDOUT_FILENO);
+    close(console);
+
+    return NO_ERROR;
+}
+
+/* Accuracy checks */
+/* Compare the fast pressure conversion with pow() for every ADC code */
+static double checkPressureConversion(void) {
+    static const double offset[VACUUM_SENSORS_NUMBER] = {CRYO_ADC_CRYO_PRESS_OFFSET, CRYO_ADC_VAC_PORT_PRESS_OFFSET};
+    static const double scale[VACUUM_SENSORS_NUMBER] = {CRYO_ADC_CRYO_PRESS_SCALE, CRYO_ADC_VAC_PORT_PRESS_SCALE};
+    double maxError = 0.0;
+
+    for (int sensor = 0; sensor < VACUUM_SENSORS_NUMBER; sensor++) {
+        for (long code = 0; code < CRYO_ADC_RANGE; code++) {
+            float vin = (CRYO_ADC_VOLTAGE_IN_SCALE * code) / CRYO_ADC_RANGE;
+            double reference = pow(10.0, (vin + offset[sensor]) / scale[sensor]);
+            double error = fabs(cryostatPressureConversion(sensor, vin) - reference) / reference;
+            if (error > maxError) {
+                maxError = error;
+            }
+        }
+    }
+    return maxError;
+}
+
+static const struct {
+    const char *name;
+    double (*run)(void);
+    double bound;
+} checks[] = {
+    {"cryostatPressureConversion", checkPressureConversion, CRYO_PRESS_EXP10_MAX_ERR},
+};
+#define CHECKS_NUMBER (sizeof(checks) / sizeof(checks[0]))
+
+static int compareDouble(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Calibrate, run and report one benchmark */
+static void runBenchmark(FILE *out, const BENCHMARK *benchmark, int reps, double targetNs, int first) {
+    unsigned long iterations = 1;
+    double samples[MAX_REPS];
+    double elapsed, median;
+
+    dispatchRca = benchmark->rca + (benchmark->rca < 0x0A000 ? BENCH_BAND << 12 : 0);
+
+    /* Calibration, also warms up the caches and the branch predictors */
+    for (;;) {
+        double start = now();
+        benchmark->run(iterations);
+        elapsed = now() - start;
+        if (elapsed >= targetNs || iterations >= (1UL << 40)) {
+            break;
+        }
+        iterations *= elapsed > 0.0 && targetNs / elapsed < 16.0 ? 2 : 16;
+    }
+
+    for (int rep = 0; rep < reps; rep++) {
+        double start = now();
+        benchmark->run(iterations);
+        samples[rep] = (now() - start) / iterations;
+    }
+    qsort(samples, reps, sizeof(double), compareDouble);
+    median = samples[reps / 2];
+
+    fprintf(out,
+            "%s    {\"name\": \"%s\", \"ns_per_op\": %.3f, \"min\": %.3f, \"max\": %.3f, \"spread_pct\": %.2f, "
+            "\"iterations\": %lu}",
+            first ? "" : ",\n", benchmark->name, median, samples[0], samples[reps - 1],
+            median > 0.0 ? 100.0 * (samples[reps - 1] - samples[0]) / median : 0.0, iterations);
+    fprintf(stderr, "%-36s %12.3f ns/op  (min %.3f, max %.3f)\n", benchmark->name, median, samples[0],
+            samples[reps - 1]);
+}
+
+int main(int argc, char *argv[]) {
+    const char *dir = "ini_files";
+    const char *filter = NULL;
+    const char *outputFile = NULL;
+    int reps = 11, cpu = 0, opt, first = 1, failed = 0;
+    double targetMs = 20.0;
+    FILE *out = stdout;
+
+    while ((opt = getopt(argc, argv, "d:r:t:f:c:o:h")) != -1) {
+        switch (opt) {
+            case 'd':
+                dir = optarg;
+                break;
+            case 'r':
+                reps = atoi(optarg);
+                if (reps < 1 || reps > MAX_REPS) {
+                    reps = 11;
+                }
+                break;
+            case 't':
+                targetMs = atof(optarg);
+                break;
+            case 'f':
+                filter = optarg;
+                break;
+            case 'c':
+                cpu = atoi(optarg);
+                break;
+            case 'o':
+                outputFile = optarg;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-d ini_dir] [-r reps] [-t target_ms] [-f filter] [-c cpu] [-o file]\n",
+                        argv[0]);
+                return 2;
+        }
+    }
+
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            fprintf(stderr, "microbench: cannot pin to CPU %d, running unpinned\n", cpu);
+        }
+    }
+
+    if (outputFile != NULL && (out = fopen(outputFile, "w")) == NULL) {
+        perror(outputFile);
+        return 1;
+    }
+
+    prepareInputs();
+    if (prepareFirmware(dir) == ERROR) {
+        fprintf(stderr, "microbench: firmware initialization failed\n");
+        return 1;
+    }
+
+    fprintf(out, "{\n  \"suite\": \"microbench\",\n");
+    fprintf(out, "  \"firmware\": \"%d.%d.%d\",\n", VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH);
+    fprintf(out, "  \"reps\": %d,\n  \"target_ms\": %.1f,\n", reps, targetMs);
+    fprintf(out, "  \"checks\": [\n");
+    for (unsigned int i = 0; i < CHECKS_NUMBER; i++) {
+        double error = checks[i].run();
+        fprintf(out, "    {\"name\": \"%s\", \"max_rel_error\": %.3g, \"bound\": %.3g, \"pass\": %s}%s\n",
+                checks[i].name, error, checks[i].bound, error <= checks[i].bound ? "true" : "false",
+                i + 1 < CHECKS_NUMBER ? "," : "");
+        fprintf(stderr, "%-36s max rel error %.3g (bound %.3g)%s\n", checks[i].name, error, checks[i].bound,
+                error <= checks[i].bound ? "" : " FAILED");
+        if (error > checks[i].bound) {
+            failed = 1;
+        }
+    }
+    fprintf(out, "  ],\n");
+    fprintf(out, "  \"results\": [\n");
+    for (unsigned int i = 0; i < BENCHMARKS_NUMBER; i++) {
+        if (filter != NULL && strstr(benchmarks[i].name, filter) == NULL) {
+            continue;
+        }
+        runBenchmark(out, &benchmarks[i], reps, targetMs * 1e6, first);
+        first = 0;
+    }
+    fprintf(out, "\n  ]\n}\n");
+
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    return failed;
+}
@@ -476,16 +476,19 @@ typedef struct {
 
 /* Prototypes */
 int getBiasAnalogMonitor(int currentModule, int currentBiasModule);  // Perform core analog monitor functions
+void temperatureConversionInit(void);                                // Precompute the calibration curve slopes
 float temperatureConversion(float voltage);                          // Perform voltage to temperature conversion
+int cartridgeTempsConversion(int currentModule, const float voltage[CARTRIDGE_TEMP_SENSORS_NUMBER]);
+//!< This function converts and stores all the temperature sensors of a cartridge
 int getSisMixerBias(unsigned char current, int currentModule, int currentBiasModule,
                     int currentPolarizationModule);  //!< This function monitors the SIS mixer bias
-int setSisMixerBias(int currentModule, int currentBiasModule,
+int setSisMixerBias(float voltage, int currentModule, int currentBiasModule,
                     int currentPolarizationModule);  //!< This function control the SIS mixer bias
 int setSisMixerLoop(unsigned char biasMode, int currentModule, int currentBiasModule,
                     int currentPolarizationModule);  //!< This function sets the SIS mixer bias mode
 int getSisMagnetBias(unsigned char current, int currentModule, int currentBiasModule,
                      int currentPolarizationModule);  //!< This function monitors the SIS magnet bias
-int setSisMagnetBias(int currentModule, int currentBiasModule,
+int setSisMagnetBias(float current, int currentModule, int currentBiasModule,
                      int currentPolarizationModule);  //!< This function control the SIS magnet bias
 int setLnaBiasEnable(unsigned char enable, int currentModule, int currentBiasModule,
                      int currentPolarizationModule);  //!< This function enables/disables the LNA bias
@@ -493,8 +496,12 @@ int getLnaStage(int currentModule, int currentBiasModule, int currentPolarizatio
                 int currentLnaStageModule);  //!< This function monitors the LNA stage conditions
 int setLnaStage(int currentModule, int currentBiasModule, int currentPolarizationModule, int currentLnaModule,
                 int currentLnaStageModule);  //!< This function controls the LNA stage conditions
+int setLnaStages(int currentModule, int currentBiasModule,
+                 const LNA_BIAS_SETPOINT setPoint[SIDEBANDS_NUMBER][LNA_STAGES_NUMBER]);
+//!< This function sets all the staged LNA stages of a polarization in one pass
 int setLnaLedEnable(unsigned char enable, int currentModule, int currentBiasModule,
                     int currentPolarizationModule);  //!< This function enables/disable the LNA led
+int setBiasStandby2(const int cartridge[], int cartridgesNumber);  //!< Put the bias of several cartridges in STANDBY2
 int setSisHeaterEnable(unsigned char enable, int currentModule, int currentBiasModule,
                        int currentPolarizationModule);  //!< This function enables/disable the SIS mixers heater
 int getSisHeater(int currentModule, int currentBiasModule,
@@ -504,4 +511,6 @@ int setBiasDacStrobe(int currentModule, int currentBiasModule, int currentPolari
                      int currentPolDacModule);  //!< This function sends the desired strobe to the DACs
 int getTemp(unsigned char polarization, unsigned char sensor, int currentModule,
             int currentCartridgeTempSubsystemModule);  //!< This function monitors the selected temperature sensor
+int getTemps(int currentModule, const TEMP_SENSOR sensor[CARTRIDGE_TEMP_SENSORS_NUMBER]);
+//!< This function monitors all the temperature sensors of a cartridge in one pass
 #endif                                                 /* _BIASSERIALINTERFACE_H */
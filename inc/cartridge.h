@@ -20,6 +20,7 @@
 #define _CARTRIDGE_H
 
 /* Extra includes */
+#include <stdatomic.h>
 
 #include "cartridgeTemp.h"
 #include "globalDefinitions.h"
@@ -113,6 +114,9 @@
 #define CARTRIDGE_INITING 2      // Cartridge is initializing
 #define CARTRIDGE_READY 3        // Cartridge is ready to be used
 #define CARTRIDGE_GO_STANDBY2 4  // Cartridge is about to enter STANDBY2 in the async process
+#define CARTRIDGE_STATES_NUMBER 6
+
+#define CARTRIDGE_EVENTS_NUMBER 16  //!< Size of the queue of state transitions for the async process
 
 /* Subsystem definition */
 #define CARTRIDGE_SUBSYSTEMS_NUMBER 2  // See the list below
@@ -149,17 +153,67 @@
 #define CARTRIDGE_TEMP_SUBSYSTEM_MODULES_MASK_SHIFT 4  // Bits right shift of the submodule mask
 
 /* Typedefs */
+//! Last control messages of the cartridge
+/*! These are only written by the message loop and read back by the control
+    monitor messages. They are kept on their own cache lines, away from the
+    monitor values updated by the cartridge async thread. The polarization
+    DAC strobes are triggered by the reception of the message: their last
+    control messages only keep the monitor requests from timing out. */
+typedef struct CACHE_ALIGNED {
+    //! SIS sense resistor, mixer voltage and mixer mode
+    LAST_CONTROL_MESSAGE sisSenseResistor[POLARIZATIONS_NUMBER][SIDEBANDS_NUMBER];
+    LAST_CONTROL_MESSAGE sisVoltage[POLARIZATIONS_NUMBER][SIDEBANDS_NUMBER];
+    LAST_CONTROL_MESSAGE sisOpenLoop[POLARIZATIONS_NUMBER][SIDEBANDS_NUMBER];
+    //! SIS magnet current
+    LAST_CONTROL_MESSAGE sisMagnetCurrent[POLARIZATIONS_NUMBER][SIDEBANDS_NUMBER];
+    //! LNA state and stages drain voltage and current
+    LAST_CONTROL_MESSAGE lnaEnable[POLARIZATIONS_NUMBER][SIDEBANDS_NUMBER];
+    LAST_CONTROL_MESSAGE lnaStageDrainVoltage[POLARIZATIONS_NUMBER][SIDEBANDS_NUMBER][LNA_STAGES_NUMBER];
+    LAST_CONTROL_MESSAGE lnaStageDrainCurrent[POLARIZATIONS_NUMBER][SIDEBANDS_NUMBER][LNA_STAGES_NUMBER];
+    //! LNA led and SIS heater state
+    LAST_CONTROL_MESSAGE lnaLedEnable[POLARIZATIONS_NUMBER];
+    LAST_CONTROL_MESSAGE sisHeaterEnable[POLARIZATIONS_NUMBER];
+    //! Polarization DACs reset and clear strobes
+    LAST_CONTROL_MESSAGE polDacResetStrobe[POLARIZATIONS_NUMBER][POL_DACS_NUMBER];
+    LAST_CONTROL_MESSAGE polDacClearStrobe[POLARIZATIONS_NUMBER][POL_DACS_NUMBER];
+    //! YTO coarse tune and photomixer state
+    LAST_CONTROL_MESSAGE ytoCoarseTune;
+    LAST_CONTROL_MESSAGE photomixerEnable;
+    //! PLL controls
+    LAST_CONTROL_MESSAGE pllClearUnlockDetectLatch;
+    LAST_CONTROL_MESSAGE pllLoopBandwidthSelect;
+    LAST_CONTROL_MESSAGE pllSidebandLockPolaritySelect;
+    LAST_CONTROL_MESSAGE pllNullLoopIntegrator;
+    //! AMC controls
+    LAST_CONTROL_MESSAGE amcDrainBVoltage;
+    LAST_CONTROL_MESSAGE amcMultiplierDVoltage;
+    LAST_CONTROL_MESSAGE amcGateEVoltage;
+    LAST_CONTROL_MESSAGE amcDrainEVoltage;
+    //! PA controls: Teledyne PA, collector bytes and channels gate and drain voltage
+    LAST_CONTROL_MESSAGE paHasTeledynePa;
+    LAST_CONTROL_MESSAGE paTeledyneCollectorByte[2];
+    LAST_CONTROL_MESSAGE paChannelGateVoltage[PA_CHANNELS_NUMBER];
+    LAST_CONTROL_MESSAGE paChannelDrainVoltage[PA_CHANNELS_NUMBER];
+    //! Cartridge temperature sensors offset
+    LAST_CONTROL_MESSAGE cartridgeTempOffset[CARTRIDGE_TEMP_SENSORS_NUMBER];
+} CARTRIDGE_LAST_CONTROL;
+
 //! Current state of the cartridge
-/*! This structure represent the current state of the cartridge. */
-typedef struct {
+/*! This structure represent the current state of the cartridge. It is
+    aligned to a cache line so that the cartridge async thread updating one
+    cartridge does not share cache lines with the other cartridges. */
+typedef struct CACHE_ALIGNED {
     //! Cartridge availability
     /*! This field indicates if a cartridge is installed or not in the receiver. */
     unsigned char available;
 
     //! Cartrdige current state
     /*! This field indicates the current state of the cartridge.
-        See definitions above. */
-    int state;
+        See definitions above. It is changed by both the CAN and the
+        cartridge async threads: use \ref cartridgeSetState,
+        \ref cartridgePowerOn, \ref cartridgeStop or \ref cartridgeFault
+        to change it. */
+    _Atomic int state;
 
     //! Cartridge STANDBY2 setting (TRUE/FALSE)
     /*! When a cartridge is operating in STANDBY2 mode,
@@ -190,6 +244,10 @@ typedef struct {
     /*! This contains the configuration file name as extracted from the
         frontend configuration file. */
     char configFile[MAX_FILE_NAME_SIZE];
+
+    //! Last control messages
+    /*! Please see \ref CARTRIDGE_LAST_CONTROL for more information. */
+    CARTRIDGE_LAST_CONTROL lastControl;
 } CARTRIDGE;
 
 /* Prototypes */
@@ -204,5 +262,8 @@ void cartridgeHandler(int currentModule);    //!< This function deals with the i
 int cartridgeInit(unsigned char cartridge);  //!< This function initializes the selected cartridge at runtime
 int cartridgeStop(unsigned char cartridge);  //!< Shut down the selected cartridge
 int cartridgeAsync(void);                    //!< This function deals with the asynchronous operation of a cartridge
+int cartridgeSetState(int cartridge, int from, int to);       //!< Move a cartridge along the state graph
+int cartridgePowerOn(int cartridge, unsigned char standby2);  //!< Move a cartridge from OFF to ON
+void cartridgeFault(int cartridge, unsigned char standby2);   //!< Put a cartridge in the error state
 
 #endif /* _CARTRIDGE_H */
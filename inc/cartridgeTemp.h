@@ -25,6 +25,7 @@
 
 /* Defines */
 #define CARTRIDGE_TEMP_SENSORS_NUMBER 6  //!< Number of cartridge temperature sensors per cartridge
+#define CARTRIDGE_TEMP_CACHE_AGE 1000    //!< Maximum age (ms) of the temperatures served without a new sweep
 
 /* Definition necessary for the mapping */
 #define SENSOR0 0
@@ -55,8 +56,6 @@ typedef struct {
     /*! This is the offset (in K) respect to the standard calibration
         curve which is applied to all the sensors in the cartridge. */
     float offset;
-    //! Last control message: set offset
-    LAST_CONTROL_MESSAGE lastOffset;
 } CARTRIDGE_TEMP;
 
 /* A structure to perform the mapping of the sensors */
@@ -69,6 +68,7 @@ typedef struct {
 void cartTempOffsetHandler(
     int currentModule, int currentCartridgeTempSubsystemModule);  //!< This function deals with the incoming can message
 void cartTempHandler(int currentModule, int currentCartridgeTempSubsystemModule);
+void cartridgeTempsInvalidate(int currentModule);  //!< This function discards the cached temperatures of a cartridge
 void cartridgeTempHandler(
     int currentModule, int currentCartridgeTempSubsystemModule);  //!< This function deals with the incoming can message
 
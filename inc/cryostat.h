@@ -95,6 +95,20 @@
            // we log cryostat cooling hours.
 
 /* Typedefs */
+//! Last control messages of the cryostat system
+/*! These are only written by the message loop and read back by the control
+    monitor messages. They are kept on their own cache lines, away from the
+    monitor values updated by the cryostat async thread. */
+typedef struct CACHE_ALIGNED {
+    LAST_CONTROL_MESSAGE cryostatTempCommand[CRYOSTAT_TEMP_SENSORS_NUMBER];  //!< Temperature sensors
+    LAST_CONTROL_MESSAGE backingPumpEnable;                                  //!< Backing pump state
+    LAST_CONTROL_MESSAGE turboPumpEnable;                                    //!< Turbo pump state
+    LAST_CONTROL_MESSAGE gateValveState;                                     //!< Gate valve state
+    LAST_CONTROL_MESSAGE solenoidValveState;                                 //!< Solenoid valve state
+    LAST_CONTROL_MESSAGE vacuumControllerEnable;                             //!< Vacuum controller state
+    LAST_CONTROL_MESSAGE coldHeadHours;                                      //!< Cold head hours reset
+} CRYOSTAT_LAST_CONTROL;
+
 //! Current state of the cryostat system
 /*! This structure represent the current state of the cryostat system. */
 typedef struct {
@@ -159,9 +173,6 @@ typedef struct {
     //! Cold head hours need to be written to NV memory?
     unsigned char coldHeadHoursDirty;
 
-    //! Last cold head reset message
-    LAST_CONTROL_MESSAGE lastColdHeadHours;
-
     //! Configuration File
     /*! This contains the configuration file name as extracted from the
         frontend configuration file. */
@@ -169,6 +180,10 @@ typedef struct {
 
     //! Cold head hours File
     char coldHeadHoursFile[MAX_FILE_NAME_SIZE];
+
+    //! Last control messages
+    /*! Please see \ref CRYOSTAT_LAST_CONTROL for more information. */
+    CRYOSTAT_LAST_CONTROL lastControl;
 } CRYOSTAT;
 
 /* Globals */
@@ -22,6 +22,7 @@
 /* Extra includes */
 #include "cryostatTemp.h"
 #include "globalDefinitions.h"
+#include "vacuumSensor.h"
 
 /* Defines */
 /* General */
@@ -125,6 +126,7 @@
 #define CRYO_ADC_VAC_PORT_PRESS_SCALE \
     1.286  // Scale factor for the vacuum port pressure (includes the vactor 10 scaling for the voltage itself)
 #define CRYO_ADC_MAX_RETRIES 10  // Maximum number of retries on ADC_READY before trowing an error
+#define CRYO_PRESS_EXP10_MAX_ERR 1e-7  // Bound on the relative error of the fast pressure conversion
 
 //! CRYO AREG bitfield (11-bit+5 -> 16-bit).
 /*! The AREG defines which monitor point is currently selected.
@@ -367,6 +369,17 @@ int getVacuumSensor(int currentAsyncVacuumControllerModule);  //!< This function
 int setVacuumControllerEnable(unsigned char state);           //!< This function enables/disables the vacuumn controller
 int getVacuumControllerState(void);                   //!< This function monitors the state of the vacuum controller
 int getCryostatTemp(int currentAsyncCryoTempModule);  //!< This function monitors the cryostat temperature
+int cryostatSweepUpdate(void);                        //!< Convert and store the sensors read during the sweep
+void cryostatTempCompile(int sensor);                 //!< Compile the TVO sensor evaluator from its coefficients
+float cryostatTempConversion(int sensor, float vin);  //!< Convert a cryostat sensor voltage to temperature
+int cryostatTempsConversion(const float vin[CRYOSTAT_TEMP_SENSORS_NUMBER],
+                            float temperature[CRYOSTAT_TEMP_SENSORS_NUMBER]);  //!< Convert all the cryostat sensors
+float cryostatPressureConversion(int sensor, float vin);  //!< Convert a vacuum sensor voltage to pressure
+int cryostatPressuresConversion(const float vin[VACUUM_SENSORS_NUMBER],
+                                float pressure[VACUUM_SENSORS_NUMBER]);  //!< Convert all the vacuum sensors
+int cryostatSweepConversion(const float tempVin[CRYOSTAT_TEMP_SENSORS_NUMBER],
+                            const float pressVin[VACUUM_SENSORS_NUMBER], float temperature[CRYOSTAT_TEMP_SENSORS_NUMBER],
+                            float pressure[VACUUM_SENSORS_NUMBER]);  //!< Convert all the temperature and vacuum sensors
 int getCryoHardwRevision(void);  //!< This function returns the cryostat M&C board hardware revision level
 
 #endif /* _CRYOSTATSERIALINTERFACE_H */
@@ -54,7 +54,8 @@
 #define TVO_COEFF_6 6              // Coefficient index for x^6
 #define TVO_RESISTOR_SCALE 1000.0  // Scaling coefficient for resistor readout
 /* PRT sensors */
-#define PRT_GAIN 124.71872  // PRT sensor gain
+#define PRT_GAIN 124.71872   // PRT sensor gain
+#define PRT_COEFFS_NUMBER 7  // Coefficients of each PRT standard curve
 /* PRT sensor interpolation curve. There are 2 curves, the first
    (PRT_A_SCALE) works for values smaller than 124 ohm (~60K), the other
    (PRT_B_SCALE) works for values greater than 124 ohm. */
@@ -96,9 +97,6 @@ typedef struct {
 
     //! Last or next TVO coefficient order to monitor:
     unsigned char nextCoeff;
-
-    //! Last control message: value
-    LAST_CONTROL_MESSAGE lastCommand;
 } CRYOSTAT_TEMP;
 
 /* Globals */
@@ -49,6 +49,7 @@
 // #define DEBUG_CRYOSTAT_ASYNC        // Turn on cryotat async debugging
 // #define DEBUG_FETIM_ASYNC           // Turn on the FETIM async debugging
 // #define DEBUG_GO_STANDBY2           // Turn on debugging the STANDBY2 transition
+// #define DEBUG_LNA_PRESET            // Turn on debugging the LNA bias preset loaded by command
 
 #else            /* If we are NOT developing: for release build */
 #define CONSOLE  // Turn on the console interface
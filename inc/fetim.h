@@ -32,7 +32,28 @@
                                        2 -> dewar */
 #define FETIM_MODULES_MASK_SHIFT 6  // Bits right shift for the submodule mask
 
+/* Async sampling schedule */
+#define FETIM_INTERLOCK_PERIOD 10    //!< Period of the interlock digital lines sampling (ms)
+#define FETIM_FE_STATUS_PERIOD 100   //!< Period of the FE safe status update (ms)
+#define FETIM_HE2_PRESS_PERIOD 1000  //!< Period of the He2 buffer tank pressure readout (ms)
+#define FETIM_EXT_TEMP_PERIOD 1000   //!< Period of the external temperatures sweep (ms)
+
+/* Interlock event log */
+#define FETIM_EVENTS_NUMBER 64       //!< Number of interlock events kept for readout
+#define FETIM_EVENT_LINES 12         //!< Number of sampled digital lines (BREG_IN bits)
+#define FETIM_EVENT_LINES_MASK 0x0FFF
+#define FETIM_EVENT_SEQUENCE_MASK 0x7F  //!< Bits of the last seen sequence number encoded in the event RCA
+#define FETIM_EVENT_OVERRUN 0x80        //!< Flag in the level byte: the events after the last seen one were lost
+
 /* Typedefs */
+//! Last control messages of the FETIM system
+/*! These are only written by the message loop and read back by the control
+    monitor messages. They are kept on their own cache line, away from the
+    interlock monitor values updated by the FETIM async thread. */
+typedef struct CACHE_ALIGNED {
+    LAST_CONTROL_MESSAGE dewarN2Fill;  //!< Dewar N2 fill state
+} FETIM_LAST_CONTROL;
+
 //! Current state of the FETIM system
 /*! This structure represent the curren tstate of the FETIM system */
 typedef struct {
@@ -56,8 +77,32 @@ typedef struct {
     //! FETIM dewar module
     /*! Please see \ref DEWAR for more information. */
     DEWAR dewar;
+
+    //! Last control messages
+    /*! Please see \ref FETIM_LAST_CONTROL for more information. */
+    FETIM_LAST_CONTROL lastControl;
 } FETIM;
 
+//! FETIM interlock event
+/*! This structure records a change of one of the FETIM digital lines, as
+    seen by the interlock sampler. */
+typedef struct {
+    //! Event sequence number
+    /*! Incremented for every event. The event with sequence number \p s is
+        kept in the slot \p s modulo \ref FETIM_EVENTS_NUMBER of the log until
+        it is overwritten. */
+    unsigned short sequence;
+    //! Digital line that changed
+    /*! This is the BREG_IN bit number, which matches \ref FETIM_DIG_FLOW_OOR
+        through \ref FETIM_DIG_HE2_PRESS_OOR. Lines 10 and 11 are the out of
+        range lines of external temperatures 1 and 2. */
+    unsigned char line;
+    //! New level of the line
+    unsigned char level;
+    //! Time of the sample that saw the change, in ms from the first sample
+    unsigned long time;
+} FETIM_EVENT;
+
 /* Globals */
 extern int asyncFetimExtTempError[FETIM_EXT_SENSORS_NUMBER];  //!< A global to keep track of the async error while
                                                               //!< monitoring FETIM external temperatures
@@ -66,5 +111,6 @@ extern int asyncFetimHePressError;  //!< A global to keep track of the async err
 void fetimHandler(int currentModule);  //!< This function deals with the incoming CAN messages
 int fetimStartup(void);                //!< This function initializes the FETIM subsystem
 int fetimAsync(void);                  //!< This function deals with the asynchronous operation of the FETIM
+int fetimReadEvent(unsigned char last, unsigned char *data);  //!< Return the interlock event after the last seen one
 
 #endif /* _FETIM_H */
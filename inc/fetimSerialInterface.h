@@ -29,6 +29,9 @@
 #define FETIM_BREG_IN 1
 #define FETIM_CREG_IN 2
 
+#define FETIM_MUX_SETTLE_TIME 1000  // Settling time after selecting an analog monitor point (ns)
+#define FETIM_SPIN_LIMIT 50000      // Waits shorter than this are spun rather than slept (ns)
+
 #define FETIM_DIG_FLOW_OOR 0x00
 #define FETIM_DIG_TEMP_OOR 0x01
 #define FETIM_DIG_GLITCH_CNT 0x02
@@ -121,6 +124,7 @@
 #define FETIM_BREG_IN_SIZE 12
 #define FETIM_BREG_IN_SHIFT_SIZE NO_SHIFT
 #define FETIM_BREG_IN_SHIFT_DIR NO_SHIFT
+#define FETIM_BREG_IN_SIMULATED 0x0000  // BREG_IN read in SIMULATION_MODE: every line OK
 
 /* --- CREG_IN definitions (5-bit) --- */
 /* Read only: 5-bit.
@@ -463,6 +467,7 @@ int getInterlockTemp(
 int getInterlockFlow(int currentInterlockFlowModule);  //!< This function monitors the interlock airflow sensors.
 int getFetimDigital(unsigned char port,
                     int currentCompressorModule);  //!< This function monitors the digital values of the FETIM.
+int getFetimDigitals(int *digitals);               //!< This function monitors all the digital values of the FETIM.
 int getIntrlkGlitchValue(void);                    //!< This function monitor the interlock glitch analog value
 int getFetimExtTemp(
     int currentAsyncFetimExtTempModule);    //!< This function monitors the FETIM external temperature sensors.
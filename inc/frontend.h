@@ -59,8 +59,42 @@
 #define MAINTENANCE_MODE 2
 #define SIMULATION_MODE 3
 
+/* Snapshot defines */
+#define FRONTEND_SNAPSHOT_MAGIC 0x46455353UL  // Snapshot signature ("FESS")
+#define FRONTEND_SNAPSHOT_VERSION 5           // Snapshot format version
+#define FRONTEND_SNAPSHOT_HEADER_SIZE 15      // Bytes in the snapshot header
+#define FRONTEND_SNAPSHOT_RECORD_SIZE 4       // Bytes in the header of each record
+#define FRONTEND_SNAPSHOT_RECORD_MAX 0xFF     // Max bytes of values in a record
+#define FRONTEND_SNAPSHOT_CHUNK_DATA 7        // Snapshot bytes returned in each chunk
+#define FRONTEND_SNAPSHOT_SIZE 17920          // Bytes available for the snapshot
+
+/* Snapshot record types */
+#define FRONTEND_SNAPSHOT_U8 0x01    //!< Unsigned 8 bits values
+#define FRONTEND_SNAPSHOT_S32 0x02   //!< Signed 32 bits values
+#define FRONTEND_SNAPSHOT_U32 0x03   //!< Unsigned 32 bits values
+#define FRONTEND_SNAPSHOT_F32 0x04   //!< IEEE 754 single precision values
+#define FRONTEND_SNAPSHOT_LAST 0x05  //!< Last control messages: status, size and size payload bytes
+
+/* Snapshot record sections: the section is the high byte of the field id */
+#define FRONTEND_SNAPSHOT_FRONTEND 0x00            //!< Mode and IP address
+#define FRONTEND_SNAPSHOT_CARTRIDGE 0x10           //!< Cartridge, plus the cartridge number
+#define FRONTEND_SNAPSHOT_POWER_DISTRIBUTION 0x20  //!< Power distribution
+#define FRONTEND_SNAPSHOT_IF_SWITCH 0x21           //!< IF switch
+#define FRONTEND_SNAPSHOT_CRYOSTAT 0x22            //!< Cryostat
+#define FRONTEND_SNAPSHOT_LPR 0x23                 //!< LPR
+#define FRONTEND_SNAPSHOT_FETIM 0x24               //!< FETIM
+#define FRONTEND_SNAPSHOT_LAST_CONTROL 0x80        //!< First field id of the last control messages of a section
+
 /* Typedefs */
 //! Current state of the frontend
+/*! The subsystems are updated by different threads: the cartridges and the
+    power distribution by the cartridge async thread, the cryostat by the
+    cryostat async thread, the FETIM by the FETIM async thread and the mode
+    and the last control messages by the message loop. Each subsystem starts
+    on its own cache line so that the threads do not share cache lines. The
+    last control messages of each subsystem are grouped in a trailing block on
+    their own cache lines, away from the monitor values. See
+    \ref frontendLayoutReport. */
 typedef struct {
     //! Frontend current state
     /*! The receiver can be in one of the following modes:
@@ -102,19 +136,19 @@ typedef struct {
     CARTRIDGE cartridge[CARTRIDGES_NUMBER];
     //! Power distibution system current state
     /*! Please see \ref POWER_DISTRIBUTION for more information. */
-    POWER_DISTRIBUTION powerDistribution;
+    POWER_DISTRIBUTION powerDistribution CACHE_ALIGNED;
     //! IF switch current state
     /*! Please see \ref IF_SWITCH for more information. */
-    IF_SWITCH ifSwitch;
+    IF_SWITCH ifSwitch CACHE_ALIGNED;
     //! Cryostat system current state
     /*! Please see \ref CRYOSTAT for more information. */
-    CRYOSTAT cryostat;
+    CRYOSTAT cryostat CACHE_ALIGNED;
     //! LPR current state
     /*! Please see \ref LPR for more information. */
-    LPR lpr;
+    LPR lpr CACHE_ALIGNED;
     //! FETIM current state
     /*! Please see \ref FETIM for more information. */
-    FETIM fetim;
+    FETIM fetim CACHE_ALIGNED;
 } FRONTEND;
 
 /* Globals */
@@ -127,5 +161,8 @@ int frontendInitIPAddress(void);               //!< Initialize the ipaddress fro
 int frontendWriteNVMemory(void);               //!< Implement SET_WRITE_NV_MEMORY
 int feAndCartridgesConfigurationReport(void);  //!< Print FE and cartridges configuration report
 int loPaLimitsTablesReport(void);              //!< Print LO PA_LIMITS tables report
+int frontendLayoutReport(void);                //!< Print FRONTEND memory layout report
+int frontendSnapshotCapture(unsigned char *data);  //!< Capture a binary snapshot of the frontend state
+int frontendSnapshotRead(unsigned int chunk, unsigned char *data);  //!< Return a chunk of the frontend snapshot
 
 #endif  // _FRONTEND_H
@@ -38,9 +38,7 @@
                                 - \ref GATE_VALVE_OVER_CURR -> Valve is
                                   stuck due to an overcurrent
                                 - \ref GATE_VALVE_ERROR -> Valve is in error
-                                  state
-    \param      lastState   This contains a copy of the last issued control
-                            message to the state of the gate valve. */
+                                  state */
 typedef struct {
     //! Gate valve state
     /*! This is the gate valve state as monitored through two limit switch.
@@ -51,10 +49,6 @@ typedef struct {
             - \ref GATE_VALVE_OVER_CURR -> Valve is stuck due to an overcurrent
             - \ref GATE_VALVE_ERROR -> Valve is in error state. */
     unsigned char state;
-    //! Last control message: gate valve state
-    /*! This is the content of the last control message sent to the gate
-        valve state. */
-    LAST_CONTROL_MESSAGE lastState;
 } GATE_VALVE;
 
 /* Prototypes */
@@ -22,6 +22,10 @@
 #define MAX_STRING_SIZE 40     //! Max lenght of string
 #define MAX_FILE_NAME_SIZE 13  //! Max size of DOS8.3 file names
 
+/* Memory layout definitions */
+#define CACHE_LINE_SIZE 64                                        //!< Size of a CPU cache line in bytes
+#define CACHE_ALIGNED __attribute__((aligned(CACHE_LINE_SIZE)))  //!< Start the type or field on its own cache line
+
 /* General definitions */
 #define TRUE 1   //!< Global definition for true
 #define FALSE 0  //!< Global definition for false
@@ -56,9 +56,7 @@
     \ingroup    ifSwitch
     \param      ifTempServo     a IF_TEMP_SERVO
     \param      attenuation     an unsigned char
-    \param      assemblyTemp    a float
-    \param      lastAttenuation This contains a copy of the last issued
-                                control message for the attenuation. */
+    \param      assemblyTemp    a float */
 typedef struct {
     //! Temperature servo current state
     /*! Please see \ref IF_TEMP_SERVO for more information. */
@@ -69,10 +67,6 @@ typedef struct {
     //! Assembly temperature
     /*! This is the current temperature for the specified IF channel. */
     float assemblyTemp;
-    //! Last control message: attenuation
-    /*! This is the content of the last control message sent to the IF
-        channel attenuation. */
-    LAST_CONTROL_MESSAGE lastAttenuation;
 } IF_CHANNEL;
 
 /* Globals */
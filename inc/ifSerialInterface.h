@@ -17,6 +17,9 @@
 #ifndef _IFSERIALINTERFACE_H
 #define _IFSERIALINTERFACE_H
 
+/* Extra includes */
+#include "ifSwitch.h"
+
 /* Defines */
 /* General */
 #define IF_AREG 0
@@ -259,9 +262,12 @@ int getIfAnalogMonitor(void);  // Perform core analog monitor functions
 int setIfTempServoEnable(
     unsigned char enable,
     int currentIfSwitchModule);                   //!< This function enables/disables the IF switch temperature servo
+void ifChannelTempInit(void);                     //!< Build the IF channel temperature table
 int getIfChannelTemp(int currentIfSwitchModule);  //!< This function monitors the IF channel temperature
+int ifChannelTempsConversion(const unsigned int adcData[IF_CHANNELS_NUMBER]);
+//!< Convert the temperature readings of all the IF channels
 int setIfChannelAttenuation(int currentIfSwitchModule);  //!< This function controls the IF channel attenuation
-int setIfSwitchBandSelect(void);                         //!< This function controls the IF switch band selection
+int setIfSwitchBandSelect(unsigned char band);           //!< This function controls the IF switch band selection
 int getIfSwitchHardwRevision(void);  //!< This function returns the IF switch M&C board hardware revision level
 
 #endif /* _IFSERIALINTERFACE_H */
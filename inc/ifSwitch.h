@@ -54,6 +54,17 @@
 #define IF_SWITCH_MODULES_MASK_SHIFT 2  // Bits right shift for the submodules mask
 
 /* Typedefs */
+//! Last control messages of the IF switch system
+/*! These are only written by the message loop and read back by the control
+    monitor messages. They are kept on their own cache lines, away from the
+    IF channel monitor values. */
+typedef struct CACHE_ALIGNED {
+    LAST_CONTROL_MESSAGE bandSelect;                                                    //!< Band select
+    LAST_CONTROL_MESSAGE allChannelsAtten;                                              //!< All channels attenuation
+    LAST_CONTROL_MESSAGE ifChannelAttenuation[POLARIZATIONS_NUMBER][SIDEBANDS_NUMBER];  //!< IF channel attenuation
+    LAST_CONTROL_MESSAGE ifTempServoEnable[POLARIZATIONS_NUMBER][SIDEBANDS_NUMBER];     //!< IF temperature servo state
+} IF_SWITCH_LAST_CONTROL;
+
 //! Current state of the IF switch system
 typedef struct {
     //! Current state of the the IF switch
@@ -75,11 +86,9 @@ typedef struct {
     //! Selected cartridge
     /*! This is the currently cartridge selected by the IF switch. */
     unsigned char bandSelect;
-    //! Last control message: band select
-    /*! This is the content of the last control message sent to the band
-        select. */
-    LAST_CONTROL_MESSAGE lastBandSelect;
-    LAST_CONTROL_MESSAGE lastAllChannelsAtten;
+    //! Last control messages
+    /*! Please see \ref IF_SWITCH_LAST_CONTROL for more information. */
+    IF_SWITCH_LAST_CONTROL lastControl;
 } IF_SWITCH;
 
 /* Globals */
@@ -36,9 +36,7 @@
                             but just a register holding the last issued
                             control:
                                 - 0 -> OFF
-                                - 1 -> ON
-    \param      lastEnable  This contains a copy of the last issued control
-                            message for the enable. */
+                                - 1 -> ON */
 typedef struct {
     //! IF temperature servo state
     /*! This is the state of the IF temperature servo:
@@ -48,10 +46,6 @@ typedef struct {
                     value is the one stored by the software after a control
                     command has ben issued. */
     unsigned char enable;
-    //! Last control message: IF temperature servo enable
-    /*! This is the content of the last control message sent to the LNA led
-        state. */
-    LAST_CONTROL_MESSAGE lastEnable;
 } IF_TEMP_SERVO;
 
 /* Prototypes */
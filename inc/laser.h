@@ -48,9 +48,6 @@
                                         value for the pump temperature.
     \param      driveCurrent        This contains the last read-back
                                         value for the drive current.
-    \param      lastDriveCurrent        This contains a copy of the last
-                                        issued control message to the
-                                        drive current.
     \param      photoDetectCurrent  This contains the last read-back
                                         value for the photo detector
                                         current. */
@@ -62,10 +59,6 @@ typedef struct {
     /*! This is the current value for the drive current of the EDFA pump
         laser. */
     float driveCurrent;
-    //! Last control message: drive current
-    /*! This is the content of the last control message sent ot the drive
-        current. */
-    LAST_CONTROL_MESSAGE lastDriveCurrent;
     //! Photo detector current
     /*! This is the current value for the photo detector current. */
     float photoDetectCurrent;
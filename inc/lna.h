@@ -32,6 +32,23 @@
                                        6 -> enableHandler */
 #define LNA_MODULES_MASK_SHIFT 2  // Bits right shift for the submodules mask
 
+/* Bulk bias */
+#define LNA_BIAS_POL_BIT 0x80     //!< Polarization bit in the first byte of the stage request
+#define LNA_BIAS_SB_BIT 0x40      //!< Sideband bit in the first byte of the stage request
+#define LNA_BIAS_STAGE_MASK 0x03  //!< Stage in the first byte of the stage request
+#define LNA_BIAS_V_SCALE 1e-4     //!< V per count of the staged drain voltage
+#define LNA_BIAS_I_SCALE 1e-3     //!< mA per count of the staged drain current
+#define LNA_BIAS_MAX_V 5.0        //!< DAC1 full scale drain voltage (V)
+#define LNA_BIAS_MAX_I 50.0       //!< DAC1 full scale drain current (mA)
+#define LNA_BIAS_APPLY_STAGED 0   //!< Apply the set points staged by SET_LNA_BIAS_STAGE
+#define LNA_BIAS_APPLY_PRESET 1   //!< Load the set points from the cartridge configuration file and apply them
+
+/* Configuration data info */
+#define LNA_PRESET_SECTION "P%d_S%d_LNA_S%d"  // Section containing the LNA stage preset
+#define LNA_PRESET_VD_KEY "VD"                // Key containing the preset drain voltage (V)
+#define LNA_PRESET_ID_KEY "ID"                // Key containing the preset drain current (mA)
+#define LNA_PRESET_EXPECTED 1                 // Expected keys containing each preset value
+
 /* Typedefs */
 //! Current state of the LNA
 typedef struct {
@@ -52,19 +69,28 @@ typedef struct {
                     value is the one stored by the software after a control
                     command has been issued.*/
     unsigned char enable;
-    //! Last control message: LNA state
-    /*! This is the content of the last control message sent to the LNA
-        state. */
-    LAST_CONTROL_MESSAGE lastEnable;
 } LNA;
 
+//! LNA stage bias set point
+/*! This is a drain set point staged for the bulk LNA bias. */
+typedef struct {
+    //! Drain voltage (in V)
+    float drainVoltage;
+    //! Drain current (in mA)
+    float drainCurrent;
+    //! TRUE if the set point has been staged
+    unsigned char valid;
+} LNA_BIAS_SETPOINT;
+
 /* Prototypes */
 void lnaEnableHandler(int currentModule, int currentBiasModule, int currentPolarizationModule, int currentLnaModule);
 void lnaHandler(int currentModule, int currentBiasModule,
                 int currentPolarizationModule);  //!< This function deals with the incoming can message
 void RESERVEDLNAHandler(int currentModule, int currentBiasModule, int currentPolarizationModule,
                         int currentLnaModule);  //!< Handler for LNA stages 4,5,6 which don't exist
-void lnaGoStandby2();
-//!< set the specified LNA to STANDBY2 mode
+int lnaBiasStage(int currentModule, const unsigned char *data,
+                 unsigned char size);  //!< Stage the drain set points of an LNA stage
+int lnaBiasApply(int currentModule, const unsigned char *data,
+                 unsigned char size);  //!< Apply the staged LNA set points of a cartridge
 
 #endif /* _LNA_H */
@@ -36,17 +36,11 @@ typedef struct {
                     value is the one stored by the software after a control
                     command has been issued.*/
     unsigned char enable;
-    //! Last control message: LNA led state
-    /*! This is the content of the last control message sent to the LNA led
-        state. */
-    LAST_CONTROL_MESSAGE lastEnable;
 } LNA_LED;
 
 /* Prototypes */
 void lnaLedEnableHandler(int currentModule, int currentBiasModule, int currentPolarizationModule);
 void lnaLedHandler(int currentModule, int currentBiasModule,
                    int currentPolarizationModule);  //!< This function deals with the incoming can message
-void lnaLedGoStandby2(int currentModule, int currentBiasModule, int currentPolarizationModule);
-//!< set the specified LNA LED to STANDBY2 mode
 
 #endif /* _LNALED_H */
@@ -44,14 +44,6 @@ typedef struct {
     //! LNA stage gate voltage
     /*! This is the gate voltage (in V) of the LNA stage. */
     float gateVoltage;
-    //! Last control message: LNA stage drain voltage
-    /*! This is the content of the last control message sent to the LNA
-        stage drain voltage. */
-    LAST_CONTROL_MESSAGE lastDrainVoltage;
-    //! Last control message: LNA stage drain current
-    /*! This is the content of the last control message sent to the LNA
-        stage drain current. */
-    LAST_CONTROL_MESSAGE lastDrainCurrent;
 } LNA_STAGE;
 
 /* Prototypes */
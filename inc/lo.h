@@ -40,6 +40,12 @@
 #define LO_PA_LIMITS_ENTRIES_KEY "ENTRIES"      // Key containing number of PA limits entries
 #define LO_PA_LIMITS_EXPECTED 1                 // Expected keys containing PA limits
 #define LO_PA_LIMITS_MAX_ENTRIES 256            // Maximum number of entries allowed
+#define LO_PA_LIMITS_ALLOC_SIZE 8               // Entries allocated at first, doubled every time the table is full
+#define LO_PA_LIMITS_CACHE_EXT ".PAL"           // Extension of the binary PA limits table file
+#define LO_PA_LIMITS_CACHE_MAGIC 0x4C415046UL   // Binary PA limits table file signature ("FPAL")
+#define LO_PA_LIMITS_CACHE_VERSION 3            // Binary PA limits table file format version
+#define LO_PA_LIMITS_PACKED_ENTRY_SIZE 4        // Size of an entry in the bulk upload message
+#define LO_PA_LIMITS_LAST_ENTRY_BIT 0x80        // Flags the last entry of a bulk upload
 #define LO_PA_LIMITS_ENTRY_KEY \
     "ENTRY_%d"  // Key for individual PA limits entries
                 // Entries are formatted as <YTO count>,<PAVD0 limit>,<PAVD1 limit>
@@ -80,6 +86,13 @@ typedef struct {
     /* Maximum allowed setting of LO PA VD1 within
        the range. Values between 0.0 and 2.5. */
     float maxVD1;
+    //! slopeVD0
+    /* Change of maxVD0 per YTO step between this and the next endpoint.
+       Computed when the entry is added to the table. */
+    float slopeVD0;
+    //! slopeVD1
+    /* Change of maxVD1 per YTO step between this and the next endpoint. */
+    float slopeVD1;
 
 } MAX_SAFE_LO_PA_ENTRY;
 
@@ -129,11 +142,17 @@ typedef struct {
 
     //! Max safe LO PA entries table size
     //* Size of the max safe LO PA entries table */
-    unsigned char maxSafeLoPaTableSize;
+    unsigned int maxSafeLoPaTableSize;
 
     //! Number of entries currently allocated to the max safe LO PA entries table
     //* Number of entries allocated may be greater than maxSafeLoPaTableSize
-    unsigned char allocatedLoPaTableSize;
+    unsigned int allocatedLoPaTableSize;
+
+    //! Max safe LO PA entries table modified
+    /*! This is set when a bulk upload of the table through control messages
+        completes and cleared once the table is written to the binary PA
+        limits table file, or when the table is changed again. */
+    unsigned char maxSafeLoPaTableDirty;
 
     //! Max safe LO PA entries table
     /*! Table of max safe LO PA entries.  See definition above */
@@ -153,10 +172,15 @@ int loZeroYtoCoarseTuning(int currentModule);  //!< Helper function to set the Y
 int loResetPaLimitsTable(unsigned char band);  //!< Helper function to clear the PA limits table
 int loAddPaLimitsEntry(unsigned char band, unsigned char pol, unsigned int ytoTuning, float maxVD);
 //!< Helper function to add a PA limits table entry
+int loAddPaLimitsEntries(unsigned char band, unsigned char *data, unsigned char size);
+//!< Helper function to add the packed PA limits table entries of a bulk upload message
+int loSavePaLimitsTable(unsigned char band);  //!< Write the PA limits table to the binary PA limits table file
 int printPaLimitsTable(unsigned char band);
+int findMaxSafeLoPaEntry(unsigned int yto, int currentModule, MAX_SAFE_LO_PA_ENTRY *entry);
+//!< Find or interpolate the PA limits table entry for a YTO tuning word
 int limitSafePaDrainVoltage(unsigned char paModule, int currentModule);
 //!< Limit the CONV_FLOAT value about to be sent to the PA channel.
-int limitSafeYtoTuning(int currentModule);
+int limitSafeYtoTuning(unsigned int yto, int currentModule);
 //!< Prior to YTO tuning, send commands to reduce the LO PA drain voltages.
 
 #endif /* _LO_H */
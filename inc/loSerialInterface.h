@@ -460,7 +460,7 @@ typedef struct {
 
 /* Prototypes */
 int getLoAnalogMonitor(int currentModule);  // Perform core analog monitor functions
-int setYtoCoarseTune(int currentModule);    //!< This function set the YTO coarse tune
+int setYtoCoarseTune(unsigned int coarseTune, int currentModule);  //!< This function set the YTO coarse tune
 int setPhotomixerEnable(unsigned char enable,
                         int currentModule);                //!< This function enables/disables the photomixer
 int getPhotomixer(unsigned char port, int currentModule);  //!< This function monitors the photomixer bias
@@ -483,6 +483,6 @@ int getPa(unsigned char port, int currentModule);                   //!< This fu
                                                                     //!< devices within the PA
 int getPaChannel(int currentModule, int currentPaModule,
                  int currentPaChannelModule);  //!< This function monitors different devices within the PA channel
-int setPaChannel(int currentModule, int currentPaModule,
+int setPaChannel(float value, int currentModule, int currentPaModule,
                  int currentPaChannelModule);  //!< This function controls different devices within the PA channel
 #endif                                         /* _LOSERIALINTERFACE_H */
@@ -0,0 +1,93 @@
+/*! \file       lockProfile.h
+    \brief      Lock contention profiler header file
+
+    This file contains the wrappers used to take the serial ports locks
+    (\ref ssc_lock) and the one wire bus lock (\ref owb_lock) and the
+    definitions of the contention profiler. See \ref lockProfile.c for more
+    information. */
+
+#ifndef _LOCKPROFILE_H
+#define _LOCKPROFILE_H
+
+/* Extra includes */
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "globalDefinitions.h"
+#include "serialMux.h"
+
+/* Defines */
+#define LOCK_PROFILE_OWB NUMBER_OF_DEVICES          //!< Lock number of the one wire bus lock
+#define LOCK_PROFILE_LOCKS (NUMBER_OF_DEVICES + 1)  //!< Number of profiled locks: serial ports + one wire bus
+#define LOCK_PROFILE_BUCKETS 16  //!< Histogram buckets: <1us, then powers of 2 up to >=16ms
+
+/* Threads taking the locks */
+#define LOCK_THREAD_MESSAGES 0   //!< Message loop (socket)
+#define LOCK_THREAD_CRYOSTAT 1   //!< Cryostat async thread
+#define LOCK_THREAD_CARTRIDGE 2  //!< Cartridge async thread
+#define LOCK_THREAD_FETIM 3      //!< FETIM async thread
+#define LOCK_THREAD_OWB 4        //!< One wire bus background search
+#define LOCK_PROFILE_THREADS 5
+
+/* Typedefs */
+//! Contention statistics of a lock
+/*! The statistics of a lock are only updated while holding the lock itself:
+    no other synchronization is needed. Every lock has its own cache lines. */
+typedef struct CACHE_ALIGNED {
+    unsigned char held;                                //!< Acquired through the profiled path
+    _Atomic unsigned char owner;                       //!< Thread holding the lock
+    unsigned long long acquiredAt;                     //!< Time of the last acquisition (ns)
+    unsigned long acquisitions;                        //!< Number of acquisitions
+    unsigned long contended;                           //!< Acquisitions that had to wait
+    unsigned long long waitTotal;                      //!< Total time spent waiting (ns)
+    unsigned long long waitMax;                        //!< Longest wait (ns)
+    unsigned long long holdTotal;                      //!< Total time the lock was held (ns)
+    unsigned long long holdMax;                        //!< Longest hold (ns)
+    unsigned long waitHistogram[LOCK_PROFILE_BUCKETS];  //!< Wait times of the contended acquisitions
+    unsigned long holdHistogram[LOCK_PROFILE_BUCKETS];  //!< Hold times
+    unsigned long blockedBy[LOCK_PROFILE_THREADS];      //!< Contended acquisitions by thread holding the lock
+    unsigned long long waitBy[LOCK_PROFILE_THREADS];    //!< Time spent waiting by waiting thread (ns)
+} LOCK_PROFILE;
+
+/* Globals */
+/* Externs */
+extern atomic_int lockProfileEnabled;                    //!< Profiler enabled
+extern LOCK_PROFILE lockProfiles[LOCK_PROFILE_LOCKS];  //!< Statistics of the profiled locks
+
+/* Prototypes */
+void lockProfileAcquire(unsigned int lock);                         //!< Take a lock and update its statistics
+void lockProfileRelease(unsigned int lock);                         //!< Update the statistics of a lock and release it
+void lockProfileThread(unsigned char thread);                       //!< Declare the thread calling the function
+void lockProfileEnable(unsigned char enable);                       //!< Start (clean statistics) or stop the profiler
+int lockProfileReport(void);                                        //!< Print the lock contention report
+void lockProfileStatus(unsigned char *data);                        //!< Rank the locks by contention
+int lockProfileReadEntry(unsigned char rank, unsigned char *data);  //!< Return the lock with the rank in the ranking
+
+/* Inline functions */
+/* The mutex of a profiled lock */
+static inline pthread_mutex_t *lockProfileMutex(unsigned int lock) {
+    return lock == LOCK_PROFILE_OWB ? &owb_lock : &ssc_lock[lock];
+}
+
+/* Take a lock */
+/*! \param lock     port number for \ref ssc_lock, \ref LOCK_PROFILE_OWB for
+                    \ref owb_lock
+    When the profiler is disabled this is a plain pthread_mutex_lock. */
+static inline void lockMux(unsigned int lock) {
+    if (atomic_load_explicit(&lockProfileEnabled, memory_order_relaxed)) {
+        lockProfileAcquire(lock);
+    } else {
+        pthread_mutex_lock(lockProfileMutex(lock));
+    }
+}
+
+/* Release a lock taken with \ref lockMux */
+static inline void unlockMux(unsigned int lock) {
+    if (lockProfiles[lock].held) {
+        lockProfileRelease(lock);
+    } else {
+        pthread_mutex_unlock(lockProfileMutex(lock));
+    }
+}
+
+#endif /* _LOCKPROFILE_H */
@@ -39,6 +39,21 @@
 #define LPR_MODULES_MASK_SHIFT 4  // Bits right shift for the submodule mask
 
 /* Typedefs */
+//! Last control messages of the LPR system
+/*! These are only written by the message loop and read back by the control
+    monitor messages. They are kept on their own cache lines, away from the
+    optical switch and EDFA monitor values. The modulation input DAC strobe is
+    triggered by the reception of the message: its last control message only
+    keeps the monitor requests from timing out. */
+typedef struct CACHE_ALIGNED {
+    LAST_CONTROL_MESSAGE opticalSwitchPort;          //!< Optical switch port
+    LAST_CONTROL_MESSAGE opticalSwitchShutter;       //!< Optical switch shutter
+    LAST_CONTROL_MESSAGE opticalSwitchForceShutter;  //!< Optical switch force shutter
+    LAST_CONTROL_MESSAGE modulationInputValue;       //!< EDFA modulation input value
+    LAST_CONTROL_MESSAGE miDacResetStrobe;           //!< EDFA modulation input DAC reset strobe
+    LAST_CONTROL_MESSAGE photoDetectorCoeff;         //!< EDFA photodetector conversion coefficient
+} LPR_LAST_CONTROL;
+
 //! Current state of the LPR system
 /*! This structure represent the current state of the LPR system */
 typedef struct {
@@ -66,11 +81,15 @@ typedef struct {
         frontend configuration file. */
     char configFile[MAX_FILE_NAME_SIZE];
 
+    //! Last control messages
+    /*! Please see \ref LPR_LAST_CONTROL for more information. */
+    LPR_LAST_CONTROL lastControl;
 } LPR;
 
 /* Prototypes */
 void lprHandler(int currentModule);  //!< This function deals with the incoming CAN messages
 int lprStartup(void);                //!< This function initializes the LPR
 int lprStop(void);                   //!< This function shuts down the LPR
+void lprAsync(void);                 //!< This function deals with the asynchronous operation of the LPR
 
 #endif /* _LPR_H */
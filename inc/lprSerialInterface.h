@@ -317,7 +317,7 @@ typedef struct {
 /* Prototypes */
 int getLprAnalogMonitor(void);                    // Perform core analog monitor functions
 int getLprTemp(int currentLprModule);             //!< This function monitors the LPR temperature sensors
-int setOpticalSwitchPort(void);                   //!< This function controls the port selection for the optical switch
+int setOpticalSwitchPort(unsigned char port);     //!< This function controls the port selection for the optical switch
 int setOpticalSwitchShutter(unsigned char mode);  //!< This function enables the LPR optical switch shutter
 int getLprStates(void);                           //!< This function monitors the states of several LPR hardware
 int getLaserPumpTemperature(void);                //!< This function monitors the temperature of the laser pump
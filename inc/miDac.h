@@ -26,23 +26,6 @@
 /* Submodules definitions */
 #define MI_DAC_MODULES_NUMBER 1  // It's just the resetStrobe
 
-/* Typedefs */
-//! Current state of the modulation input DAC
-/*! This structure represent the current state of the modulation input DAC.
-    Since these are only debug control messages and the strobes are triggered
-    by the reception of the message independently from the payload, this
-    structure is necessary exclusively to prevent monitor messages on these
-    control addresses from timing out. The returned payload has no meaning.
-    \ingroup    polSpecialMsgs
-    \param      lastResetStrobe     This contains a copy of the last issued
-                                    control message to the reset strobe. */
-typedef struct {
-    //! Last control message: DAC reset strobe
-    /*! This is the content of the last control message sent to the dac
-        reset strobe. */
-    LAST_CONTROL_MESSAGE lastResetStrobe;
-} MI_DAC;
-
 /* Prototypes */
 void miDacResetStrobeHandler(void);
 void miDacHandler(void);  //!< This function deals with the incoming can message
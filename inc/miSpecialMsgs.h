@@ -26,21 +26,6 @@
 /* Submodules definitions */
 #define MI_SPECIAL_MSGS_MODULES_NUMBER 1  // Only one DAC
 
-/* Typedefs */
-//! Current state of the modulation input special messages
-/*! This structure represent the current state of the modulation input
-    special messages.
-    \ingroup    modulationInput
-    \param      This contains the information about the DAC available for
-                this module. There can be up to \ref MI_DAC_NUMBER for
-                each special messages module. */
-typedef struct {
-    //! Polarization dac current state
-    /*! Please see the definition of the \ref MI_DAC structure for more
-        information.*/
-    MI_DAC miDac;
-} MI_SPECIAL_MSGS;
-
 /* Prototypes */
 void miSpecialMsgsHandler(void);  //!< This function deals with the incoming can message
 
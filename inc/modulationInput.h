@@ -40,9 +40,7 @@
                             modulation input. It has to be remembered that
                             this is \em not a read-back from the hardware
                             but just a register holding the last issued
-                            control value.
-    \param      lastValue   This contains a copy of the last issued control
-                            message to the modulation input value. */
+                            control value. */
 typedef struct {
     //! Modulation input value
     /*! This is the current value of the modulation input.
@@ -50,13 +48,6 @@ typedef struct {
                     value is the one stored by the software after a control
                     command has been issued. */
     float value;
-    //! Last control message: value
-    /*! This is the content of the last control message sent to the value
-        of the modulation input. */
-    LAST_CONTROL_MESSAGE lastValue;
-    //! Modulation Input special messages current state
-    /*! Please see \ref MI_SPECIAL_MSGS for more information. */
-    MI_SPECIAL_MSGS miSpecialMsgs;
 } MODULATION_INPUT;
 
 /* Prototypes */
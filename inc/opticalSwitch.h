@@ -33,6 +33,14 @@
                                                 4 -> busyHandler */
 #define OPTICAL_SWITCH_MODULES_MASK_SHIFT 1  // Bits right shift for the submodule mask
 
+/* Port moves */
+#define OPTICAL_SWITCH_MOVE_IDLE 0    //!< No port move was requested
+#define OPTICAL_SWITCH_MOVE_QUEUED 1  //!< The port move waits for the switch to be idle
+#define OPTICAL_SWITCH_MOVE_MOVING 2  //!< The port move was issued, waiting for completion
+#define OPTICAL_SWITCH_MOVE_DONE 3    //!< The switch settled on the requested port
+#define OPTICAL_SWITCH_MOVE_FAILED 4  //!< The port move failed, see the status byte
+#define OPTICAL_SWITCH_MOVE_SETTLE 10  //!< Min time (ms) after the strobe before an idle switch means done
+
 /* Typedefs */
 //! Current state of the optical switch
 /*! This structure represent the current state of the optical switch
@@ -42,8 +50,6 @@
                                 is \em not a read-back from the hardware but
                                 just a register holding the last issued
                                 control.
-    \param      lastPort        This contains a copy of the last issued
-                                control message to the port selection.
     \param      shutter     This contains the current state of the
                                 shutter.
                                 It has to be remembered that this is \em not
@@ -51,10 +57,6 @@
                                 register holding the last issued control:
                                     - \ref SHUTTER_ENABLE   -> Enable/ON
                                     - \ref SHUTTER_DISABLE  -> Disable/OFF
-    \param      lastShutter     This contains a copy of the last issed
-                                control message to the shutter.
-    \param      lastForceShutter    This contains a copy of the last issed
-                                    control message to the force shutter.
     \param      state       This contains the current error state for
                                 the optical switch:
                                     - \ref NO_ERROR -> No error
@@ -70,10 +72,6 @@ typedef struct {
                     value is the one stored by the software after a control
                     command has been issued. */
     unsigned char port;
-    //! Last control message: port
-    /*! This is the content of the last control message sent to the port
-        select of the optical switch. */
-    LAST_CONTROL_MESSAGE lastPort;
     //! Shutter
     /*! This is the current state of the shutter:
             - \ref SHUTTER_ENABLE   -> Enable/ON
@@ -82,14 +80,6 @@ typedef struct {
                     value is the one stored by the software after a control
                     command has been issued. */
     unsigned char shutter;
-    //! Last control message: shutter
-    /*! This is the content of the last control message sent to the shutter
-        of the optical switch. */
-    LAST_CONTROL_MESSAGE lastShutter;
-    //! Last control message: forceShutter
-    /*! This is the content of the last control message sent to the force
-        shutter of the optical switch. */
-    LAST_CONTROL_MESSAGE lastForceShutter;
     //! Optical switch error state
     /*! This is the error state of the optical switch:
             - \ref NO_ERROR -> no error
@@ -109,5 +99,10 @@ void forceShutterHandler(void);
 void stateHandler(void);
 void busyHandler(void);
 void opticalSwitchHandler(int currentLprModule);  //!< This function deals with the incoming CAN messages
+int opticalSwitchMoveStart(unsigned char port);   //!< Queue a port move for the optical switch
+void opticalSwitchMoveCancel(void);               //!< Drop the pending port move
+int opticalSwitchMoveState(unsigned char *port);  //!< Return the state of the last port move
+void opticalSwitchMoveStatus(unsigned char *data);  //!< Return the completion status of the last port move
+void opticalSwitchAsync(void);                      //!< Drive the queued port move
 
 #endif /* _OPTICALSWITCH_H */
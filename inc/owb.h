@@ -10,6 +10,8 @@
 #define _OWB_H
 
 /* Extra includes */
+#include <stdint.h> /* uint32_t */
+
 #include "globalDefinitions.h"
 
 /* Defines */
@@ -32,6 +34,16 @@
 
 #define SEARCH_BYTES_LENGTH 16  // Lenght in bytes of the search
 
+#define OWB_ESN_CACHE_FILE "ESNS.BIN"       // Binary file caching the ESNs found during the last search
+#define OWB_ESN_CACHE_TEMP_FILE "ESNS.TMP"  // Temporary file used while writing the ESN cache file
+#define OWB_ESN_CACHE_MAGIC 0x4E534546UL    // ESN cache file signature ("FESN")
+#define OWB_ESN_CACHE_VERSION 2             // ESN cache file format version
+
+/* Background search states */
+#define OWB_SCAN_PENDING 0  // Search of the bus in progress: serving the cached ESNs
+#define OWB_SCAN_DONE 1     // Search of the bus completed: serving the ESNs found
+#define OWB_SCAN_ERROR 2    // Search of the bus failed: serving the cached ESNs
+
 /* Dallas Maxim Chips Defines */
 
 /* Family codes */
@@ -70,10 +82,16 @@
 #define OWM_WRITE 0x01
 #define OWM_READ 0x02
 
-/* Globals */
-/* Externs */
-extern unsigned char esnDevicesFound;                               //!< Number of devices with ESN found on the bus
-extern unsigned char ESNS[MAX_DEVICES_NUMBER][SERIAL_NUMBER_SIZE];  // Array to store the ESNs of the found devices
+/* Typedefs */
+//! Header of the ESN cache file
+/*! The fields are stored big endian. The header is followed by \p devices ESNs
+    of \ref SERIAL_NUMBER_SIZE bytes. */
+typedef struct {
+    uint32_t magic;    //!< \ref OWB_ESN_CACHE_MAGIC
+    uint32_t version;  //!< \ref OWB_ESN_CACHE_VERSION
+    uint32_t devices;  //!< Number of ESNs in the file
+    uint32_t crc;      //!< CRC-32 of the ESNs
+} OWB_ESN_CACHE_HEADER;
 
 /* Prototypes */
 int owbReset(void);              // Send the reset signal on the one wire bus
@@ -83,5 +101,9 @@ int RecoverROM(int* ReceiveData, int* TransmitData,
 int writeOwb(int data);                  // Writes data to the one wire bus
 int owbInit(void);                       //!< Performs the initialization of the one wire bus
 int owbGetEsn(void);                     //!< Gather the available ESN from the OWB
+int owbLoadEsnCache(void);               //!< Load the ESNs found during the last search from the cache file
+int owbStartScan(void);                  //!< Gather the available ESN from the OWB in the background
+unsigned char owbEsnsFound(unsigned char* generation, unsigned char* state);  //!< Number of ESNs being served
+int owbEsnRead(unsigned char device, unsigned char* esn);                    //!< Copy one of the ESNs being served
 
 #endif /* _OWB_H */
\ No newline at end of file
@@ -49,10 +49,6 @@ typedef struct {
 
     //! Control byte value to use for collector voltage control when Teledyne PA is operating
     unsigned char teledyneCollectorByte[2];
-
-    //! Last control message: hasTeledynePA, teledyneCollectorByte:
-    LAST_CONTROL_MESSAGE lastHasTeledynePa;
-    LAST_CONTROL_MESSAGE lastTeledyneCollectorByte[2];
 } PA;
 
 /* Prototypes */
@@ -38,14 +38,6 @@ typedef struct {
     //! A channel Drain  Current
     /*! This is the PA channel drain current (in mA). */
     float drainCurrent;
-    //! Last control message: PA channel Gate Voltage
-    /*! This is the content of the last control message sent to the PA
-        channel gate voltage. */
-    LAST_CONTROL_MESSAGE lastGateVoltage;
-    //! Last control message: A channel Drain  Voltage
-    /*! This is the content of the last control message sent to the PA
-        channel drain voltage. */
-    LAST_CONTROL_MESSAGE lastDrainVoltage;
 } PA_CHANNEL;
 
 /* Prototypes */
@@ -34,6 +34,7 @@
 #define CAN_INT_SIZE 0x02                                             // Size of an int payload
 #define CAN_BYTE_SIZE 0x01                                            // Siza of a char payload
 #define CAN_BOOLEAN_SIZE 0x01                                         // Size of a enable/disable state payload
+#define CAN_ESNS_FOUND_SIZE 0x03                                      // Size of the ESNs found message
 #define CAN_LAST_CONTROL_MESSAGE_SIZE (CAN_MESSAGE_PAYLOAD_SIZE + 2)  // Size of the last control message
 /* Type substitution macros for CAN data import/export */
 #define CAN_MSG CANMessage
@@ -147,8 +148,8 @@
 #define GET_CONSOLE_ENABLE \
     0x20009L                     //!< \b BASE+0x09 -> Returns the current state of the console
                                  //!< (0->disabled 1->enabled)
-#define GET_ESNS_FOUND 0x2000AL  //!< \b BASE+0x0A -> Returns the number of ESNs found
-#define GET_ESNS 0x2000BL        //!< \b BASE+0x0B -> Returns the list of the found ESNs
+#define GET_ESNS_FOUND 0x2000AL  //!< \b BASE+0x0A -> Returns the number of ESNs found, list generation, search state
+#define GET_ESNS 0x2000BL        //!< \b BASE+0x0B -> Returns the next found ESN (superseded by GET_ESN)
 #define GET_ERRORS_NUMBER \
     0x2000CL                     //!< \b BASE+0x0C -> Returns the number unread errors in the error
                                  //!< buffer
@@ -160,6 +161,45 @@
 #define GET_LO_PA_LIMITS_TABLE_ESN \
     0x20010L  //!< \b BASE+0x10 through 0x19 return the PA LIMITS table ESN for
               //!< band 1-10
+#define GET_SIS_IV_SWEEP_STATUS \
+    0x20020L  //!< \b BASE+0x20 -> Returns the state of the SIS I-V sweep
+              //!< (see sisSweepStatus)
+#define GET_SIS_MAGNET_RAMP_STATUS \
+    0x20022L  //!< \b BASE+0x22 -> Returns the state of the last requested SIS
+              //!< magnet ramp (see sisMagnetRampStatus)
+#define GET_BAND_SELECT_STATUS \
+    0x20024L  //!< \b BASE+0x24 -> Returns the progress of the last band select
+              //!< (see bandSelectStatus)
+#define GET_LPR_SWITCH_MOVE_STATUS \
+    0x20025L  //!< \b BASE+0x25 -> Returns the completion status of the last
+              //!< optical switch port move (see opticalSwitchMoveStatus)
+#define GET_PLL_LOCK_SEARCH_STATUS \
+    0x20026L  //!< \b BASE+0x26 -> Returns the state of the PLL lock search
+              //!< (see pllLockSearchStatus)
+#define GET_FE_SNAPSHOT \
+    0x20028L  //!< \b BASE+0x28 -> Captures a binary snapshot of the frontend
+              //!< state (see frontendSnapshotCapture)
+#define GET_LOCK_PROFILE \
+    0x2002AL  //!< \b BASE+0x2A -> Ranks the locks by contention
+              //!< (see lockProfileStatus)
+#define GET_ESN \
+    0x20100L  //!< \b BASE+0x100 through 0x122 return the ESN with the given
+              //!< index in the list of the found ESNs (see owbEsnRead)
+#define GET_LOCK_PROFILE_ENTRY \
+    0x20140L  //!< \b BASE+0x140 through 0x14A return the lock with the given
+              //!< rank in the contention ranking (see lockProfileReadEntry)
+#define GET_FETIM_INTERLOCK_EVENT \
+    0x20180L  //!< \b BASE+0x180 through 0x1FF return the FETIM interlock event
+              //!< after the one with the given sequence low bits (see fetimReadEvent)
+#define GET_SIS_IV_SWEEP_POINT \
+    0x20200L  //!< \b BASE+0x200 through 0x3FF return the point of the SIS I-V
+              //!< sweep with the given index (see sisSweepReadPoint)
+#define GET_SIS_MAGNET_RAMP_SAMPLE \
+    0x20400L  //!< \b BASE+0x400 through 0x5FF return the sample of the SIS magnet
+              //!< ramp with the given index (see sisMagnetRampReadSample)
+#define GET_FE_SNAPSHOT_CHUNK \
+    0x20600L  //!< \b BASE+0x600 through 0xFFF return the chunk with the given
+              //!< index of the frontend snapshot (see frontendSnapshotRead)
 #define LAST_SPECIAL_MONITOR_RCA (BASE_SPECIAL_MONITOR_RCA + 0x00FFF)  // Last possible special monitor RCA
 /* Control */
 //! \b 0x21000 -> Base address for the special control RCAs
@@ -173,7 +213,7 @@
     0x21007L                          //!< \b BASE+0x07 -> Bytes to return from GET_PPCOMM_TIME.
                                       //!< Defaults to 8 0xFF.
 #define SET_CONSOLE_ENABLE 0x21009L   //!< \b BASE+0x09 -> Enables/Disables the console
-#define SET_WRITE_NV_MEMORY 0x2100DL  //!< \b BASE+0x0D -> Writes cold head hours to the flash disk
+#define SET_WRITE_NV_MEMORY 0x2100DL  //!< \b BASE+0x0D -> Writes cold head hours and PA limits tables to the flash disk
 #define SET_FE_MODE 0x2100EL          //!< \b BASE+0x0E -> Changes the current FE operating mode
 #define SET_READ_ESN \
     0x2100FL  //!< \b BASE+0x0F -> Forces the firmware to read again the ESN
@@ -184,6 +224,33 @@
 #define SET_LO_SET_PA_LIMITS_ENTRY \
     0x21030L  //!< \b BASE+0x30 through 0x39 upload a PA LIMITS table entry for
               //!< band 1-10
+#define SET_LO_SET_PA_LIMITS_ENTRIES \
+    0x21040L  //!< \b BASE+0x40 through 0x49 upload one or two packed PA LIMITS
+              //!< table entries for band 1-10 (see loAddPaLimitsEntries)
+#define SET_SIS_IV_SWEEP \
+    0x21050L  //!< \b BASE+0x50 through 0x59 start a SIS I-V sweep for band
+              //!< 1-10 (see sisSweepStart)
+#define SET_SIS_IV_SWEEP_ABORT 0x2105AL  //!< \b BASE+0x5A -> Aborts the running SIS I-V sweep
+#define SET_SIS_MAGNET_RAMP \
+    0x21060L  //!< \b BASE+0x60 through 0x69 start a SIS magnet current ramp for
+              //!< band 1-10 (see sisMagnetRampStart)
+#define SET_SIS_MAGNET_RAMP_ABORT 0x2106AL  //!< \b BASE+0x6A -> Aborts all the running SIS magnet ramps
+#define SET_LNA_BIAS_STAGE \
+    0x21070L  //!< \b BASE+0x70 through 0x79 stage an LNA stage drain set point
+              //!< for band 1-10 (see lnaBiasStage)
+#define SET_LNA_BIAS_APPLY \
+    0x21080L  //!< \b BASE+0x80 through 0x89 apply the staged or preset LNA
+              //!< set points for band 1-10 (see lnaBiasApply)
+#define SET_BAND_SELECT \
+    0x21090L  //!< \b BASE+0x90 through 0x99 power and switch in band 1-10
+              //!< (see bandSelectStart)
+#define SET_PLL_LOCK_SEARCH \
+    0x210A0L  //!< \b BASE+0xA0 through 0xA9 start a PLL lock search for band
+              //!< 1-10 (see pllLockSearchStart)
+#define SET_PLL_LOCK_SEARCH_ABORT 0x210AAL  //!< \b BASE+0xAA -> Aborts the running PLL lock search
+#define SET_LOCK_PROFILE \
+    0x210B0L  //!< \b BASE+0xB0 -> Starts (1) or stops (0) the lock contention
+              //!< profiler. Stopping it prints the report (see lockProfileEnable)
 #define LAST_SPECIAL_CONTROL_RCA (BASE_SPECIAL_CONTROL_RCA + 0x00FFF)  // Last possible special monitor RCA
 
 /* Typedefs */
@@ -31,6 +31,8 @@
 #define PLUS_24 4             //!< 4: +24
 #define PLUS_8 5              //!< 5: +8
 
+#define PD_CHANNELS_CACHE_AGE 5000  //!< Max age (ms) of the swept readings returned by the monitor RCAs
+
 /* Submodules definitions */
 #define PD_CHANNEL_MODULES_NUMBER 2  // See list below
 #define PD_CHANNEL_MODULES_RCA_MASK                  \
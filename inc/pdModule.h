@@ -58,11 +58,7 @@
                                     register holding the last issued
                                     control:
                                         - \ref PD_MODULE_DISABLE -> Disable/OFF
-                                        - \ref PD_MODULE_ENABLE -> Enable/ON
-    \param      lastEnable          This contains a copy of the last issued
-                                    control message to enable the state of
-                                    this module of the power distribution
-                                    system. */
+                                        - \ref PD_MODULE_ENABLE -> Enable/ON */
 typedef struct {
     //! Current state of the power distribution module channel
     /*! In every power distribution module there is one channel available
@@ -86,17 +82,16 @@ typedef struct {
                     value is the one stored by the software after a control
                     command has been issued. */
     unsigned char enable;
-    //! Last control message: pdModule state
-    /*! This is the content of the last control message sent to the power
-        distribution module state. */
-    LAST_CONTROL_MESSAGE lastEnable;
 } PD_MODULE;
 
 /* Prototypes */
 void printPoweredModuleCounts(void);
 void pdEnableHandler(int currentPowerDistributionModule, int currentPdModuleModule);
 int allowPowerOn(int module, int standby2);
+void pdModuleRelease(unsigned char standby2);  //!< Return the slot reserved by allowPowerOn
+void pdModuleHold(unsigned char standby2);     //!< Take a slot regardless of the limits
 int allowStandby2(int module);
+int pdModulePowerOn(int module, unsigned char standby2);  //!< Power on a cartridge that is currently off
 void pdModuleHandler(int currentPowerDistributionModule);  //!< This function deals wit the incoming CAN message
 
 #endif /* _PDMODULE_H */
@@ -244,4 +244,6 @@ int setPdModuleEnable(
     int currentPowerDistributionModule);  //!< This function enables/disables the selected power distribution module
 int getPdChannel(int currentPowerDistributionModule, int currentPdModuleModule,
                  int currentPdChannelModule);  //!< This function monitors the selected power distribution channel
+int getPdChannels(int currentPowerDistributionModule);  //!< This function monitors all the channels of a module
+int pdChannelsCached(int currentPowerDistributionModule);  //!< TRUE if the module channels readings are recent
 #endif                                         /* _PDSERIALINTERFACE_H */
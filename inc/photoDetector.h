@@ -45,12 +45,6 @@ typedef struct {
     /*! This is the coefficient necessary to calculate the power of the
         photodetector. */
     float coeff;
-
-    //! Last control message: conversion coefficient
-    /*! This is the content of the last control message sent to the LNA led
-        state. */
-    LAST_CONTROL_MESSAGE lastCoeff;
-
 } PHOTO_DETECTOR;
 
 /* Prototypes */
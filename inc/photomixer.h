@@ -45,9 +45,7 @@
     \param      voltage     This contains the most recent read-back value of
                             the mixer bias voltage.
     \param      current     This contains the most recent read-back value of
-                            the mixer bias current.
-    \param      lastEnable  This contains a copy of the last issued control
-                            message for the enable. */
+                            the mixer bias current. */
 typedef struct {
     //! LO photomixer state
     /*! This is the state of the LO photomixer:\n
@@ -63,10 +61,6 @@ typedef struct {
     //! LO photomixer current
     /*! This is the current (in mA) across the LO photomixer. */
     float current;
-    //! Last control message: LO photomixer state
-    /*! This is the content of the last control message sent to the LO
-        photomixer state. */
-    LAST_CONTROL_MESSAGE lastEnable;
 } PHOTOMIXER;
 
 /* Prototypes */
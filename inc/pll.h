@@ -37,6 +37,20 @@
                A -> sidebandLockPolaritySelect       \
                B -> nullLoopIntegrator */
 
+/* Lock search */
+#define PLL_LOCK_SEARCH_LOCK_V 3.0           //!< Lock detect voltage (V) above which the PLL is locked
+#define PLL_LOCK_SEARCH_TOLERANCE_SCALE 0.1  //!< V per count of the requested correction voltage tolerance
+#define PLL_LOCK_SEARCH_TOLERANCE_DFLT 0.5   //!< Correction voltage tolerance (V) if none is requested
+#define PLL_LOCK_SEARCH_SETTLE_DFLT 10       //!< Settle time (ms) after each YTO step if none is requested
+#define PLL_LOCK_SEARCH_MAX_REFINE 64        //!< Max YTO steps while centering the correction voltage
+#define PLL_LOCK_SEARCH_V_SCALE 10.0         //!< Counts per V of the voltages in the status message
+
+#define PLL_LOCK_SEARCH_IDLE 0     //!< No lock search was requested
+#define PLL_LOCK_SEARCH_RUNNING 1  //!< The lock search is in progress
+#define PLL_LOCK_SEARCH_LOCKED 2   //!< The PLL is locked, see the status byte for the centering
+#define PLL_LOCK_SEARCH_FAILED 3   //!< No lock was found or an error occurred, the YTO was restored
+#define PLL_LOCK_SEARCH_ABORTED 4  //!< The lock search was aborted
+
 /* Typedefs */
 //! Current state of the PLL
 typedef struct {
@@ -73,22 +87,6 @@ typedef struct {
     //! Null the loop integrator
     /*! This bit controls the operation of the PLL loop integrator. */
     char nullLoopIntegrator;
-    //! Last control message: clear unlock latched bit
-    /*! This is the content of the last control message sent to the PLL
-        clear unlock latched bit. */
-    LAST_CONTROL_MESSAGE lastClearUnlockDetectLatch;
-    //! Last control message: loop bandwidth select
-    /*! This is the content of the last control message sent to the PLL
-        select lock polarity register. */
-    LAST_CONTROL_MESSAGE lastLoopBandwidthSelect;
-    //! Last control message: sideband lock polarity select
-    /*! This is the content of the last control message sent to the PLL
-        sideband lock polarity select. */
-    LAST_CONTROL_MESSAGE lastSidebandLockPolaritySelect;
-    //! Last control message: null loop integrator
-    /*! This is the content of the last control message sent to the PLL
-        null loop integrator. */
-    LAST_CONTROL_MESSAGE lastNullLoopIntegrator;
 } PLL;
 
 /* Prototypes */
@@ -104,5 +102,11 @@ void loopBandwidthSelectHandler(int currentModule);
 void sidebandLockPolaritySelectHandler(int currentModule);
 void nullLoopIntegratorHandler(int currentModule);
 void pllHandler(int currentModule);  //!< This function deals with the incoming can message
+int pllLockSearchStart(int currentModule, const unsigned char *data,
+                       unsigned char size);  //!< Start a PLL lock search around a YTO coarse tune
+void pllLockSearchCancel(int currentModule);  //!< Stop the lock search before a direct YTO tuning
+void pllLockSearchAbort(void);                //!< Abort the running lock search
+void pllLockSearchStatus(unsigned char *data);  //!< Return the state of the lock search
+void pllLockSearchAsync(void);                  //!< Advance the lock search from the cartridge async thread
 
 #endif /* _PLL_H */
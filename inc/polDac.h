@@ -37,29 +37,6 @@
 
 #define POL_DAC_ALLOW_CLEAR_STROBE DAC1  // Only DAC1 allows a clear strobe
 
-/* Typedefs */
-//! Current state of the polarization DAC
-/*! This structure represent the current state of the polarization DAC.
-    Since these are only debug control messages and the strobes are triggered
-    by the reception of the message independently from the payload, this
-    structure is necessary exclusively to prevent monitor messages on these
-    control addresses from timing out. The returned payload has no meaning.
-    \ingroup    polSpecialMsgs
-    \param      lastResetStrobe     This contains a copy of the last issued
-                                    control message to the reset strobe.
-    \param      lastClearStrobe     This contains a copy of the last issued
-                                    control message to the clear strobe. */
-typedef struct {
-    //! Last control message: DAC reset strobe
-    /*! This is the content of the last control message sent to the dac
-        reset strobe. */
-    LAST_CONTROL_MESSAGE lastResetStrobe;
-    //! Last control message: DAC clear strobe
-    /*! This is the content of the last control message sent to the dac
-        clear strobe. */
-    LAST_CONTROL_MESSAGE lastClearStrobe;
-} POL_DAC;
-
 /* Prototypes */
 void polDacResetStrobeHandler(int currentModule, int currentBiasModule, int currentPolarizationModule,
                               int currentPolSpecialMsgsModule, int currentPolDacModule);
@@ -31,21 +31,6 @@
                                                   1 -> dac */
 #define POL_SPECIAL_MSGS_MODULES_MASK_SHIFT 6  // Bits right shift for the submodules mask
 
-/* Typedefs */
-//! Current state of the polarization special messages
-/*! This structure represent the current state of the polarization special
-    messages.
-    \ingroup    polarization
-    \param      This contains the information about the DACs available for
-                this module. There can be up to \ref POL_DACS_NUMBER for
-                each special messages module. */
-typedef struct {
-    //! Polarization dac current state
-    /*! Please see the definition of the \ref POL_DAC structure for more
-        information.*/
-    POL_DAC polDac[POL_DACS_NUMBER];
-} POL_SPECIAL_MSGS;
-
 /* Prototypes */
 void polSpecialMsgsHandler(int currentModule, int currentBiasModule,
                            int currentPolarizationModule);  //!< This function deals with the incoming can message
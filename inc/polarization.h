@@ -68,10 +68,6 @@ typedef struct {
     //! SIS heater current state
     /*! Please see \ref SIS_HEATER for more information. */
     SIS_HEATER sisHeater;
-
-    //! Polarization special messages current state
-    /*! Please see \ref POL_SPECIAL_MSGS for more information. */
-    POL_SPECIAL_MSGS polSpecialMsgs;
 } POLARIZATION;
 
 /* Prototypes */
@@ -23,6 +23,8 @@
 #define _POWERDISTRIBUTION_H
 
 /* Extra includes */
+#include <stdatomic.h>
+
 #include "globalDefinitions.h"
 #include "pdModule.h"
 
@@ -48,7 +50,33 @@
                                                     10 -> poweredModules */
 #define POWER_DISTRIBUTION_MODULES_MASK_SHIFT 4  // Bits right shift for the submodules mask
 
+/* Channels sweep */
+#define PD_SWEEP_PERIOD 1000  //!< Time (ms) between the starts of two sweeps of the channels
+
+/* Band select */
+#define BAND_SELECT_TIMEOUT 60000  //!< Max time (ms) for a band select to complete
+
+#define BAND_SELECT_IDLE 0     //!< No band select was requested
+#define BAND_SELECT_RUNNING 1  //!< The band select is in progress
+#define BAND_SELECT_DONE 2     //!< The selected band is ready and switched in
+#define BAND_SELECT_FAILED 3   //!< The band select failed, see the status byte
+
+#define BAND_SELECT_STEP_POWER 0x01     //!< The band is powered
+#define BAND_SELECT_STEP_IF_SWITCH 0x02  //!< The IF switch is set to the band
+#define BAND_SELECT_STEP_LPR_MOVE 0x04  //!< The optical switch move to the band was queued
+#define BAND_SELECT_STEP_LPR_PORT 0x08  //!< The optical switch settled on the band
+#define BAND_SELECT_STEP_READY 0x10     //!< The cartridge completed its initialization
+#define BAND_SELECT_STEPS_ALL 0x1F      //!< All the steps completed
+
 /* Typedefs */
+//! Last control messages of the power distribution system
+/*! These are only written by the message loop and read back by the control
+    monitor messages. They are kept on their own cache lines, away from the
+    power distribution channels monitor values. */
+typedef struct CACHE_ALIGNED {
+    LAST_CONTROL_MESSAGE pdModuleEnable[PD_MODULES_NUMBER];  //!< Power distribution modules state
+} POWER_DISTRIBUTION_LAST_CONTROL;
+
 //! Current state of the power distribution system
 typedef struct {
     //! Current state of the different power distribution modules.
@@ -71,7 +99,9 @@ typedef struct {
     PD_MODULE pdModule[PD_MODULES_NUMBER];
 
     //! Current number of cartridges powered
-    unsigned char poweredModules;
+    /*! A slot is reserved by \ref allowPowerOn and returned when the
+        cartridge is stopped. */
+    _Atomic unsigned char poweredModules;
 
     /*! Maximum number of cartridges powered, depends on FE mode:
             - \ref MAX_POWERED_BANDS_OPERATION in operational mode
@@ -80,8 +110,11 @@ typedef struct {
 
     /*! Number of cartridges in STANDBY2 mode,
         limited to MAX_STANDBY2_BANDS_OPERATIONAL */
-    unsigned char standby2Modules;
+    _Atomic unsigned char standby2Modules;
 
+    //! Last control messages
+    /*! Please see \ref POWER_DISTRIBUTION_LAST_CONTROL for more information. */
+    POWER_DISTRIBUTION_LAST_CONTROL lastControl;
 } POWER_DISTRIBUTION;
 
 /* Prototypes */
@@ -90,5 +123,9 @@ int powerDistributionStartup(void);  //!< This function deals with the initializ
                                      //!< system
 void powerDistributionHandler(int currentModule);  //!< This function deals with the incoming can message
 int powerDistributionStop(void);  //!< This function deals with the shut down of the power distribution system
+int bandSelectStart(int band);     //!< Start switching the front end to the selected band
+void bandSelectStatus(unsigned char *data);  //!< Return the progress of the band select
+void bandSelectAsync(void);                  //!< Advance the band select from the cartridge async thread
+void pdSweepAsync(void);                     //!< Sweep the channels of the enabled modules in the background
 
 #endif /* _POWERDISTRIBUTION_H */
@@ -17,14 +17,38 @@
 #ifndef _SERIALINTERFACE_H
 #define _SERIALINTERFACE_H
 
+/* Extra includes */
+#include "serialMux.h"
+
 /* Defines */
 #define COMMAND_WORD_SIZE 0x1F  //!< Maximum size of the command word (5-bit)
 #define SERIAL_READ 0           //!< Serial read
 #define SERIAL_WRITE 1          //!< Serial write
+#define SERIAL_LIST_SIZE 128    //!< Maximum number of frames in a \ref SERIAL_LIST
+
+/* Typedefs */
+//! Prepared list of serial writes
+/*! This structure collects write frames, already formatted as
+    \ref serialAccess would, so that they can be sent to one port back to
+    back with a single acquisition of the port. */
+typedef struct {
+    //! Port addressed by every frame in the list
+    /*! Set by the first frame added to the list. */
+    unsigned int port;
+    //! Number of frames in the list
+    int framesNumber;
+    //! The frames, in transmission order
+    FRAME frame[SERIAL_LIST_SIZE];
+} SERIAL_LIST;
 
 /* Prototypes */
 int serialAccess(unsigned int command, int *reg, unsigned char regSize, unsigned char shiftAmount,
                  unsigned char shiftDir, unsigned char write, int currentModule,
                  int localCartSubsystem);  //!< Serial Access funtion
+void serialListInit(SERIAL_LIST *list);  //!< Empty a serial write list
+int serialListAdd(SERIAL_LIST *list, unsigned int command, int *reg, unsigned char regSize, unsigned char shiftAmount,
+                  unsigned char shiftDir, int currentModule,
+                  int localCartSubsystem);  //!< Append a write to a serial write list
+int serialListWrite(SERIAL_LIST *list);     //!< Send a serial write list
 
 #endif  // _SERIALINTERFACE_H
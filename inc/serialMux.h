@@ -28,6 +28,10 @@
 #include <sys/mman.h>
 #include <unistd.h>
 
+/* Build options */
+/* Define SIMULATED_HARDWARE (make sim) to replace the /dev/mem mapping with an
+   in-memory register file and to boot the front end in SIMULATION_MODE. */
+
 /* PicoZed Registers and values */
 #define BASE_LPR 0x43C00000
 #define MAP_SIZE 512
@@ -163,7 +167,8 @@ extern int LATCH_DEBUG_SERIAL_WRITE;
 /* Externs */
 int writeMux(unsigned int port, FRAME *frame);  //!< Serial Mux Board write
 int readMux(unsigned int port, FRAME *frame);   //!< Serial Mux Board read
+int writeMuxList(unsigned int port, FRAME *frame, int framesNumber);  //!< Serial Mux Board list write
 
-unsigned char init_mem_map(void);
+unsigned char init_mem_map(void);  //!< Map the serial controllers registers
 
 #endif  // _SERIALMUX_H
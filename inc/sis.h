@@ -32,6 +32,21 @@
                                      3 -> openLoopHandler */
 #define SIS_MODULES_MASK_SHIFT 3  // Bits right shift for the submodules mask
 
+/* I-V sweep */
+#define SIS_SWEEP_MAX_POINTS 512       //!< Max number of points stored by an I-V sweep
+#define SIS_SWEEP_MAX_AVERAGING 64     //!< Max number of readings averaged for each point
+#define SIS_SWEEP_VOLTAGE_SCALE 1e-3   //!< mV per count of the sweep start, stop and step parameters
+#define SIS_SWEEP_POL_BIT 0x80         //!< Polarization bit in the first byte of the sweep request
+#define SIS_SWEEP_SB_BIT 0x40          //!< Sideband bit in the first byte of the sweep request
+#define SIS_SWEEP_AVERAGING_MASK 0x3F  //!< Averaging (minus one) in the first byte of the sweep request
+
+/* I-V sweep states */
+#define SIS_SWEEP_IDLE 0     //!< No sweep was requested since startup
+#define SIS_SWEEP_RUNNING 1  //!< Sweep in progress
+#define SIS_SWEEP_DONE 2     //!< Sweep completed, all the points are available
+#define SIS_SWEEP_ABORTED 3  //!< Sweep aborted by command
+#define SIS_SWEEP_ERROR 4    //!< Sweep stopped by a hardware error or a cartridge state change
+
 /* Typedefs */
 typedef struct {
     //! SIS mixer availability
@@ -55,20 +70,17 @@ typedef struct {
                     value is the one stored by the software after a control
                     command has been issued.*/
     unsigned char openLoop;
-    //! Last control message: SIS sense resister
-    /*! This is the content of the last control message sent to the SIS
-        sense resistor. */
-    LAST_CONTROL_MESSAGE lastSenseResistor;
-    //! Last control message: SIS mixer voltage
-    /*! This is the content of the last control message sent to the SIS
-        mixer voltage. */
-    LAST_CONTROL_MESSAGE lastVoltage;
-    //! Last control message: SIS mixer mode
-    /*! This is the content of the last control message sent to the SIS
-        mixer mode. */
-    LAST_CONTROL_MESSAGE lastOpenLoop;
 } SIS;
 
+//! SIS I-V sweep point
+/*! This is a single point of the I-V curve acquired by the sweep engine. */
+typedef struct {
+    //! Measured mixer voltage (in mV)
+    float voltage;
+    //! Measured mixer current (in mA)
+    float current;
+} SIS_SWEEP_POINT;
+
 /* Prototypes */
 void senseResistorHandler(int currentModule, int currentBiasModule, int currentPolarizationModule);
 void sisVoltageHandler(int currentModule, int currentBiasModule, int currentPolarizationModule);
@@ -76,7 +88,11 @@ void sisCurrentHandler(int currentModule, int currentBiasModule, int currentPola
 void openLoopHandler(int currentModule, int currentBiasModule, int currentPolarizationModule);
 void sisHandler(int currentModule, int currentBiasModule,
                 int currentPolarizationModule);  //!< This function deals with the incoming can message
-void sisGoStandby2(int currentModule, int currentBiasModule, int currentPolarizationModule);
-//!< set the specified SIS to STANDBY2 mode
+int sisSweepStart(int currentModule, const unsigned char *data,
+                  unsigned char size);       //!< Start an I-V sweep on the selected cartridge
+void sisSweepAbort(void);                    //!< Abort the running I-V sweep
+void sisSweepStatus(unsigned char *data);                        //!< Return the state of the I-V sweep
+int sisSweepReadPoint(unsigned int index, unsigned char *data);  //!< Return the point of the I-V sweep with the index
+int sisSweepAsync(void);                     //!< Execute the next step of the running I-V sweep
 
 #endif /* _SIS_H */
@@ -31,6 +31,24 @@
                                             1 -> currentHandler */
 #define SIS_MAGNET_MODULES_MASK_SHIFT 4  // Bits right shift for the submodules mask
 
+/* Current limits: the DAC2 full scale */
+#define SIS_MAGNET_CURRENT_SET_MIN -125.0   //!< Minimum SIS magnet current set point (mA)
+#define SIS_MAGNET_CURRENT_SET_MAX 124.996  //!< Maximum SIS magnet current set point (mA)
+
+/* Current ramp */
+#define SIS_MAGNET_RAMP_MAX_SAMPLES 512   //!< Max number of samples stored while ramping
+#define SIS_MAGNET_RAMP_RATE_SCALE 1e-3   //!< mA/s per count of the ramp rate parameter
+#define SIS_MAGNET_RAMP_POL_BIT 0x80      //!< Polarization bit in the first byte of the ramp request
+#define SIS_MAGNET_RAMP_SB_BIT 0x40       //!< Sideband bit in the first byte of the ramp request
+#define SIS_MAGNET_RAMP_SAMPLE_BIT 0x01   //!< Sample-while-ramping bit in the first byte of the ramp request
+
+/* Current ramp states */
+#define SIS_MAGNET_RAMP_IDLE 0     //!< No ramp was requested since startup
+#define SIS_MAGNET_RAMP_RUNNING 1  //!< Ramp in progress
+#define SIS_MAGNET_RAMP_DONE 2     //!< Target current reached
+#define SIS_MAGNET_RAMP_ABORTED 3  //!< Ramp aborted by command
+#define SIS_MAGNET_RAMP_ERROR 4    //!< Ramp stopped by a hardware error or a cartridge state change
+
 /* Typedefs */
 //! Current state of the SIS magnetic coil
 /*! This structure represent the current state of the SIS magnetic coil.
@@ -42,9 +60,7 @@
     \param      voltage     This contains the most recent read-back value
                             for the magnet voltage.
     \param      current     This contains the most recent read-back value
-                            for the magnet current.
-    \param      lastCurrent This contains a copy of the last issued control
-                            message for the current. */
+                            for the magnet current. */
 typedef struct {
     //! SIS magnet availability
     unsigned char available;
@@ -54,18 +70,30 @@ typedef struct {
     //! SIS magnetic coil current
     /*! This is the current (in mA) across the magnetic coils. */
     float current;
-    //! Last control message: SIS magnetic coil current
-    /*! This is the content of the last control message sent to the SIS
-        magnetic coil current. */
-    LAST_CONTROL_MESSAGE lastCurrent;
 } SIS_MAGNET;
 
+//! SIS magnet ramp sample
+/*! This is a single reading of the magnet acquired while ramping. */
+typedef struct {
+    //! Magnet voltage (in mV)
+    float voltage;
+    //! Magnet current (in mA)
+    float current;
+} SIS_MAGNET_RAMP_SAMPLE;
+
 /* Prototypes */
 void sisMagnetVoltageHandler(int currentModule, int currentBiasModule, int currentPolarizationModule);
 void sisMagnetCurrentHandler(int currentModule, int currentBiasModule, int currentPolarizationModule);
 void sisMagnetHandler(int currentModule, int currentBiasModule,
                       int currentPolarizationModule);  //!< This function deals with the incoming can message
-void sisMagnetGoStandby2(int currentModule, int currentBiasModule, int currentPolarizationModule);
-//!< set the specified SIS magnet to STANDBY2 mode.
+int sisMagnetRampStart(int currentModule, const unsigned char *data,
+                       unsigned char size);  //!< Start a current ramp on the selected cartridge
+void sisMagnetRampCancel(int currentModule, int currentBiasModule,
+                         int currentPolarizationModule);  //!< Cancel the ramp running on a SIS magnet
+void sisMagnetRampAbort(void);                            //!< Abort all the running current ramps
+void sisMagnetRampStatus(unsigned char *data);            //!< Return the state of the last requested ramp
+int sisMagnetRampReadSample(unsigned int index,
+                            unsigned char *data);         //!< Return the sample of the sampled ramp with the index
+int sisMagnetRampAsync(void);                             //!< Execute the next step of the running ramps
 
 #endif /* _SISMAGNET_H */
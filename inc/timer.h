@@ -36,6 +36,8 @@
 /* BAND9 SIS Heater */
 #define TIMER_BIAS_B9_HEATER(pol) (22 + pol)  // Timer number
 #define TIMER_BIAS_TO_B9_HEATER 10000         // Timeout in milliseconds
+/* SIS I-V sweep settling time */
+#define TIMER_BIAS_SIS_SWEEP 24  // Timer number, the timeout is part of the sweep request
 
 /*** LO Module ***/
 /* ADC */
@@ -234,7 +234,7 @@ void drainBVoltageHandler(int currentModule) {
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.amc.lastDrainBVoltage)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.amcDrainBVoltage)
 
         /* Extract the float from the can message */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -243,7 +243,7 @@ void drainBVoltageHandler(int currentModule) {
            and return the error state then return. */
         if (setAmc(AMC_DRAIN_B_VOLTAGE, currentModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].lo.amc.lastDrainBVoltage.status = ERROR;
+            frontend.cartridge[currentModule].lastControl.amcDrainBVoltage.status = ERROR;
 
             return;
         }
@@ -255,7 +255,7 @@ void drainBVoltageHandler(int currentModule) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {  // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.amc.lastDrainBVoltage)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.amcDrainBVoltage)
 
         return;
     }
@@ -336,12 +336,12 @@ void multiplierDVoltageHandler(int currentModule) {
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.amc.lastMultiplierDVoltage);
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.amcMultiplierDVoltage);
         /* Set the AMC multiplier D voltage. If an error occurs then store the state
            and return the error state then return. */
         if (setAmc(AMC_MULTIPLIER_D_VOLTAGE, currentModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].lo.amc.lastMultiplierDVoltage.status = ERROR;
+            frontend.cartridge[currentModule].lastControl.amcMultiplierDVoltage.status = ERROR;
             return;
         }
 
@@ -352,7 +352,7 @@ void multiplierDVoltageHandler(int currentModule) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {  // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.amc.lastMultiplierDVoltage)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.amcMultiplierDVoltage)
         return;
     }
 
@@ -421,7 +421,7 @@ void gateEVoltageHandler(int currentModule) {
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.amc.lastGateEVoltage);
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.amcGateEVoltage);
 
         /* Extract the float from the can message */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -430,7 +430,7 @@ void gateEVoltageHandler(int currentModule) {
            and return the error state then return. */
         if (setAmc(AMC_GATE_E_VOLTAGE, currentModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].lo.amc.lastGateEVoltage.status = ERROR;
+            frontend.cartridge[currentModule].lastControl.amcGateEVoltage.status = ERROR;
             return;
         }
 
@@ -441,7 +441,7 @@ void gateEVoltageHandler(int currentModule) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {  // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.amc.lastGateEVoltage)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.amcGateEVoltage)
         return;
     }
 
@@ -476,7 +476,7 @@ void drainEVoltageHandler(int currentModule) {
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.amc.lastDrainEVoltage)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.amcDrainEVoltage)
 
         /* Extract the float from the can message */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -485,7 +485,7 @@ void drainEVoltageHandler(int currentModule) {
            and return the error state then return. */
         if (setAmc(AMC_DRAIN_E_VOLTAGE, currentModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].lo.amc.lastDrainEVoltage.status = ERROR;
+            frontend.cartridge[currentModule].lastControl.amcDrainEVoltage.status = ERROR;
 
             return;
         }
@@ -497,7 +497,7 @@ void drainEVoltageHandler(int currentModule) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {  // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.amc.lastDrainEVoltage)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.amcDrainEVoltage)
         return;
     }
 
@@ -51,7 +51,7 @@ void backingPumpEnableHandler(void) {
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.backingPump.lastEnable)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.lastControl.backingPumpEnable)
 
         /* If turning the backing pump off, then shut down the hardware that is
            biased by the backing pump: turbo, gate and solenoid valve. */
@@ -76,7 +76,7 @@ void backingPumpEnableHandler(void) {
            CAN message. */
         if (setBackingPumpEnable(CAN_BYTE ? BACKING_PUMP_ENABLE : BACKING_PUMP_DISABLE) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cryostat.backingPump.lastEnable.status = ERROR;
+            frontend.cryostat.lastControl.backingPumpEnable.status = ERROR;
             return;
         }
 
@@ -87,7 +87,7 @@ void backingPumpEnableHandler(void) {
     /* If monitor on a control RCA */
     if (currentClass == CONTROL_CLASS) {
         // Return the last control message and status:
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.backingPump.lastEnable)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.lastControl.backingPumpEnable)
         return;
     }
 
@@ -22,6 +22,7 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -88,12 +89,35 @@ float calibrationCurve[CARTRIDGE_TEMP_TBL_SIZE][2] = {
     {470.000, 0.159010}, {475.000, 0.147191}, {480.000, 0.135480}, {485.000, 0.123915}, {490.000, 0.112553},
     {495.000, 0.101454}, {500.000, 0.090681}};
 
+/* Slopes of the calibration curve segments: calibrationSlope[i] is the slope
+   of the segment going from calibrationCurve[i] to calibrationCurve[i + 1].
+   They are precomputed at startup by temperatureConversionInit(). */
+static float calibrationSlope[CARTRIDGE_TEMP_TBL_SIZE];
+
+/* Temperature calibration curve preprocessing */
+/*! This function precomputes the slopes of the calibration curve segments so
+    that \ref temperatureConversion only has to search the curve and perform a
+    single multiply-add. It has to be called once before any conversion. */
+void temperatureConversionInit(void) {
+    unsigned char i;
+
+    /* Entry 0 is only a guard for voltages above the curve: no segment
+       starts there. */
+    calibrationSlope[0] = 0.0;
+    for (i = 1; i < CARTRIDGE_TEMP_TBL_SIZE - 1; i++) {
+        calibrationSlope[i] =
+            (calibrationCurve[i + 1][0] - calibrationCurve[i][0]) / (calibrationCurve[i + 1][1] - calibrationCurve[i][1]);
+    }
+
+    /* The last entry has no following segment: extend the previous one. */
+    calibrationSlope[CARTRIDGE_TEMP_TBL_SIZE - 1] = calibrationSlope[CARTRIDGE_TEMP_TBL_SIZE - 2];
+}
+
 /* Temperature interpolation */
 /* This function preform the interpolation with the standard curve for the
    cartridge temperature sensors. */
 float temperatureConversion(float voltage) {
-    float temperature, slope;
-    unsigned char i;
+    unsigned char i, low = 0, high = CARTRIDGE_TEMP_TBL_SIZE;
 
     /* Check if voltage is lower than lowest limit. The highest limit is
        checked by the search algorithm. */
@@ -101,38 +125,68 @@ float temperatureConversion(float voltage) {
         return CARTRIDGE_TEMP_CONV_ERR;
     }
 
-    /* Find position in the calibration curve */
-    for (i = 0; (i < CARTRIDGE_TEMP_TBL_SIZE) && (voltage <= calibrationCurve[i][1]); i++)
-        ;
+    /* Find position in the calibration curve: the first entry with a voltage
+       lower than the given one. The curve is sorted by decreasing voltage so a
+       binary search can be used. */
+    while (low < high) {
+        i = (low + high) / 2;
+        if (voltage <= calibrationCurve[i][1]) {
+            low = i + 1;
+        } else {
+            high = i;
+        }
+    }
+    i = low;
 
     /* If not found return error */
     if ((i == CARTRIDGE_TEMP_TBL_SIZE) || (i == 0)) {
         return CARTRIDGE_TEMP_CONV_ERR;
     }
 
-    /* Calculate the slope in the interval containing the voltage */
-    slope =
-        (calibrationCurve[i + 1][0] - calibrationCurve[i][0]) / (calibrationCurve[i + 1][1] - calibrationCurve[i][1]);
-
     /* Calculate the temperature */
-    temperature = calibrationCurve[i][0] + slope * (voltage - calibrationCurve[i][1]);
-
-    return temperature;
+    return calibrationCurve[i][0] + calibrationSlope[i] * (voltage - calibrationCurve[i][1]);
 }
 
-/* BIAS analog monitor request core.
-   This function performs the core operations that are common to all the analog
-   monitor request for the BIAS module:
-       - Write the BIAS AREG with a parallel output write cycle
-       - Initiate an ADC conversion:
-           - with a convert strobe command
-       - Wait on ADC ready status:
-           - with a parallel input read cycle
-       - Execute an ADC read cycle that get the raw data
+/* Cartridge temperatures batch conversion */
+/*! This function converts the voltages read from all the temperature sensors
+    of a cartridge in a single call, adds the sensors offsets and stores the
+    results in the \ref frontend variable. A sensor whose voltage is outside
+    the calibration curve is stored as \ref CARTRIDGE_TEMP_CONV_ERR without
+    offset, as done by \ref getTemp.
 
-   If an error happens during the process it will return ERROR, otherwise
-   NO_ERROR will be returned. */
-int getBiasAnalogMonitor(int currentModule, int currentBiasModule) {
+    \param currentModule    This is the cartridge to update.
+    \param voltage          These are the sensors voltages, in the same order
+                            as the cartridgeTemp array of the cartridge.
+
+    \return
+        - \ref NO_ERROR -> if all the sensors were converted
+        - \ref ERROR    -> if at least one conversion failed */
+int cartridgeTempsConversion(int currentModule, const float voltage[CARTRIDGE_TEMP_SENSORS_NUMBER]) {
+    CARTRIDGE_TEMP *cartridgeTemp = frontend.cartridge[currentModule].cartridgeTemp;
+    int ret = NO_ERROR;
+    unsigned char sensor;
+    float temperature;
+
+    for (sensor = 0; sensor < CARTRIDGE_TEMP_SENSORS_NUMBER; sensor++) {
+        temperature = temperatureConversion(voltage[sensor]);
+
+        if (temperature == CARTRIDGE_TEMP_CONV_ERR) {
+            cartridgeTemp[sensor].temp = temperature;
+            ret = ERROR;
+        } else {
+            cartridgeTemp[sensor].temp = temperature + cartridgeTemp[sensor].offset;
+        }
+    }
+
+    return ret;
+}
+
+/* BIAS ADC readback.
+   This function waits for the ADC conversion started by a convert strobe to
+   complete and reads the raw data in the BIAS registers of the cartridge. It
+   is shared by the single analog monitor requests and by the batched
+   cartridge temperature sweep. */
+static int biasAdcReadback(int currentModule, int currentBiasModule) {
     /* A temporary variable to deal with the timer. */
     int timedOut;
 
@@ -142,34 +196,6 @@ int getBiasAnalogMonitor(int currentModule, int currentBiasModule) {
        stored one is only the real 16 bit value. */
     int tempAdcValue[2];
 
-/* Parallel write AREG */
-#ifdef DEBUG_BIAS_SERIAL
-    printf("         - Writing AREG\n");
-#endif /* DEBUG_BIAS_SERIAL */
-
-    /* The function to write the data to the hardware is called passing the
-       intermediate buffer. If an error occurs, notify the calling function. */
-    if (serialAccess(BIAS_PARALLEL_WRITE(currentBiasModule, BIAS_AREG), &biasRegisters[currentModule].aReg.integer,
-                     BIAS_AREG_SIZE, BIAS_AREG_SHIFT_SIZE, BIAS_AREG_SHIFT_DIR, SERIAL_WRITE, currentModule,
-                     CARTRIDGE_SUBSYSTEM_BIAS) == ERROR) {
-        return ERROR;
-    }
-
-    /* Do 40 us busy wait instead of four more calls to the hardware */
-    struct timespec request = {0, 40000};
-    nanosleep(&request, NULL);
-
-/* Initiate ADC conversion
-    - send ADC convert strobe command */
-#ifdef DEBUG_BIAS_SERIAL
-    printf("         - Initiating ADC conversion\n");
-#endif /* DEBUG_BIAS_SERIAL */
-    /* If an error occurs, notify the calling function */
-    if (serialAccess(BIAS_ADC_CONVERT_STROBE(currentBiasModule), NULL, BIAS_ADC_STROBE_SIZE, BIAS_ADC_STROBE_SHIFT_SIZE,
-                     BIAS_ADC_STROBE_SHIFT_DIR, SERIAL_WRITE, currentModule, CARTRIDGE_SUBSYSTEM_BIAS) == ERROR) {
-        return ERROR;
-    }
-
     /* Wait on ADC ready status
         - parallel input */
     /* Setup for 1 seconds and start the asynchronous timer */
@@ -230,6 +256,51 @@ int getBiasAnalogMonitor(int currentModule, int currentBiasModule) {
     return NO_ERROR;
 }
 
+/* BIAS analog monitor request core.
+   This function performs the core operations that are common to all the analog
+   monitor request for the BIAS module:
+       - Write the BIAS AREG with a parallel output write cycle
+       - Initiate an ADC conversion:
+           - with a convert strobe command
+       - Wait on ADC ready status:
+           - with a parallel input read cycle
+       - Execute an ADC read cycle that get the raw data
+
+   If an error happens during the process it will return ERROR, otherwise
+   NO_ERROR will be returned. */
+int getBiasAnalogMonitor(int currentModule, int currentBiasModule) {
+/* Parallel write AREG */
+#ifdef DEBUG_BIAS_SERIAL
+    printf("         - Writing AREG\n");
+#endif /* DEBUG_BIAS_SERIAL */
+
+    /* The function to write the data to the hardware is called passing the
+       intermediate buffer. If an error occurs, notify the calling function. */
+    if (serialAccess(BIAS_PARALLEL_WRITE(currentBiasModule, BIAS_AREG), &biasRegisters[currentModule].aReg.integer,
+                     BIAS_AREG_SIZE, BIAS_AREG_SHIFT_SIZE, BIAS_AREG_SHIFT_DIR, SERIAL_WRITE, currentModule,
+                     CARTRIDGE_SUBSYSTEM_BIAS) == ERROR) {
+        return ERROR;
+    }
+
+    /* Do 40 us busy wait instead of four more calls to the hardware */
+    struct timespec request = {0, 40000};
+    nanosleep(&request, NULL);
+
+/* Initiate ADC conversion
+    - send ADC convert strobe command */
+#ifdef DEBUG_BIAS_SERIAL
+    printf("         - Initiating ADC conversion\n");
+#endif /* DEBUG_BIAS_SERIAL */
+    /* If an error occurs, notify the calling function */
+    if (serialAccess(BIAS_ADC_CONVERT_STROBE(currentBiasModule), NULL, BIAS_ADC_STROBE_SIZE, BIAS_ADC_STROBE_SHIFT_SIZE,
+                     BIAS_ADC_STROBE_SHIFT_DIR, SERIAL_WRITE, currentModule, CARTRIDGE_SUBSYSTEM_BIAS) == ERROR) {
+        return ERROR;
+    }
+
+    /* Wait on ADC ready status and read the raw data */
+    return biasAdcReadback(currentModule, currentBiasModule);
+}
+
 /* Get SIS mixer bias */
 /*! This function return the operating voltage and current of the addressed
     SIS mixer. The resulting scaled value is stored in the frontend status
@@ -321,10 +392,12 @@ int getSisMixerBias(unsigned char current, int currentModule, int currentBiasMod
         -# Scale the analog control parameter from float to raw 16-bit data.
         -# Execute a DAC2 write cycle.
 
+    \param voltage  This is the bias voltage (mV) to set the SIS mixer to
+
     \return
         - \ref NO_ERROR -> if no error occurred
         - \ref ERROR    -> if something wrong happened */
-int setSisMixerBias(int currentModule, int currentBiasModule, int currentPolarizationModule) {
+int setSisMixerBias(float voltage, int currentModule, int currentBiasModule, int currentPolarizationModule) {
     if (frontend.mode != SIMULATION_MODE) {
         /* Setup the DAC2 message */
         /* Select the register to address */
@@ -333,7 +406,7 @@ int setSisMixerBias(int currentModule, int currentBiasModule, int currentPolariz
         /* Setup quick load */
         biasRegisters[currentModule].dac2Reg.bitField.quickLoad = NO;
         /* 1 - Format the data according to the dac specifications. */
-        biasRegisters[currentModule].dac2Reg.bitField.data = BIAS_DAC2_SIS_MIXER_V_SCALE(CONV_FLOAT);
+        biasRegisters[currentModule].dac2Reg.bitField.data = BIAS_DAC2_SIS_MIXER_V_SCALE(voltage);
 
 /* 2 - Write the data to the serial access function */
 #ifdef DEBUG_BIAS_SERIAL
@@ -497,10 +570,12 @@ int getSisMagnetBias(unsigned char current, int currentModule, int currentBiasMo
         -# Scale the analog control parameter from float to raw 16-bit data.
         -# Execute a DAC2 write cycle.
 
+    \param current  This is the bias current (mA) to set the SIS magnet to
+
     \return
         - \ref NO_ERROR -> if no error occurred
         - \ref ERROR    -> if something wrong happened */
-int setSisMagnetBias(int currentModule, int currentBiasModule, int currentPolarizationModule) {
+int setSisMagnetBias(float current, int currentModule, int currentBiasModule, int currentPolarizationModule) {
     if (frontend.mode != SIMULATION_MODE) {
         /* Setup the DAC2 message */
         /* Select the register to address */
@@ -509,7 +584,7 @@ int setSisMagnetBias(int currentModule, int currentBiasModule, int currentPolari
         /* Setup quick load */
         biasRegisters[currentModule].dac2Reg.bitField.quickLoad = NO;
         /* 1 - Format the data according to the dac specifications. */
-        biasRegisters[currentModule].dac2Reg.bitField.data = BIAS_DAC2_SIS_MAGNET_C_SCALE(CONV_FLOAT);
+        biasRegisters[currentModule].dac2Reg.bitField.data = BIAS_DAC2_SIS_MAGNET_C_SCALE(current);
 
 /* 2 - Write the data to the serial access function */
 #ifdef DEBUG_BIAS_SERIAL
@@ -681,6 +756,87 @@ int getLnaStage(int currentModule, int currentBiasModule, int currentPolarizatio
     return NO_ERROR;
 }
 
+/* Wait for DAC1 ready */
+/* This function polls the bias module status register until DAC1 is ready to
+   accept a new word or the DAC1 timer expires. */
+static int waitBiasDac1Ready(int currentModule, int currentBiasModule) {
+    /* A temporary variable to deal with the timer. */
+    int timedOut;
+
+    /* Setup for 1 seconds and start the asynchronous timer */
+    if (startAsyncTimer(TIMER_BIAS_DAC1_RDY, TIMER_BIAS_TO_DAC1_RDY, FALSE) == ERROR) {
+        return ERROR;
+    }
+
+    do {
+#ifdef DEBUG_BIAS_SERIAL
+        printf("         - Waiting on DAC1 ready\n");
+#endif /* DEBUG_BIAS_SERIAL */
+
+        /* If there is a problem writing to DAC1, return error so that the
+           frontend variable is not going to be updated. */
+        if (serialAccess(BIAS_PARALLEL_READ(currentBiasModule), &biasRegisters[currentModule].statusReg.integer,
+                         BIAS_STATUS_REG_SIZE, BIAS_STATUS_REG_SHIFT_SIZE, BIAS_STATUS_REG_SHIFT_DIR, SERIAL_READ,
+                         currentModule, CARTRIDGE_SUBSYSTEM_BIAS) == ERROR) {
+            /* Stop the timer. */
+            if (stopAsyncTimer(TIMER_BIAS_DAC1_RDY) == ERROR) {
+                return ERROR;
+            }
+
+            return ERROR;
+        }
+        timedOut = queryAsyncTimer(TIMER_BIAS_DAC1_RDY);
+        if (timedOut == ERROR) {
+            return ERROR;
+        }
+    } while ((biasRegisters[currentModule].statusReg.bitField.dac1Ready == BIAS_DAC1_BUSY) &&
+             (timedOut == TIMER_RUNNING));
+
+    /* If the timer has expired signal the error */
+    if (timedOut == TIMER_EXPIRED) {
+        storeError(ERR_BIAS_SERIAL,
+                   ERC_HARDWARE_TIMEOUT);  // Timeout while waiting for the
+                                           // DAC1 to become ready
+        return ERROR;
+    }
+
+    /* In case of no error, clear the asynchronous timer. */
+    if (stopAsyncTimer(TIMER_BIAS_DAC1_RDY) == ERROR) {
+        return ERROR;
+    }
+
+    return NO_ERROR;
+}
+
+/* Format a DAC1 LNA stage word */
+static void formatLnaStageWord(BIAS_DAC1_REG_UNION *dac1Reg, int currentPolarizationModule, int currentLnaModule,
+                               int currentLnaStageModule, float value) {
+    /* Set the toggle mode. Since we're not using the toggle function, this
+       bit is always to 0. */
+    dac1Reg->bitField.toggleABSelect = BIAS_DAC1_TOGGLE_OFF;
+    /* Set the read/_write mode. Since the read mode is not supported by the
+       hardware, this bit is always set to 0. */
+    dac1Reg->bitField.readWrite = BIAS_DAC1_READ_WRITE;
+    /* Select the channel to write to. */
+    dac1Reg->bitField.channel = BIAS_DAC1_LNA_STAGE_PORT(currentPolarizationModule, currentLnaStageModule,
+                                                         currentLnaModule);
+    /* Select the input register to update. */
+    dac1Reg->bitField.inputRegister = BIAS_DAC1_INPUT_DATA_REGISTER;
+    /* Scale the data to conform to the DAC1 requirements */
+    switch (currentLnaStageModule) {
+        /* The LNA drain voltage is given by: (Vds/5)*16384 */
+        case LNA_STAGE_DRAIN_V:
+            dac1Reg->bitField.data = BIAS_DAC1_LNA_STAGE_DRAIN_V_SCALE(value);
+            break;
+        /* The LNA drain voltage is given by: (Ids/50)*16384 */
+        case LNA_STAGE_DRAIN_C:
+            dac1Reg->bitField.data = BIAS_DAC1_LNA_STAGE_DRAIN_C_SCALE(value);
+            break;
+        default:
+            break;
+    }
+}
+
 /* Set LNA stage */
 /*! This function allow the user to set different values for the drain current
     and drain voltage of the addressed lna stage.
@@ -695,94 +851,89 @@ int getLnaStage(int currentModule, int currentBiasModule, int currentPolarizatio
         - \ref ERROR    -> if something wrong happened */
 int setLnaStage(int currentModule, int currentBiasModule, int currentPolarizationModule, int currentLnaModule,
                 int currentLnaStageModule) {
-    /* A temporary variable to deal with the timer. */
-    int timedOut;
-
     if (frontend.mode != SIMULATION_MODE) {
         /* 1 - Setup the DAC1 message */
-        /* Set the toggle mode. Since we're not using the toggle function, this
-           bit is always to 0. */
-        biasRegisters[currentModule].dac1Reg.bitField.toggleABSelect = BIAS_DAC1_TOGGLE_OFF;
-        /* Set the read/_write mode. Since the read mode is not supported by the
-           hardware, this bit is always set to 0. */
-        biasRegisters[currentModule].dac1Reg.bitField.readWrite = BIAS_DAC1_READ_WRITE;
-        /* Select the channel to write to. */
-        biasRegisters[currentModule].dac1Reg.bitField.channel =
-            BIAS_DAC1_LNA_STAGE_PORT(currentPolarizationModule, currentLnaStageModule, currentLnaModule);
-        /* Select the input register to update. */
-        biasRegisters[currentModule].dac1Reg.bitField.inputRegister = BIAS_DAC1_INPUT_DATA_REGISTER;
-        /* Scale the data to conform to the DAC1 requirements */
-        switch (currentLnaStageModule) {
-            /* The LNA drain voltage is given by: (Vds/5)*16384 */
-            case LNA_STAGE_DRAIN_V:
-                biasRegisters[currentModule].dac1Reg.bitField.data = BIAS_DAC1_LNA_STAGE_DRAIN_V_SCALE(CONV_FLOAT);
-                break;
-            /* The LNA drain voltage is given by: (Ids/50)*16384 */
-            case LNA_STAGE_DRAIN_C:
-                biasRegisters[currentModule].dac1Reg.bitField.data = BIAS_DAC1_LNA_STAGE_DRAIN_C_SCALE(CONV_FLOAT);
-                break;
-            default:
-                break;
-        }
+        formatLnaStageWord(&biasRegisters[currentModule].dac1Reg, currentPolarizationModule, currentLnaModule,
+                           currentLnaStageModule, CONV_FLOAT);
 
         /* 2 - Wait on DAC1 ready status
            - parallel input */
-
-        /* Setup for 1 seconds and start the asynchronous timer */
-        if (startAsyncTimer(TIMER_BIAS_DAC1_RDY, TIMER_BIAS_TO_DAC1_RDY, FALSE) == ERROR) {
+        if (waitBiasDac1Ready(currentModule, currentBiasModule) == ERROR) {
             return ERROR;
         }
 
-        do {
+/* 3 - Write the data to the serial access function */
 #ifdef DEBUG_BIAS_SERIAL
-            printf("         - Waiting on DAC1 ready\n");
+        printf("         - Writing DAC1: %u\n", biasRegisters[currentModule].dac1Reg.bitField.data);
 #endif /* DEBUG_BIAS_SERIAL */
 
-            /* If there is a problem writing to DAC1, return error so that the
-               frontend variable is not going to be updated. */
-            if (serialAccess(BIAS_PARALLEL_READ(currentBiasModule), &biasRegisters[currentModule].statusReg.integer,
-                             BIAS_STATUS_REG_SIZE, BIAS_STATUS_REG_SHIFT_SIZE, BIAS_STATUS_REG_SHIFT_DIR, SERIAL_READ,
-                             currentModule, CARTRIDGE_SUBSYSTEM_BIAS) == ERROR) {
-                /* Stop the timer. */
-                if (stopAsyncTimer(TIMER_BIAS_DAC1_RDY) == ERROR) {
-                    return ERROR;
-                }
+        /* If there is a problem writing DAC1, return it so that the value in
+          the frontend variable is not going to be updated. */
+        if (serialAccess(BIAS_DAC_DATA_WRITE(currentBiasModule, BIAS_DAC1),
+                         biasRegisters[currentModule].dac1Reg.integer, BIAS_DAC1_DATA_SIZE, BIAS_DAC1_DATA_SHIFT_SIZE,
+                         BIAS_DAC1_DATA_SHIFT_DIR, SERIAL_WRITE, currentModule, CARTRIDGE_SUBSYSTEM_BIAS) == ERROR) {
+            return ERROR;
+        }
+    }
+    return NO_ERROR;
+}
 
-                return ERROR;
-            }
-            timedOut = queryAsyncTimer(TIMER_BIAS_DAC1_RDY);
-            if (timedOut == ERROR) {
-                return ERROR;
+/* Set LNA stages */
+/*! This function sets the drain voltage and drain current of all the staged
+    LNA stages of a polarization in a single pass.
+
+    All the DAC1 words are formatted before the first write so the outputs
+    are updated in one tight burst, with no CAN round trip or scaling between
+    them. DAC1 has no load strobe (its input data register drives the output
+    directly), so the burst is the closest thing to a simultaneous update the
+    hardware allows.
+
+    \param currentModule       The cartridge hosting the LNAs
+    \param currentBiasModule   The polarization of the LNAs
+    \param setPoint    The set points indexed by sideband and stage. Only the
+                        entries marked valid are written.
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int setLnaStages(int currentModule, int currentBiasModule,
+                 const LNA_BIAS_SETPOINT setPoint[SIDEBANDS_NUMBER][LNA_STAGES_NUMBER]) {
+    BIAS_DAC1_REG_UNION words[SIDEBANDS_NUMBER * LNA_STAGES_NUMBER * 2];
+    int sb, stage, word, wordsNumber = 0;
+
+    if (frontend.mode == SIMULATION_MODE) {
+        return NO_ERROR;
+    }
+
+    /* 1 - Setup all the DAC1 messages */
+    memset(words, 0, sizeof(words));
+    for (sb = 0; sb < SIDEBANDS_NUMBER; sb++) {
+        for (stage = 0; stage < LNA_STAGES_NUMBER; stage++) {
+            if (!setPoint[sb][stage].valid) {
+                continue;
             }
-        } while ((biasRegisters[currentModule].statusReg.bitField.dac1Ready == BIAS_DAC1_BUSY) &&
-                 (timedOut == TIMER_RUNNING));
-
-        /* If the timer has expired signal the error */
-        if (timedOut == TIMER_EXPIRED) {
-            storeError(ERR_BIAS_SERIAL,
-                       ERC_HARDWARE_TIMEOUT);  // Timeout while waiting for the
-                                               // DAC1 to become ready
-            return ERROR;
+            formatLnaStageWord(&words[wordsNumber++], sb, stage, LNA_STAGE_DRAIN_V, setPoint[sb][stage].drainVoltage);
+            formatLnaStageWord(&words[wordsNumber++], sb, stage, LNA_STAGE_DRAIN_C, setPoint[sb][stage].drainCurrent);
         }
+    }
 
-        /* In case of no error, clear the asynchronous timer. */
-        if (stopAsyncTimer(TIMER_BIAS_DAC1_RDY) == ERROR) {
+    /* 2 - Write them back to back, each after DAC1 is ready */
+    for (word = 0; word < wordsNumber; word++) {
+        if (waitBiasDac1Ready(currentModule, currentBiasModule) == ERROR) {
             return ERROR;
         }
 
-/* 3 - Write the data to the serial access function */
 #ifdef DEBUG_BIAS_SERIAL
-        printf("         - Writing DAC1: %u\n", biasRegisters[currentModule].dac1Reg.bitField.data);
+        printf("         - Writing DAC1: %u\n", words[word].bitField.data);
 #endif /* DEBUG_BIAS_SERIAL */
 
-        /* If there is a problem writing DAC1, return it so that the value in
-          the frontend variable is not going to be updated. */
+        biasRegisters[currentModule].dac1Reg = words[word];
         if (serialAccess(BIAS_DAC_DATA_WRITE(currentBiasModule, BIAS_DAC1),
                          biasRegisters[currentModule].dac1Reg.integer, BIAS_DAC1_DATA_SIZE, BIAS_DAC1_DATA_SHIFT_SIZE,
                          BIAS_DAC1_DATA_SHIFT_DIR, SERIAL_WRITE, currentModule, CARTRIDGE_SUBSYSTEM_BIAS) == ERROR) {
             return ERROR;
         }
     }
+
     return NO_ERROR;
 }
 
@@ -839,6 +990,143 @@ int setLnaLedEnable(unsigned char enable, int currentModule, int currentBiasModu
     return NO_ERROR;
 }
 
+/* Add the STANDBY2 DAC2 words of one polarization to a write list */
+/*! Both DAC2 scales put zero at mid range, so when all the four outputs are
+    in use a single quick load word zeroes them at once. Otherwise one word is
+    queued per available output and the unused ones are left alone. */
+static int biasStandby2Dac2(SERIAL_LIST *list, int currentModule, int currentBiasModule) {
+    POLARIZATION *polarization = &frontend.cartridge[currentModule].polarization[currentBiasModule];
+    BIAS_DAC2_REG_UNION dac2Reg;
+    unsigned char allAvailable = YES;
+    int sb, output;
+
+    for (sb = 0; sb < SIDEBANDS_NUMBER; sb++) {
+        if (polarization->sideband[sb].sis.available == UNAVAILABLE ||
+            polarization->sideband[sb].sisMagnet.available == UNAVAILABLE) {
+            allAvailable = NO;
+        }
+    }
+
+    memset(&dac2Reg, 0, sizeof(dac2Reg));
+    if (allAvailable && BIAS_DAC2_SIS_MIXER_V_SCALE(0.0) == BIAS_DAC2_SIS_MAGNET_C_SCALE(0.0)) {
+        dac2Reg.bitField.quickLoad = YES;
+        dac2Reg.bitField.data = BIAS_DAC2_SIS_MIXER_V_SCALE(0.0);
+        biasRegisters[currentModule].dac2Reg = dac2Reg;
+        return serialListAdd(list, BIAS_DAC_DATA_WRITE(currentBiasModule, BIAS_DAC2), dac2Reg.integer,
+                             BIAS_DAC2_DATA_SIZE, BIAS_DAC2_DATA_SHIFT_SIZE, BIAS_DAC2_DATA_SHIFT_DIR, currentModule,
+                             CARTRIDGE_SUBSYSTEM_BIAS);
+    }
+
+    for (output = 0; output < SIDEBANDS_NUMBER * 2; output++) {
+        sb = output % SIDEBANDS_NUMBER;
+        if (output < SIDEBANDS_NUMBER) {
+            if (polarization->sideband[sb].sis.available == UNAVAILABLE) {
+                continue;
+            }
+            dac2Reg.bitField.inputRegister = BIAS_DAC2_REGISTER(BIAS_DAC2_SIS_MIXER_VOLTAGE(sb));
+            dac2Reg.bitField.data = BIAS_DAC2_SIS_MIXER_V_SCALE(0.0);
+        } else {
+            if (polarization->sideband[sb].sisMagnet.available == UNAVAILABLE) {
+                continue;
+            }
+            dac2Reg.bitField.inputRegister = BIAS_DAC2_REGISTER(BIAS_DAC2_SIS_MAGNET_CURRENT(sb));
+            dac2Reg.bitField.data = BIAS_DAC2_SIS_MAGNET_C_SCALE(0.0);
+        }
+        biasRegisters[currentModule].dac2Reg = dac2Reg;
+        if (serialListAdd(list, BIAS_DAC_DATA_WRITE(currentBiasModule, BIAS_DAC2), dac2Reg.integer,
+                          BIAS_DAC2_DATA_SIZE, BIAS_DAC2_DATA_SHIFT_SIZE, BIAS_DAC2_DATA_SHIFT_DIR, currentModule,
+                          CARTRIDGE_SUBSYSTEM_BIAS) == ERROR) {
+            return ERROR;
+        }
+    }
+
+    return NO_ERROR;
+}
+
+/* Put the bias of several cartridges in STANDBY2 */
+/*! This function applies the STANDBY2 bias state to the listed cartridges:
+    both LNAs and the LNA led of each polarization are turned off and the SIS
+    mixer voltages and magnet currents are set to zero.
+
+    The function will perform the following operations:
+        -# Compute the final BREG of each cartridge once, with all the STANDBY2
+           bits cleared
+        -# Prepare one list with the BREG and the DAC2 writes of every
+           polarization of every cartridge
+        -# Send the list with a single acquisition of the bias port
+        -# If no error occurs, update BREG and the frontend variable with the
+           new state
+
+    Compared with the individual control functions this writes BREG once per
+    polarization instead of once per LNA and led, and nothing else can use
+    the port while the list is sent.
+
+    \param cartridge           The cartridges to put in STANDBY2
+    \param cartridgesNumber    The number of cartridges in the list
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int setBiasStandby2(const int cartridge[], int cartridgesNumber) {
+    static SERIAL_LIST list;
+    BIAS_BREG_UNION bReg[CARTRIDGES_NUMBER];
+    int word[2] = {0, 0};
+    int c, pol, sb;
+
+    if (cartridgesNumber > CARTRIDGES_NUMBER) {
+        return ERROR;
+    }
+
+    if (frontend.mode != SIMULATION_MODE) {
+        serialListInit(&list);
+
+        for (c = 0; c < cartridgesNumber; c++) {
+            /* 1 - Final BREG, shared by the two polarizations */
+            bReg[c] = biasRegisters[cartridge[c]].bReg;
+            bReg[c].bitField.lnaBiasEnable &= ~(BIAS_BREG_LNA_ENABLE(SIDEBAND0) | BIAS_BREG_LNA_ENABLE(SIDEBAND1));
+            bReg[c].bitField.lnaLedControl = LNA_LED_DISABLE;
+            word[0] = bReg[c].integer;
+
+            /* 2 - Queue the writes of each polarization */
+            for (pol = 0; pol < POLARIZATIONS_NUMBER; pol++) {
+                if (serialListAdd(&list, BIAS_PARALLEL_WRITE(pol, BIAS_BREG), word, BIAS_BREG_SIZE,
+                                  BIAS_BREG_SHIFT_SIZE, BIAS_BREG_SHIFT_DIR, cartridge[c],
+                                  CARTRIDGE_SUBSYSTEM_BIAS) == ERROR) {
+                    return ERROR;
+                }
+                if (biasStandby2Dac2(&list, cartridge[c], pol) == ERROR) {
+                    return ERROR;
+                }
+            }
+        }
+
+#ifdef DEBUG_GO_STANDBY2
+        printf(" - setBiasStandby2 cartridges=%d frames=%d\n", cartridgesNumber, list.framesNumber);
+#endif  // DEBUG_GO_STANDBY2
+
+        /* 3 - Send everything in one go. BREG is left untouched on error. */
+        if (serialListWrite(&list) == ERROR) {
+            return ERROR;
+        }
+
+        for (c = 0; c < cartridgesNumber; c++) {
+            biasRegisters[cartridge[c]].bReg = bReg[c];
+        }
+    }
+
+    /* Since there is no real hardware read back, if no error occured the
+       current state is updated to reflect the issued command. */
+    for (c = 0; c < cartridgesNumber; c++) {
+        for (pol = 0; pol < POLARIZATIONS_NUMBER; pol++) {
+            for (sb = 0; sb < SIDEBANDS_NUMBER; sb++) {
+                frontend.cartridge[cartridge[c]].polarization[pol].sideband[sb].lna.enable = LNA_BIAS_DISABLE;
+            }
+            frontend.cartridge[cartridge[c]].polarization[pol].lnaLed.enable = LNA_LED_DISABLE;
+        }
+    }
+
+    return NO_ERROR;
+}
+
 /* Set SIS heater enable */
 /*! This function controls the SIS heater status for the currently addressed
     polarization.
@@ -965,6 +1253,23 @@ int setBiasDacStrobe(int currentModule, int currentBiasModule, int currentPolari
     return NO_ERROR;
 }
 
+/* Simulated temperature of a sensor in SIMULATION_MODE */
+static float simulatedTemp(unsigned char sensor) {
+    switch (sensor) {
+        case 0:
+        case 2:
+        case 5:
+            return 4.0 + ((float)rand() / (float)RAND_MAX) * 0.2;
+        case 1:
+            return 110.0 + ((float)rand() / (float)RAND_MAX);
+        case 4:
+            return 15.5 + ((float)rand() / (float)RAND_MAX);
+        case 3:
+        default:
+            return -1.0;
+    }
+}
+
 /* Get Temperature sensor */
 /*! This function return the operating information about the addressed
     temperature sensor. The resulting scaled value is stored in the
@@ -1040,26 +1345,126 @@ int getTemp(unsigned char polarization, unsigned char sensor, int currentModule,
             temperature + frontend.cartridge[currentModule].cartridgeTemp[currentCartridgeTempSubsystemModule].offset;
     } else {
         // SIMULATION_MODE
-        switch (sensor) {
-            case 0:
-            case 2:
-            case 5:
-                frontend.cartridge[currentModule].cartridgeTemp[currentCartridgeTempSubsystemModule].temp =
-                    4.0 + ((float)rand() / (float)RAND_MAX) * 0.2;
-                break;
-            case 1:
-                frontend.cartridge[currentModule].cartridgeTemp[currentCartridgeTempSubsystemModule].temp =
-                    110.0 + ((float)rand() / (float)RAND_MAX);
-                break;
-            case 4:
-                frontend.cartridge[currentModule].cartridgeTemp[currentCartridgeTempSubsystemModule].temp =
-                    15.5 + ((float)rand() / (float)RAND_MAX);
-                break;
-            case 3:
-            default:
-                frontend.cartridge[currentModule].cartridgeTemp[currentCartridgeTempSubsystemModule].temp = -1.0;
-                break;
+        frontend.cartridge[currentModule].cartridgeTemp[currentCartridgeTempSubsystemModule].temp =
+            simulatedTemp(sensor);
+    }
+
+    return NO_ERROR;
+}
+
+/* Get all the cartridge temperatures */
+/*! This function reads all the temperature sensors of a cartridge in a single
+    pipelined pass and stores the converted temperatures in the \ref frontend
+    variable through \ref cartridgeTempsConversion.
+
+    The sensors are split between the BIAS modules of the two polarizations,
+    each with its own ADC. In each round one sensor per polarization is
+    monitored:
+        -# Select the monitor point on both modules by writing AREG
+        -# Wait once for the analog multiplexers to settle
+        -# Send the ADC convert strobe to both modules
+        -# Wait for the ADC ready status and read the raw data of each module.
+           The second conversion runs while the first one is being read, so
+           its ready poll normally succeeds at the first attempt.
+
+    This halves the settling waits and ADC polls of six separate \ref getTemp
+    requests.
+
+    \param currentModule    This is the cartridge to monitor.
+    \param sensor           This is the mapping of the cartridge sensors to
+                            the polarization and sensor number in the BIAS
+                            modules, in the same order as the cartridgeTemp
+                            array of the cartridge.
+
+    \return
+        - \ref NO_ERROR         -> if no error occurred
+        - \ref ERROR            -> if something wrong happened. The stored
+                                   temperatures are left untouched.
+        - \ref HARDW_CON_ERR    -> if at least one conversion failed. The
+                                   failed sensors are stored as
+                                   \ref CARTRIDGE_TEMP_CONV_ERR. */
+int getTemps(int currentModule, const TEMP_SENSOR sensor[CARTRIDGE_TEMP_SENSORS_NUMBER]) {
+    /* The sensors still to be read for each polarization */
+    unsigned char pending[POLARIZATIONS_NUMBER][CARTRIDGE_TEMP_SENSORS_NUMBER];
+    unsigned char pendingNumber[POLARIZATIONS_NUMBER] = {0};
+    unsigned char current[POLARIZATIONS_NUMBER];
+    unsigned char round, polarization, temp;
+    float voltage[CARTRIDGE_TEMP_SENSORS_NUMBER];
+    BIAS_AREG_UNION aReg;
+    struct timespec request = {0, 40000};
+
+    if (frontend.mode == SIMULATION_MODE) {
+        for (temp = 0; temp < CARTRIDGE_TEMP_SENSORS_NUMBER; temp++) {
+            frontend.cartridge[currentModule].cartridgeTemp[temp].temp = simulatedTemp(sensor[temp].sensorNumber);
         }
+
+        return NO_ERROR;
+    }
+
+    for (temp = 0; temp < CARTRIDGE_TEMP_SENSORS_NUMBER; temp++) {
+        polarization = sensor[temp].polarization;
+        pending[polarization][pendingNumber[polarization]++] = temp;
+    }
+
+    for (round = 0; (round < pendingNumber[POLARIZATION0]) || (round < pendingNumber[POLARIZATION1]); round++) {
+        /* 1 - Select the monitor point on each module with a sensor left */
+        for (polarization = 0; polarization < POLARIZATIONS_NUMBER; polarization++) {
+            if (round >= pendingNumber[polarization]) {
+                continue;
+            }
+            current[polarization] = pending[polarization][round];
+
+#ifdef DEBUG_BIAS_SERIAL
+            printf("         - Writing AREG (polarization %d, sensor %d)\n", polarization,
+                   sensor[current[polarization]].sensorNumber);
+#endif /* DEBUG_BIAS_SERIAL */
+
+            aReg.integer = 0x0000;
+            aReg.bitField.monitorPoint = BIAS_AREG_CARTRIDGE_TEMP;
+            aReg.bitField.tempSensor = BIAS_AREG_TEMP_SENSOR(sensor[current[polarization]].sensorNumber);
+            biasRegisters[currentModule].aReg.integer = aReg.integer;
+
+            if (serialAccess(BIAS_PARALLEL_WRITE(polarization, BIAS_AREG), &aReg.integer, BIAS_AREG_SIZE,
+                             BIAS_AREG_SHIFT_SIZE, BIAS_AREG_SHIFT_DIR, SERIAL_WRITE, currentModule,
+                             CARTRIDGE_SUBSYSTEM_BIAS) == ERROR) {
+                return ERROR;
+            }
+        }
+
+        /* 2 - One settling wait for both modules */
+        nanosleep(&request, NULL);
+
+        /* 3 - Start both conversions */
+        for (polarization = 0; polarization < POLARIZATIONS_NUMBER; polarization++) {
+            if (round >= pendingNumber[polarization]) {
+                continue;
+            }
+
+            if (serialAccess(BIAS_ADC_CONVERT_STROBE(polarization), NULL, BIAS_ADC_STROBE_SIZE,
+                             BIAS_ADC_STROBE_SHIFT_SIZE, BIAS_ADC_STROBE_SHIFT_DIR, SERIAL_WRITE, currentModule,
+                             CARTRIDGE_SUBSYSTEM_BIAS) == ERROR) {
+                return ERROR;
+            }
+        }
+
+        /* 4 - Read back and scale both results */
+        for (polarization = 0; polarization < POLARIZATIONS_NUMBER; polarization++) {
+            if (round >= pendingNumber[polarization]) {
+                continue;
+            }
+
+            if (biasAdcReadback(currentModule, polarization) == ERROR) {
+                return ERROR;
+            }
+
+            voltage[current[polarization]] =
+                (BIAS_ADC_CART_TEMP_V_SCALE * biasRegisters[currentModule].adcData) / BIAS_ADC_RANGE;
+        }
+    }
+
+    /* 5 - Convert and store all the temperatures */
+    if (cartridgeTempsConversion(currentModule, voltage) == ERROR) {
+        return HARDW_CON_ERR;
     }
 
     return NO_ERROR;
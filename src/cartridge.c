@@ -7,7 +7,9 @@
     This file contains all the functions necessary to handle cartridge events. */
 
 /* Includes */
-#include <stdio.h> /* printf */
+#include <pthread.h>   /* pthread_mutex_t */
+#include <stdatomic.h> /* atomic_compare_exchange_strong */
+#include <stdio.h>     /* printf */
 
 #include "async.h"
 #include "biasSerialInterface.h"
@@ -31,6 +33,34 @@ static HANDLER_INT_INT cartridgeTempSubsystemModulesHandler[CARTRIDGE_TEMP_SUBSY
     cartridgeTempHandler, cartridgeTempHandler, cartridgeTempHandler,
     cartridgeTempHandler, cartridgeTempHandler, cartridgeTempHandler};
 
+/* Legal state transitions performed by cartridgeSetState: bit 'to' is set in
+   the entry of 'from'. The transitions to CARTRIDGE_OFF and CARTRIDGE_ERROR
+   are always allowed and are performed by cartridgeStop and cartridgeFault.
+   The transition from CARTRIDGE_OFF is performed by cartridgePowerOn. */
+#define CARTRIDGE_STATE_BIT(St) (1 << ((St) - CARTRIDGE_ERROR))
+static const unsigned char cartridgeTransitions[CARTRIDGE_STATES_NUMBER] = {
+    0,                                           // CARTRIDGE_ERROR
+    0,                                           // CARTRIDGE_OFF
+    CARTRIDGE_STATE_BIT(CARTRIDGE_INITING),      // CARTRIDGE_ON
+    CARTRIDGE_STATE_BIT(CARTRIDGE_READY),        // CARTRIDGE_INITING
+    CARTRIDGE_STATE_BIT(CARTRIDGE_GO_STANDBY2),  // CARTRIDGE_READY
+    CARTRIDGE_STATE_BIT(CARTRIDGE_READY)};       // CARTRIDGE_GO_STANDBY2
+
+/* The STANDBY2 mode of a cartridge is written together with the transitions
+   from and to CARTRIDGE_OFF and CARTRIDGE_ERROR, holding this lock, so that a
+   power on never sees nor leaves a STANDBY2 mode written by a concurrent stop
+   or fault. */
+static pthread_mutex_t cartridgePowerLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Queue of the cartridges that changed state, consumed by the cartridge async
+   process instead of scanning all the cartridges. */
+static pthread_mutex_t cartridgeEventsLock = PTHREAD_MUTEX_INITIALIZER;
+static struct {
+    unsigned char cartridge[CARTRIDGE_EVENTS_NUMBER];
+    int first;  // Oldest event
+    int count;  // Number of queued events
+} cartridgeEvents;
+
 /* Cartridge handler */
 /*! This function will be called by the CAN message handling subroutine when the
     received message is pertinent to the cartridges. */
@@ -160,6 +190,113 @@ void biasSubsystemHandler(int currentModule) {
     (biasModulesHandler[currentBiasModule])(currentModule, currentBiasModule);
 }
 
+/* Queue a state change for the cartridge async process. If the queue is full
+   the oldest events are replaced by one event for each cartridge, which is
+   equivalent to a full scan. */
+static void cartridgeEventPost(unsigned char cartridge) {
+    int event;
+
+    pthread_mutex_lock(&cartridgeEventsLock);
+    if (cartridgeEvents.count == CARTRIDGE_EVENTS_NUMBER) {
+        for (event = 0; event < CARTRIDGES_NUMBER; event++) {
+            cartridgeEvents.cartridge[event] = event;
+        }
+        cartridgeEvents.first = 0;
+        cartridgeEvents.count = CARTRIDGES_NUMBER;
+    } else {
+        event = (cartridgeEvents.first + cartridgeEvents.count++) % CARTRIDGE_EVENTS_NUMBER;
+        cartridgeEvents.cartridge[event] = cartridge;
+    }
+    pthread_mutex_unlock(&cartridgeEventsLock);
+}
+
+/* Oldest queued state change, -1 if none */
+static int cartridgeEventGet(void) {
+    int cartridge = -1;
+
+    pthread_mutex_lock(&cartridgeEventsLock);
+    if (cartridgeEvents.count) {
+        cartridge = cartridgeEvents.cartridge[cartridgeEvents.first];
+        cartridgeEvents.first = (cartridgeEvents.first + 1) % CARTRIDGE_EVENTS_NUMBER;
+        cartridgeEvents.count--;
+    }
+    pthread_mutex_unlock(&cartridgeEventsLock);
+
+    return cartridge;
+}
+
+/* Cartridge state transition */
+/*! This function atomically moves a cartridge from one state to the next one.
+    The transition only happens if the cartridge is still in the expected
+    state, so that a cartridge stopped by the CAN thread is never brought back
+    by the cartridge async thread, and vice versa. The change is queued for the
+    cartridge async process.
+    \param cartridge   This is the cartridge to change
+    \param from        This is the expected current state
+    \param to          This is the new state
+    \return
+        - \ref TRUE     -> if the state was changed
+        - \ref FALSE    -> if the cartridge was not in the expected state or
+                           the transition is not allowed */
+int cartridgeSetState(int cartridge, int from, int to) {
+    int expected = from;
+
+    if ((from < CARTRIDGE_ERROR) || (from >= CARTRIDGE_STATES_NUMBER + CARTRIDGE_ERROR) ||
+        !(cartridgeTransitions[from - CARTRIDGE_ERROR] & CARTRIDGE_STATE_BIT(to))) {
+        storeError(ERR_CARTRIDGE, ERC_DEBUG_ME);  // Illegal state transition
+        return FALSE;
+    }
+
+    if (!atomic_compare_exchange_strong(&frontend.cartridge[cartridge].state, &expected, to)) {
+        return FALSE;
+    }
+    cartridgeEventPost(cartridge);
+
+    return TRUE;
+}
+
+/* Cartridge power on */
+/*! This function moves a cartridge that is off to the \ref CARTRIDGE_ON state.
+    The STANDBY2 mode is set before the state is published, so that any thread
+    reading \ref CARTRIDGE_ON also reads the new STANDBY2 mode, and only if the
+    cartridge is off, so that it is never changed on a running cartridge.
+    \param cartridge   This is the cartridge to power on
+    \param standby2    TRUE to power on in STANDBY2 mode
+    \return
+        - \ref TRUE     -> if the state was changed
+        - \ref FALSE    -> if the cartridge was not off */
+int cartridgePowerOn(int cartridge, unsigned char standby2) {
+    pthread_mutex_lock(&cartridgePowerLock);
+    if (atomic_load(&frontend.cartridge[cartridge].state) != CARTRIDGE_OFF) {
+        pthread_mutex_unlock(&cartridgePowerLock);
+        return FALSE;
+    }
+    frontend.cartridge[cartridge].standby2 = standby2 ? TRUE : FALSE;
+    atomic_store(&frontend.cartridge[cartridge].state, CARTRIDGE_ON);
+    pthread_mutex_unlock(&cartridgePowerLock);
+    cartridgeEventPost(cartridge);
+
+    return TRUE;
+}
+
+/* Cartridge fault */
+/*! This function puts the cartridge in the error state after a failure to
+    power it off. The cartridge keeps or takes back its slot among the powered
+    cartridges until it is successfully turned off, since its power state is
+    unknown.
+    \param cartridge   This is the cartridge in error
+    \param standby2    This is the STANDBY2 mode of the cartridge before the
+                       failure */
+void cartridgeFault(int cartridge, unsigned char standby2) {
+    pthread_mutex_lock(&cartridgePowerLock);
+    frontend.cartridge[cartridge].standby2 = standby2;
+    if (atomic_exchange(&frontend.cartridge[cartridge].state, CARTRIDGE_ERROR) == CARTRIDGE_OFF) {
+        pdModuleHold(standby2);
+    }
+    pthread_mutex_unlock(&cartridgePowerLock);
+    cartridgeEventPost(cartridge);
+}
+
 /* Cartridge stop */
 /*! This function performs the operations necessary to shut down a cartidge.
     \param cartridge    This is the selected cartridge to power off
@@ -171,11 +308,20 @@ int cartridgeStop(unsigned char cartridge) {
     printf("- Shutting down cartridge %d...\n", cartridge);
 #endif  // DEBUG_INIT
 
-    /* Change the state of the addressed cartridge to OFF */
-    frontend.cartridge[cartridge].state = CARTRIDGE_OFF;
+    /* Change the state of the addressed cartridge to OFF. Only the thread that
+       actually stops the cartridge returns its slot. */
+    pthread_mutex_lock(&cartridgePowerLock);
+    if (atomic_exchange(&frontend.cartridge[cartridge].state, CARTRIDGE_OFF) != CARTRIDGE_OFF) {
+        pdModuleRelease(frontend.cartridge[cartridge].standby2);
+        cartridgeEventPost(cartridge);
+    }
 
     /* Force clear STANDBY2 mode */
     frontend.cartridge[cartridge].standby2 = FALSE;
+    pthread_mutex_unlock(&cartridgePowerLock);
+
+    /* Discard the cached temperatures */
+    cartridgeTempsInvalidate(cartridge);
 
 #ifdef DEBUG_INIT
     printf("  done!\n\n");
@@ -502,9 +648,19 @@ int cartridgeAsync(void) {
         ASYNC_CARTRIDGE_GO_STANDBY2
     } asyncCartridgeTask = ASYNC_CARTRIDGE_IDLE;
 
+    /* A temporary variable for the queued state changes */
+    int cartridge;
+
     /* Switch depending on the cartridge task */
     switch (asyncCartridgeTask) {
         case ASYNC_CARTRIDGE_IDLE:
+            // Get the next cartridge that changed state
+            cartridge = cartridgeEventGet();
+            if (cartridge < 0) {
+                return ASYNC_DONE;
+            }
+            currentAsyncCartridge = cartridge;
+
             // Check if the cartridge was turned on
             if (frontend.cartridge[currentAsyncCartridge].state == CARTRIDGE_ON) {
                 // If CARTRIDGE_ON, then next task is initialization
@@ -521,7 +677,7 @@ int cartridgeAsync(void) {
                 // Stay with this cartridge
                 return NO_ERROR;
             }
-            break;
+            return NO_ERROR;
 
         case ASYNC_CARTRIDGE_INIT:
             /* Initialize cartridge and switch on result */
@@ -546,10 +702,10 @@ int cartridgeAsync(void) {
                            module that there was an urecoverable error with the
                            initialization and allow for a restart of the cartridge. */
                         /* Store the Error state in the last control message variable */
-                        frontend.powerDistribution.pdModule[currentAsyncCartridge].lastEnable.status = ERROR;
+                        frontend.powerDistribution.lastControl.pdModuleEnable[currentAsyncCartridge].status = ERROR;
 
                         /* Set the state of the cartridge to 'error' */
-                        frontend.cartridge[currentAsyncCartridge].state = CARTRIDGE_ERROR;
+                        cartridgeFault(currentAsyncCartridge, frontend.cartridge[currentAsyncCartridge].standby2);
 
                         /* Next state: IDLE */
                         asyncCartridgeTask = ASYNC_CARTRIDGE_IDLE;
@@ -557,15 +713,12 @@ int cartridgeAsync(void) {
                                 //        so none of the next steps execute.
                     }
 
-                    /*  If it worked. Mark the catridge as off. */
+                    /*  If it worked. Mark the catridge as off and return its slot. */
                     if (cartridgeStop(currentAsyncCartridge) == ERROR) {
                         /* Store the Error state in the last control message variable */
-                        frontend.powerDistribution.pdModule[currentAsyncCartridge].lastEnable.status = ERROR;
+                        frontend.powerDistribution.lastControl.pdModuleEnable[currentAsyncCartridge].status = ERROR;
                     }
 
-                    /* Decrease the number of currently turned on cartridges. */
-                    frontend.powerDistribution.poweredModules--;
-
 #ifdef DEBUG_POWERDIS
                     printPoweredModuleCounts();
 #endif /* DEBUG_POWERDIS */
@@ -597,14 +750,8 @@ int cartridgeAsync(void) {
             break;
     }
 
-    /* Next cartridge, if wrap around, then we are done with cartridges. */
-    if (++currentAsyncCartridge == CARTRIDGES_NUMBER) {
-        currentAsyncCartridge = 0;
-
-        /* If all the cartrdiges have been handled then we are done */
-        return ASYNC_DONE;
-    }
-    return NO_ERROR;
+    /* Done with this cartridge */
+    return ASYNC_DONE;
 }
 
 /* Asynchronously initialize a cartridge */
@@ -634,7 +781,10 @@ int asyncCartridgeInit(int currentModule) {
     switch (asyncCartridgeInitState) {
         case ASYNC_CARTRIDGE_INIT_SET_WAIT:
             /* Set the state of the cartridge to 'initializing' */
-            frontend.cartridge[currentModule].state = CARTRIDGE_INITING;
+            if (!cartridgeSetState(currentModule, CARTRIDGE_ON, CARTRIDGE_INITING)) {
+                /* Turned off in the meantime */
+                return ASYNC_DONE;
+            }
 
             /* Setup timer to wait before initializing the cartridge */
             if (startAsyncTimer(TIMER_CARTRIDGE_INIT, TIMER_TO_CARTRIDGE_INIT, FALSE) == ERROR) {
@@ -675,14 +825,15 @@ int asyncCartridgeInit(int currentModule) {
         case ASYNC_CARTRIDGE_INIT_INIT:
             /* Perform the actual initialization */
             if (cartridgeInit(currentModule) == ERROR) {
-                /* Set next state */
-                asyncCartridgeInitState = ASYNC_CARTRIDGE_INIT_INIT;
+                /* Next state: start state, the cartridge is turned off */
+                asyncCartridgeInitState = ASYNC_CARTRIDGE_INIT_SET_WAIT;
 
                 return ERROR;
             }
 
-            /* Set the state of the cartridge to 'ready' */
-            frontend.cartridge[currentModule].state = CARTRIDGE_READY;
+            /* Set the state of the cartridge to 'ready', unless it was turned
+               off in the meantime */
+            cartridgeSetState(currentModule, CARTRIDGE_INITING, CARTRIDGE_READY);
 
             /* Next state: start state */
             asyncCartridgeInitState = ASYNC_CARTRIDGE_INIT_SET_WAIT;
@@ -699,97 +850,36 @@ int asyncCartridgeInit(int currentModule) {
 }
 
 // Asynchronously set a cartridge to STANDBY2 mode:
+/*! Every other cartridge waiting to enter STANDBY2 is handled in the same
+    pass, so that the bias writes of all of them are sent as one list. The
+    events queued for the others find them READY and are ignored. */
 int asyncCartridgeGoStandby2(int currentModule) {
-    // Check if the cartridge was turned off in the meantime
-    if (frontend.cartridge[currentModule].state == CARTRIDGE_OFF) {
+    int cartridge[CARTRIDGES_NUMBER];
+    int cartridgesNumber = 0;
+    int c, ret;
+
+    // Collect the cartridges still waiting, unless they were turned off in the meantime
+    for (c = 0; c < CARTRIDGES_NUMBER; c++) {
+        if (frontend.cartridge[c].state == CARTRIDGE_GO_STANDBY2) {
+            cartridge[cartridgesNumber++] = c;
+        }
+    }
+    if (cartridgesNumber == 0) {
         // Cartridge was turned off so nothing else to do
         return ASYNC_DONE;
     }
 
-    LATCH_DEBUG_SERIAL_WRITE = 1;
-
-    int currentBiasModule = POLARIZATION0;
-    int currentPolarizationModule = SIDEBAND0;
-    lnaGoStandby2();
-
-    LATCH_DEBUG_SERIAL_WRITE = 1;
-
-    currentBiasModule = POLARIZATION0;
-    currentPolarizationModule = SIDEBAND1;
-    lnaGoStandby2();
-
-    LATCH_DEBUG_SERIAL_WRITE = 1;
-
-    currentBiasModule = POLARIZATION1;
-    currentPolarizationModule = SIDEBAND0;
-    lnaGoStandby2();
-
-    LATCH_DEBUG_SERIAL_WRITE = 1;
-
-    currentBiasModule = POLARIZATION1;
-    currentPolarizationModule = SIDEBAND1;
-    lnaGoStandby2();
-
-    LATCH_DEBUG_SERIAL_WRITE = 1;
-
-    currentBiasModule = POLARIZATION0;
-    currentPolarizationModule = SIDEBAND0;
-    sisGoStandby2(currentModule, currentBiasModule, currentPolarizationModule);
-
-    LATCH_DEBUG_SERIAL_WRITE = 1;
+    // Disable the LNAs and LNA LEDs and zero the SIS and SIS magnets:
+    ret = setBiasStandby2(cartridge, cartridgesNumber);
 
-    currentBiasModule = POLARIZATION0;
-    currentPolarizationModule = SIDEBAND1;
-    sisGoStandby2(currentModule, currentBiasModule, currentPolarizationModule);
+#ifdef DEBUG_GO_STANDBY2
+    if (ret) printf(" -- ret=%d\n", ret);
+#endif  // DEBUG_GO_STANDBY2
 
-    LATCH_DEBUG_SERIAL_WRITE = 1;
-
-    currentBiasModule = POLARIZATION1;
-    currentPolarizationModule = SIDEBAND0;
-    sisGoStandby2(currentModule, currentBiasModule, currentPolarizationModule);
-
-    LATCH_DEBUG_SERIAL_WRITE = 1;
-
-    currentBiasModule = POLARIZATION1;
-    currentPolarizationModule = SIDEBAND1;
-    sisGoStandby2(currentModule, currentBiasModule, currentPolarizationModule);
-
-    LATCH_DEBUG_SERIAL_WRITE = 1;
-
-    currentBiasModule = POLARIZATION0;
-    currentPolarizationModule = SIDEBAND0;
-    sisMagnetGoStandby2(currentModule, currentBiasModule, currentPolarizationModule);
-
-    LATCH_DEBUG_SERIAL_WRITE = 1;
-
-    currentBiasModule = POLARIZATION0;
-    currentPolarizationModule = SIDEBAND1;
-    sisMagnetGoStandby2(currentModule, currentBiasModule, currentPolarizationModule);
-
-    LATCH_DEBUG_SERIAL_WRITE = 1;
-
-    currentBiasModule = POLARIZATION1;
-    currentPolarizationModule = SIDEBAND0;
-    sisMagnetGoStandby2(currentModule, currentBiasModule, currentPolarizationModule);
-
-    LATCH_DEBUG_SERIAL_WRITE = 1;
-
-    currentBiasModule = POLARIZATION1;
-    currentPolarizationModule = SIDEBAND1;
-    sisMagnetGoStandby2(currentModule, currentBiasModule, currentPolarizationModule);
-
-    LATCH_DEBUG_SERIAL_WRITE = 1;
-
-    currentBiasModule = POLARIZATION0;
-    lnaLedGoStandby2(currentModule, currentBiasModule, currentPolarizationModule);
-
-    LATCH_DEBUG_SERIAL_WRITE = 1;
-
-    currentBiasModule = POLARIZATION1;
-    lnaLedGoStandby2(currentModule, currentBiasModule, currentPolarizationModule);
-
-    // Set the state of the cartridge to READY:
-    frontend.cartridge[currentModule].state = CARTRIDGE_READY;
+    // Set the state of the cartridges to READY, unless they were turned off in the meantime:
+    for (c = 0; c < cartridgesNumber; c++) {
+        cartridgeSetState(cartridge[c], CARTRIDGE_GO_STANDBY2, CARTRIDGE_READY);
+    }
 
-    return ASYNC_DONE;
+    return (ret == ERROR) ? ERROR : ASYNC_DONE;
 }
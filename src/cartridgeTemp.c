@@ -8,7 +8,9 @@
     temperature sensors events. */
 
 /* Includes */
+#include <pthread.h>
 #include <stdio.h> /* printf */
+#include <time.h>  /* clock_gettime */
 
 #include "biasSerialInterface.h"
 #include "debug.h"
@@ -33,6 +35,11 @@ static TEMP_SENSOR temperatureSensor[CARTRIDGE_TEMP_SENSORS_NUMBER][CARTRIDGES_N
      {{P1, S2}, {P1, S2}, {P1, S2}, {P1, S2}, {P1, S2}, {P1, S2}, {P1, S2}, {P1, S2}, {P1, S2}, {P1, S2}}};  // Mixer
                                                                                                              // Pol1
 
+/* Time (ms) of the last complete temperature sweep of each cartridge. 0 if the
+   cached temperatures are not valid. */
+static double cartridgeTempsTime[CARTRIDGES_NUMBER];
+static pthread_mutex_t cartridgeTempsLock = PTHREAD_MUTEX_INITIALIZER;
+
 /* Cartridge Temperature sensors handler */
 /*! This function will be called by the CAN message handling subroutine when the
     received message is pertinent to the cartridges temperature sensors. */
@@ -65,13 +72,16 @@ void cartTempOffsetHandler(int currentModule, int currentCartridgeTempSubsystemM
     if (CAN_SIZE) {
         // save the incoming message:
         SAVE_LAST_CONTROL_MESSAGE(
-            frontend.cartridge[currentModule].cartridgeTemp[currentCartridgeTempSubsystemModule].lastOffset)
+            frontend.cartridge[currentModule].lastControl.cartridgeTempOffset[currentCartridgeTempSubsystemModule])
 
         /* Extract the floating data from the CAN message */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
 
         /* Save the new value */
         frontend.cartridge[currentModule].cartridgeTemp[currentCartridgeTempSubsystemModule].offset = CONV_FLOAT;
+
+        /* The cached temperatures include the old offset */
+        cartridgeTempsInvalidate(currentModule);
         /* If everything went fine, it's a control message, we're done. */
         return;
     }
@@ -80,7 +90,7 @@ void cartTempOffsetHandler(int currentModule, int currentCartridgeTempSubsystemM
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
         RETURN_LAST_CONTROL_MESSAGE(
-            frontend.cartridge[currentModule].cartridgeTemp[currentCartridgeTempSubsystemModule].lastOffset)
+            frontend.cartridge[currentModule].lastControl.cartridgeTempOffset[currentCartridgeTempSubsystemModule])
         return;
     }
 
@@ -95,6 +105,48 @@ void cartTempOffsetHandler(int currentModule, int currentCartridgeTempSubsystemM
     CAN_SIZE = CAN_FLOAT_SIZE;
 }
 
+/* Current time for the temperatures cache in ms */
+static double cartridgeTempsNow(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+/* Refresh the cached temperatures of the cartridge if older than
+   CARTRIDGE_TEMP_CACHE_AGE. On hardware error the cache stays invalid and the
+   last read values are left in the frontend variable. */
+static void cartridgeTempsRefresh(int currentModule) {
+    TEMP_SENSOR sensor[CARTRIDGE_TEMP_SENSORS_NUMBER];
+    double now;
+    int temp;
+
+    pthread_mutex_lock(&cartridgeTempsLock);
+
+    now = cartridgeTempsNow();
+    if ((cartridgeTempsTime[currentModule] == 0.0) ||
+        (now - cartridgeTempsTime[currentModule] > CARTRIDGE_TEMP_CACHE_AGE)) {
+        for (temp = 0; temp < CARTRIDGE_TEMP_SENSORS_NUMBER; temp++) {
+            sensor[temp] = temperatureSensor[temp][currentModule];
+        }
+
+        cartridgeTempsTime[currentModule] = (getTemps(currentModule, sensor) == ERROR) ? 0.0 : now;
+    }
+
+    pthread_mutex_unlock(&cartridgeTempsLock);
+}
+
+/* Invalidate the cached temperatures */
+/*! This function discards the cached temperatures of a cartridge so that the
+    next temperature monitor request reads all the sensors again. It is called
+    when the cartridge is powered off and when a sensor offset is changed.
+    \param currentModule    This is the cartridge whose cache is discarded. */
+void cartridgeTempsInvalidate(int currentModule) {
+    pthread_mutex_lock(&cartridgeTempsLock);
+    cartridgeTempsTime[currentModule] = 0.0;
+    pthread_mutex_unlock(&cartridgeTempsLock);
+}
+
 /* Temperature Value Handler */
 void cartTempHandler(int currentModule, int currentCartridgeTempSubsystemModule) {
 #ifdef DEBUG
@@ -123,13 +175,16 @@ void cartTempHandler(int currentModule, int currentCartridgeTempSubsystemModule)
            temperatureSensor[currentCartridgeTempSubsystemModule][currentModule].sensorNumber);
 #endif /* DEBUG */
 
-    /* Monitor the temperature sensor */
-    getTemp(temperatureSensor[currentCartridgeTempSubsystemModule][currentModule].polarization,
-            temperatureSensor[currentCartridgeTempSubsystemModule][currentModule].sensorNumber, currentModule,
-            currentCartridgeTempSubsystemModule);
+    /* Serve the temperature from the last sweep of the cartridge if recent
+       enough, otherwise read all the sensors in one pass. */
+    cartridgeTempsRefresh(currentModule);
 
-    /* If error during monitoring, the error state was stored in the outgoing CAN message during by getTemp().
-       Whether or not an error occurred, store the last read value in the outgoing message: */
+    /* Whether or not an error occurred, store the last read value in the outgoing message. A sensor outside
+       the calibration curve is notified as a conversion error. */
+    if (frontend.cartridge[currentModule].cartridgeTemp[currentCartridgeTempSubsystemModule].temp ==
+        CARTRIDGE_TEMP_CONV_ERR) {
+        CAN_STATUS = HARDW_CON_ERR;
+    }
     CONV_FLOAT = frontend.cartridge[currentModule].cartridgeTemp[currentCartridgeTempSubsystemModule].temp;
 
     /* Load the CAN message payload with the returned value and set the
@@ -226,6 +226,9 @@ int cryostatStartup(void) {
 
         /* Initialize next coeff to read to zero */
         frontend.cryostat.cryostatTemp[sensor].nextCoeff = 0;
+
+        /* Compile the sensor evaluator */
+        cryostatTempCompile(sensor);
     }
 
     /* The vaccum controller power up state is ON. This allows to monitor the
@@ -339,7 +342,7 @@ void coldHeadHoursHandler(int currentCryostatModule) {
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.lastColdHeadHours)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.lastControl.coldHeadHours)
 
         /* Extract the unsigned int from the CAN message. */
         changeEndianInt(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -360,7 +363,7 @@ void coldHeadHoursHandler(int currentCryostatModule) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.lastColdHeadHours)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.lastControl.coldHeadHours)
         return;
     }
 
@@ -459,6 +462,8 @@ int cryostatAsync(void) {
             /* Next sensor, if wrap around, then next monitor next thing */
             if (++currentAsyncVacuumControllerModule == VACUUM_SENSORS_NUMBER) {
                 currentAsyncVacuumControllerModule -= VACUUM_SENSORS_NUMBER;
+                /* Convert all the temperatures and pressures of the sweep in one pass */
+                cryostatSweepUpdate();
                 asyncCryoGetState = ASYNC_CRYO_GET_230V;
             }
 
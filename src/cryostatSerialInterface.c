@@ -19,8 +19,7 @@
 /* Includes */
 #include "cryostatSerialInterface.h"
 
-#include <errno.h>  /* errno */
-#include <math.h>   /* pow */
+#include <math.h>   /* ldexp, isfinite */
 #include <stddef.h> /* NULL */
 #include <stdio.h>  /* printf */
 #include <unistd.h>
@@ -39,6 +38,13 @@
 /* Statics */
 CRYO_REGISTERS cryoRegisters;
 
+/* Voltages read from the temperature and vacuum sensors during the current
+   sweep, not yet converted. See cryostatSweepUpdate. */
+static float sweepTempVin[CRYOSTAT_TEMP_SENSORS_NUMBER];
+static unsigned char sweepTempRead[CRYOSTAT_TEMP_SENSORS_NUMBER];
+static float sweepPressVin[VACUUM_SENSORS_NUMBER];
+static unsigned char sweepPressRead[VACUUM_SENSORS_NUMBER];
+
 /* CRYO analog monitor request core.
    This function performs the core operation that are common to all the analog
    monitor requests for the CRYO module:
@@ -610,25 +616,23 @@ int setSolenoidValveState(unsigned char state) {
 }
 
 /* Get vacuum sensor */
-/*! This function returns the pressure of the vacuum sensor. The resulting
-    scaled value is stored in the frontend status structure.
+/*! This function reads the voltage of the vacuum sensor. The voltages of the
+    whole sweep are converted to pressures together by
+    \ref cryostatSweepUpdate.
 
     This function performs the following operations:
         -# Select the desired monitor point by:
             - updating AREG
         -# Execute the core set of functions common to all the analog monitor
            requests for the cryostat module (verify that this is true)
-        -# Scale the raw binary data to with the correct unit and store the
-           result in the \ref frontend variable
+        -# Scale the raw binary data to a voltage and keep it for the
+           conversion at the end of the sweep
 
     \return
         - \ref NO_ERROR     -> if no error occurred
         - \ref ERROR        -> if something wrong happened
         - \ref ASYNC_DONE   -> if the async measurement is completed */
 int getVacuumSensor(int currentAsyncVacuumControllerModule) {
-    /* A float to hold the voltage in and a temp */
-    float vin = 0.0, pressure = 0.0;
-
     if (frontend.mode != SIMULATION_MODE) {
         /* Clear the CRYO AREG */
         cryoRegisters.aReg.integer = 0x0000;
@@ -653,31 +657,11 @@ int getVacuumSensor(int currentAsyncVacuumControllerModule) {
         }
 
         /* 6 - Scale the data */
-        /* Scale the input voltage to the right value: vin=10*(adcData/65536) */
-        vin = (CRYO_ADC_VOLTAGE_IN_SCALE * cryoRegisters.adcData) / CRYO_ADC_RANGE;
-        switch (currentAsyncVacuumControllerModule) {
-            case CRYOSTAT_PRESSURE:
-                /* The cryostat pressure is given by: 10^[(vin-7.75)/0.75] */
-                pressure = pow(10.0, (vin + CRYO_ADC_CRYO_PRESS_OFFSET) / CRYO_ADC_CRYO_PRESS_SCALE);
-                break;
-            case VACUUM_PORT_PRESSURE:
-                /* The vacuum port pressure is given by: 10^[(vin-6.143)/1.286] */
-                pressure = pow(10.0, (vin + CRYO_ADC_VAC_PORT_PRESS_OFFSET) / CRYO_ADC_VAC_PORT_PRESS_SCALE);
-                break;
-            default:
-                break;
-        }
-
-        /* Check if a domain error occurred while evaluating the pow. */
-        if (errno == EDOM) {
-            frontend.cryostat.vacuumController.vacuumSensor[currentAsyncVacuumControllerModule].pressure =
-                CRYOSTAT_PRESS_CONV_ERR;
-
-            return ERROR;
-        }
-
-        /* Store the data */
-        frontend.cryostat.vacuumController.vacuumSensor[currentAsyncVacuumControllerModule].pressure = pressure;
+        /* Scale the input voltage to the right value: vin=10*(adcData/65536)
+           and keep it for the conversion at the end of the sweep. */
+        sweepPressVin[currentAsyncVacuumControllerModule] =
+            (CRYO_ADC_VOLTAGE_IN_SCALE * cryoRegisters.adcData) / CRYO_ADC_RANGE;
+        sweepPressRead[currentAsyncVacuumControllerModule] = TRUE;
     } else {
         // SIMULATION_MODE
         frontend.cryostat.vacuumController.vacuumSensor[currentAsyncVacuumControllerModule].pressure = 0.0000005;
@@ -765,18 +749,284 @@ int getVacuumControllerState(void) {
     return NO_ERROR;
 }
 
+/* TVO sensors evaluators */
+/* The fitting coefficients of each TVO sensor stored in Horner order (highest
+   degree first). They are stored by coefficient rather than by sensor so that
+   the batch conversion can evaluate all the sensors in the same pass. The
+   evaluators are compiled by cryostatTempCompile() every time the
+   coefficients of a sensor change. */
+static double tvoHorner[TVO_COEFFS_NUMBER][TVO_SENSORS_NUMBER];
+
+/* TVO sensor gain */
+/* This function returns the TVO voltage to resistance gain for the current
+   hardware revision. */
+static float tvoGain(void) {
+    switch (frontend.cryostat.hardwRevision) {
+        case CRYO_HRDW_REV0:
+            return TVO_GAIN_REV0;
+        case CRYO_HRDW_REV1:
+            return TVO_GAIN_REV1;
+        default:
+            return TVO_GAIN_REV1;
+    }
+}
+
+/* PRT standard curves coefficients in Horner order (highest degree first) */
+static const double prtCurveA[PRT_COEFFS_NUMBER] = {PRT_A6, PRT_A5, PRT_A4, PRT_A3, PRT_A2, PRT_A1, PRT_A0};
+static const double prtCurveB[PRT_COEFFS_NUMBER] = {PRT_B6, PRT_B5, PRT_B4, PRT_B3, PRT_B2, PRT_B1, PRT_B0};
+
+/* PRT temperature conversion */
+/* This function evaluates the standard PRT curves for the given sensor
+   voltage. */
+static double prtTempConversion(float vin) {
+    const double *curve;
+    double temperature;
+    unsigned char coeff;
+
+    /* Find the sensor resistance */
+    float resistance = PRT_GAIN * vin;
+
+    /* Select the curve */
+    if (resistance >= PRT_A_SCALE) {
+        resistance = resistance / PRT_B_SCALE;
+        curve = prtCurveB;
+    } else {
+        resistance = resistance / PRT_A_SCALE;
+        curve = prtCurveA;
+    }
+
+    /* Apply the interpolation */
+    temperature = curve[0];
+    for (coeff = 1; coeff < PRT_COEFFS_NUMBER; coeff++) {
+        temperature = temperature * resistance + curve[coeff];
+    }
+
+    return temperature;
+}
+
+/* Cryostat temperature evaluator compilation */
+/*! This function compiles the evaluator of a TVO sensor from the fitting
+    coefficients currently stored in the \ref frontend variable. It has to be
+    called every time the coefficients of the sensor are changed, either when
+    loaded from the configuration file or by a control message.
+
+    \param sensor   This is the TVO sensor (0-8) */
+void cryostatTempCompile(int sensor) {
+    unsigned char coeff;
+
+    if (sensor >= TVO_SENSORS_NUMBER) {
+        return;
+    }
+
+    for (coeff = 0; coeff < TVO_COEFFS_NUMBER; coeff++) {
+        tvoHorner[coeff][sensor] = frontend.cryostat.cryostatTemp[sensor].coeff[TVO_COEFFS_NUMBER - 1 - coeff];
+    }
+}
+
+/* Cryostat temperature conversion */
+/*! This function converts the voltage read from a cryostat temperature sensor
+    into a temperature. The TVO sensors use the evaluators compiled by
+    \ref cryostatTempCompile from the fitting coefficients, the PRT sensors the
+    standard curves.
+
+    \param sensor   This is the cryostat temperature sensor (0-12)
+    \param vin      This is the scaled ADC input voltage
+
+    \return
+        - The temperature in K. A voltage outside the domain of the sensor
+          curve returns a non finite value. */
+float cryostatTempConversion(int sensor, float vin) {
+    float resistance;
+    double temperature;
+    unsigned char coeff;
+
+    if (sensor < TVO_SENSORS_NUMBER) {
+        /* Find the sensor resistance and apply the interpolation */
+        resistance = TVO_RESISTOR_SCALE / (tvoGain() * vin);
+        temperature = tvoHorner[0][sensor];
+        for (coeff = 1; coeff < TVO_COEFFS_NUMBER; coeff++) {
+            temperature = temperature * resistance + tvoHorner[coeff][sensor];
+        }
+
+        return temperature;
+    }
+
+    if (sensor < CRYOSTAT_TEMP_SENSORS_NUMBER) {
+        return prtTempConversion(vin);
+    }
+
+    return 0.0;
+}
+
+/* Cryostat temperatures batch conversion */
+/*! This function converts the voltages read from all the cryostat temperature
+    sensors in a single call. The TVO polynomials are evaluated for all the
+    sensors in the same loop so that the compiler can vectorize them. Sensors
+    whose conversion doesn't return a finite value are reported as
+    \ref CRYOSTAT_TEMP_CONV_ERR.
+
+    \param vin          These are the scaled ADC input voltages, indexed by
+                        sensor number (0-12)
+    \param temperature  This is where the temperatures in K are returned
+
+    \return
+        - \ref NO_ERROR -> if all the sensors were converted
+        - \ref ERROR    -> if at least one conversion failed */
+int cryostatTempsConversion(const float vin[CRYOSTAT_TEMP_SENSORS_NUMBER],
+                            float temperature[CRYOSTAT_TEMP_SENSORS_NUMBER]) {
+    float gain = tvoGain(), resistance[TVO_SENSORS_NUMBER];
+    double tvoTemp[TVO_SENSORS_NUMBER];
+    unsigned char sensor, coeff;
+    int ret = NO_ERROR;
+
+    /* Evaluate all the TVO sensors together */
+    for (sensor = 0; sensor < TVO_SENSORS_NUMBER; sensor++) {
+        resistance[sensor] = TVO_RESISTOR_SCALE / (gain * vin[sensor]);
+        tvoTemp[sensor] = tvoHorner[0][sensor];
+    }
+    for (coeff = 1; coeff < TVO_COEFFS_NUMBER; coeff++) {
+        for (sensor = 0; sensor < TVO_SENSORS_NUMBER; sensor++) {
+            tvoTemp[sensor] = tvoTemp[sensor] * resistance[sensor] + tvoHorner[coeff][sensor];
+        }
+    }
+    for (sensor = 0; sensor < TVO_SENSORS_NUMBER; sensor++) {
+        temperature[sensor] = tvoTemp[sensor];
+    }
+
+    /* Then the PRT sensors */
+    for (sensor = TVO_SENSORS_NUMBER; sensor < CRYOSTAT_TEMP_SENSORS_NUMBER; sensor++) {
+        temperature[sensor] = prtTempConversion(vin[sensor]);
+    }
+
+    /* Flag the failed conversions */
+    for (sensor = 0; sensor < CRYOSTAT_TEMP_SENSORS_NUMBER; sensor++) {
+        if (!isfinite(temperature[sensor])) {
+            temperature[sensor] = CRYOSTAT_TEMP_CONV_ERR;
+            ret = ERROR;
+        }
+    }
+
+    return ret;
+}
+
+/* Fast power of 10 */
+/* This function evaluates 10^x without the cost of pow(). The
+   argument is reduced to 2^n * 2^f with n integer and |f| <= 0.5, 2^f is
+   evaluated with its degree 7 Taylor polynomial and the result is scaled by
+   2^n. The relative error is below CRYO_PRESS_EXP10_MAX_ERR over the whole
+   range of the vacuum sensors inputs. */
+static double fastExp10(double x) {
+    /* Coefficients of 2^f = e^(f*ln2) in Horner order */
+    static const double exp2Poly[] = {1.5252733804059838e-05, 0.00015403530393381606, 0.0013333558146428441,
+                                      0.0096181291076284769, 0.055504108664821576, 0.24022650695910069,
+                                      0.69314718055994529, 1.0};
+    double y = x * 3.32192809488736234787;  // log2(10)
+    double result;
+    unsigned char coeff;
+    int n;
+
+    /* Split the exponent */
+    n = (int)(y < 0.0 ? y - 0.5 : y + 0.5);
+    y -= n;
+
+    /* Evaluate the fractional part */
+    result = exp2Poly[0];
+    for (coeff = 1; coeff < sizeof(exp2Poly) / sizeof(exp2Poly[0]); coeff++) {
+        result = result * y + exp2Poly[coeff];
+    }
+
+    return ldexp(result, n);
+}
+
+/* Cryostat pressure conversion */
+/*! This function converts the voltage read from a vacuum sensor into a
+    pressure, using the fast power of 10 evaluation.
+
+    \param sensor   This is the vacuum sensor:
+                        - \ref CRYOSTAT_PRESSURE
+                        - \ref VACUUM_PORT_PRESSURE
+    \param vin      This is the scaled ADC input voltage
+
+    \return
+        - The pressure in mbar */
+float cryostatPressureConversion(int sensor, float vin) {
+    switch (sensor) {
+        case CRYOSTAT_PRESSURE:
+            /* The cryostat pressure is given by: 10^[(vin-7.75)/0.75] */
+            return fastExp10((vin + CRYO_ADC_CRYO_PRESS_OFFSET) / CRYO_ADC_CRYO_PRESS_SCALE);
+        case VACUUM_PORT_PRESSURE:
+            /* The vacuum port pressure is given by: 10^[(vin-6.143)/1.286] */
+            return fastExp10((vin + CRYO_ADC_VAC_PORT_PRESS_OFFSET) / CRYO_ADC_VAC_PORT_PRESS_SCALE);
+        default:
+            return 0.0;
+    }
+}
+
+/* Cryostat pressures batch conversion */
+/*! This function converts the voltages read from all the vacuum sensors in a
+    single call. It has the same interface as \ref cryostatTempsConversion.
+    Sensors whose conversion doesn't return a finite value are reported as
+    \ref CRYOSTAT_PRESS_CONV_ERR.
+
+    \param vin          These are the scaled ADC input voltages, indexed by
+                        sensor number
+    \param pressure     This is where the pressures in mbar are returned
+
+    \return
+        - \ref NO_ERROR -> if all the sensors were converted
+        - \ref ERROR    -> if at least one conversion failed */
+int cryostatPressuresConversion(const float vin[VACUUM_SENSORS_NUMBER], float pressure[VACUUM_SENSORS_NUMBER]) {
+    unsigned char sensor;
+    int ret = NO_ERROR;
+
+    for (sensor = 0; sensor < VACUUM_SENSORS_NUMBER; sensor++) {
+        pressure[sensor] = cryostatPressureConversion(sensor, vin[sensor]);
+
+        if (!isfinite(pressure[sensor])) {
+            pressure[sensor] = CRYOSTAT_PRESS_CONV_ERR;
+            ret = ERROR;
+        }
+    }
+
+    return ret;
+}
+
+/* Cryostat sweep conversion */
+/*! This function converts a full sweep of the cryostat temperature and
+    vacuum sensors in one pass.
+
+    \param tempVin      These are the temperature sensors input voltages
+    \param pressVin     These are the vacuum sensors input voltages
+    \param temperature  This is where the temperatures in K are returned
+    \param pressure     This is where the pressures in mbar are returned
+
+    \return
+        - \ref NO_ERROR -> if all the sensors were converted
+        - \ref ERROR    -> if at least one conversion failed */
+int cryostatSweepConversion(const float tempVin[CRYOSTAT_TEMP_SENSORS_NUMBER],
+                            const float pressVin[VACUUM_SENSORS_NUMBER], float temperature[CRYOSTAT_TEMP_SENSORS_NUMBER],
+                            float pressure[VACUUM_SENSORS_NUMBER]) {
+    int ret = cryostatTempsConversion(tempVin, temperature);
+
+    if (cryostatPressuresConversion(pressVin, pressure) == ERROR) {
+        ret = ERROR;
+    }
+
+    return ret;
+}
+
 /* Get cryostat temperature */
-/*! This function returns the temperature mesured by the currently addressed
-    cryostat temperature sensor. The resulting scaled value is stored in the
-    frontend status structure.
+/*! This function reads the voltage of the currently addressed cryostat
+    temperature sensor. The voltages of the whole sweep are converted to
+    temperatures together by \ref cryostatSweepUpdate.
 
     This function performs the following operations:
         -# Select the desired monitor point by:
             - updating AREG
         -# Execute the core set of functions common to all the analog monitor
            requests for the cryostat module
-        -# Scale the raw binary data to with the correct unit and store the
-           result in the \ref frontend variable
+        -# Scale the raw binary data to a voltage and keep it for the
+           conversion at the end of the sweep
 
     \return
         - \ref NO_ERROR     -> if no error occurred
@@ -784,9 +1034,6 @@ int getVacuumControllerState(void) {
         - \ref ASYNC_DONE   -> if the async measurement is completed */
 
 int getCryostatTemp(int currentAsyncCryoTempModule) {
-    /* Floats to help perform the temperature evaluation */
-    float vin = 0.0, resistance = 0.0, temperature = 0.0;
-
     if (frontend.mode != SIMULATION_MODE) {
         /* Clear the CRYO AREG */
         cryoRegisters.aReg.integer = 0x0000;
@@ -811,83 +1058,11 @@ int getCryostatTemp(int currentAsyncCryoTempModule) {
         }
 
         /* 6 - Scale the data */
-        /* Scale the input voltage to the right value: vin=10*(adcData/65536) */
-        vin = (CRYO_ADC_VOLTAGE_IN_SCALE * cryoRegisters.adcData) / CRYO_ADC_RANGE;
-
-        switch (currentAsyncCryoTempModule) {
-            case CRYOCOOLER_4K:
-            case PLATE_4K_NEAR_LINK1:
-            case PLATE_4K_NEAR_LINK2:
-            case PLATE_4K_FAR_SIDE1:
-            case PLATE_4K_FAR_SIDE2:
-            case CRYOCOOLER_12K:
-            case PLATE_12K_NEAR_LINK:
-            case PLATE_12K_FAR_SIDE:
-            case SHIELD_TOP_12K:
-                /* Find the sensor resistance */
-                /* Apply the correct scaling depending on the hardware revision */
-                switch (frontend.cryostat.hardwRevision) {
-                    case CRYO_HRDW_REV0:
-                        resistance = TVO_GAIN_REV0 * vin;
-                        break;
-                    case CRYO_HRDW_REV1:
-                        resistance = TVO_GAIN_REV1 * vin;
-                        break;
-                    default:
-                        resistance = TVO_GAIN_REV1 * vin;
-                        break;
-                }
-
-                /* Apply the interpolation */
-                resistance = TVO_RESISTOR_SCALE / resistance;
-                temperature =
-                    frontend.cryostat.cryostatTemp[currentAsyncCryoTempModule].coeff[TVO_COEFF_0] +
-                    frontend.cryostat.cryostatTemp[currentAsyncCryoTempModule].coeff[TVO_COEFF_1] * resistance +
-                    frontend.cryostat.cryostatTemp[currentAsyncCryoTempModule].coeff[TVO_COEFF_2] *
-                        pow(resistance, 2.0) +
-                    frontend.cryostat.cryostatTemp[currentAsyncCryoTempModule].coeff[TVO_COEFF_3] *
-                        pow(resistance, 3.0) +
-                    frontend.cryostat.cryostatTemp[currentAsyncCryoTempModule].coeff[TVO_COEFF_4] *
-                        pow(resistance, 4.0) +
-                    frontend.cryostat.cryostatTemp[currentAsyncCryoTempModule].coeff[TVO_COEFF_5] *
-                        pow(resistance, 5.0) +
-                    frontend.cryostat.cryostatTemp[currentAsyncCryoTempModule].coeff[TVO_COEFF_6] *
-                        pow(resistance, 6.0);
-                break;
-            case CRYOCOOLER_90K:
-            case PLATE_90K_NEAR_LINK:
-            case PLATE_90K_FAR_SIDE:
-            case SHIELD_TOP_90K:
-                /* Find the sensor resistance */
-                resistance = PRT_GAIN * vin;
-                /* Apply the interpolation */
-                if (resistance >= PRT_A_SCALE) {
-                    resistance = resistance / PRT_B_SCALE;
-                    temperature = PRT_B0 + PRT_B1 * resistance + PRT_B2 * pow(resistance, 2.0) +
-                                  PRT_B3 * pow(resistance, 3.0) + PRT_B4 * pow(resistance, 4.0) +
-                                  PRT_B5 * pow(resistance, 5.0) + PRT_B6 * pow(resistance, 6.0);
-                } else {
-                    resistance = resistance / PRT_A_SCALE;
-                    temperature = PRT_A0 + PRT_A1 * resistance + PRT_A2 * pow(resistance, 2.0) +
-                                  PRT_A3 * pow(resistance, 3.0) + PRT_A4 * pow(resistance, 4.0) +
-                                  PRT_A5 * pow(resistance, 5.0) + PRT_A6 * pow(resistance, 6.0);
-                }
-
-                break;
-            default:
-                break;
-        }
-
-        /* Check if a domain error occurred while evaluating the power.
-           If error, return a default value. */
-        if (errno == EDOM) {
-            frontend.cryostat.cryostatTemp[currentAsyncCryoTempModule].temp = CRYOSTAT_TEMP_CONV_ERR;
-
-            return ERROR;
-        }
-
-        /* Store the data */
-        frontend.cryostat.cryostatTemp[currentAsyncCryoTempModule].temp = temperature;
+        /* Scale the input voltage to the right value: vin=10*(adcData/65536)
+           and keep it for the conversion at the end of the sweep. */
+        sweepTempVin[currentAsyncCryoTempModule] =
+            (CRYO_ADC_VOLTAGE_IN_SCALE * cryoRegisters.adcData) / CRYO_ADC_RANGE;
+        sweepTempRead[currentAsyncCryoTempModule] = TRUE;
     } else {
         // SIMULATION_MODE
         switch (currentAsyncCryoTempModule) {
@@ -920,6 +1095,53 @@ int getCryostatTemp(int currentAsyncCryoTempModule) {
     return ASYNC_DONE;
 }
 
+/* Cryostat sweep update */
+/*! This function converts in one pass the voltages read from the cryostat
+    temperature and vacuum sensors during the last async sweep and stores the
+    results in the \ref frontend variable. Only the sensors read since the
+    last update are stored, a failed conversion is flagged in
+    \ref asyncCryoTempError or \ref asyncVacuumControllerError.
+
+    \return
+        - \ref NO_ERROR -> if all the sensors were converted
+        - \ref ERROR    -> if at least one conversion failed */
+int cryostatSweepUpdate(void) {
+    float temperature[CRYOSTAT_TEMP_SENSORS_NUMBER], pressure[VACUUM_SENSORS_NUMBER];
+    unsigned char sensor;
+    int ret = NO_ERROR;
+
+    cryostatSweepConversion(sweepTempVin, sweepPressVin, temperature, pressure);
+
+    for (sensor = 0; sensor < CRYOSTAT_TEMP_SENSORS_NUMBER; sensor++) {
+        if (!sweepTempRead[sensor]) {
+            continue;
+        }
+        sweepTempRead[sensor] = FALSE;
+
+        /* Store the data, a failed conversion stores the default value */
+        frontend.cryostat.cryostatTemp[sensor].temp = temperature[sensor];
+        if (temperature[sensor] == CRYOSTAT_TEMP_CONV_ERR) {
+            asyncCryoTempError[sensor] = ERROR;
+            ret = ERROR;
+        }
+    }
+
+    for (sensor = 0; sensor < VACUUM_SENSORS_NUMBER; sensor++) {
+        if (!sweepPressRead[sensor]) {
+            continue;
+        }
+        sweepPressRead[sensor] = FALSE;
+
+        frontend.cryostat.vacuumController.vacuumSensor[sensor].pressure = pressure[sensor];
+        if (pressure[sensor] == CRYOSTAT_PRESS_CONV_ERR) {
+            asyncVacuumControllerError[sensor] = ERROR;
+            ret = ERROR;
+        }
+    }
+
+    return ret;
+}
+
 /* Get CRYO M&C board hardware revision level */
 /*! This function reads the hardware revision level of the cryostat M&C board.
     Different revision require different handling of certain data.
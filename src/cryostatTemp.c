@@ -128,7 +128,7 @@ void sequentialCoeffHandler(int currentCryostatModule, int currentCryostatTempMo
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.cryostatTemp[currentCryostatModule].lastCommand)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.lastControl.cryostatTempCommand[currentCryostatModule])
 
         /* Extract the coefficient order byte */
         coeff = CAN_DATA(4);
@@ -138,7 +138,7 @@ void sequentialCoeffHandler(int currentCryostatModule, int currentCryostatTempMo
             storeError(ERR_CRYOSTAT_TEMP, ERC_COMMAND_VAL);
 
             /* Store the error in the last control message variable */
-            frontend.cryostat.cryostatTemp[currentCryostatModule].lastCommand.status = CON_ERROR_RNG;
+            frontend.cryostat.lastControl.cryostatTempCommand[currentCryostatModule].status = CON_ERROR_RNG;
 
             /* Reset the last order to a legal value */
             frontend.cryostat.cryostatTemp[currentCryostatModule].nextCoeff = TVO_COEFF_0;
@@ -149,6 +149,7 @@ void sequentialCoeffHandler(int currentCryostatModule, int currentCryostatTempMo
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
         frontend.cryostat.cryostatTemp[currentCryostatModule].coeff[coeff] = CONV_FLOAT;
         frontend.cryostat.cryostatTemp[currentCryostatModule].nextCoeff = coeff;
+        cryostatTempCompile(currentCryostatModule);
 
         /* If everything went fine, it's a control message, we're done. */
         return;
@@ -157,7 +158,7 @@ void sequentialCoeffHandler(int currentCryostatModule, int currentCryostatTempMo
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.cryostatTemp[currentCryostatModule].lastCommand)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.lastControl.cryostatTempCommand[currentCryostatModule])
         return;
     }
 
@@ -189,18 +190,19 @@ void specificCoeffHandler(unsigned int sensor, unsigned int coeff, int currentCr
         storeError(ERR_CRYOSTAT_TEMP, ERC_COMMAND_VAL);
 
         /* Store the error in the last control message variable */
-        frontend.cryostat.cryostatTemp[currentCryostatModule].lastCommand.status = CON_ERROR_RNG;
+        frontend.cryostat.lastControl.cryostatTempCommand[currentCryostatModule].status = CON_ERROR_RNG;
         return;
     }
 
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.cryostatTemp[sensor].lastCommand)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.lastControl.cryostatTempCommand[sensor])
 
         /* Extract the float from the can message. */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
         frontend.cryostat.cryostatTemp[sensor].coeff[coeff] = CONV_FLOAT;
+        cryostatTempCompile(sensor);
 
         /* If everything went fine, it's a control message, we're done. */
         return;
@@ -209,7 +211,7 @@ void specificCoeffHandler(unsigned int sensor, unsigned int coeff, int currentCr
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.cryostatTemp[sensor].lastCommand)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.lastControl.cryostatTempCommand[sensor])
         return;
     }
 
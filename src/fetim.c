@@ -7,8 +7,11 @@
     This file contains all the functions necessary to handle FETIM events. */
 
 /* Includes */
-#include <stdio.h>  /* printf */
-#include <stdlib.h> /* exit */
+#include <pthread.h> /* pthread_mutex_t */
+#include <stdio.h>   /* printf */
+#include <stdlib.h>  /* exit */
+#include <string.h>  /* memset */
+#include <time.h>    /* clock_gettime, clock_nanosleep */
 
 #include "async.h"
 #include "debug.h"
@@ -16,6 +19,7 @@
 #include "fetimSerialInterface.h"
 #include "frontend.h"
 #include "globalOperations.h"
+#include "packet.h"
 
 /* Globals */
 /* Externs */
@@ -104,13 +108,191 @@ int fetimStartup(void) {
 
 /*  #define DEBUG_FETIM_FE_SAFE_MODE 1  */
 
+/* The points sampled by the async process, in priority order. The points
+   from ASYNC_FETIM_GET_HE2_PRESS on use the serial ADC and span several
+   calls: once started they can only be interrupted by the points before them,
+   which don't touch the serial ADC. */
+enum {
+    ASYNC_FETIM_SAMPLE_INTERLOCK,
+    ASYNC_FETIM_SET_FE_STATUS,
+    ASYNC_FETIM_GET_HE2_PRESS,
+    ASYNC_FETIM_GET_EXT_TEMP,
+    ASYNC_FETIM_POINTS_NUMBER
+};
+#define ASYNC_FETIM_SERIAL_POINT(Pt) ((Pt) >= ASYNC_FETIM_GET_HE2_PRESS)
+
+/* The sampling schedule: period and next due time of every point (ms) */
+static struct {
+    double period;
+    double due;
+} fetimSchedule[ASYNC_FETIM_POINTS_NUMBER] = {{FETIM_INTERLOCK_PERIOD, 0.0},
+                                              {FETIM_FE_STATUS_PERIOD, 0.0},
+                                              {FETIM_HE2_PRESS_PERIOD, 0.0},
+                                              {FETIM_EXT_TEMP_PERIOD, 0.0}};
+
+/* Current time for the sampling schedule in ms */
+static double fetimTime(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+/* Schedule the next sample of a point one period after the last one was due.
+   If the point fell behind by more than a period, the missed samples are
+   dropped rather than taken back to back. */
+static void fetimReschedule(int point, double now) {
+    fetimSchedule[point].due += fetimSchedule[point].period;
+    if (fetimSchedule[point].due <= now) {
+        fetimSchedule[point].due = now + fetimSchedule[point].period;
+    }
+}
+
+/* Sleep until the next point is due */
+static void fetimSleep(void) {
+    struct timespec deadline;
+    double due = fetimSchedule[0].due;
+    int point;
+
+    for (point = 1; point < ASYNC_FETIM_POINTS_NUMBER; point++) {
+        if (fetimSchedule[point].due < due) {
+            due = fetimSchedule[point].due;
+        }
+    }
+
+    deadline.tv_sec = (time_t)(due / 1000.0);
+    deadline.tv_nsec = (long)((due - deadline.tv_sec * 1000.0) * 1000000.0);
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_nsec = 999999999L;
+    }
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+}
+
+/* The interlock event log: a ring of the last changes of the digital lines.
+   Reading doesn't remove the events, so every client sees all of them. */
+static pthread_mutex_t fetimEventsLock = PTHREAD_MUTEX_INITIALIZER;
+static FETIM_EVENT fetimEvents[FETIM_EVENTS_NUMBER];
+static int fetimEventsCount = 0;                // Events in the log
+static unsigned short fetimEventsSequence = 0;  // Sequence number of the next event
+
+/* The slot of an event must not change when the sequence number wraps, and
+   the RCA must resolve every event in the log */
+_Static_assert(65536 % FETIM_EVENTS_NUMBER == 0, "the event slots must wrap with the sequence number");
+_Static_assert(FETIM_EVENT_SEQUENCE_MASK + 1 >= 2 * FETIM_EVENTS_NUMBER, "the event RCA range is too small");
+
+/* Compare a sample of the digital lines with the previous one and log every
+   line that changed. The first sample only sets the reference. */
+static void fetimLogEdges(int sample, double now) {
+    static int lastSample;
+    static double firstTime = -1.0;
+    FETIM_EVENT *event;
+    int changed, line;
+
+    sample &= FETIM_EVENT_LINES_MASK;
+    if (firstTime < 0.0) {
+        firstTime = now;
+        lastSample = sample;
+        return;
+    }
+
+    changed = sample ^ lastSample;
+    lastSample = sample;
+    if (!changed) {
+        return;
+    }
+
+    pthread_mutex_lock(&fetimEventsLock);
+    for (line = 0; line < FETIM_EVENT_LINES; line++) {
+        if (!(changed & (1 << line))) {
+            continue;
+        }
+
+        /* If full, the oldest event is overwritten */
+        if (fetimEventsCount < FETIM_EVENTS_NUMBER) {
+            fetimEventsCount++;
+        }
+
+        event = &fetimEvents[fetimEventsSequence % FETIM_EVENTS_NUMBER];
+        event->sequence = fetimEventsSequence++;
+        event->line = line;
+        event->level = (sample >> line) & 1;
+        event->time = (unsigned long)(now - firstTime);
+
+#ifdef DEBUG_FETIM_ASYNC
+        printf("Async -> FETIM -> Interlock line %d -> %d\n", event->line, event->level);
+#endif /* DEBUG_FETIM_ASYNC */
+    }
+    pthread_mutex_unlock(&fetimEventsLock);
+}
+
+/* Read an interlock event */
+/*! This function returns the interlock event that follows the last one seen
+    by the client. The log is not modified and no state is kept between
+    requests, so every client sees all the events. The CAN bus has no
+    unsolicited messages, so clients poll this with the low bits of the
+    sequence number of the last event they received, encoded in the RCA,
+    until it reports no newer event. The last seen event is taken as the most
+    recent one with these low bits. The event is returned as:
+        - byte 0-1: sequence number (big endian)
+        - byte 2:   digital line (see \ref FETIM_EVENT)
+        - byte 3:   new level of the line, with \ref FETIM_EVENT_OVERRUN set
+                    if the event after the last seen one was overwritten. The
+                    oldest event in the log is returned instead.
+        - byte 4-7: ms from the first sample (big endian)
+    \param last    The low bits (\ref FETIM_EVENT_SEQUENCE_MASK) of the sequence
+                   number of the last event seen by the client
+    \param data    The 8 bytes buffer to fill
+    \return
+        - \ref NO_ERROR -> if an event was returned
+        - \ref ERROR    -> if there is no event after the last seen one. The
+                           buffer is filled with 0xFF. */
+int fetimReadEvent(unsigned char last, unsigned char *data) {
+    unsigned short newest, next;
+    unsigned char overrun = 0;
+    FETIM_EVENT event;
+
+    pthread_mutex_lock(&fetimEventsLock);
+    newest = fetimEventsSequence - 1;
+    next = newest - ((newest - last) & FETIM_EVENT_SEQUENCE_MASK) + 1;
+    if (fetimEventsCount == 0 || next == fetimEventsSequence) {
+        pthread_mutex_unlock(&fetimEventsLock);
+        memset(data, 0xFF, CAN_FULL_SIZE);
+        return ERROR;
+    }
+    if ((unsigned short)(fetimEventsSequence - next) > fetimEventsCount) {
+        next = fetimEventsSequence - fetimEventsCount;
+        overrun = FETIM_EVENT_OVERRUN;
+    }
+    event = fetimEvents[next % FETIM_EVENTS_NUMBER];
+    pthread_mutex_unlock(&fetimEventsLock);
+
+    data[0] = (unsigned char)(event.sequence >> 8);
+    data[1] = (unsigned char)event.sequence;
+    data[2] = event.line;
+    data[3] = event.level | overrun;
+    data[4] = (unsigned char)(event.time >> 24);
+    data[5] = (unsigned char)(event.time >> 16);
+    data[6] = (unsigned char)(event.time >> 8);
+    data[7] = (unsigned char)event.time;
+
+    return NO_ERROR;
+}
+
 /*! This function deals with the asynchronous operation in the FETIM:
         - Monitor the external temperature sensors (this are going to be used
           by the turbo pump code to allow/disallow operation of the hardware)
         - Gracefully shutdown the Front End if the ultimate shutdown sequence
           has been started
         - Generate and communicate to the FETIM the FE state bit
+        - Sample the interlock digital lines and log their changes
         - ...
+
+    Every point has its own period (see \ref FETIM_INTERLOCK_PERIOD and
+    following) so that the interlock lines are sampled often while the
+    thermal points are sampled at a leisurely rate. Each call serves the
+    highest priority point that is due. When nothing is due the function
+    sleeps until the next point is.
+
     \return
         - \ref NO_ERROR     -> if no error occured
         - \ref ASYNC_DONE   -> once all the async operations are done
@@ -119,23 +301,38 @@ int fetimAsync(void) {
     /* A static to keep track of the currently addressed cartridge */
     static unsigned char currentAsyncFetimExtTempModule = 0;
 
-    /* A static enum to track the state of the async function */
-    static enum {
-        ASYNC_FETIM_GET_EXT_TEMP,
-        ASYNC_FETIM_GET_HE2_PRESS,
-        ASYNC_FETIM_SET_FE_STATUS,
-        ASYNC_FETIM_SHUTDOWN_FE
-    } asyncFetimState = ASYNC_FETIM_GET_EXT_TEMP;
+    /* A static to keep track of the serial ADC point being read, if any */
+    static int asyncFetimBusy = ASYNC_FETIM_POINTS_NUMBER;
+
+    double now;
+    int point, digitals;
 
     /* If the FETIM is not installed, return */
     if (frontend.fetim.available == UNAVAILABLE) {
         return ASYNC_DONE;
     }
 
-    /* Switch to the correct state */
-    switch (asyncFetimState) {
+    /* Find the highest priority point that is due. A point already in
+       progress goes on unless a point before it is due. */
+    now = fetimTime();
+    for (point = 0; point < asyncFetimBusy; point++) {
+        if (fetimSchedule[point].due <= now &&
+            !(asyncFetimBusy < ASYNC_FETIM_POINTS_NUMBER && ASYNC_FETIM_SERIAL_POINT(point))) {
+            break;
+        }
+    }
+
+    /* Nothing to do: wait for the next point */
+    if (point == ASYNC_FETIM_POINTS_NUMBER) {
+        fetimSleep();
+        return ASYNC_DONE;
+    }
+
+    /* Switch to the correct point */
+    switch (point) {
         /* Monitor the external temperature asynchronously */
         case ASYNC_FETIM_GET_EXT_TEMP:
+            asyncFetimBusy = ASYNC_FETIM_GET_EXT_TEMP;
 
             /* Get the external temperatures */
             asyncFetimExtTempError[currentAsyncFetimExtTempModule] = getFetimExtTemp(currentAsyncFetimExtTempModule);
@@ -159,10 +356,11 @@ int fetimAsync(void) {
                     break;
             }
 
-            /* Next sensor, if wrap around, then next monitor next thing */
+            /* Next sensor, if wrap around, then the sweep is done */
             if (++currentAsyncFetimExtTempModule == FETIM_EXT_SENSORS_NUMBER) {
                 currentAsyncFetimExtTempModule -= FETIM_EXT_SENSORS_NUMBER;
-                asyncFetimState = ASYNC_FETIM_GET_HE2_PRESS;
+                asyncFetimBusy = ASYNC_FETIM_POINTS_NUMBER;
+                fetimReschedule(ASYNC_FETIM_GET_EXT_TEMP, now);
             }
 
             break;
@@ -172,6 +370,7 @@ int fetimAsync(void) {
 #ifdef DEBUG_FETIM_ASYNC
             printf("Async -> FETIM -> He2 Pressure\n");
 #endif /* DEBUG_FETIM_ASYNC */
+            asyncFetimBusy = ASYNC_FETIM_GET_HE2_PRESS;
 
             /* Get the tank pressure */
             asyncFetimHePressError = getCompHe2Press();
@@ -190,8 +389,9 @@ int fetimAsync(void) {
                     break;
             }
 
-            /* Next monitor next thing */
-            asyncFetimState = ASYNC_FETIM_SET_FE_STATUS;
+            /* Done with this point */
+            asyncFetimBusy = ASYNC_FETIM_POINTS_NUMBER;
+            fetimReschedule(ASYNC_FETIM_GET_HE2_PRESS, now);
 
             break;
 
@@ -205,6 +405,8 @@ int fetimAsync(void) {
             printf("Async -> FETIM -> FE Status\n");
 #endif /* DEBUG_FETIM_ASYNC */
 
+            fetimReschedule(ASYNC_FETIM_SET_FE_STATUS, now);
+
             /* Check current conditions */
             tempFloat = frontend.cryostat.vacuumController.vacuumSensor[CRYOSTAT_PRESSURE].pressure;
 
@@ -222,7 +424,6 @@ int fetimAsync(void) {
 
             /* If the state has not changed, then skip. */
             if (newState == currentState) {
-                asyncFetimState = ASYNC_FETIM_SHUTDOWN_FE;
                 break;
             }
 
@@ -232,20 +433,25 @@ int fetimAsync(void) {
             /* Update current state */
             currentState = newState;
 
-            /* Set next state */
-            asyncFetimState = ASYNC_FETIM_SHUTDOWN_FE;
-
             break;
         }
 
-        /* Check if ultimate shutdown sequence has been triggered and if so,
-           gracefully shut down the Front End */
-        case ASYNC_FETIM_SHUTDOWN_FE:
+        /* Sample the interlock lines, log their changes and, if the ultimate
+           shutdown sequence has been triggered, gracefully shut down the Front
+           End */
+        case ASYNC_FETIM_SAMPLE_INTERLOCK:
 
 #ifdef DEBUG_FETIM_ASYNC
-            printf("Async -> FETIM -> FE Shutdown\n");
+            printf("Async -> FETIM -> Interlock sample\n");
 #endif /* DEBUG_FETIM_ASYNC */
 
+            fetimReschedule(ASYNC_FETIM_SAMPLE_INTERLOCK, now);
+
+            /* On error the last known state is kept and no edge is logged */
+            if (getFetimDigitals(&digitals) == NO_ERROR) {
+                fetimLogEdges(digitals, now);
+            }
+
             if (frontend.fetim.interlock.state.shutdownTrig == TRUE) {
                 /* Shut down the frontend */
                 shutDown();
@@ -255,9 +461,6 @@ int fetimAsync(void) {
                 exit(NO_ERROR);
             }
 
-            /* Set next state */
-            asyncFetimState = ASYNC_FETIM_GET_EXT_TEMP;
-
             return ASYNC_DONE;
 
             break;
@@ -19,8 +19,9 @@
 /* Includes */
 #include "fetimSerialInterface.h"
 
+#include <errno.h> /* EINTR */
 #include <stdio.h> /* printf */
-#include <unistd.h>
+#include <time.h>  /* clock_gettime, clock_nanosleep */
 
 #include "async.h"
 #include "debug.h"
@@ -30,6 +31,40 @@
 
 FETIM_REGISTERS fetimRegisters;
 
+/* Settle deadline */
+/*! Set \p deadline to \p nanoseconds from now on the monotonic clock. */
+static void fetimSettleDeadline(struct timespec *deadline, long nanoseconds) {
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_nsec += nanoseconds;
+    while (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_nsec -= 1000000000L;
+        deadline->tv_sec++;
+    }
+}
+
+/* Wait for a settle deadline */
+/*! A sleep costs a scheduler round trip of tens of microseconds, far more
+    than the hardware settling times. Deadlines closer than
+    \ref FETIM_SPIN_LIMIT are therefore spun on the monotonic clock, the
+    others are slept on as an absolute deadline so that a late wake up is not
+    added to the time already spent. A deadline in the past returns at once. */
+static void fetimSettleWait(const struct timespec *deadline) {
+    struct timespec now;
+    long long remaining;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    remaining = (deadline->tv_sec - now.tv_sec) * 1000000000LL + (deadline->tv_nsec - now.tv_nsec);
+    if (remaining > FETIM_SPIN_LIMIT) {
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, deadline, NULL) == EINTR)
+            ;
+        return;
+    }
+    while (remaining > 0) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        remaining = (deadline->tv_sec - now.tv_sec) * 1000000000LL + (deadline->tv_nsec - now.tv_nsec);
+    }
+}
+
 /* Get internal interlock temperature sensors */
 /*! This function returns the temperature of the addressed internal interlock
     temperature sensor.
@@ -278,6 +313,58 @@ int setFeSafeStatus(unsigned char safe) {
     return NO_ERROR;
 }
 
+/* Store one FETIM digital value from BREG_IN into the frontend variable */
+static void fetimDigitalStore(unsigned char port, int currentCompressorModule) {
+    switch (port) {
+        case FETIM_DIG_FLOW_OOR:
+            frontend.fetim.interlock.state.flowOutRng = fetimRegisters.bRegIn.bitField.intrlkFlowOutRng;
+            break;
+        case FETIM_DIG_TEMP_OOR:
+            frontend.fetim.interlock.state.tempOutRng = fetimRegisters.bRegIn.bitField.intrlkTempOutRng;
+            break;
+        case FETIM_DIG_GLITCH_CNT:
+            frontend.fetim.interlock.state.glitch.countTrig = fetimRegisters.bRegIn.bitField.glitchCntTrig;
+            break;
+        case FETIM_DIG_SHTDWN_TRIG:
+            frontend.fetim.interlock.state.shutdownTrig = fetimRegisters.bRegIn.bitField.shutdownTrig;
+            break;
+        case FETIM_DIG_SHTDWN_DELAY:
+            frontend.fetim.interlock.state.delayTrig = fetimRegisters.bRegIn.bitField.shutdownDelayTrig;
+            break;
+        case FETIM_DIG_SINGLE_FAIL:
+            frontend.fetim.interlock.sensors.singleFail = fetimRegisters.bRegIn.bitField.singleFail;
+            break;
+        case FETIM_DIG_MULTI_FAIL:
+            frontend.fetim.interlock.state.multiFail = fetimRegisters.bRegIn.bitField.multiFail;
+            break;
+        case FETIM_DIG_COMP_CBL_STA:
+            frontend.fetim.compressor.cableStatus = fetimRegisters.bRegIn.bitField.compCableStatus;
+            break;
+        case FETIM_DIG_INTRLK_STA:
+            frontend.fetim.compressor.intrlkStatus = fetimRegisters.bRegIn.bitField.compIntrlkStatus;
+            break;
+        case FETIM_DIG_HE2_PRESS_OOR:
+            frontend.fetim.compressor.he2Press.pressOutRng = fetimRegisters.bRegIn.bitField.he2PressOutRng;
+            break;
+        case FETIM_DIG_EXT_TEMP_OOR:  // currentCompressorModule
+            switch (currentCompressorModule) {
+                case EXT_TEMP_1:
+                    frontend.fetim.compressor.temp[currentCompressorModule].tempOutRng =
+                        fetimRegisters.bRegIn.bitField.compExtTemp1OutRng;
+                    break;
+                case EXT_TEMP_2:
+                    frontend.fetim.compressor.temp[currentCompressorModule].tempOutRng =
+                        fetimRegisters.bRegIn.bitField.compExtTemp2OutRng;
+                    break;
+                default:
+                    break;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
 /* Get FETIM digital values */
 /*! This function monitors the FETIM digital inputs.
 
@@ -308,99 +395,56 @@ int getFetimDigital(unsigned char port, int currentCompressorModule) {
                          FETIM_BREG_IN_SHIFT_DIR, SERIAL_READ, FETIM_MODULE, 0) == ERROR) {
             return ERROR;
         }
+    } else {
+        // SIMULATION_MODE: the same register content as getFetimDigitals
+        tempDigData = FETIM_BREG_IN_SIMULATED;
+    }
 
-        /* If no error store the data */
-        fetimRegisters.bRegIn.integer = tempDigData;
+    /* If no error store the data */
+    fetimRegisters.bRegIn.integer = tempDigData;
 
-        /* Assign to the correct variable depending on the port */
-        switch (port) {
-            case FETIM_DIG_FLOW_OOR:
-                frontend.fetim.interlock.state.flowOutRng = fetimRegisters.bRegIn.bitField.intrlkFlowOutRng;
-                break;
-            case FETIM_DIG_TEMP_OOR:
-                frontend.fetim.interlock.state.tempOutRng = fetimRegisters.bRegIn.bitField.intrlkTempOutRng;
-                break;
-            case FETIM_DIG_GLITCH_CNT:
-                frontend.fetim.interlock.state.glitch.countTrig = fetimRegisters.bRegIn.bitField.glitchCntTrig;
-                break;
-            case FETIM_DIG_SHTDWN_TRIG:
-                frontend.fetim.interlock.state.shutdownTrig = fetimRegisters.bRegIn.bitField.shutdownTrig;
-                break;
-            case FETIM_DIG_SHTDWN_DELAY:
-                frontend.fetim.interlock.state.delayTrig = fetimRegisters.bRegIn.bitField.shutdownDelayTrig;
-                break;
-            case FETIM_DIG_SINGLE_FAIL:
-                frontend.fetim.interlock.sensors.singleFail = fetimRegisters.bRegIn.bitField.singleFail;
-                break;
-            case FETIM_DIG_MULTI_FAIL:
-                frontend.fetim.interlock.state.multiFail = fetimRegisters.bRegIn.bitField.multiFail;
-                break;
-            case FETIM_DIG_COMP_CBL_STA:
-                frontend.fetim.compressor.cableStatus = fetimRegisters.bRegIn.bitField.compCableStatus;
-                break;
-            case FETIM_DIG_INTRLK_STA:
-                frontend.fetim.compressor.intrlkStatus = fetimRegisters.bRegIn.bitField.compIntrlkStatus;
-                break;
-            case FETIM_DIG_HE2_PRESS_OOR:
-                frontend.fetim.compressor.he2Press.pressOutRng = fetimRegisters.bRegIn.bitField.he2PressOutRng;
-                break;
-            case FETIM_DIG_EXT_TEMP_OOR:  // currentCompressorModule
-                switch (currentCompressorModule) {
-                    case EXT_TEMP_1:
-                        frontend.fetim.compressor.temp[currentCompressorModule].tempOutRng =
-                            fetimRegisters.bRegIn.bitField.compExtTemp1OutRng;
-                        break;
-                    case EXT_TEMP_2:
-                        frontend.fetim.compressor.temp[currentCompressorModule].tempOutRng =
-                            fetimRegisters.bRegIn.bitField.compExtTemp2OutRng;
-                        break;
-                    default:
-                        break;
-                }
-                break;
-            default:
-                break;
+    /* Assign to the correct variable depending on the port */
+    fetimDigitalStore(port, currentCompressorModule);
+
+    return NO_ERROR;
+}
+
+/* Get all the FETIM digital values */
+/*! This function reads BREG_IN once and updates all the digital values that
+    \ref getFetimDigital would return one at a time. It is used by the
+    interlock sampler, for which one serial access per sample matters.
+
+    \param digitals     Returns the raw content of BREG_IN
+
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something went wrong */
+int getFetimDigitals(int *digitals) {
+    /* A variable to temporarily hold the read data */
+    int tempDigData = 0x0000;
+    unsigned char port;
+
+    if (frontend.mode != SIMULATION_MODE) {
+        /* Read the digital data */
+        if (serialAccess(FETIM_PARALLEL_READ(FETIM_BREG_IN), &tempDigData, FETIM_BREG_IN_SIZE, FETIM_BREG_IN_SHIFT_SIZE,
+                         FETIM_BREG_IN_SHIFT_DIR, SERIAL_READ, FETIM_MODULE, 0) == ERROR) {
+            return ERROR;
         }
     } else {
-        // SIMULATION_MODE
-        switch (port) {
-            case FETIM_DIG_FLOW_OOR:
-                frontend.fetim.interlock.state.flowOutRng = 0;
-                break;
-            case FETIM_DIG_TEMP_OOR:
-                frontend.fetim.interlock.state.tempOutRng = 0;
-                break;
-            case FETIM_DIG_GLITCH_CNT:
-                frontend.fetim.interlock.state.glitch.countTrig = 0;
-                break;
-            case FETIM_DIG_SHTDWN_TRIG:
-                frontend.fetim.interlock.state.shutdownTrig = 0;
-                break;
-            case FETIM_DIG_SHTDWN_DELAY:
-                frontend.fetim.interlock.state.delayTrig = 0;
-                break;
-            case FETIM_DIG_SINGLE_FAIL:
-                frontend.fetim.interlock.sensors.singleFail = 0;
-                break;
-            case FETIM_DIG_MULTI_FAIL:
-                frontend.fetim.interlock.state.multiFail = 0;
-                break;
-            case FETIM_DIG_COMP_CBL_STA:
-                frontend.fetim.compressor.cableStatus = 0;
-                break;
-            case FETIM_DIG_INTRLK_STA:
-                frontend.fetim.compressor.intrlkStatus = 0;
-                break;
-            case FETIM_DIG_HE2_PRESS_OOR:
-                frontend.fetim.compressor.he2Press.pressOutRng = 0;
-                break;
-            case FETIM_DIG_EXT_TEMP_OOR:  // currentCompressorModule
-                frontend.fetim.compressor.temp[currentCompressorModule].tempOutRng = 0;
-                break;
-            default:
-                break;
-        }
+        // SIMULATION_MODE: the same register content as getFetimDigital
+        tempDigData = FETIM_BREG_IN_SIMULATED;
     }
+
+    /* If no error store the data */
+    fetimRegisters.bRegIn.integer = tempDigData;
+    *digitals = tempDigData;
+
+    for (port = FETIM_DIG_FLOW_OOR; port < FETIM_DIG_EXT_TEMP_OOR; port++) {
+        fetimDigitalStore(port, 0);
+    }
+    fetimDigitalStore(FETIM_DIG_EXT_TEMP_OOR, EXT_TEMP_1);
+    fetimDigitalStore(FETIM_DIG_EXT_TEMP_OOR, EXT_TEMP_2);
+
     return NO_ERROR;
 }
 
@@ -408,6 +452,7 @@ int getFetimDigital(unsigned char port, int currentCompressorModule) {
 int getFetimParallelMonitor(void) {
     /* A variable to hold the incoming parallel ADC data */
     int tempParAdcValue = 0x0000;
+    struct timespec settle;
 
     /* Perform a parallel write to select the desired monitor point */
     if (serialAccess(FETIM_PARALLEL_WRITE(FETIM_AREG_OUT), &fetimRegisters.aRegOut.integer, FETIM_AREG_OUT_SIZE,
@@ -415,7 +460,9 @@ int getFetimParallelMonitor(void) {
         return ERROR;
     }
 
-    usleep(1);
+    /* Let the multiplexer settle on the new monitor point */
+    fetimSettleDeadline(&settle, FETIM_MUX_SETTLE_TIME);
+    fetimSettleWait(&settle);
 
     /* Initiate the conversion. This includes also extra clock cycles necessary
        to allow time for the converion to complete. */
@@ -445,6 +492,10 @@ int getFetimSerialMonitor(void) {
         ASYNC_FETIM_SERIAL_ADC_READ
     } asyncFetimSerialState = ASYNC_FETIM_SERIAL_BREG;
 
+    /* The earliest time the conversion can start. The readout is split over
+       two calls, so usually it has already passed when it is checked. */
+    static struct timespec settle;
+
     /* Switch to the correct current state */
     switch (asyncFetimSerialState) {
         /* Perform a parallel write to select the desired monitor point */
@@ -464,6 +515,8 @@ int getFetimSerialMonitor(void) {
                 return ERROR;
             }
 
+            fetimSettleDeadline(&settle, FETIM_MUX_SETTLE_TIME);
+
             /* Set next state */
             asyncFetimSerialState = ASYNC_FETIM_SERIAL_ADC_READ;
 
@@ -474,7 +527,7 @@ int getFetimSerialMonitor(void) {
             /* A variable to hold the incoming serial ADC data */
             int tempSerAdcValue[2];
 
-            usleep(1);
+            fetimSettleWait(&settle);
 
 #ifdef DEBUG_FETIM_ASYNC
             if (fetimRegisters.bRegOut.bitField.monitorPoint == FETIM_BREG_OUT_HE2_PRESS)
@@ -10,18 +10,308 @@
 /* Includes */
 #include "frontend.h"
 
+#include <pthread.h>
+#include <stddef.h> /* offsetof */
 #include <stdio.h>  /* printf */
 #include <string.h> /* memset */
+#include <time.h>
 
+#include "biasSerialInterface.h"
 #include "debug.h"
 #include "error_local.h"
 #include "iniWrapper.h"
+#include "packet.h"
+#include "version.h"
 
 /* Globals */
 /* Externs */
 FRONTEND frontend; /*!< This variable contains the current status of
                         the entire frontend system. */
 
+/* Layout checks: every subsystem must start on its own cache line */
+_Static_assert(sizeof(CARTRIDGE) % CACHE_LINE_SIZE == 0, "CARTRIDGE must fill whole cache lines");
+_Static_assert(offsetof(FRONTEND, cartridge) % CACHE_LINE_SIZE == 0, "cartridge is not cache line aligned");
+_Static_assert(offsetof(FRONTEND, powerDistribution) % CACHE_LINE_SIZE == 0,
+               "powerDistribution is not cache line aligned");
+_Static_assert(offsetof(FRONTEND, ifSwitch) % CACHE_LINE_SIZE == 0, "ifSwitch is not cache line aligned");
+_Static_assert(offsetof(FRONTEND, cryostat) % CACHE_LINE_SIZE == 0, "cryostat is not cache line aligned");
+_Static_assert(offsetof(CARTRIDGE, lastControl) % CACHE_LINE_SIZE == 0, "cartridge lastControl is not aligned");
+_Static_assert(offsetof(CRYOSTAT, lastControl) % CACHE_LINE_SIZE == 0, "cryostat lastControl is not aligned");
+_Static_assert(offsetof(POWER_DISTRIBUTION, lastControl) % CACHE_LINE_SIZE == 0,
+               "powerDistribution lastControl is not aligned");
+_Static_assert(offsetof(IF_SWITCH, lastControl) % CACHE_LINE_SIZE == 0, "ifSwitch lastControl is not aligned");
+_Static_assert(offsetof(LPR, lastControl) % CACHE_LINE_SIZE == 0, "lpr lastControl is not aligned");
+_Static_assert(offsetof(FETIM, lastControl) % CACHE_LINE_SIZE == 0, "fetim lastControl is not aligned");
+_Static_assert(offsetof(FRONTEND, lpr) % CACHE_LINE_SIZE == 0, "lpr is not cache line aligned");
+_Static_assert(offsetof(FRONTEND, fetim) % CACHE_LINE_SIZE == 0, "fetim is not cache line aligned");
+_Static_assert(sizeof(FRONTEND) % CACHE_LINE_SIZE == 0, "FRONTEND must fill whole cache lines");
+/* Every chunk of the largest snapshot must have its own RCA */
+_Static_assert((FRONTEND_SNAPSHOT_SIZE + FRONTEND_SNAPSHOT_CHUNK_DATA - 1) / FRONTEND_SNAPSHOT_CHUNK_DATA <=
+                   LAST_SPECIAL_MONITOR_RCA - GET_FE_SNAPSHOT_CHUNK + 1,
+               "the frontend snapshot chunks don't fit in the special monitor RCAs");
+
+/* Statics */
+static pthread_mutex_t frontendSnapshotLock = PTHREAD_MUTEX_INITIALIZER;
+static FRONTEND frontendSnapshotCopy;                           // Frontend state at the time of the capture
+static unsigned char frontendSnapshot[FRONTEND_SNAPSHOT_SIZE];  // Encoded snapshot
+static unsigned int frontendSnapshotLength = 0;                 // Bytes in the encoded snapshot
+static unsigned char frontendSnapshotSequence = 0;              // Incremented at every capture
+
+/* Snapshot field tables. Each entry describes one record of the snapshot:
+   the field id within the section, the record type and where the values are
+   found in the section. Arrays are walked with up to three counts and
+   strides, the last index changing fastest. The field ids are part of the
+   snapshot format: new fields take new ids and ids are never reused. */
+typedef struct {
+    unsigned char id;          // Field id within the section
+    unsigned char type;        // Record type (FRONTEND_SNAPSHOT_U8 ...)
+    unsigned char size;        // Size of each value in the structure
+    unsigned short offset;     // Offset of the first value in the section
+    unsigned char count[3];    // Values along each index
+    unsigned short stride[3];  // Bytes between values along each index
+} FRONTEND_SNAPSHOT_FIELD;
+
+#define SNAPSHOT_SIZEOF(base, member) sizeof(((base *)0)->member)
+#define SNAPSHOT_FIELD(id, type, base, member) \
+    {id, type, SNAPSHOT_SIZEOF(base, member), offsetof(base, member), {1, 1, 1}, {0, 0, 0}}
+#define SNAPSHOT_ARRAY(id, type, base, member, n0, s0) \
+    {id, type, SNAPSHOT_SIZEOF(base, member), offsetof(base, member), {n0, 1, 1}, {s0, 0, 0}}
+#define SNAPSHOT_ARRAY2(id, type, base, member, n0, s0, n1, s1) \
+    {id, type, SNAPSHOT_SIZEOF(base, member), offsetof(base, member), {n0, n1, 1}, {s0, s1, 0}}
+#define SNAPSHOT_ARRAY3(id, type, base, member, n0, s0, n1, s1, n2, s2) \
+    {id, type, SNAPSHOT_SIZEOF(base, member), offsetof(base, member), {n0, n1, n2}, {s0, s1, s2}}
+
+#define P POLARIZATIONS_NUMBER
+#define S SIDEBANDS_NUMBER
+#define LCM sizeof(LAST_CONTROL_MESSAGE)
+#define U8 FRONTEND_SNAPSHOT_U8
+#define S32 FRONTEND_SNAPSHOT_S32
+#define U32 FRONTEND_SNAPSHOT_U32
+#define F32 FRONTEND_SNAPSHOT_F32
+#define LAST FRONTEND_SNAPSHOT_LAST
+#define LC(id) (FRONTEND_SNAPSHOT_LAST_CONTROL + (id))
+
+static const FRONTEND_SNAPSHOT_FIELD frontendSnapshotFrontend[] = {
+    SNAPSHOT_FIELD(0x00, U8, FRONTEND, mode),
+    SNAPSHOT_ARRAY(0x01, U8, FRONTEND, ipaddress[0], 4, 1),
+};
+
+/* The first field must be the availability: it is the only field sent for
+   the cartridges that are not available. */
+#define SNAPSHOT_POL(id, type, member) \
+    SNAPSHOT_ARRAY(id, type, CARTRIDGE, polarization[0].member, P, sizeof(POLARIZATION))
+#define SNAPSHOT_SB(id, type, member)                                                                \
+    SNAPSHOT_ARRAY2(id, type, CARTRIDGE, polarization[0].sideband[0].member, P, sizeof(POLARIZATION), S, \
+                    sizeof(SIDEBAND))
+#define SNAPSHOT_STAGE(id, member)                                                                                  \
+    SNAPSHOT_ARRAY3(id, F32, CARTRIDGE, polarization[0].sideband[0].lna.stage[0].member, P, sizeof(POLARIZATION), \
+                    S, sizeof(SIDEBAND), LNA_STAGES_NUMBER, sizeof(LNA_STAGE))
+static const FRONTEND_SNAPSHOT_FIELD frontendSnapshotCartridge[] = {
+    SNAPSHOT_FIELD(0x00, U8, CARTRIDGE, available),
+    SNAPSHOT_FIELD(0x01, S32, CARTRIDGE, state),
+    SNAPSHOT_FIELD(0x02, U8, CARTRIDGE, standby2),
+    SNAPSHOT_POL(0x03, U8, ssi10MHzEnable),
+    SNAPSHOT_STAGE(0x04, drainVoltage),
+    SNAPSHOT_STAGE(0x05, drainCurrent),
+    SNAPSHOT_STAGE(0x06, gateVoltage),
+    SNAPSHOT_SB(0x07, U8, lna.enable),
+    SNAPSHOT_SB(0x08, U8, sis.available),
+    SNAPSHOT_SB(0x09, F32, sis.resistor),
+    SNAPSHOT_SB(0x0A, F32, sis.voltage),
+    SNAPSHOT_SB(0x0B, F32, sis.current),
+    SNAPSHOT_SB(0x0C, U8, sis.openLoop),
+    SNAPSHOT_SB(0x0D, U8, sisMagnet.available),
+    SNAPSHOT_SB(0x0E, F32, sisMagnet.voltage),
+    SNAPSHOT_SB(0x0F, F32, sisMagnet.current),
+    SNAPSHOT_POL(0x10, U8, lnaLed.enable),
+    SNAPSHOT_POL(0x11, U8, sisHeater.available),
+    SNAPSHOT_POL(0x12, U8, sisHeater.enable),
+    SNAPSHOT_POL(0x13, F32, sisHeater.current),
+    SNAPSHOT_FIELD(0x14, U8, CARTRIDGE, lo.ssi10MHzEnable),
+    SNAPSHOT_FIELD(0x15, F32, CARTRIDGE, lo.amc.gateAVoltage),
+    SNAPSHOT_FIELD(0x16, F32, CARTRIDGE, lo.amc.drainAVoltage),
+    SNAPSHOT_FIELD(0x17, F32, CARTRIDGE, lo.amc.drainACurrent),
+    SNAPSHOT_FIELD(0x18, F32, CARTRIDGE, lo.amc.gateBVoltage),
+    SNAPSHOT_FIELD(0x19, F32, CARTRIDGE, lo.amc.drainBVoltage),
+    SNAPSHOT_FIELD(0x1A, F32, CARTRIDGE, lo.amc.drainBCurrent),
+    SNAPSHOT_FIELD(0x1B, F32, CARTRIDGE, lo.amc.supplyVoltage5V),
+    SNAPSHOT_FIELD(0x1C, U8, CARTRIDGE, lo.amc.multiplierDVoltage),
+    SNAPSHOT_FIELD(0x1D, F32, CARTRIDGE, lo.amc.multiplierDCurrent),
+    SNAPSHOT_FIELD(0x1E, F32, CARTRIDGE, lo.amc.gateEVoltage),
+    SNAPSHOT_FIELD(0x1F, F32, CARTRIDGE, lo.amc.drainEVoltage),
+    SNAPSHOT_FIELD(0x20, F32, CARTRIDGE, lo.amc.drainECurrent),
+    SNAPSHOT_FIELD(0x21, F32, CARTRIDGE, lo.pll.lockDetectVoltage),
+    SNAPSHOT_FIELD(0x22, F32, CARTRIDGE, lo.pll.correctionVoltage),
+    SNAPSHOT_FIELD(0x23, F32, CARTRIDGE, lo.pll.assemblyTemp),
+    SNAPSHOT_FIELD(0x24, F32, CARTRIDGE, lo.pll.YIGHeaterCurrent),
+    SNAPSHOT_FIELD(0x25, F32, CARTRIDGE, lo.pll.refTotalPower),
+    SNAPSHOT_FIELD(0x26, F32, CARTRIDGE, lo.pll.ifTotalPower),
+    SNAPSHOT_FIELD(0x27, U8, CARTRIDGE, lo.pll.unlockDetectLatch),
+    SNAPSHOT_FIELD(0x28, U8, CARTRIDGE, lo.pll.loopBandwidthSelect),
+    SNAPSHOT_FIELD(0x29, U8, CARTRIDGE, lo.pll.sidebandLockPolaritySelect),
+    SNAPSHOT_FIELD(0x2A, U8, CARTRIDGE, lo.pll.nullLoopIntegrator),
+    SNAPSHOT_ARRAY(0x2B, F32, CARTRIDGE, lo.pa.paChannel[0].gateVoltage, PA_CHANNELS_NUMBER, sizeof(PA_CHANNEL)),
+    SNAPSHOT_ARRAY(0x2C, F32, CARTRIDGE, lo.pa.paChannel[0].drainVoltage, PA_CHANNELS_NUMBER, sizeof(PA_CHANNEL)),
+    SNAPSHOT_ARRAY(0x2D, F32, CARTRIDGE, lo.pa.paChannel[0].drainCurrent, PA_CHANNELS_NUMBER, sizeof(PA_CHANNEL)),
+    SNAPSHOT_FIELD(0x2E, F32, CARTRIDGE, lo.pa.supplyVoltage3V),
+    SNAPSHOT_FIELD(0x2F, F32, CARTRIDGE, lo.pa.supplyVoltage5V),
+    SNAPSHOT_FIELD(0x30, U8, CARTRIDGE, lo.pa.hasTeledynePa),
+    SNAPSHOT_ARRAY(0x31, U8, CARTRIDGE, lo.pa.teledyneCollectorByte[0], 2, 1),
+    SNAPSHOT_FIELD(0x32, U8, CARTRIDGE, lo.photomixer.enable),
+    SNAPSHOT_FIELD(0x33, F32, CARTRIDGE, lo.photomixer.voltage),
+    SNAPSHOT_FIELD(0x34, F32, CARTRIDGE, lo.photomixer.current),
+    SNAPSHOT_FIELD(0x35, U32, CARTRIDGE, lo.yto.ytoCoarseTune),
+    SNAPSHOT_ARRAY(0x36, F32, CARTRIDGE, cartridgeTemp[0].temp, CARTRIDGE_TEMP_SENSORS_NUMBER, sizeof(CARTRIDGE_TEMP)),
+    SNAPSHOT_ARRAY(0x37, F32, CARTRIDGE, cartridgeTemp[0].offset, CARTRIDGE_TEMP_SENSORS_NUMBER,
+                   sizeof(CARTRIDGE_TEMP)),
+    SNAPSHOT_ARRAY2(LC(0x00), LAST, CARTRIDGE, lastControl.sisSenseResistor[0][0], P, S * LCM, S, LCM),
+    SNAPSHOT_ARRAY2(LC(0x01), LAST, CARTRIDGE, lastControl.sisVoltage[0][0], P, S * LCM, S, LCM),
+    SNAPSHOT_ARRAY2(LC(0x02), LAST, CARTRIDGE, lastControl.sisOpenLoop[0][0], P, S * LCM, S, LCM),
+    SNAPSHOT_ARRAY2(LC(0x03), LAST, CARTRIDGE, lastControl.sisMagnetCurrent[0][0], P, S * LCM, S, LCM),
+    SNAPSHOT_ARRAY2(LC(0x04), LAST, CARTRIDGE, lastControl.lnaEnable[0][0], P, S * LCM, S, LCM),
+    SNAPSHOT_ARRAY3(LC(0x05), LAST, CARTRIDGE, lastControl.lnaStageDrainVoltage[0][0][0], P,
+                    S * LNA_STAGES_NUMBER * LCM, S, LNA_STAGES_NUMBER * LCM, LNA_STAGES_NUMBER, LCM),
+    SNAPSHOT_ARRAY3(LC(0x06), LAST, CARTRIDGE, lastControl.lnaStageDrainCurrent[0][0][0], P,
+                    S * LNA_STAGES_NUMBER * LCM, S, LNA_STAGES_NUMBER * LCM, LNA_STAGES_NUMBER, LCM),
+    SNAPSHOT_ARRAY(LC(0x07), LAST, CARTRIDGE, lastControl.lnaLedEnable[0], P, LCM),
+    SNAPSHOT_ARRAY(LC(0x08), LAST, CARTRIDGE, lastControl.sisHeaterEnable[0], P, LCM),
+    SNAPSHOT_ARRAY2(LC(0x09), LAST, CARTRIDGE, lastControl.polDacResetStrobe[0][0], P, POL_DACS_NUMBER * LCM,
+                    POL_DACS_NUMBER, LCM),
+    SNAPSHOT_ARRAY2(LC(0x0A), LAST, CARTRIDGE, lastControl.polDacClearStrobe[0][0], P, POL_DACS_NUMBER * LCM,
+                    POL_DACS_NUMBER, LCM),
+    SNAPSHOT_FIELD(LC(0x0B), LAST, CARTRIDGE, lastControl.ytoCoarseTune),
+    SNAPSHOT_FIELD(LC(0x0C), LAST, CARTRIDGE, lastControl.photomixerEnable),
+    SNAPSHOT_FIELD(LC(0x0D), LAST, CARTRIDGE, lastControl.pllClearUnlockDetectLatch),
+    SNAPSHOT_FIELD(LC(0x0E), LAST, CARTRIDGE, lastControl.pllLoopBandwidthSelect),
+    SNAPSHOT_FIELD(LC(0x0F), LAST, CARTRIDGE, lastControl.pllSidebandLockPolaritySelect),
+    SNAPSHOT_FIELD(LC(0x10), LAST, CARTRIDGE, lastControl.pllNullLoopIntegrator),
+    SNAPSHOT_FIELD(LC(0x11), LAST, CARTRIDGE, lastControl.amcDrainBVoltage),
+    SNAPSHOT_FIELD(LC(0x12), LAST, CARTRIDGE, lastControl.amcMultiplierDVoltage),
+    SNAPSHOT_FIELD(LC(0x13), LAST, CARTRIDGE, lastControl.amcGateEVoltage),
+    SNAPSHOT_FIELD(LC(0x14), LAST, CARTRIDGE, lastControl.amcDrainEVoltage),
+    SNAPSHOT_FIELD(LC(0x15), LAST, CARTRIDGE, lastControl.paHasTeledynePa),
+    SNAPSHOT_ARRAY(LC(0x16), LAST, CARTRIDGE, lastControl.paTeledyneCollectorByte[0], 2, LCM),
+    SNAPSHOT_ARRAY(LC(0x17), LAST, CARTRIDGE, lastControl.paChannelGateVoltage[0], PA_CHANNELS_NUMBER, LCM),
+    SNAPSHOT_ARRAY(LC(0x18), LAST, CARTRIDGE, lastControl.paChannelDrainVoltage[0], PA_CHANNELS_NUMBER, LCM),
+    SNAPSHOT_ARRAY(LC(0x19), LAST, CARTRIDGE, lastControl.cartridgeTempOffset[0], CARTRIDGE_TEMP_SENSORS_NUMBER, LCM),
+};
+
+static const FRONTEND_SNAPSHOT_FIELD frontendSnapshotPowerDistribution[] = {
+    SNAPSHOT_ARRAY2(0x00, F32, POWER_DISTRIBUTION, pdModule[0].pdChannel[0].voltage, PD_MODULES_NUMBER,
+                    sizeof(PD_MODULE), PD_CHANNELS_NUMBER, sizeof(PD_CHANNEL)),
+    SNAPSHOT_ARRAY2(0x01, F32, POWER_DISTRIBUTION, pdModule[0].pdChannel[0].current, PD_MODULES_NUMBER,
+                    sizeof(PD_MODULE), PD_CHANNELS_NUMBER, sizeof(PD_CHANNEL)),
+    SNAPSHOT_ARRAY(0x02, U8, POWER_DISTRIBUTION, pdModule[0].enable, PD_MODULES_NUMBER, sizeof(PD_MODULE)),
+    SNAPSHOT_FIELD(0x03, U8, POWER_DISTRIBUTION, poweredModules),
+    SNAPSHOT_FIELD(0x04, U8, POWER_DISTRIBUTION, maxPoweredModules),
+    SNAPSHOT_FIELD(0x05, U8, POWER_DISTRIBUTION, standby2Modules),
+    SNAPSHOT_ARRAY(LC(0x00), LAST, POWER_DISTRIBUTION, lastControl.pdModuleEnable[0], PD_MODULES_NUMBER, LCM),
+};
+
+#define SNAPSHOT_IF(id, type, member) \
+    SNAPSHOT_ARRAY2(id, type, IF_SWITCH, ifChannel[0][0].member, P, S * sizeof(IF_CHANNEL), S, sizeof(IF_CHANNEL))
+static const FRONTEND_SNAPSHOT_FIELD frontendSnapshotIfSwitch[] = {
+    SNAPSHOT_FIELD(0x00, U8, IF_SWITCH, hardwRevision),
+    SNAPSHOT_IF(0x01, U8, ifTempServo.enable),
+    SNAPSHOT_IF(0x02, U8, attenuation),
+    SNAPSHOT_IF(0x03, F32, assemblyTemp),
+    SNAPSHOT_FIELD(0x04, U8, IF_SWITCH, bandSelect),
+    SNAPSHOT_FIELD(LC(0x00), LAST, IF_SWITCH, lastControl.bandSelect),
+    SNAPSHOT_FIELD(LC(0x01), LAST, IF_SWITCH, lastControl.allChannelsAtten),
+    SNAPSHOT_ARRAY2(LC(0x02), LAST, IF_SWITCH, lastControl.ifChannelAttenuation[0][0], P, S * LCM, S, LCM),
+    SNAPSHOT_ARRAY2(LC(0x03), LAST, IF_SWITCH, lastControl.ifTempServoEnable[0][0], P, S * LCM, S, LCM),
+};
+
+static const FRONTEND_SNAPSHOT_FIELD frontendSnapshotCryostat[] = {
+    SNAPSHOT_FIELD(0x00, U8, CRYOSTAT, available),
+    SNAPSHOT_FIELD(0x01, U8, CRYOSTAT, hardwRevision),
+    SNAPSHOT_ARRAY(0x02, F32, CRYOSTAT, cryostatTemp[0].temp, CRYOSTAT_TEMP_SENSORS_NUMBER, sizeof(CRYOSTAT_TEMP)),
+    SNAPSHOT_FIELD(0x03, U8, CRYOSTAT, backingPump.enable),
+    SNAPSHOT_FIELD(0x04, U8, CRYOSTAT, turboPump.enable),
+    SNAPSHOT_FIELD(0x05, U8, CRYOSTAT, turboPump.state),
+    SNAPSHOT_FIELD(0x06, U8, CRYOSTAT, turboPump.speed),
+    SNAPSHOT_FIELD(0x07, U8, CRYOSTAT, gateValve.state),
+    SNAPSHOT_FIELD(0x08, U8, CRYOSTAT, solenoidValve.state),
+    SNAPSHOT_ARRAY(0x09, F32, CRYOSTAT, vacuumController.vacuumSensor[0].pressure, VACUUM_SENSORS_NUMBER,
+                   sizeof(VACUUM_SENSOR)),
+    SNAPSHOT_FIELD(0x0A, U8, CRYOSTAT, vacuumController.enable),
+    SNAPSHOT_FIELD(0x0B, U8, CRYOSTAT, vacuumController.state),
+    SNAPSHOT_FIELD(0x0C, F32, CRYOSTAT, supplyCurrent230V),
+    SNAPSHOT_FIELD(0x0D, U32, CRYOSTAT, coldHeadHours),
+    SNAPSHOT_ARRAY(LC(0x00), LAST, CRYOSTAT, lastControl.cryostatTempCommand[0], CRYOSTAT_TEMP_SENSORS_NUMBER, LCM),
+    SNAPSHOT_FIELD(LC(0x01), LAST, CRYOSTAT, lastControl.backingPumpEnable),
+    SNAPSHOT_FIELD(LC(0x02), LAST, CRYOSTAT, lastControl.turboPumpEnable),
+    SNAPSHOT_FIELD(LC(0x03), LAST, CRYOSTAT, lastControl.gateValveState),
+    SNAPSHOT_FIELD(LC(0x04), LAST, CRYOSTAT, lastControl.solenoidValveState),
+    SNAPSHOT_FIELD(LC(0x05), LAST, CRYOSTAT, lastControl.vacuumControllerEnable),
+    SNAPSHOT_FIELD(LC(0x06), LAST, CRYOSTAT, lastControl.coldHeadHours),
+};
+
+static const FRONTEND_SNAPSHOT_FIELD frontendSnapshotLpr[] = {
+    SNAPSHOT_FIELD(0x00, U8, LPR, ssi10MHzEnable),
+    SNAPSHOT_ARRAY(0x01, F32, LPR, lprTemp[0].temp, LPR_TEMP_SENSORS_NUMBER, sizeof(LPR_TEMP)),
+    SNAPSHOT_FIELD(0x02, U8, LPR, opticalSwitch.port),
+    SNAPSHOT_FIELD(0x03, U8, LPR, opticalSwitch.shutter),
+    SNAPSHOT_FIELD(0x04, U8, LPR, opticalSwitch.state),
+    SNAPSHOT_FIELD(0x05, U8, LPR, opticalSwitch.busy),
+    SNAPSHOT_FIELD(0x06, F32, LPR, edfa.laser.pumpTemp),
+    SNAPSHOT_FIELD(0x07, F32, LPR, edfa.laser.driveCurrent),
+    SNAPSHOT_FIELD(0x08, F32, LPR, edfa.laser.photoDetectCurrent),
+    SNAPSHOT_FIELD(0x09, F32, LPR, edfa.photoDetector.current),
+    SNAPSHOT_FIELD(0x0A, F32, LPR, edfa.photoDetector.power),
+    SNAPSHOT_FIELD(0x0B, F32, LPR, edfa.photoDetector.coeff),
+    SNAPSHOT_FIELD(0x0C, F32, LPR, edfa.modulationInput.value),
+    SNAPSHOT_FIELD(0x0D, U8, LPR, edfa.driverTempAlarm),
+    SNAPSHOT_FIELD(LC(0x00), LAST, LPR, lastControl.opticalSwitchPort),
+    SNAPSHOT_FIELD(LC(0x01), LAST, LPR, lastControl.opticalSwitchShutter),
+    SNAPSHOT_FIELD(LC(0x02), LAST, LPR, lastControl.opticalSwitchForceShutter),
+    SNAPSHOT_FIELD(LC(0x03), LAST, LPR, lastControl.modulationInputValue),
+    SNAPSHOT_FIELD(LC(0x04), LAST, LPR, lastControl.miDacResetStrobe),
+    SNAPSHOT_FIELD(LC(0x05), LAST, LPR, lastControl.photoDetectorCoeff),
+};
+
+static const FRONTEND_SNAPSHOT_FIELD frontendSnapshotFetim[] = {
+    SNAPSHOT_FIELD(0x00, U8, FETIM, available),
+    SNAPSHOT_FIELD(0x01, U8, FETIM, hardwRevision),
+    SNAPSHOT_ARRAY(0x02, F32, FETIM, interlock.sensors.temperature.intrlkTempSens[0].temp,
+                   INTERLOCK_TEMP_SENSORS_NUMBER, sizeof(INTRLK_TEMP_SENS)),
+    SNAPSHOT_ARRAY(0x03, F32, FETIM, interlock.sensors.flow.intrlkFlowSens[0].flow, INTERLOCK_FLOW_SENSORS_NUMBER,
+                   sizeof(INTRLK_FLOW_SENS)),
+    SNAPSHOT_FIELD(0x04, U8, FETIM, interlock.sensors.singleFail),
+    SNAPSHOT_FIELD(0x05, F32, FETIM, interlock.state.glitch.value),
+    SNAPSHOT_FIELD(0x06, U8, FETIM, interlock.state.glitch.countTrig),
+    SNAPSHOT_FIELD(0x07, U8, FETIM, interlock.state.multiFail),
+    SNAPSHOT_FIELD(0x08, U8, FETIM, interlock.state.tempOutRng),
+    SNAPSHOT_FIELD(0x09, U8, FETIM, interlock.state.flowOutRng),
+    SNAPSHOT_FIELD(0x0A, U8, FETIM, interlock.state.delayTrig),
+    SNAPSHOT_FIELD(0x0B, U8, FETIM, interlock.state.shutdownTrig),
+    SNAPSHOT_ARRAY(0x0C, F32, FETIM, compressor.temp[0].temp, FETIM_EXT_SENSORS_NUMBER, sizeof(COMP_TEMP)),
+    SNAPSHOT_ARRAY(0x0D, U8, FETIM, compressor.temp[0].tempOutRng, FETIM_EXT_SENSORS_NUMBER, sizeof(COMP_TEMP)),
+    SNAPSHOT_FIELD(0x0E, F32, FETIM, compressor.he2Press.pressure),
+    SNAPSHOT_FIELD(0x0F, U8, FETIM, compressor.he2Press.pressOutRng),
+    SNAPSHOT_FIELD(0x10, U8, FETIM, compressor.feStatus),
+    SNAPSHOT_FIELD(0x11, U8, FETIM, compressor.intrlkStatus),
+    SNAPSHOT_FIELD(0x12, U8, FETIM, compressor.cableStatus),
+    SNAPSHOT_FIELD(0x13, U8, FETIM, dewar.n2Fill),
+    SNAPSHOT_FIELD(LC(0x00), LAST, FETIM, lastControl.dewarN2Fill),
+};
+
+#undef P
+#undef S
+#undef LCM
+#undef U8
+#undef S32
+#undef U32
+#undef F32
+#undef LAST
+#undef LC
+#undef SNAPSHOT_POL
+#undef SNAPSHOT_SB
+#undef SNAPSHOT_STAGE
+#undef SNAPSHOT_IF
+
+#define SNAPSHOT_FIELDS(table) (sizeof(table) / sizeof(FRONTEND_SNAPSHOT_FIELD))  // Fields in a table
+
 /* Stop the frontend */
 /*! This function takes care of shutting down the frontend.
     \return
@@ -111,6 +401,9 @@ int frontendInit(void) {
 
 #endif  // CHECK_HW_AVAIL
 
+    /* Prepare the cartridge temperature sensors calibration curve */
+    temperatureConversionInit();
+
     /* Perform CCA and LO startup */
     for (int currentModule = 0; currentModule < CARTRIDGES_NUMBER; currentModule++) {
         if (frontend.cartridge[currentModule].available) {
@@ -155,6 +448,7 @@ int frontendInit(void) {
 }
 
 int frontendWriteNVMemory(void) {
+    unsigned char band;
     char buf[20];
 #ifdef DEBUG_CRYOSTAT_ASYNC
     printf("frontend -> frontendWriteNVMemory\n");
@@ -170,6 +464,13 @@ int frontendWriteNVMemory(void) {
         printf("frontend -> frontendWriteNVMemory wrote %s hours\n", buf);
 #endif /* DEBUG_CRYOSTAT_ASYNC */
     }
+
+    // Write the PA limits tables uploaded since the last write:
+    for (band = 0; band < CARTRIDGES_NUMBER; band++) {
+        if (frontend.cartridge[band].lo.maxSafeLoPaTableDirty != 0) {
+            loSavePaLimitsTable(band);
+        }
+    }
     return NO_ERROR;
 }
 
@@ -217,6 +518,44 @@ int feAndCartridgesConfigurationReport(void) {
     return NO_ERROR;
 }
 
+/* Helper to print the layout of a subsystem */
+static void frontendLayoutLine(const char *name, unsigned long offset, unsigned long size) {
+    printf(" %-18s offset:%5lu size:%5lu lines:%3lu\n", name, offset, size,
+           (size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE);
+}
+
+int frontendLayoutReport(void) {
+    unsigned char band;
+    char name[MAX_STRING_SIZE];
+
+    printf("\nFRONTEND memory layout report: %lu bytes, %d bytes cache lines\n", (unsigned long)sizeof(FRONTEND),
+           CACHE_LINE_SIZE);
+    frontendLayoutLine("mode", 0, offsetof(FRONTEND, cartridge));
+    for (band = 0; band < CARTRIDGES_NUMBER; band++) {
+        sprintf(name, "cartridge[%d]", band);
+        frontendLayoutLine(name, offsetof(FRONTEND, cartridge) + band * sizeof(CARTRIDGE), sizeof(CARTRIDGE));
+        frontendLayoutLine(" lastControl",
+                           offsetof(FRONTEND, cartridge) + band * sizeof(CARTRIDGE) + offsetof(CARTRIDGE, lastControl),
+                           sizeof(CARTRIDGE_LAST_CONTROL));
+    }
+    frontendLayoutLine("powerDistribution", offsetof(FRONTEND, powerDistribution), sizeof(POWER_DISTRIBUTION));
+    frontendLayoutLine(" lastControl",
+                       offsetof(FRONTEND, powerDistribution) + offsetof(POWER_DISTRIBUTION, lastControl),
+                       sizeof(POWER_DISTRIBUTION_LAST_CONTROL));
+    frontendLayoutLine("ifSwitch", offsetof(FRONTEND, ifSwitch), sizeof(IF_SWITCH));
+    frontendLayoutLine(" lastControl", offsetof(FRONTEND, ifSwitch) + offsetof(IF_SWITCH, lastControl),
+                       sizeof(IF_SWITCH_LAST_CONTROL));
+    frontendLayoutLine("cryostat", offsetof(FRONTEND, cryostat), sizeof(CRYOSTAT));
+    frontendLayoutLine(" lastControl", offsetof(FRONTEND, cryostat) + offsetof(CRYOSTAT, lastControl),
+                       sizeof(CRYOSTAT_LAST_CONTROL));
+    frontendLayoutLine("lpr", offsetof(FRONTEND, lpr), sizeof(LPR));
+    frontendLayoutLine(" lastControl", offsetof(FRONTEND, lpr) + offsetof(LPR, lastControl), sizeof(LPR_LAST_CONTROL));
+    frontendLayoutLine("fetim", offsetof(FRONTEND, fetim), sizeof(FETIM));
+    frontendLayoutLine(" lastControl", offsetof(FRONTEND, fetim) + offsetof(FETIM, lastControl),
+                       sizeof(FETIM_LAST_CONTROL));
+    return NO_ERROR;
+}
+
 int loPaLimitsTablesReport(void) {
     unsigned char band;
     printf("\nLO PA_LIMITS tables report:\n");
@@ -225,3 +564,255 @@ int loPaLimitsTablesReport(void) {
     }
     return NO_ERROR;
 }
+
+/* Helper to store a big endian value in the snapshot */
+static void frontendSnapshotPut(unsigned char *data, unsigned long value, int bytes) {
+    while (bytes-- > 0) {
+        data[bytes] = (unsigned char)value;
+        value >>= 8;
+    }
+}
+
+/* Helper to store a float in the snapshot, as its big endian IEEE 754 bits */
+static void frontendSnapshotPutFloat(unsigned char *data, float value) {
+    unsigned int bits;
+
+    memcpy(&bits, &value, sizeof(bits));
+    frontendSnapshotPut(data, bits, 4);
+}
+
+/* Helper to append the record of a snapshot field. The values of the field
+   are read from the section at base. Returns the new length of the snapshot
+   or 0 if the record doesn't fit. */
+static unsigned int frontendSnapshotRecord(const FRONTEND_SNAPSHOT_FIELD *field, unsigned char section,
+                                           const unsigned char *base, unsigned int length) {
+    unsigned int start = length, i, j, k;
+    const unsigned char *value;
+    const LAST_CONTROL_MESSAGE *last;
+    unsigned long word;
+    unsigned char size;
+    float real;
+    int integer;
+
+    if (length + FRONTEND_SNAPSHOT_RECORD_SIZE > FRONTEND_SNAPSHOT_SIZE) {
+        return 0;
+    }
+    frontendSnapshot[length++] = section;
+    frontendSnapshot[length++] = field->id;
+    frontendSnapshot[length++] = field->type;
+    length++;  // Record length, filled at the end
+
+    for (i = 0; i < field->count[0]; i++) {
+        for (j = 0; j < field->count[1]; j++) {
+            for (k = 0; k < field->count[2]; k++) {
+                value = base + field->offset + i * field->stride[0] + j * field->stride[1] + k * field->stride[2];
+                /* Worst case value: a full last control message */
+                if (length + 2 + CAN_MESSAGE_PAYLOAD_SIZE > FRONTEND_SNAPSHOT_SIZE) {
+                    return 0;
+                }
+                switch (field->type) {
+                    case FRONTEND_SNAPSHOT_U8:
+                        frontendSnapshot[length++] = *value;
+                        break;
+                    case FRONTEND_SNAPSHOT_S32:
+                        memcpy(&integer, value, sizeof(integer));
+                        frontendSnapshotPut(frontendSnapshot + length, (unsigned long)integer, 4);
+                        length += 4;
+                        break;
+                    case FRONTEND_SNAPSHOT_U32:
+                        if (field->size == sizeof(unsigned long)) {
+                            memcpy(&word, value, sizeof(word));
+                        } else {
+                            word = *(const unsigned int *)value;
+                        }
+                        frontendSnapshotPut(frontendSnapshot + length, word, 4);
+                        length += 4;
+                        break;
+                    case FRONTEND_SNAPSHOT_F32:
+                        memcpy(&real, value, sizeof(real));
+                        frontendSnapshotPutFloat(frontendSnapshot + length, real);
+                        length += 4;
+                        break;
+                    case FRONTEND_SNAPSHOT_LAST:
+                        last = (const LAST_CONTROL_MESSAGE *)value;
+                        size = last->size > CAN_MESSAGE_PAYLOAD_SIZE ? CAN_MESSAGE_PAYLOAD_SIZE : last->size;
+                        frontendSnapshot[length++] = last->status;
+                        frontendSnapshot[length++] = size;
+                        memcpy(frontendSnapshot + length, last->data, size);
+                        length += size;
+                        break;
+                }
+            }
+        }
+    }
+
+    if (length - start - FRONTEND_SNAPSHOT_RECORD_SIZE > FRONTEND_SNAPSHOT_RECORD_MAX) {
+        return 0;
+    }
+    frontendSnapshot[start + 3] = (unsigned char)(length - start - FRONTEND_SNAPSHOT_RECORD_SIZE);
+    return length;
+}
+
+/* Helper to append the records of all the fields of a section. Returns the new
+   length of the snapshot or 0 if the records don't fit. */
+static unsigned int frontendSnapshotSection(const FRONTEND_SNAPSHOT_FIELD *fields, unsigned int number,
+                                            unsigned char section, const void *base, unsigned int length,
+                                            unsigned int *records) {
+    unsigned int field;
+
+    for (field = 0; field < number && length != 0; field++) {
+        length = frontendSnapshotRecord(&fields[field], section, base, length);
+        (*records)++;
+    }
+    return length;
+}
+
+/* Capture a frontend snapshot */
+/*! This function serializes the cached state of the frontend, monitor values
+    and last control messages, in a binary snapshot. The hardware is not
+    accessed. The chunks of the snapshot are read with
+    \ref frontendSnapshotRead.
+
+    The snapshot is self-describing: it is made of a 15 bytes header followed
+    by one tagged record per field. All the values are big endian and don't
+    depend on the layout of \ref FRONTEND in memory:
+        - header: magic (4), format version (1), firmware major, minor and
+          patch (3), capture sequence (1), number of records (2), capture
+          time in ms (4)
+        - record: section (1), field id (1), type (1), length of the values
+          (1), values
+        - values: the values of the field, the last index changing fastest.
+          Their encoding is given by the type:
+            - \ref FRONTEND_SNAPSHOT_U8   -> 1 byte each
+            - \ref FRONTEND_SNAPSHOT_S32  -> 4 bytes each, two's complement
+            - \ref FRONTEND_SNAPSHOT_U32  -> 4 bytes each
+            - \ref FRONTEND_SNAPSHOT_F32  -> 4 bytes each, IEEE 754
+            - \ref FRONTEND_SNAPSHOT_LAST -> status (1), payload size (1) and
+                                             payload bytes, for each message
+
+    The section is \ref FRONTEND_SNAPSHOT_FRONTEND, \ref FRONTEND_SNAPSHOT_CARTRIDGE
+    plus the cartridge number or one of the other subsystems. The field ids of
+    the last control messages start at \ref FRONTEND_SNAPSHOT_LAST_CONTROL. The
+    field ids are listed in the snapshot field tables of this file: new fields
+    take new ids, so a client skips the records it doesn't know using their
+    length. Only the availability is sent for the cartridges not available.
+    \param data    The 8 bytes buffer to fill with: snapshot size (2), number
+                   of chunks (2), format version (1), capture sequence (1) and
+                   capture time in us (2)
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int frontendSnapshotCapture(unsigned char *data) {
+    unsigned int length, chunks, records = 0;
+    struct timespec start, stop;
+    unsigned char band;
+    long elapsed;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    pthread_mutex_lock(&frontendSnapshotLock);
+
+    memcpy(&frontendSnapshotCopy, &frontend, sizeof(FRONTEND));
+
+    frontendSnapshotSequence++;
+    length = frontendSnapshotSection(frontendSnapshotFrontend, SNAPSHOT_FIELDS(frontendSnapshotFrontend),
+                                     FRONTEND_SNAPSHOT_FRONTEND, &frontendSnapshotCopy,
+                                     FRONTEND_SNAPSHOT_HEADER_SIZE, &records);
+    for (band = 0; band < CARTRIDGES_NUMBER; band++) {
+        length = frontendSnapshotSection(frontendSnapshotCartridge,
+                                         frontendSnapshotCopy.cartridge[band].available
+                                             ? SNAPSHOT_FIELDS(frontendSnapshotCartridge)
+                                             : 1,
+                                         FRONTEND_SNAPSHOT_CARTRIDGE + band, &frontendSnapshotCopy.cartridge[band],
+                                         length, &records);
+    }
+    length = frontendSnapshotSection(frontendSnapshotPowerDistribution,
+                                     SNAPSHOT_FIELDS(frontendSnapshotPowerDistribution),
+                                     FRONTEND_SNAPSHOT_POWER_DISTRIBUTION, &frontendSnapshotCopy.powerDistribution,
+                                     length, &records);
+    length = frontendSnapshotSection(frontendSnapshotIfSwitch, SNAPSHOT_FIELDS(frontendSnapshotIfSwitch),
+                                     FRONTEND_SNAPSHOT_IF_SWITCH, &frontendSnapshotCopy.ifSwitch, length, &records);
+    length = frontendSnapshotSection(frontendSnapshotCryostat, SNAPSHOT_FIELDS(frontendSnapshotCryostat),
+                                     FRONTEND_SNAPSHOT_CRYOSTAT, &frontendSnapshotCopy.cryostat, length, &records);
+    length = frontendSnapshotSection(frontendSnapshotLpr, SNAPSHOT_FIELDS(frontendSnapshotLpr),
+                                     FRONTEND_SNAPSHOT_LPR, &frontendSnapshotCopy.lpr, length, &records);
+    length = frontendSnapshotSection(frontendSnapshotFetim, SNAPSHOT_FIELDS(frontendSnapshotFetim),
+                                     FRONTEND_SNAPSHOT_FETIM, &frontendSnapshotCopy.fetim, length, &records);
+
+    if (length == 0) {
+        /* The records of a full frontend fit in the buffer: this is a bug */
+        frontendSnapshotLength = 0;
+        pthread_mutex_unlock(&frontendSnapshotLock);
+        storeError(ERR_CAN, ERC_DEBUG_ME);  // Snapshot doesn't fit in the buffer
+        return ERROR;
+    }
+
+    frontendSnapshotPut(frontendSnapshot, FRONTEND_SNAPSHOT_MAGIC, 4);
+    frontendSnapshot[4] = FRONTEND_SNAPSHOT_VERSION;
+    frontendSnapshot[5] = VERSION_MAJOR;
+    frontendSnapshot[6] = VERSION_MINOR;
+    frontendSnapshot[7] = VERSION_PATCH;
+    frontendSnapshot[8] = frontendSnapshotSequence;
+    frontendSnapshotPut(frontendSnapshot + 9, records, 2);
+    frontendSnapshotPut(frontendSnapshot + 11, start.tv_sec * 1000UL + start.tv_nsec / 1000000, 4);
+
+    frontendSnapshotLength = length;
+
+    pthread_mutex_unlock(&frontendSnapshotLock);
+
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    elapsed = (stop.tv_sec - start.tv_sec) * 1000000L + (stop.tv_nsec - start.tv_nsec) / 1000;
+    if (elapsed > 0xFFFF) {
+        elapsed = 0xFFFF;
+    }
+
+    chunks = (length + FRONTEND_SNAPSHOT_CHUNK_DATA - 1) / FRONTEND_SNAPSHOT_CHUNK_DATA;
+    frontendSnapshotPut(data, length, 2);
+    frontendSnapshotPut(data + 2, chunks, 2);
+    data[4] = FRONTEND_SNAPSHOT_VERSION;
+    data[5] = frontendSnapshotSequence;
+    frontendSnapshotPut(data + 6, elapsed, 2);
+
+#ifdef DEBUG_SNAPSHOT
+    printf(" - frontendSnapshotCapture sequence=%d size=%u chunks=%u time=%ldus\n", frontendSnapshotSequence, length,
+           chunks, elapsed);
+#endif /* DEBUG_SNAPSHOT */
+
+    return NO_ERROR;
+}
+
+/* Read a frontend snapshot chunk */
+/*! This function returns a chunk of the last captured snapshot. No readout
+    state is kept, so several clients can read the snapshot at the same time.
+    The capture sequence is returned with the data so that a chunk of a newer
+    capture can be detected.
+    \param chunk   The index of the chunk
+    \param data    The 8 bytes buffer to fill with: capture sequence (1) and
+                   \ref FRONTEND_SNAPSHOT_CHUNK_DATA bytes of the snapshot,
+                   zero padded at the end of the snapshot
+    \return
+        - \ref NO_ERROR -> if a chunk was returned
+        - \ref ERROR    -> if the chunk is past the end of the snapshot. The
+                           buffer is filled with 0xFF. */
+int frontendSnapshotRead(unsigned int chunk, unsigned char *data) {
+    unsigned int offset, bytes;
+
+    pthread_mutex_lock(&frontendSnapshotLock);
+    offset = chunk * FRONTEND_SNAPSHOT_CHUNK_DATA;
+    if (offset >= frontendSnapshotLength) {
+        pthread_mutex_unlock(&frontendSnapshotLock);
+        memset(data, 0xFF, CAN_FULL_SIZE);
+        return ERROR;
+    }
+
+    bytes = frontendSnapshotLength - offset;
+    if (bytes > FRONTEND_SNAPSHOT_CHUNK_DATA) {
+        bytes = FRONTEND_SNAPSHOT_CHUNK_DATA;
+    }
+    data[0] = frontendSnapshotSequence;
+    memset(data + 1, 0, FRONTEND_SNAPSHOT_CHUNK_DATA);
+    memcpy(data + 1, frontendSnapshot + offset, bytes);
+    pthread_mutex_unlock(&frontendSnapshotLock);
+
+    return NO_ERROR;
+}
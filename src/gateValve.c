@@ -47,14 +47,14 @@ void gatevalveStateHandler(void) {
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.gateValve.lastState)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.lastControl.gateValveState)
 
         /* Check if the backing pump is enabled. If it's not then the electronics to
            control the gate valve is off. In that case, return the HARDW_BLKD_ERR
            and return. */
         if (frontend.cryostat.backingPump.enable == BACKING_PUMP_DISABLE) {
             storeError(ERR_GATE_VALVE, ERC_MODULE_POWER);  // Backing Pump off -> Gate valve disabled
-            frontend.cryostat.gateValve.lastState.status =
+            frontend.cryostat.lastControl.gateValveState.status =
                 HARDW_BLKD_ERR;  // Store the status in the last control message
             return;
         }
@@ -63,7 +63,7 @@ void gatevalveStateHandler(void) {
         if (getGateValveState() == ERROR) {
             /* If error while monitoring, store the status in the last control
                message */
-            frontend.cryostat.gateValve.lastState.status = ERROR;  // Store the status in the last control message
+            frontend.cryostat.lastControl.gateValveState.status = ERROR;
 
             return;
         }
@@ -72,7 +72,7 @@ void gatevalveStateHandler(void) {
         if (frontend.cryostat.gateValve.state == GATE_VALVE_UNKNOWN) {
             storeError(ERR_GATE_VALVE, ERC_HARDWARE_WAIT);  // Valve still moving -> Wait unil stopped
 
-            frontend.cryostat.gateValve.lastState.status =
+            frontend.cryostat.lastControl.gateValveState.status =
                 HARDW_BLKD_ERR;  // Store the status in the last control message
 
             return;
@@ -82,7 +82,7 @@ void gatevalveStateHandler(void) {
            CAN message. */
         if (setGateValveState(CAN_BYTE ? GATE_VALVE_OPEN : GATE_VALVE_CLOSE) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cryostat.gateValve.lastState.status = ERROR;
+            frontend.cryostat.lastControl.gateValveState.status = ERROR;
 
             return;
         }
@@ -94,7 +94,7 @@ void gatevalveStateHandler(void) {
     /* If monitor on a control RCA */
     if (currentClass == CONTROL_CLASS) {
         // Return the last control message and status:
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.gateValve.lastState)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.lastControl.gateValveState)
         return;
     }
 
@@ -47,14 +47,24 @@ int initialization(void) {
         return ERROR;
     }
 
-    if (owbGetEsn() == ERROR) {
+    /* Serve the ESNs found during the last search while the bus is searched
+       again in the background. */
+    owbLoadEsnCache();
+
+    if (owbStartScan() == ERROR) {
         return ERROR;
     }
 #endif /* OWB */
 
     /* Switch to maintenance while initializing frontend and before enabling
      * interrupt. */
+#ifdef SIMULATED_HARDWARE
+    /* No hardware: every serial interface must take its simulated path, also
+       during the initialization. */
+    frontend.mode = SIMULATION_MODE;
+#else
     frontend.mode = MAINTENANCE_MODE;
+#endif /* SIMULATED_HARDWARE */
 
     /* At this point we gathered all the information about the ESNs and the
        communication is fully established with the AMBSI. */
@@ -64,10 +74,14 @@ int initialization(void) {
         return ERROR;
     }
 
+#ifndef SIMULATED_HARDWARE
     /* Switch to operational mode */
     frontend.mode = OPERATIONAL_MODE;
+#endif /* SIMULATED_HARDWARE */
 
 #ifdef DEBUG_STARTUP
+    feAndCartridgesConfigurationReport();
+    frontendLayoutReport();
     printf("End initialization!\n\n");
 #endif
 
@@ -69,10 +69,9 @@ void attenuationHandler(int currentIfSwitchModule) {
     /* If control (size!=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.ifSwitch
-                                      .ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
-                                                [currentIfChannelSideband[currentIfSwitchModule]]
-                                      .lastAttenuation)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.ifSwitch.lastControl
+                                      .ifChannelAttenuation[currentIfChannelPolarization[currentIfSwitchModule]]
+                                                           [currentIfChannelSideband[currentIfSwitchModule]])
 
         /* Since the payload is just a byte, there is no need to conver the
            received data from the can message to any particular format, the
@@ -81,10 +80,9 @@ void attenuationHandler(int currentIfSwitchModule) {
             storeError(ERR_IF_CHANNEL, ERC_COMMAND_VAL);  // Attenuation set value out of range
 
             /* Store error in the last control message variable */
-            frontend.ifSwitch
-                .ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
-                          [currentIfChannelSideband[currentIfSwitchModule]]
-                .lastAttenuation.status = CON_ERROR_RNG;
+            frontend.ifSwitch.lastControl
+                .ifChannelAttenuation[currentIfChannelPolarization[currentIfSwitchModule]]
+                                     [currentIfChannelSideband[currentIfSwitchModule]].status = CON_ERROR_RNG;
 
             return;
         }
@@ -93,10 +91,9 @@ void attenuationHandler(int currentIfSwitchModule) {
            state and then return. */
         if (setIfChannelAttenuation(currentIfSwitchModule) == ERROR) {
             /* Store the Error state in the last control message variable */
-            frontend.ifSwitch
-                .ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
-                          [currentIfChannelSideband[currentIfSwitchModule]]
-                .lastAttenuation.status = ERROR;
+            frontend.ifSwitch.lastControl
+                .ifChannelAttenuation[currentIfChannelPolarization[currentIfSwitchModule]]
+                                     [currentIfChannelSideband[currentIfSwitchModule]].status = ERROR;
 
             return;
         }
@@ -108,10 +105,9 @@ void attenuationHandler(int currentIfSwitchModule) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {  // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.ifSwitch
-                                        .ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
-                                                  [currentIfChannelSideband[currentIfSwitchModule]]
-                                        .lastAttenuation)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.ifSwitch.lastControl
+                                        .ifChannelAttenuation[currentIfChannelPolarization[currentIfSwitchModule]]
+                                                             [currentIfChannelSideband[currentIfSwitchModule]])
         return;
     }
 
@@ -189,6 +189,56 @@ int setIfTempServoEnable(unsigned char enable, int currentIfSwitchModule) {
     return NO_ERROR;
 }
 
+/* IF channel temperature table */
+/* Temperature in K for every ADC code of the thermistor reading on the new
+   M&C hardware. It is filled by ifChannelTempInit() so that the monitor
+   doesn't have to evaluate the thermistor curve for every sample. */
+static float ifChannelTempTable[IF_ADC_RANGE];
+
+/* IF channel temperature table initialization */
+/*! This function evaluates the thermistor curve of the new M&C hardware for
+    every ADC code and stores the result in the lookup table used by
+    \ref getIfChannelTemp and \ref ifChannelTempsConversion. It has to be
+    called once during startup. */
+void ifChannelTempInit(void) {
+    unsigned int adcData;
+    float v, rTermistor;
+
+    for (adcData = 0; adcData < IF_ADC_RANGE; adcData++) {
+        /* Same scaling as the monitor request */
+        v = (IF_ADC_TEMP_V_SCALE * adcData) / IF_ADC_RANGE;
+        rTermistor = BRIDGE_RESISTOR_NEW_HARDW * (v / VREF_NEW_HARDW);
+        ifChannelTempTable[adcData] = BETA_NORDEN * 298.15 / (298.15 * log(rTermistor / 10000.0) + BETA_NORDEN);
+    }
+}
+
+/* IF channel temperatures batch conversion */
+/*! This function converts the thermistor ADC readings of all the IF channels
+    in one pass and stores the assembly temperatures in the \ref frontend
+    variable. Only the new M&C hardware is supported: the old hardware needs
+    two readings per channel.
+
+    \param adcData      These are the raw ADC readings, indexed by IF switch
+                        module (0-3)
+
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if the hardware revision is not supported */
+int ifChannelTempsConversion(const unsigned int adcData[IF_CHANNELS_NUMBER]) {
+    unsigned char channel;
+
+    if (frontend.ifSwitch.hardwRevision == IF_SWITCH_HRDW_REV0) {
+        return ERROR;
+    }
+
+    for (channel = 0; channel < IF_CHANNELS_NUMBER; channel++) {
+        frontend.ifSwitch.ifChannel[currentIfChannelPolarization[channel]][currentIfChannelSideband[channel]]
+            .assemblyTemp = ifChannelTempTable[adcData[channel] & (IF_ADC_RANGE - 1)] - TEMP_OFFSET;
+    }
+
+    return NO_ERROR;
+}
+
 /* Get IF channel temperature */
 /*! This function gets the temperature of the selected IF switch channel.
     The temperatures are computed in different ways depending on the hardware
@@ -211,7 +261,7 @@ int setIfTempServoEnable(unsigned char enable, int currentIfSwitchModule) {
         - \ref ERROR    -> if something wrong happened */
 int getIfChannelTemp(int currentIfSwitchModule) {
     /* Variables to store the temporary data */
-    float v = 0.0, v1 = 0.0, v2 = 0.0, rTermistor = 0.0, temperature = 0.0;
+    float v1 = 0.0, v2 = 0.0, rTermistor = 0.0, temperature = 0.0;
 
     if (frontend.mode != SIMULATION_MODE) {
         /* Clear the IF switch GREG */
@@ -249,8 +299,14 @@ int getIfChannelTemp(int currentIfSwitchModule) {
             rTermistor = BRIDGE_RESISTOR * (v1 + v2 - 2.0 * VREF) / (VREF - v1);
 
             /* Find the temperature in K */
+            errno = 0;
             temperature = BETA_NORDEN * 298.15 / (298.15 * log(rTermistor / 10000.0) + BETA_NORDEN);
 
+            /* Check if a domain error occurred while evaluating the log. */
+            if (errno == EDOM) {
+                return HARDW_CON_ERR;
+            }
+
         } else {  // If it is the new hardware
 
             /* 1 - Select the desired monitor point
@@ -262,20 +318,8 @@ int getIfChannelTemp(int currentIfSwitchModule) {
                 return ERROR;
             }
 
-            /* 3 - Scale the first data and store in temporary variable */
-            v = (IF_ADC_TEMP_V_SCALE * ifRegisters.adcData) / IF_ADC_RANGE;
-
-            /* 4 - Scale the data */
-            /* Find the termistor resistance */
-            rTermistor = BRIDGE_RESISTOR_NEW_HARDW * (v / VREF_NEW_HARDW);
-
-            /* Find the temperature in K */
-            temperature = BETA_NORDEN * 298.15 / (298.15 * log(rTermistor / 10000.0) + BETA_NORDEN);
-        }
-
-        /* Check if a domain error occurred while evaluating the log. */
-        if (errno == EDOM) {
-            return HARDW_CON_ERR;
+            /* 3 - Find the temperature in K from the precomputed table */
+            temperature = ifChannelTempTable[ifRegisters.adcData & (IF_ADC_RANGE - 1)];
         }
 
         /* If no error in evaluating the temperature, store the data */
@@ -423,10 +467,11 @@ int setIfChannelAttenuation(int currentIfSwitchModule) {
         -# If no error occurs, update AREG and the frontend variable with the
            new state.
 
+    \param band     The band to select (\ref BAND1 through \ref BAND10)
     \return
         - \ref NO_ERROR -> if no error occurres
         - \ref ERROR    -> if something wrong happened */
-int setIfSwitchBandSelect(void) {
+int setIfSwitchBandSelect(unsigned char band) {
     /* Store the current value of the temperature servo mode in a temporary
        variable. We use a temporary variable so that if any error occurs during
        the update of the hardware state, we don't end up with AREG describing a
@@ -435,7 +480,7 @@ int setIfSwitchBandSelect(void) {
 
     if (frontend.mode != SIMULATION_MODE) {
         /* Update AREG */
-        ifRegisters.aReg = IF_AREG_SELECT_WAY(CAN_BYTE);
+        ifRegisters.aReg = IF_AREG_SELECT_WAY(band);
 
 /* 2 - Parallel write AREG */
 #ifdef DEBUG_IFSWITCH_SERIAL
@@ -454,7 +499,7 @@ int setIfSwitchBandSelect(void) {
 
     /* Since there is no real hardware read back, if no error occurred the
        current state is updated to reflect the issued command. */
-    frontend.ifSwitch.bandSelect = CAN_BYTE;
+    frontend.ifSwitch.bandSelect = band;
 
     return NO_ERROR;
 }
@@ -65,7 +65,7 @@ void bandSelectHandler(int currentIfSwitchModule) {
     /* If control (size!=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.ifSwitch.lastBandSelect)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.ifSwitch.lastControl.bandSelect)
 
         /* Since the payload is just a byte, there is no need to conver the
            received data from the can message to any particular format, the
@@ -74,15 +74,15 @@ void bandSelectHandler(int currentIfSwitchModule) {
             storeError(ERR_IF_SWITCH, ERC_COMMAND_VAL);  // Selected band set value out of range
 
             /* Store error in the last control message variable */
-            frontend.ifSwitch.lastBandSelect.status = CON_ERROR_RNG;
+            frontend.ifSwitch.lastControl.bandSelect.status = CON_ERROR_RNG;
             return;
         }
 
         /* Set the IF switch band. If an error occurs then store the state and
            return. */
-        if (setIfSwitchBandSelect() == ERROR) {
+        if (setIfSwitchBandSelect(CAN_BYTE) == ERROR) {
             /* Store the error state in the last control message variable */
-            frontend.ifSwitch.lastBandSelect.status = ERROR;
+            frontend.ifSwitch.lastControl.bandSelect.status = ERROR;
             return;
         }
 
@@ -93,7 +93,7 @@ void bandSelectHandler(int currentIfSwitchModule) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {  // If monitor on control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.ifSwitch.lastBandSelect)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.ifSwitch.lastControl.bandSelect)
         return;
     }
 
@@ -114,7 +114,7 @@ void allChannelsHandler(int currentIfSwitchModule) {
     /* If control (size!=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.ifSwitch.lastAllChannelsAtten)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.ifSwitch.lastControl.allChannelsAtten)
 
         // Set all four IF switch attenuators:
         for (int currentIfSwitchModule = 0; currentIfSwitchModule < IF_CHANNELS_NUMBER; currentIfSwitchModule++) {
@@ -124,7 +124,7 @@ void allChannelsHandler(int currentIfSwitchModule) {
                 storeError(ERR_IF_SWITCH, ERC_COMMAND_VAL);  // Attenuation set value out of range
 
                 /* Store error in the last control message variable */
-                frontend.ifSwitch.lastAllChannelsAtten.status = CON_ERROR_RNG;
+                frontend.ifSwitch.lastControl.allChannelsAtten.status = CON_ERROR_RNG;
                 return;
             }
             // Copy the attenuation for the current module being set to CAN_BYTE:
@@ -133,7 +133,7 @@ void allChannelsHandler(int currentIfSwitchModule) {
             // Set the current attenuator using CAN_BYTE:
             if (setIfChannelAttenuation(currentIfSwitchModule) == ERROR) {
                 /* Store the Error state in the last control message variable */
-                frontend.ifSwitch.lastAllChannelsAtten.status = ERROR;
+                frontend.ifSwitch.lastControl.allChannelsAtten.status = ERROR;
                 // bail out early if error:
                 return;
             }
@@ -145,7 +145,7 @@ void allChannelsHandler(int currentIfSwitchModule) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {  // If monitor on control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.ifSwitch.lastAllChannelsAtten)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.ifSwitch.lastControl.allChannelsAtten)
         return;
     }
 
@@ -185,6 +185,14 @@ int ifSwitchStartup(void) {
 #ifdef DEBUG_STARTUP
     printf("     Revision level: %d\n", frontend.ifSwitch.hardwRevision);
     printf("    done!\n");  // Hardware Revision Level
+    printf("  - Building the IF channel temperature table...\n");
+#endif
+
+    /* Precompute the thermistor curve for the assembly temperature monitor */
+    ifChannelTempInit();
+
+#ifdef DEBUG_STARTUP
+    printf("    done!\n");  // Temperature table
     printf(" done!\n\n");   // Initialization
 #endif
     return NO_ERROR;
@@ -52,19 +52,17 @@ void ifTempServoEnableHandler(int currentIfSwitchModule) {
     /* If control (size!=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.ifSwitch
-                                      .ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
-                                                [currentIfChannelSideband[currentIfSwitchModule]]
-                                      .ifTempServo.lastEnable)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.ifSwitch.lastControl
+                                      .ifTempServoEnable[currentIfChannelPolarization[currentIfSwitchModule]]
+                                                        [currentIfChannelSideband[currentIfSwitchModule]])
 
         /* Check that the CAN_BYTE is a legal value for enable/disable */
         if (CAN_BYTE != IF_TEMP_SERVO_ENABLE && CAN_BYTE != IF_TEMP_SERVO_DISABLE) {
             storeError(ERR_IF_CHANNEL, ERC_COMMAND_VAL);  // Bad command for servo enable/disable
             /* Store the ERROR state in the last control message variable */
-            frontend.ifSwitch
-                .ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
-                          [currentIfChannelSideband[currentIfSwitchModule]]
-                .ifTempServo.lastEnable.status = ERROR;
+            frontend.ifSwitch.lastControl
+                .ifTempServoEnable[currentIfChannelPolarization[currentIfSwitchModule]]
+                                  [currentIfChannelSideband[currentIfSwitchModule]].status = ERROR;
             return;
         }
 
@@ -73,10 +71,9 @@ void ifTempServoEnableHandler(int currentIfSwitchModule) {
         if (setIfTempServoEnable(CAN_BYTE ? IF_TEMP_SERVO_ENABLE : IF_TEMP_SERVO_DISABLE, currentIfSwitchModule) ==
             ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.ifSwitch
-                .ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
-                          [currentIfChannelSideband[currentIfSwitchModule]]
-                .ifTempServo.lastEnable.status = ERROR;
+            frontend.ifSwitch.lastControl
+                .ifTempServoEnable[currentIfChannelPolarization[currentIfSwitchModule]]
+                                  [currentIfChannelSideband[currentIfSwitchModule]].status = ERROR;
 
             return;
         }
@@ -88,10 +85,9 @@ void ifTempServoEnableHandler(int currentIfSwitchModule) {
     /* If monitor on a control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.ifSwitch
-                                        .ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
-                                                  [currentIfChannelSideband[currentIfSwitchModule]]
-                                        .ifTempServo.lastEnable)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.ifSwitch.lastControl
+                                        .ifTempServoEnable[currentIfChannelPolarization[currentIfSwitchModule]]
+                                                          [currentIfChannelSideband[currentIfSwitchModule]])
         return;
     }
 
@@ -14,12 +14,16 @@
 #include "debug.h"
 #include "error_local.h"
 #include "frontend.h"
+#include "iniWrapper.h"
 
 /* Statics */
 static HANDLER_INT_INT_INT_INT lnaModulesHandler[LNA_MODULES_NUMBER] = {
     lnaStageHandler,    lnaStageHandler,    lnaStageHandler, RESERVEDLNAHandler,
     RESERVEDLNAHandler, RESERVEDLNAHandler, lnaEnableHandler};
 
+/* Drain set points staged for the bulk LNA bias */
+static LNA_BIAS_SETPOINT lnaBiasStaged[CARTRIDGES_NUMBER][POLARIZATIONS_NUMBER][SIDEBANDS_NUMBER][LNA_STAGES_NUMBER];
+
 /* LNA handler */
 /*! This function will be called by the CAN message handling subroutine when the
     received message is pertinent to the LNA. */
@@ -59,17 +63,13 @@ void lnaEnableHandler(int currentModule, int currentBiasModule, int currentPolar
     if (CAN_SIZE) {
         // save the incoming message:
         SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                      .polarization[currentBiasModule]
-                                      .sideband[currentPolarizationModule]
-                                      .lna.lastEnable)
+                                      .lastControl.lnaEnable[currentBiasModule][currentPolarizationModule])
 
         // If we are in STANDBY2 mode, return HARDW_BLKD_ERR
         if (frontend.cartridge[currentModule].standby2) {
             /* Store the ERROR state in the last control message variable */
             frontend.cartridge[currentModule]
-                .polarization[currentBiasModule]
-                .sideband[currentPolarizationModule]
-                .lna.lastEnable.status = HARDW_BLKD_ERR;
+                .lastControl.lnaEnable[currentBiasModule][currentPolarizationModule].status = HARDW_BLKD_ERR;
             return;
         }
 
@@ -79,9 +79,7 @@ void lnaEnableHandler(int currentModule, int currentBiasModule, int currentPolar
                              currentPolarizationModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
             frontend.cartridge[currentModule]
-                .polarization[currentBiasModule]
-                .sideband[currentPolarizationModule]
-                .lna.lastEnable.status = ERROR;
+                .lastControl.lnaEnable[currentBiasModule][currentPolarizationModule].status = ERROR;
             return;
         }
 
@@ -101,9 +99,7 @@ void lnaEnableHandler(int currentModule, int currentBiasModule, int currentPolar
     if (currentClass == CONTROL_CLASS) {
         // Return the last control message and status:
         RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                        .polarization[currentBiasModule]
-                                        .sideband[currentPolarizationModule]
-                                        .lna.lastEnable)
+                                        .lastControl.lnaEnable[currentBiasModule][currentPolarizationModule])
         return;
     }
 
@@ -118,19 +114,180 @@ void lnaEnableHandler(int currentModule, int currentBiasModule, int currentPolar
     CAN_SIZE = CAN_BOOLEAN_SIZE;
 }
 
-// set the specified LNA to STANDBY2 mode
-void lnaGoStandby2(int currentModule, int currentBiasModule, int currentPolarizationModule) {
-#ifdef DEBUG_GO_STANDBY2
-    int ret;
-    printf(" - lnaGoStandby2 pol=%d sb=%d\n", currentBiasModule, currentPolarizationModule);
-    // disable the LNA:
-    ret = setLnaBiasEnable(LNA_BIAS_DISABLE, currentModule, currentBiasModule, currentPolarizationModule);
-#else
-    // disable the LNA:
-    setLnaBiasEnable(LNA_BIAS_DISABLE, currentModule, currentBiasModule, currentPolarizationModule);
-#endif  // DEBUG_GO_STANDBY2
-
-#ifdef DEBUG_GO_STANDBY2
-    if (ret) printf(" -- ret=%d\n", ret);
-#endif  // DEBUG_GO_STANDBY2
+/* Stage LNA bias */
+/*! This function stores the drain set points of one LNA stage to be applied
+    later by \ref lnaBiasApply. The request is 5 bytes:
+        - byte 0: bit 7 polarization, bit 6 sideband, bits 1-0 stage
+        - bytes 1-2: drain voltage in 0.1 mV (unsigned, big endian)
+        - bytes 3-4: drain current in uA (unsigned, big endian)
+    \param currentModule   The cartridge hosting the LNA
+    \param data            The request payload
+    \param size            The request size
+    \return
+        - \ref NO_ERROR -> if the set point was staged
+        - \ref ERROR    -> if the request was refused */
+int lnaBiasStage(int currentModule, const unsigned char *data, unsigned char size) {
+    int pol, sb, stage;
+    float drainVoltage, drainCurrent;
+
+    if (size != 5) {
+        storeError(ERR_LNA, ERC_COMMAND_VAL);  // Malformed stage request
+        return ERROR;
+    }
+
+    pol = (data[0] & LNA_BIAS_POL_BIT) ? POLARIZATION1 : POLARIZATION0;
+    sb = (data[0] & LNA_BIAS_SB_BIT) ? SIDEBAND1 : SIDEBAND0;
+    stage = data[0] & LNA_BIAS_STAGE_MASK;
+    drainVoltage = ((data[1] << 8) | data[2]) * LNA_BIAS_V_SCALE;
+    drainCurrent = ((data[3] << 8) | data[4]) * LNA_BIAS_I_SCALE;
+
+    if (stage >= LNA_STAGES_NUMBER || drainVoltage > LNA_BIAS_MAX_V || drainCurrent > LNA_BIAS_MAX_I) {
+        storeError(ERR_LNA, ERC_COMMAND_VAL);  // Set point out of range
+        return ERROR;
+    }
+
+    lnaBiasStaged[currentModule][pol][sb][stage].drainVoltage = drainVoltage;
+    lnaBiasStaged[currentModule][pol][sb][stage].drainCurrent = drainCurrent;
+    lnaBiasStaged[currentModule][pol][sb][stage].valid = TRUE;
+
+    return NO_ERROR;
+}
+
+/* Load the LNA bias preset of a cartridge from its configuration file. Stages
+   without both keys are left out of the preset. */
+static int lnaBiasLoadPreset(int currentModule) {
+    CFG_STRUCT dataIn;
+    char section[SENSOR_SEC_NAME_SIZE];
+    LNA_BIAS_SETPOINT *setPoint;
+    int pol, sb, stage, found = 0;
+
+    for (pol = 0; pol < POLARIZATIONS_NUMBER; pol++) {
+        for (sb = 0; sb < SIDEBANDS_NUMBER; sb++) {
+            for (stage = 0; stage < LNA_STAGES_NUMBER; stage++) {
+                setPoint = &lnaBiasStaged[currentModule][pol][sb][stage];
+                setPoint->valid = FALSE;
+                snprintf(section, sizeof(section), LNA_PRESET_SECTION, pol, sb, stage);
+
+                dataIn.Name = LNA_PRESET_VD_KEY;
+                dataIn.VarType = Cfg_Float;
+                dataIn.DataPtr = &setPoint->drainVoltage;
+                if (myReadCfg(frontend.cartridge[currentModule].configFile, section, &dataIn, LNA_PRESET_EXPECTED) !=
+                    NO_ERROR) {
+                    continue;
+                }
+
+                dataIn.Name = LNA_PRESET_ID_KEY;
+                dataIn.VarType = Cfg_Float;
+                dataIn.DataPtr = &setPoint->drainCurrent;
+                if (myReadCfg(frontend.cartridge[currentModule].configFile, section, &dataIn, LNA_PRESET_EXPECTED) !=
+                    NO_ERROR) {
+                    continue;
+                }
+
+                if (setPoint->drainVoltage < 0.0 || setPoint->drainVoltage > LNA_BIAS_MAX_V ||
+                    setPoint->drainCurrent < 0.0 || setPoint->drainCurrent > LNA_BIAS_MAX_I) {
+                    storeError(ERR_LNA, ERC_COMMAND_VAL);  // Preset out of range
+                    continue;
+                }
+
+                setPoint->valid = TRUE;
+                found++;
+
+#ifdef DEBUG_LNA_PRESET
+                printf("    - LNA preset %s: VD=%f ID=%f\n", section, setPoint->drainVoltage, setPoint->drainCurrent);
+#endif /* DEBUG_LNA_PRESET */
+            }
+        }
+    }
+
+    if (found == 0) {
+        storeError(ERR_LNA, ERC_FLASH_ERROR);  // No preset in the configuration file
+        return ERROR;
+    }
+
+    return NO_ERROR;
+}
+
+/* Store a drain set point in a last control message, as if it was received
+   on the standard RCA. */
+static void lnaBiasLastControl(LAST_CONTROL_MESSAGE *last, float value, int status) {
+    CONVERSION conv;
+
+    conv.flt = value;
+    changeEndian(last->data, conv.chr);
+    last->size = CAN_FLOAT_SIZE;
+    last->status = status;
+}
+
+/* Apply LNA bias */
+/*! This function writes all the staged drain set points of a cartridge, one
+    DAC1 burst per polarization (see \ref setLnaStages). The request is 1 byte:
+        - \ref LNA_BIAS_APPLY_STAGED -> apply the set points staged with
+          \ref lnaBiasStage
+        - \ref LNA_BIAS_APPLY_PRESET -> load the set points from the VD and ID
+          keys of the LNA stage sections of the cartridge configuration file
+          and apply them
+
+    The last control messages of the standard drain voltage and current RCAs
+    are updated with the applied values and the result. The staged set points
+    are cleared once applied.
+    \param currentModule   The cartridge to bias
+    \param data            The request payload
+    \param size            The request size
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int lnaBiasApply(int currentModule, const unsigned char *data, unsigned char size) {
+    int pol, sb, stage, status, ret = NO_ERROR;
+    LNA_BIAS_SETPOINT *setPoint;
+    CARTRIDGE_LAST_CONTROL *lastControl;
+
+    if (size != CAN_BYTE_SIZE || data[0] > LNA_BIAS_APPLY_PRESET) {
+        storeError(ERR_LNA, ERC_COMMAND_VAL);  // Malformed apply request
+        return ERROR;
+    }
+
+    /* The bias drives the hardware, block it in maintenance mode as for the
+       standard control RCAs. */
+    if (frontend.mode == MAINTENANCE_MODE) {
+        storeError(ERR_CAN, ERC_MAINT_MODE);  // Front End in maintenance mode
+        return ERROR;
+    }
+
+    if (frontend.cartridge[currentModule].available == UNAVAILABLE) {
+        storeError(ERR_LNA, ERC_MODULE_ABSENT);  // Cartridge not installed
+        return ERROR;
+    }
+
+    if (frontend.cartridge[currentModule].state != CARTRIDGE_READY || frontend.cartridge[currentModule].standby2) {
+        storeError(ERR_LNA, ERC_MODULE_POWER);  // Cartridge not ready for biasing
+        return ERROR;
+    }
+
+    if (data[0] == LNA_BIAS_APPLY_PRESET && lnaBiasLoadPreset(currentModule) == ERROR) {
+        return ERROR;
+    }
+
+    for (pol = 0; pol < POLARIZATIONS_NUMBER; pol++) {
+        status = setLnaStages(currentModule, pol,
+                              (const LNA_BIAS_SETPOINT(*)[LNA_STAGES_NUMBER])lnaBiasStaged[currentModule][pol]);
+        if (status == ERROR) {
+            ret = ERROR;
+        }
+
+        for (sb = 0; sb < SIDEBANDS_NUMBER; sb++) {
+            for (stage = 0; stage < LNA_STAGES_NUMBER; stage++) {
+                setPoint = &lnaBiasStaged[currentModule][pol][sb][stage];
+                if (!setPoint->valid) {
+                    continue;
+                }
+                lastControl = &frontend.cartridge[currentModule].lastControl;
+                lnaBiasLastControl(&lastControl->lnaStageDrainVoltage[pol][sb][stage], setPoint->drainVoltage, status);
+                lnaBiasLastControl(&lastControl->lnaStageDrainCurrent[pol][sb][stage], setPoint->drainCurrent, status);
+                setPoint->valid = FALSE;
+            }
+        }
+    }
+
+    return ret;
 }
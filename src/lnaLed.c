@@ -49,12 +49,12 @@ void lnaLedEnableHandler(int currentModule, int currentBiasModule, int currentPo
     /* If contro (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].polarization[currentBiasModule].lnaLed.lastEnable)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.lnaLedEnable[currentBiasModule])
 
         // If we are in STANDBY2 mode, return HARDW_BLKD_ERR
         if (frontend.cartridge[currentModule].standby2) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].polarization[currentBiasModule].lnaLed.lastEnable.status = HARDW_BLKD_ERR;
+            frontend.cartridge[currentModule].lastControl.lnaLedEnable[currentBiasModule].status = HARDW_BLKD_ERR;
 
             return;
         }
@@ -64,7 +64,7 @@ void lnaLedEnableHandler(int currentModule, int currentBiasModule, int currentPo
         if (setLnaLedEnable(CAN_BYTE ? LNA_LED_ENABLE : LNA_LED_DISABLE, currentModule, currentBiasModule,
                             currentPolarizationModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].polarization[currentBiasModule].lnaLed.lastEnable.status = ERROR;
+            frontend.cartridge[currentModule].lastControl.lnaLedEnable[currentBiasModule].status = ERROR;
 
             return;
         }
@@ -76,7 +76,7 @@ void lnaLedEnableHandler(int currentModule, int currentBiasModule, int currentPo
     /* If monitor on a control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].polarization[currentBiasModule].lnaLed.lastEnable)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.lnaLedEnable[currentBiasModule])
         return;
     }
 
@@ -88,20 +88,3 @@ void lnaLedEnableHandler(int currentModule, int currentBiasModule, int currentPo
     CAN_BYTE = frontend.cartridge[currentModule].polarization[currentBiasModule].lnaLed.enable;
     CAN_SIZE = CAN_BOOLEAN_SIZE;
 }
-
-// set the specified LNA LED to STANDBY2 mode
-void lnaLedGoStandby2(int currentModule, int currentBiasModule, int currentPolarizationModule) {
-#ifdef DEBUG_GO_STANDBY2
-    int ret;
-    printf(" - lnaLedGoStandby2 pol=%d\n", currentBiasModule);
-    // disable the LNA LED:
-    ret = setLnaLedEnable(LNA_LED_DISABLE, currentModule, currentBiasModule, currentPolarizationModule);
-#else
-    // disable the LNA LED:
-    setLnaLedEnable(LNA_LED_DISABLE, currentModule, currentBiasModule, currentPolarizationModule);
-#endif  // DEBUG_GO_STANDBY2
-
-#ifdef DEBUG_GO_STANDBY2
-    if (ret) printf(" -- ret=%d\n", ret);
-#endif  // DEBUG_GO_STANDBY2
-}
@@ -56,11 +56,9 @@ void lnaStageDrainVoltageHandler(int currentModule, int currentBiasModule, int c
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                      .polarization[currentBiasModule]
-                                      .sideband[currentPolarizationModule]
-                                      .lna.stage[currentLnaModule]
-                                      .lastDrainVoltage)
+        SAVE_LAST_CONTROL_MESSAGE(
+            frontend.cartridge[currentModule]
+                .lastControl.lnaStageDrainVoltage[currentBiasModule][currentPolarizationModule][currentLnaModule])
 
         /* Extract the float from the can message. */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -69,10 +67,8 @@ void lnaStageDrainVoltageHandler(int currentModule, int currentBiasModule, int c
         if (frontend.cartridge[currentModule].standby2) {
             /* Store the ERROR state in the last control message variable */
             frontend.cartridge[currentModule]
-                .polarization[currentBiasModule]
-                .sideband[currentPolarizationModule]
-                .lna.stage[currentLnaModule]
-                .lastDrainVoltage.status = HARDW_BLKD_ERR;
+                .lastControl.lnaStageDrainVoltage[currentBiasModule][currentPolarizationModule][currentLnaModule]
+                .status = HARDW_BLKD_ERR;
 
             return;
         }
@@ -83,10 +79,8 @@ void lnaStageDrainVoltageHandler(int currentModule, int currentBiasModule, int c
                         currentLnaStageModule) == ERROR) {
             /* Store the ERROR state in the last control message varibale */
             frontend.cartridge[currentModule]
-                .polarization[currentBiasModule]
-                .sideband[currentPolarizationModule]
-                .lna.stage[currentLnaModule]
-                .lastDrainVoltage.status = ERROR;
+                .lastControl.lnaStageDrainVoltage[currentBiasModule][currentPolarizationModule][currentLnaModule]
+                .status = ERROR;
 
             return;
         }
@@ -98,11 +92,9 @@ void lnaStageDrainVoltageHandler(int currentModule, int currentBiasModule, int c
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                        .polarization[currentBiasModule]
-                                        .sideband[currentPolarizationModule]
-                                        .lna.stage[currentLnaModule]
-                                        .lastDrainVoltage)
+        RETURN_LAST_CONTROL_MESSAGE(
+            frontend.cartridge[currentModule]
+                .lastControl.lnaStageDrainVoltage[currentBiasModule][currentPolarizationModule][currentLnaModule])
         return;
     }
 
@@ -149,11 +141,9 @@ void lnaStageDrainCurrentHandler(int currentModule, int currentBiasModule, int c
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                      .polarization[currentBiasModule]
-                                      .sideband[currentPolarizationModule]
-                                      .lna.stage[currentLnaModule]
-                                      .lastDrainCurrent)
+        SAVE_LAST_CONTROL_MESSAGE(
+            frontend.cartridge[currentModule]
+                .lastControl.lnaStageDrainCurrent[currentBiasModule][currentPolarizationModule][currentLnaModule])
 
         /* Extract the float from the can message. */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -162,10 +152,8 @@ void lnaStageDrainCurrentHandler(int currentModule, int currentBiasModule, int c
         if (frontend.cartridge[currentModule].standby2) {
             /* Store the ERROR state in the last control message variable */
             frontend.cartridge[currentModule]
-                .polarization[currentBiasModule]
-                .sideband[currentPolarizationModule]
-                .lna.stage[currentLnaModule]
-                .lastDrainCurrent.status = HARDW_BLKD_ERR;
+                .lastControl.lnaStageDrainCurrent[currentBiasModule][currentPolarizationModule][currentLnaModule]
+                .status = HARDW_BLKD_ERR;
 
             return;
         }
@@ -175,10 +163,8 @@ void lnaStageDrainCurrentHandler(int currentModule, int currentBiasModule, int c
                         currentLnaStageModule) == ERROR) {
             /* Store the ERROR state in the last control message varibale */
             frontend.cartridge[currentModule]
-                .polarization[currentBiasModule]
-                .sideband[currentPolarizationModule]
-                .lna.stage[currentLnaModule]
-                .lastDrainCurrent.status = ERROR;
+                .lastControl.lnaStageDrainCurrent[currentBiasModule][currentPolarizationModule][currentLnaModule]
+                .status = ERROR;
 
             return;
         }
@@ -190,11 +176,9 @@ void lnaStageDrainCurrentHandler(int currentModule, int currentBiasModule, int c
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {  // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                        .polarization[currentBiasModule]
-                                        .sideband[currentPolarizationModule]
-                                        .lna.stage[currentLnaModule]
-                                        .lastDrainCurrent)
+        RETURN_LAST_CONTROL_MESSAGE(
+            frontend.cartridge[currentModule]
+                .lastControl.lnaStageDrainCurrent[currentBiasModule][currentPolarizationModule][currentLnaModule])
         return;
     }
 
@@ -7,9 +7,11 @@
     This file contains all the functions necessary to handle LO events. */
 
 /* Includes */
-#include <stdio.h>  /* printf & sscanf */
-#include <stdlib.h> /* malloc */
-#include <string.h> /* memset & strtok */
+#include <pthread.h>  /* pthread_mutex_t */
+#include <stdint.h>   /* uint32_t */
+#include <stdio.h>    /* printf & sscanf */
+#include <stdlib.h>   /* malloc */
+#include <string.h>   /* memset & strtok */
 
 #include "debug.h"
 #include "error_local.h"
@@ -21,9 +23,42 @@
 /* Statics */
 static HANDLER_INT loModulesHandler[LO_MODULES_NUMBER] = {ytoHandler, photomixerHandler, pllHandler,
                                                           amcHandler, paHandler,         teledynePaHandler};
+/* The PA limits table of a band is replaced and grown by the message loop
+   while the cartridge async process searches it (PLL lock search): every
+   access to the table of a band is done holding the lock of the band. */
+static pthread_mutex_t loPaLimitsLock[CARTRIDGES_NUMBER] = {[0 ... CARTRIDGES_NUMBER - 1] =
+                                                                PTHREAD_MUTEX_INITIALIZER};
+
+/* Typedefs */
+/* Binary PA limits table file header. The file is written next to the WCA
+   configuration file and is only used while the configuration file keeps the
+   size and content hash recorded here. Only fixed width fields are used, so
+   the layout doesn't depend on the word size of the build. The fields are in
+   host byte order: a file written with the other one fails the magic check and
+   is rebuilt from the configuration file. */
+typedef struct {
+    uint32_t magic;                // LO_PA_LIMITS_CACHE_MAGIC
+    uint32_t version;              // LO_PA_LIMITS_CACHE_VERSION
+    uint32_t entries;              // Number of entries following the header
+    uint32_t checksum;             // Sum of the bytes of the entries
+    uint32_t iniSize;              // Size of the configuration file
+    uint32_t iniHash;              // FNV-1a hash of the content of the configuration file
+    char esn[SERIAL_NUMBER_SIZE];  // maxSafeLoPaESN
+} LO_PA_LIMITS_CACHE_HEADER;
+
+/* Binary PA limits table file entry */
+typedef struct {
+    uint32_t ytoEndpoint;
+    float maxVD0;
+    float maxVD1;
+} LO_PA_LIMITS_CACHE_ENTRY;
 
 /* Forward declarations */
 void loLoadPaLimitsTable(unsigned char band);
+static int loLoadPaLimitsCache(unsigned char band);
+static int loWritePaLimitsCache(unsigned char band);
+static int searchMaxSafeLoPaEntry(unsigned int yto, int currentModule, MAX_SAFE_LO_PA_ENTRY *entry);
+static void loPaLimitsSlope(MAX_SAFE_LO_PA_ENTRY *table, unsigned int tableSize, unsigned int index);
 
 // Loop BW defaults - No longer loading from INI file:
 static char loopBandwidthDefaults[10] = {
@@ -96,6 +131,7 @@ int loInit(int currentModule) {
         - \ref NO_ERROR -> if no error occurred
         - \ref ERROR    -> if something wrong happened */
 int loZeroPaDrainVoltage(int currentModule) {
+    CONVERSION drainVoltage;
     unsigned char *lastCommandData;
 
 /* Set the PA's drain voltage to 0. The mapping from channel to actual
@@ -104,7 +140,7 @@ int loZeroPaDrainVoltage(int currentModule) {
     printf("   - Setting PAs drain voltage to 0\n");
 #endif  // DEBUG_INIT
 
-    CONV_FLOAT = 0.0;
+    drainVoltage.flt = 0.0;
     int currentPaChannelModule = PA_CHANNEL_DRAIN_VOLTAGE;
 
 /* PA Channel A */
@@ -113,15 +149,15 @@ int loZeroPaDrainVoltage(int currentModule) {
 #endif  // DEBUG_INIT
     int currentPaModule = PA_CHANNEL_A;
     /* Set Channel. If error, return error and abort initialization */
-    if (setPaChannel(currentModule, currentPaModule, currentPaChannelModule) == ERROR) {
+    if (setPaChannel(drainVoltage.flt, currentModule, currentPaModule, currentPaChannelModule) == ERROR) {
         return ERROR;
     }
 
     // make a pointer to the data word in the last commanded PA drain voltage:
-    lastCommandData = frontend.cartridge[currentModule].lo.pa.paChannel[currentPaModule].lastDrainVoltage.data;
+    lastCommandData = frontend.cartridge[currentModule].lastControl.paChannelDrainVoltage[currentPaModule].data;
 
     // save the zero we just sent as the last commanded value:
-    changeEndian(lastCommandData, CONV_CHR_ADD);
+    changeEndian(lastCommandData, drainVoltage.chr);
 
 #ifdef DEBUG_INIT
     printf("       done!\n");  // Channel A
@@ -133,15 +169,15 @@ int loZeroPaDrainVoltage(int currentModule) {
 #endif  // DEBUG_INIT
     currentPaModule = PA_CHANNEL_B;
     /* Set Channel. If error, return error and abort initialization */
-    if (setPaChannel(currentModule, currentPaModule, currentPaChannelModule) == ERROR) {
+    if (setPaChannel(drainVoltage.flt, currentModule, currentPaModule, currentPaChannelModule) == ERROR) {
         return ERROR;
     }
 
     // make a pointer to the data word in the last commanded PA drain voltage:
-    lastCommandData = frontend.cartridge[currentModule].lo.pa.paChannel[currentPaModule].lastDrainVoltage.data;
+    lastCommandData = frontend.cartridge[currentModule].lastControl.paChannelDrainVoltage[currentPaModule].data;
 
     // save the zero we just sent as the last commanded value:
-    changeEndian(lastCommandData, CONV_CHR_ADD);
+    changeEndian(lastCommandData, drainVoltage.chr);
 
 #ifdef DEBUG_INIT
     printf("       done!\n");  // Channel B
@@ -159,7 +195,6 @@ int loZeroPAGateVoltage(int currentModule) {
 #ifdef DEBUG_INIT
     printf("   - Setting PAs gate voltage to 0\n");
 #endif  // DEBUG_INIT
-    CONV_FLOAT = 0.0;
     int currentPaChannelModule = PA_CHANNEL_GATE_VOLTAGE;
 
 /* PA Channel A */
@@ -168,7 +203,7 @@ int loZeroPAGateVoltage(int currentModule) {
 #endif  // DEBUG_INIT
     int currentPaModule = PA_CHANNEL_A;
     /* Set Channel. If error, return error and abort initialization */
-    if (setPaChannel(currentModule, currentPaModule, currentPaChannelModule) == ERROR) {
+    if (setPaChannel(0.0, currentModule, currentPaModule, currentPaChannelModule) == ERROR) {
         return ERROR;
     }
 #ifdef DEBUG_INIT
@@ -181,7 +216,7 @@ int loZeroPAGateVoltage(int currentModule) {
 #endif  // DEBUG_INIT
     currentPaModule = PA_CHANNEL_B;
     /* Set Channel. If error, return error and abort initialization */
-    if (setPaChannel(currentModule, currentPaModule, currentPaChannelModule) == ERROR) {
+    if (setPaChannel(0.0, currentModule, currentPaModule, currentPaChannelModule) == ERROR) {
         return ERROR;
     }
 #ifdef DEBUG_INIT
@@ -199,11 +234,9 @@ int loZeroYtoCoarseTuning(int currentModule) {
 #ifdef DEBUG_INIT
     printf("   - Setting YTO coarse tuning to 0\n");
 #endif  // DEBUG_INIT
-    CONV_FLOAT = 0.0;
 
     /* Set coarse tuning. If error, return error and abort initialization */
-    CONV_UINT(0) = 0;
-    if (setYtoCoarseTune(currentModule) == ERROR) {
+    if (setYtoCoarseTune(0, currentModule) == ERROR) {
         return ERROR;
     }
 #ifdef DEBUG_INIT
@@ -330,8 +363,8 @@ void loHandler(int currentModule) {
     (loModulesHandler[currentLoModule])(currentModule);
 }
 
-/// Delete the LO PA limits table in preparation to load a new one
-int loResetPaLimitsTable(unsigned char band) {
+/// Helper to free the LO PA limits table. Called with the lock of the band held.
+static void loFreePaLimitsTable(unsigned char band) {
 #ifdef DEBUG_PA_LIMITS
     printf("loResetPaLimitsTable: band=%d ptr=%p size=%d alloc=%d\n", band,
            frontend.cartridge[band].lo.maxSafeLoPaTable, frontend.cartridge[band].lo.maxSafeLoPaTableSize,
@@ -341,11 +374,21 @@ int loResetPaLimitsTable(unsigned char band) {
     frontend.cartridge[band].lo.maxSafeLoPaTable = NULL;
     frontend.cartridge[band].lo.maxSafeLoPaTableSize = 0;
     frontend.cartridge[band].lo.allocatedLoPaTableSize = 0;
+    /* A reset starts a new upload: don't write the table until it completes */
+    frontend.cartridge[band].lo.maxSafeLoPaTableDirty = 0;
+}
+
+/// Delete the LO PA limits table in preparation to load a new one
+int loResetPaLimitsTable(unsigned char band) {
+    pthread_mutex_lock(&loPaLimitsLock[band]);
+    loFreePaLimitsTable(band);
+    pthread_mutex_unlock(&loPaLimitsLock[band]);
     return NO_ERROR;
 }
 
 //! Helper to load the LO PA limits table from the INI file
-void loLoadPaLimitsTable(unsigned char band) {
+/*! Called with the lock of the band held. */
+static void loParsePaLimitsTable(unsigned char band) {
     /* variables to help load the data from the configuration file */
     CFG_STRUCT dataIn;
     unsigned char tableSize, actualCnt, i;
@@ -361,8 +404,14 @@ void loLoadPaLimitsTable(unsigned char band) {
     frontend.cartridge[band].lo.maxSafeLoPaTableSize = 0;
     frontend.cartridge[band].lo.allocatedLoPaTableSize = 0;
     frontend.cartridge[band].lo.maxSafeLoPaTable = NULL;
+    frontend.cartridge[band].lo.maxSafeLoPaTableDirty = 0;
     memset(frontend.cartridge[band].lo.maxSafeLoPaESN, 0, SERIAL_NUMBER_SIZE);
 
+    /* Use the binary PA limits table file if it is still valid. */
+    if (loLoadPaLimitsCache(band) == NO_ERROR) {
+        return;
+    }
+
     /* Configure read array */
     dataIn.Name = LO_PA_LIMITS_ENTRIES_KEY;
     dataIn.VarType = Cfg_Byte;
@@ -437,8 +486,17 @@ void loLoadPaLimitsTable(unsigned char band) {
                        (*nextEntry).maxVD1);
 #endif
 
-                nextEntry++;
-                actualCnt++;
+                /* The lookup requires the entries in nondecreasing YTO order:
+                   ignore the entries breaking it. */
+                if (actualCnt > 0 && (*nextEntry).ytoEndpoint < (*(nextEntry - 1)).ytoEndpoint) {
+                    storeError(ERR_LO, ERC_COMMAND_VAL);
+#ifdef DEBUG_PA_LIMITS
+                    printf(" out of order: ignored");
+#endif
+                } else {
+                    nextEntry++;
+                    actualCnt++;
+                }
             }
 #ifdef DEBUG_PA_LIMITS
             printf("\n");
@@ -448,6 +506,11 @@ void loLoadPaLimitsTable(unsigned char band) {
         /* save the number of entries actually loaded */
         frontend.cartridge[band].lo.maxSafeLoPaTableSize = tableSize = actualCnt;
 
+        /* precompute the interpolation slopes */
+        for (i = 0; i < tableSize; i++) {
+            loPaLimitsSlope(frontend.cartridge[band].lo.maxSafeLoPaTable, tableSize, i);
+        }
+
         if (tableSize > 0) {
             // Get the ESN from LO PA entries table
             dataIn.Name = LO_PA_LIMITS_ESN_KEY;
@@ -476,12 +539,218 @@ void loLoadPaLimitsTable(unsigned char band) {
 #endif
         }
     }
+
+    /* Save the parsed table to skip the parsing at the next startup. */
+    loWritePaLimitsCache(band);
+
 #ifdef DEBUG_PA_LIMITS
     printf("loLoadPaLimitsTable: band=%d ptr=%p size=%d alloc=%d\n", band, frontend.cartridge[band].lo.maxSafeLoPaTable,
            frontend.cartridge[band].lo.maxSafeLoPaTableSize, frontend.cartridge[band].lo.allocatedLoPaTableSize);
 #endif
 }
 
+//! Load the LO PA limits table from the binary PA limits table file or the INI file
+void loLoadPaLimitsTable(unsigned char band) {
+    pthread_mutex_lock(&loPaLimitsLock[band]);
+    loParsePaLimitsTable(band);
+    pthread_mutex_unlock(&loPaLimitsLock[band]);
+}
+
+/// Helper to build the binary PA limits table file name from the WCA configuration file name
+static void loPaLimitsCacheName(unsigned char band, char *fileName) {
+    char *ext;
+
+    strcpy(fileName, frontend.cartridge[band].lo.configFile);
+    ext = strrchr(fileName, '.');
+    if (ext) *ext = '\0';
+    strcat(fileName, LO_PA_LIMITS_CACHE_EXT);
+}
+
+/// Helper to compute the checksum of the binary PA limits table file entries
+static uint32_t loPaLimitsCacheChecksum(const LO_PA_LIMITS_CACHE_ENTRY *entries, unsigned long count) {
+    const unsigned char *data = (const unsigned char *)entries;
+    uint32_t checksum = 0;
+    unsigned long i;
+
+    for (i = 0; i < count * sizeof(LO_PA_LIMITS_CACHE_ENTRY); i++) {
+        checksum += data[i];
+    }
+    return checksum;
+}
+
+/// Helper to hash the content of the WCA configuration file the binary PA limits table file was built from
+static int loPaLimitsIniHash(unsigned char band, uint32_t *size, uint32_t *hash) {
+    unsigned char buffer[512];
+    size_t read, i;
+    FILE *file;
+
+    if (!(file = fopen(frontend.cartridge[band].lo.configFile, "rb"))) {
+        return ERROR;
+    }
+
+    *size = 0;
+    *hash = 2166136261U;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        for (i = 0; i < read; i++) {
+            *hash = (*hash ^ buffer[i]) * 16777619U;
+        }
+        *size += read;
+    }
+
+    i = ferror(file);
+    fclose(file);
+    return i ? ERROR : NO_ERROR;
+}
+
+//! Helper to load the LO PA limits table from the binary PA limits table file
+static int loLoadPaLimitsCache(unsigned char band) {
+    char fileName[MAX_FILE_NAME_SIZE + 4];
+    LO_PA_LIMITS_CACHE_HEADER header;
+    LO_PA_LIMITS_CACHE_ENTRY *entries = NULL;
+    MAX_SAFE_LO_PA_ENTRY *table = NULL;
+    uint32_t iniSize, iniHash;
+    unsigned long i;
+    FILE *file;
+    int ret = ERROR;
+
+    /* The file is only valid for the current content of the configuration file */
+    if (loPaLimitsIniHash(band, &iniSize, &iniHash) == ERROR) {
+        return ERROR;
+    }
+
+    loPaLimitsCacheName(band, fileName);
+    if (!(file = fopen(fileName, "rb"))) {
+        return ERROR;
+    }
+
+    if (fread(&header, sizeof(header), 1, file) == 1 && header.magic == LO_PA_LIMITS_CACHE_MAGIC &&
+        header.version == LO_PA_LIMITS_CACHE_VERSION && header.entries > 0 &&
+        header.entries <= LO_PA_LIMITS_MAX_ENTRIES && header.iniSize == iniSize && header.iniHash == iniHash) {
+        entries = (LO_PA_LIMITS_CACHE_ENTRY *)malloc(header.entries * sizeof(LO_PA_LIMITS_CACHE_ENTRY));
+        table = (MAX_SAFE_LO_PA_ENTRY *)malloc(header.entries * sizeof(MAX_SAFE_LO_PA_ENTRY));
+
+        if (entries && table &&
+            fread(entries, sizeof(LO_PA_LIMITS_CACHE_ENTRY), header.entries, file) == header.entries &&
+            loPaLimitsCacheChecksum(entries, header.entries) == header.checksum) {
+            for (i = 0; i < header.entries; i++) {
+                memset(&table[i], 0, sizeof(MAX_SAFE_LO_PA_ENTRY));
+                table[i].ytoEndpoint = entries[i].ytoEndpoint;
+                table[i].maxVD0 = entries[i].maxVD0;
+                table[i].maxVD1 = entries[i].maxVD1;
+            }
+            for (i = 0; i < header.entries; i++) {
+                loPaLimitsSlope(table, header.entries, i);
+            }
+
+            frontend.cartridge[band].lo.maxSafeLoPaTable = table;
+            frontend.cartridge[band].lo.maxSafeLoPaTableSize = header.entries;
+            frontend.cartridge[band].lo.allocatedLoPaTableSize = header.entries;
+            memcpy(frontend.cartridge[band].lo.maxSafeLoPaESN, header.esn, SERIAL_NUMBER_SIZE);
+            table = NULL;
+            ret = NO_ERROR;
+        }
+    }
+
+    fclose(file);
+    free(entries);
+    free(table);
+
+#ifdef DEBUG_PA_LIMITS
+    printf("loLoadPaLimitsCache: band=%d file=%s %s\n", band, fileName, ret == NO_ERROR ? "loaded" : "not valid");
+#endif
+
+    return ret;
+}
+
+//! Helper to write the binary PA limits table file. Called with the lock of the band held.
+static int loWritePaLimitsCache(unsigned char band) {
+    char fileName[MAX_FILE_NAME_SIZE + 4], tempName[MAX_FILE_NAME_SIZE + 4];
+    LO_PA_LIMITS_CACHE_HEADER header;
+    LO_PA_LIMITS_CACHE_ENTRY *entries = NULL;
+    MAX_SAFE_LO_PA_ENTRY *table = frontend.cartridge[band].lo.maxSafeLoPaTable;
+    unsigned long i;
+    FILE *file;
+    int ret = ERROR;
+
+    memset(&header, 0, sizeof(header));
+    header.magic = LO_PA_LIMITS_CACHE_MAGIC;
+    header.version = LO_PA_LIMITS_CACHE_VERSION;
+    header.entries = table ? frontend.cartridge[band].lo.maxSafeLoPaTableSize : 0;
+
+    /* An empty table is never written: it would replace the configuration
+       file table at the next startup. */
+    if (header.entries == 0) {
+        return ERROR;
+    }
+
+    if (loPaLimitsIniHash(band, &header.iniSize, &header.iniHash) == ERROR) {
+        return ERROR;
+    }
+    memcpy(header.esn, frontend.cartridge[band].lo.maxSafeLoPaESN, SERIAL_NUMBER_SIZE);
+
+    entries = (LO_PA_LIMITS_CACHE_ENTRY *)malloc(header.entries * sizeof(LO_PA_LIMITS_CACHE_ENTRY));
+    if (!entries) {
+        storeError(ERR_LO, ERC_NO_MEMORY);
+        return ERROR;
+    }
+    memset(entries, 0, header.entries * sizeof(LO_PA_LIMITS_CACHE_ENTRY));
+    for (i = 0; i < header.entries; i++) {
+        entries[i].ytoEndpoint = table[i].ytoEndpoint;
+        entries[i].maxVD0 = table[i].maxVD0;
+        entries[i].maxVD1 = table[i].maxVD1;
+    }
+    header.checksum = loPaLimitsCacheChecksum(entries, header.entries);
+
+    /* Write a temporary file and replace the old one only when complete */
+    loPaLimitsCacheName(band, fileName);
+    strcpy(tempName, fileName);
+    strcpy(strrchr(tempName, '.'), ".TMP");
+
+    if ((file = fopen(tempName, "wb"))) {
+        if (fwrite(&header, sizeof(header), 1, file) == 1 &&
+            fwrite(entries, sizeof(LO_PA_LIMITS_CACHE_ENTRY), header.entries, file) == header.entries) {
+            ret = NO_ERROR;
+        }
+        if (fclose(file) != 0) {
+            ret = ERROR;
+        }
+        if (ret == NO_ERROR && rename(tempName, fileName) != 0) {
+            ret = ERROR;
+        }
+        if (ret == ERROR) {
+            remove(tempName);
+        }
+    }
+
+    free(entries);
+
+    if (ret == NO_ERROR) {
+        frontend.cartridge[band].lo.maxSafeLoPaTableDirty = 0;
+    }
+
+#ifdef DEBUG_PA_LIMITS
+    printf("loSavePaLimitsTable: band=%d file=%s entries=%u %s\n", band, fileName, header.entries,
+           ret == NO_ERROR ? "written" : "failed");
+#endif
+
+    return ret;
+}
+
+/*! Write the LO PA limits table to the binary PA limits table file.
+    The file is used by \ref loLoadPaLimitsTable at the next startup instead
+    of parsing the PA_LIMITS section of the WCA configuration file, as long as
+    the configuration file is not modified.
+    \param band           for which band
+    \return               ERROR or NO_ERROR */
+int loSavePaLimitsTable(unsigned char band) {
+    int ret;
+
+    pthread_mutex_lock(&loPaLimitsLock[band]);
+    ret = loWritePaLimitsCache(band);
+    pthread_mutex_unlock(&loPaLimitsLock[band]);
+    return ret;
+}
+
 /// Helper to assign values to an entry
 void assignPaLimitsEntry(MAX_SAFE_LO_PA_ENTRY *entry, unsigned char pol, unsigned int ytoTuning, float maxVD) {
     if (!entry) return;
@@ -490,18 +759,29 @@ void assignPaLimitsEntry(MAX_SAFE_LO_PA_ENTRY *entry, unsigned char pol, unsigne
     if (pol == 1 || pol == 2) entry->maxVD1 = maxVD;
 }
 
-/*! Add an entry to the LO PA limits table
-    \param band           for which band
-    \param pol            for which polarization 0, 1, or 2 meaning both
-    \param ytoTuning      for YTO tuning word
-    \param maxVD          maximum drain voltage allowed at tuning word
-    \return               ERROR or NO_ERROR */
-int loAddPaLimitsEntry(unsigned char band, unsigned char pol, unsigned int ytoTuning, float maxVD) {
+/// Helper to compute the interpolation slopes from an entry of the table to the next one
+static void loPaLimitsSlope(MAX_SAFE_LO_PA_ENTRY *table, unsigned int tableSize, unsigned int index) {
+    MAX_SAFE_LO_PA_ENTRY *entry = table + index;
+    float span;
+
+    // The last entry and repeated endpoints are never interpolated from:
+    if (index + 1 >= tableSize || entry[1].ytoEndpoint == entry->ytoEndpoint) {
+        entry->slopeVD0 = entry->slopeVD1 = 0.0;
+        return;
+    }
+
+    span = (float)(entry[1].ytoEndpoint - entry->ytoEndpoint);
+    entry->slopeVD0 = (entry[1].maxVD0 - entry->maxVD0) / span;
+    entry->slopeVD1 = (entry[1].maxVD1 - entry->maxVD1) / span;
+}
+
+/// Helper to add an entry to the LO PA limits table. Called with the lock of the band held.
+static int loAppendPaLimitsEntry(unsigned char band, unsigned char pol, unsigned int ytoTuning, float maxVD) {
     MAX_SAFE_LO_PA_ENTRY *entry = NULL;
     MAX_SAFE_LO_PA_ENTRY *table = frontend.cartridge[band].lo.maxSafeLoPaTable;
-    size_t allocSize = 8;  //< Number of entries to allocate at a time.
+    size_t allocSize = LO_PA_LIMITS_ALLOC_SIZE;  //< Number of entries to allocate the first time.
     size_t allocatedSize;
-    unsigned char tableSize;
+    unsigned int tableSize;
 
 #ifdef DEBUG_PA_LIMITS
     printf("loAddPaLimitsEntry 1: band=%d ptr=%p size=%d alloc=%d\n", band,
@@ -514,7 +794,7 @@ int loAddPaLimitsEntry(unsigned char band, unsigned char pol, unsigned int ytoTu
         table = (MAX_SAFE_LO_PA_ENTRY *)malloc(allocSize * sizeof(MAX_SAFE_LO_PA_ENTRY));
         if (!table) {
             storeError(ERR_LO, ERC_NO_MEMORY);
-            loResetPaLimitsTable(band);
+            loFreePaLimitsTable(band);
             return ERROR;
         }
         memset(table, 0, allocSize * sizeof(MAX_SAFE_LO_PA_ENTRY));
@@ -542,33 +822,37 @@ int loAddPaLimitsEntry(unsigned char band, unsigned char pol, unsigned int ytoTu
         entry = table + tableSize - 1;
         // Check whether the new entry is in nondecreasing YTO order:
         if (ytoTuning < entry->ytoEndpoint) {
-            storeError(ERR_LO, ERC_COMMAND_VAL);
+            storeError(ERR_CAN, ERC_COMMAND_VAL);
             return ERROR;
 
             // Check if same YTO tuning as the last entry:
         } else if (ytoTuning == entry->ytoEndpoint) {
             assignPaLimitsEntry(entry, pol, ytoTuning, maxVD);
+            // Update the slopes leading to the modified entry:
+            if (tableSize > 1) loPaLimitsSlope(table, tableSize, tableSize - 2);
 
             // Else we are adding a new entry:
         } else {
             // Check whether we need to allocate more space:
             if (tableSize == allocatedSize) {
-                // yes.  Alocate a table larger by allocSize:
-                allocatedSize += allocSize;
-                table = (MAX_SAFE_LO_PA_ENTRY *)malloc(allocatedSize * sizeof(MAX_SAFE_LO_PA_ENTRY));
+                // Check whether the table is already at its maximum size:
+                if (allocatedSize >= LO_PA_LIMITS_MAX_ENTRIES) {
+                    storeError(ERR_LO, ERC_NO_MEMORY);
+                    return ERROR;
+                }
+                // yes.  Double the table so that the cost of growing it is amortized:
+                allocatedSize *= 2;
+                if (allocatedSize > LO_PA_LIMITS_MAX_ENTRIES) allocatedSize = LO_PA_LIMITS_MAX_ENTRIES;
+                table = (MAX_SAFE_LO_PA_ENTRY *)realloc(table, allocatedSize * sizeof(MAX_SAFE_LO_PA_ENTRY));
                 if (!table) {
                     storeError(ERR_LO, ERC_NO_MEMORY);
-                    loResetPaLimitsTable(band);
+                    loFreePaLimitsTable(band);
                     return ERROR;
                 }
-                // Zero out the new table:
-                memset(table, 0, allocatedSize * sizeof(MAX_SAFE_LO_PA_ENTRY));
-                // Copy the old table to the front of the new:
-                memcpy(table, frontend.cartridge[band].lo.maxSafeLoPaTable, tableSize * sizeof(MAX_SAFE_LO_PA_ENTRY));
-                // Free the old table and store the new:
-                free(frontend.cartridge[band].lo.maxSafeLoPaTable);
+                // Zero out the new part of the table:
+                memset(table + tableSize, 0, (allocatedSize - tableSize) * sizeof(MAX_SAFE_LO_PA_ENTRY));
+                // Store the new table and update the allocated size:
                 frontend.cartridge[band].lo.maxSafeLoPaTable = table;
-                // Update the allocated size:
                 frontend.cartridge[band].lo.allocatedLoPaTableSize = allocatedSize;
             }
             // Update the next entry:
@@ -576,8 +860,14 @@ int loAddPaLimitsEntry(unsigned char band, unsigned char pol, unsigned int ytoTu
             assignPaLimitsEntry(entry, pol, ytoTuning, maxVD);
             // Increment the table size:
             frontend.cartridge[band].lo.maxSafeLoPaTableSize += 1;
+            // Update the slopes leading to the new entry:
+            loPaLimitsSlope(table, tableSize + 1, tableSize - 1);
+            loPaLimitsSlope(table, tableSize + 1, tableSize);
         }
     }
+    /* The table is written only when an upload completes */
+    frontend.cartridge[band].lo.maxSafeLoPaTableDirty = 0;
+
 #ifdef DEBUG_PA_LIMITS
     printf("loAddPaLimitsEntry 3: band=%d ptr=%p size=%d alloc=%d\n", band,
            frontend.cartridge[band].lo.maxSafeLoPaTable, frontend.cartridge[band].lo.maxSafeLoPaTableSize,
@@ -586,10 +876,78 @@ int loAddPaLimitsEntry(unsigned char band, unsigned char pol, unsigned int ytoTu
     return NO_ERROR;
 }
 
+/*! Add an entry to the LO PA limits table
+    \param band           for which band
+    \param pol            for which polarization 0, 1, or 2 meaning both
+    \param ytoTuning      for YTO tuning word
+    \param maxVD          maximum drain voltage allowed at tuning word
+    \return               ERROR or NO_ERROR */
+int loAddPaLimitsEntry(unsigned char band, unsigned char pol, unsigned int ytoTuning, float maxVD) {
+    int ret;
+
+    pthread_mutex_lock(&loPaLimitsLock[band]);
+    ret = loAppendPaLimitsEntry(band, pol, ytoTuning, maxVD);
+    pthread_mutex_unlock(&loPaLimitsLock[band]);
+    return ret;
+}
+
+/*! Add the entries of a bulk upload message to the LO PA limits table.
+    Each entry is packed in \ref LO_PA_LIMITS_PACKED_ENTRY_SIZE bytes:
+        - byte 0: \ref LO_PA_LIMITS_LAST_ENTRY_BIT in bit 7, polarization (0, 1 or 2 meaning both) in bits 5-4,
+                  YTO tuning word bits 11-8 in bits 3-0
+        - byte 1: YTO tuning word bits 7-0
+        - byte 2-3: maximum drain voltage in mV, big endian (0-2500)
+    The entries are added in order and the first invalid entry stops the upload.
+    The last entry of the upload is flagged with \ref LO_PA_LIMITS_LAST_ENTRY_BIT
+    and must be the last one of its message: only a completed upload is
+    written to the binary PA limits table file by \ref frontendWriteNVMemory.
+    \param band           for which band
+    \param data           the packed entries
+    \param size           the size of the data, a multiple of the packed entry size
+    \return               ERROR or NO_ERROR */
+int loAddPaLimitsEntries(unsigned char band, unsigned char *data, unsigned char size) {
+    unsigned char pol, last = FALSE;
+    unsigned int ytoTuning, maxVD;
+    int ret = NO_ERROR;
+
+    if (size == 0 || size % LO_PA_LIMITS_PACKED_ENTRY_SIZE) {
+        storeError(ERR_CAN, ERC_COMMAND_VAL);
+        return ERROR;
+    }
+
+    pthread_mutex_lock(&loPaLimitsLock[band]);
+    for (; size > 0; size -= LO_PA_LIMITS_PACKED_ENTRY_SIZE, data += LO_PA_LIMITS_PACKED_ENTRY_SIZE) {
+        last = (data[0] & LO_PA_LIMITS_LAST_ENTRY_BIT) != 0;
+        pol = (data[0] & ~LO_PA_LIMITS_LAST_ENTRY_BIT) >> 4;
+        ytoTuning = ((data[0] & 0x0F) << 8) | data[1];
+        maxVD = (data[2] << 8) | data[3];
+
+        if (pol > 2 || maxVD > 2500 || (last && size > LO_PA_LIMITS_PACKED_ENTRY_SIZE)) {
+            storeError(ERR_CAN, ERC_COMMAND_VAL);
+            ret = ERROR;
+            break;
+        }
+
+        if (loAppendPaLimitsEntry(band, pol, ytoTuning, maxVD / 1000.0) == ERROR) {
+            ret = ERROR;
+            break;
+        }
+    }
+
+    /* The upload is complete: write the table at the next non volatile memory write */
+    if (ret == NO_ERROR && last && frontend.cartridge[band].lo.maxSafeLoPaTableSize > 0) {
+        frontend.cartridge[band].lo.maxSafeLoPaTableDirty = 1;
+    }
+    pthread_mutex_unlock(&loPaLimitsLock[band]);
+
+    return ret;
+}
+
 int printPaLimitsTable(unsigned char band) {
     int i;
     char *str;
 
+    pthread_mutex_lock(&loPaLimitsLock[band]);
     printf("Band %d: ENTRIES=%d alloc=%d ESN=", band + 1, frontend.cartridge[band].lo.maxSafeLoPaTableSize,
            frontend.cartridge[band].lo.allocatedLoPaTableSize);
 
@@ -601,6 +959,7 @@ int printPaLimitsTable(unsigned char band) {
         printf("yto=%u, vd0=%.2f, vd1=%.2f\n", (*nextEntry).ytoEndpoint, (*nextEntry).maxVD0, (*nextEntry).maxVD1);
     }
     printf("\n");
+    pthread_mutex_unlock(&loPaLimitsLock[band]);
     return 0;
 }
 
@@ -608,83 +967,72 @@ int printPaLimitsTable(unsigned char band) {
 /*! Find entry in the max safe LO PA table corresponding to the given YTO tuning word
     Perform linear interpolation if the given YTO word is between entries.
     If yto is above or below first and last entries in the table, return the nearest.
+    The table is binary searched and the entry is copied into the caller storage,
+    so concurrent lookups don't share any state. The search holds the lock of
+    the band so the table can't be freed or reallocated meanwhile.
 
-    \param yto      tuning word to look up
+    \param yto              tuning word to look up
+    \param currentModule    band of the table to search
+    \param entry            where to return the found or interpolated entry
 
-    \return         pointer to entry or NULL if not found */
-MAX_SAFE_LO_PA_ENTRY *findMaxSafeLoPaEntry(unsigned int yto, int currentModule) {
-    MAX_SAFE_LO_PA_ENTRY *entry = NULL;
-    MAX_SAFE_LO_PA_ENTRY *lastEntry = NULL;
-    MAX_SAFE_LO_PA_ENTRY *table = frontend.cartridge[currentModule].lo.maxSafeLoPaTable;
-    unsigned char tableSize = frontend.cartridge[currentModule].lo.maxSafeLoPaTableSize;
-
-    static MAX_SAFE_LO_PA_ENTRY interpEntry;
-    //< if we need to interpolate, we'll return a pointer to this entry.
+    \return
+        - \ref NO_ERROR -> if the entry was found
+        - \ref ERROR    -> if the table is empty */
+int findMaxSafeLoPaEntry(unsigned int yto, int currentModule, MAX_SAFE_LO_PA_ENTRY *entry) {
+    int ret;
 
-    float interpFactor;
-    //< interpolation factor for scaling the maxVD0 and maxVD1 values betwen table entries.
+    pthread_mutex_lock(&loPaLimitsLock[currentModule]);
+    ret = searchMaxSafeLoPaEntry(yto, currentModule, entry);
+    pthread_mutex_unlock(&loPaLimitsLock[currentModule]);
+    return ret;
+}
 
-    int index = 0;
-    int done = 0;
-    unsigned int lastEndpoint = 0;
+/// Helper to search the max safe LO PA table. Called with the lock of the band held.
+static int searchMaxSafeLoPaEntry(unsigned int yto, int currentModule, MAX_SAFE_LO_PA_ENTRY *entry) {
+    MAX_SAFE_LO_PA_ENTRY *table = frontend.cartridge[currentModule].lo.maxSafeLoPaTable;
+    unsigned int tableSize = frontend.cartridge[currentModule].lo.maxSafeLoPaTableSize;
+    unsigned int low, high, mid;
+    float offset;
 
     // if table is empty or not allocated, get out:
-    if (tableSize == 0 || table == NULL) return NULL;
-
-    // look at the first entry:
-    entry = &table[0];
-
-    // if there is only one entry or if the requested YTO is at or below
-    //  the first endpoint, return the first entry:
-    if ((tableSize == 1) || (yto <= (*entry).ytoEndpoint)) return entry;
+    if (tableSize == 0 || table == NULL) return ERROR;
 
-    // look at the YTO tuning for the last entry in the table:
-    lastEndpoint = table[tableSize - 1].ytoEndpoint;
+    // if the requested YTO is at or below the first endpoint, return the first entry:
+    if (yto <= table[0].ytoEndpoint) {
+        *entry = table[0];
+        return NO_ERROR;
+    }
 
-    // if the requested YTO is at or above the last YTO tuning,
-    //  return the last entry:
-    if (yto >= lastEndpoint) {
-        entry = &table[tableSize - 1];
-        return entry;
+    // if the requested YTO is at or above the last endpoint, return the last entry:
+    if (yto >= table[tableSize - 1].ytoEndpoint) {
+        *entry = table[tableSize - 1];
+        return NO_ERROR;
     }
 
-    // loop to find an exact endpoint match or a pair of entries
-    //  between which to interpolate:
-    index = 0;
-    done = 0;
-    while (!done) {
-        // check for past end of table.
-        if (index >= tableSize) {
-            // this should be an impossible case because of lastEndpoint check above.
-            lastEntry = entry = NULL;
-            done = 1;
+    // binary search the first entry with the endpoint at or above the requested YTO:
+    low = 0;
+    high = tableSize - 1;
+    while (high - low > 1) {
+        mid = (low + high) / 2;
+        if (table[mid].ytoEndpoint < yto)
+            low = mid;
+        else
+            high = mid;
+    }
 
-        } else {
-            // save the last entry for endpoint comparison:
-            lastEntry = entry;
-
-            // get the current entry:
-            entry = &table[index];
-
-            // check for exact match current endpoint:
-            if (yto == (*entry).ytoEndpoint) done = 1;
-
-            // check for case where we need to interpolate:
-            else if (lastEntry && (*lastEntry).ytoEndpoint < yto && yto < (*entry).ytoEndpoint) {
-                // interpolate:
-                interpEntry.ytoEndpoint = yto;
-                interpFactor = ((float)(yto - (*lastEntry).ytoEndpoint)) /
-                               ((float)((*entry).ytoEndpoint - (*lastEntry).ytoEndpoint));
-                interpEntry.maxVD0 = (*lastEntry).maxVD0 + (interpFactor * ((*entry).maxVD0 - (*lastEntry).maxVD0));
-                interpEntry.maxVD1 = (*lastEntry).maxVD1 + (interpFactor * ((*entry).maxVD1 - (*lastEntry).maxVD1));
-                entry = &interpEntry;
-                done = 1;
-
-            } else
-                ++index;
-        }
+    // check for exact match of the endpoint:
+    if (table[high].ytoEndpoint == yto) {
+        *entry = table[high];
+        return NO_ERROR;
     }
-    return entry;
+
+    // else interpolate from the previous entry using the precomputed slopes:
+    *entry = table[low];
+    offset = (float)(yto - entry->ytoEndpoint);
+    entry->ytoEndpoint = yto;
+    entry->maxVD0 += offset * entry->slopeVD0;
+    entry->maxVD1 += offset * entry->slopeVD1;
+    return NO_ERROR;
 }
 
 /* LO PA max safe level limits check */
@@ -697,15 +1045,13 @@ MAX_SAFE_LO_PA_ENTRY *findMaxSafeLoPaEntry(unsigned int yto, int currentModule)
         - \ref NO_ERROR -> if no error occurred
         - \ref HARDW_BLKD_ERR -> the drain voltage was disallowed by the max safe level table */
 int limitSafePaDrainVoltage(unsigned char paModule, int currentModule) {
-    MAX_SAFE_LO_PA_ENTRY *entry;
+    MAX_SAFE_LO_PA_ENTRY entry;
     unsigned int yto = frontend.cartridge[currentModule].lo.yto.ytoCoarseTune;
 #ifdef DEBUG_PA_LIMITS
     printf("limitSafePaDrainVoltage yto=%u ", yto);
 #endif
 
-    entry = findMaxSafeLoPaEntry(yto, currentModule);
-
-    if (!entry) {
+    if (findMaxSafeLoPaEntry(yto, currentModule, &entry) == ERROR) {
 #ifdef DEBUG_PA_LIMITS
         printf("\n");
 #endif
@@ -713,15 +1059,15 @@ int limitSafePaDrainVoltage(unsigned char paModule, int currentModule) {
     }
 
 #ifdef DEBUG_PA_LIMITS
-    printf("maxVD0=%.2f maxVD1=%.2f ", (*entry).maxVD0, (*entry).maxVD1);
+    printf("maxVD0=%.2f maxVD1=%.2f ", entry.maxVD0, entry.maxVD1);
 #endif
 
     if (paModule == 0) {
 #ifdef DEBUG_PA_LIMITS
         printf("vd0=%.2f\n", CONV_FLOAT);
 #endif
-        if (CONV_FLOAT > (*entry).maxVD0) {
-            CONV_FLOAT = (*entry).maxVD0;
+        if (CONV_FLOAT > entry.maxVD0) {
+            CONV_FLOAT = entry.maxVD0;
             return HARDW_BLKD_ERR;
         }
     }
@@ -730,8 +1076,8 @@ int limitSafePaDrainVoltage(unsigned char paModule, int currentModule) {
 #ifdef DEBUG_PA_LIMITS
         printf("vd1=%.2f\n", CONV_FLOAT);
 #endif
-        if (CONV_FLOAT > (*entry).maxVD1) {
-            CONV_FLOAT = (*entry).maxVD1;
+        if (CONV_FLOAT > entry.maxVD1) {
+            CONV_FLOAT = entry.maxVD1;
             return HARDW_BLKD_ERR;
         }
     }
@@ -740,18 +1086,18 @@ int limitSafePaDrainVoltage(unsigned char paModule, int currentModule) {
 }
 
 /* LO PA max safe level limits check */
-/*! Prior to YTO tuning to CONV_UINT(0), send commands to reduce the LO PA drain
+/*! Prior to YTO tuning to the given tuning word, send commands to reduce the LO PA drain
       voltages to the limits in the max safe level table.
 
-    \param paModule     which polarization PA channel to check.
+    \param yto              the YTO tuning word about to be set.
+    \param currentModule    the band of the LO.
 
     \return
         - \ref NO_ERROR -> if no error occurred
         - \ref HARDW_BLKD_ERR -> the drain voltage was disallowed by the max safe level table */
-int limitSafeYtoTuning(int currentModule) {
-    MAX_SAFE_LO_PA_ENTRY *entry;
-    unsigned int yto = CONV_UINT(0);
-    long int backup = CONV_LONGINT;  // backup copy of the conversion buffer
+int limitSafeYtoTuning(unsigned int yto, int currentModule) {
+    MAX_SAFE_LO_PA_ENTRY entry;
+    CONVERSION drainVoltage;  // local conversion buffer: also called from the lock search thread
     float vd0, vd1;
     unsigned char *lastCommandData;
     int ret0 = NO_ERROR;
@@ -761,9 +1107,7 @@ int limitSafeYtoTuning(int currentModule) {
     printf("limitSafeYtoTuning yto=%u ", yto);
 #endif
 
-    entry = findMaxSafeLoPaEntry(yto, currentModule);
-
-    if (!entry) {
+    if (findMaxSafeLoPaEntry(yto, currentModule, &entry) == ERROR) {
 #ifdef DEBUG_PA_LIMITS
         printf("\n");
 #endif
@@ -773,24 +1117,23 @@ int limitSafeYtoTuning(int currentModule) {
     // make a pointer to the data word in the last commanded Pol0 PA drain voltage:
     int currentPaModule = PA_CHANNEL_A;
     lastCommandData = frontend.cartridge[currentModule]
-                          .lo.pa.paChannel[currentPaChannel(currentModule, currentPaModule)]
-                          .lastDrainVoltage.data;
+                          .lastControl.paChannelDrainVoltage[currentPaChannel(currentModule, currentPaModule)].data;
 
     // get the last commanded setting:
-    changeEndian(CONV_CHR_ADD, lastCommandData);
-    vd0 = CONV_FLOAT;
+    changeEndian(drainVoltage.chr, lastCommandData);
+    vd0 = drainVoltage.flt;
 
     // if we are about to exceed the max pol0 VD at the new yto tuning...
-    if (vd0 > (*entry).maxVD0) {
+    if (vd0 > entry.maxVD0) {
         // use the max setting instead:
-        CONV_FLOAT = (*entry).maxVD0;
+        drainVoltage.flt = entry.maxVD0;
 
         // save it back as the last commanded value
-        changeEndian(lastCommandData, CONV_CHR_ADD);
+        changeEndian(lastCommandData, drainVoltage.chr);
 
         // send the command to reduce the LO PA drain voltage:
         int currentPaChannelModule = PA_CHANNEL_DRAIN_VOLTAGE;
-        if (setPaChannel(currentModule, currentPaModule, currentPaChannelModule) == ERROR)
+        if (setPaChannel(drainVoltage.flt, currentModule, currentPaModule, currentPaChannelModule) == ERROR)
             ret0 = ERROR;
         else
             ret0 = HARDW_BLKD_ERR;
@@ -799,36 +1142,32 @@ int limitSafeYtoTuning(int currentModule) {
     // make a pointer to the data word in the last commanded Pol1 PA drain voltage:
     currentPaModule = PA_CHANNEL_B;
     lastCommandData = frontend.cartridge[currentModule]
-                          .lo.pa.paChannel[currentPaChannel(currentModule, currentPaModule)]
-                          .lastDrainVoltage.data;
+                          .lastControl.paChannelDrainVoltage[currentPaChannel(currentModule, currentPaModule)].data;
 
     // get the last commanded setting:
-    changeEndian(CONV_CHR_ADD, lastCommandData);
-    vd1 = CONV_FLOAT;
+    changeEndian(drainVoltage.chr, lastCommandData);
+    vd1 = drainVoltage.flt;
 
     // if we are about to exceed the max pol0 VD at the new yto tuning...
-    if (vd1 > (*entry).maxVD1) {
+    if (vd1 > entry.maxVD1) {
         // use the max setting instead:
-        CONV_FLOAT = (*entry).maxVD1;
+        drainVoltage.flt = entry.maxVD1;
 
         // save it back as the last commanded value
-        changeEndian(lastCommandData, CONV_CHR_ADD);
+        changeEndian(lastCommandData, drainVoltage.chr);
 
         // send the command to reduce the LO PA drain voltage:
         int currentPaChannelModule = PA_CHANNEL_DRAIN_VOLTAGE;
-        if (setPaChannel(currentModule, currentPaModule, currentPaChannelModule) == ERROR)
+        if (setPaChannel(drainVoltage.flt, currentModule, currentPaModule, currentPaChannelModule) == ERROR)
             ret1 = ERROR;
         else
             ret1 = HARDW_BLKD_ERR;
     }
 
 #ifdef DEBUG_PA_LIMITS
-    printf("maxVD0=%.2f maxVD1=%.2f vd0=%.2f vd1=%.2f\n", (*entry).maxVD0, (*entry).maxVD1, vd0, vd1);
+    printf("maxVD0=%.2f maxVD1=%.2f vd0=%.2f vd1=%.2f\n", entry.maxVD0, entry.maxVD1, vd0, vd1);
 #endif
 
-    // restore the conversion buffer to its prior state:
-    CONV_LONGINT = backup;
-
     // return any error which was seen:
     if (ret0 == ERROR || ret1 == ERROR) return ERROR;
     // HARDW_BLKD_ERR tells caller that one or both PA VD settings were reduced:
@@ -161,11 +161,13 @@ int getLoAnalogMonitor(int currentModule) {
         -# If no error occurs, update AREG and the frontend variable with the
            new state
 
+    \param coarseTune   This is the YTO coarse tune word to set
+
     \return
         - \ref NO_ERROR -> if no error occurred
         - \ref ERROR    -> if something wrong happened */
 
-int setYtoCoarseTune(int currentModule) {
+int setYtoCoarseTune(unsigned int coarseTune, int currentModule) {
     /* Store the current value of the YTO coarse tune in a temporary variable.
        We use a temporary variable so that if any error occurs during the update
        of the hardware state, we don't end up with an AREG describing a
@@ -174,7 +176,7 @@ int setYtoCoarseTune(int currentModule) {
 
     if (frontend.mode != SIMULATION_MODE) {
         /* Update AREG */
-        loRegisters[currentModule].aReg.bitField.ytoCoarseTune = CONV_UINT(0);
+        loRegisters[currentModule].aReg.bitField.ytoCoarseTune = coarseTune;
 
 /* 1 - Parallel write AREG */
 #ifdef DEBUG
@@ -192,7 +194,7 @@ int setYtoCoarseTune(int currentModule) {
     }
     /* Since there is no real hardware read back, if no error occurred the
        current state is updated to reflect the issued command. */
-    frontend.cartridge[currentModule].lo.yto.ytoCoarseTune = CONV_UINT(0);
+    frontend.cartridge[currentModule].lo.yto.ytoCoarseTune = coarseTune;
 
     return NO_ERROR;
 }
@@ -1071,10 +1073,13 @@ int getPaChannel(int currentModule, int currentPaModule, int currentPaChannelMod
     The function performs the following operation:
         -# Scale the analog control parameter from float to raw data
         -# Execute a pot write cycle.
+
+    \param value    This is the voltage to set the addressed PA channel to
+
     \return
         - \ref NO_ERROR -> if no error occurred
         - \ref ERROR    -> if something wrong happened */
-int setPaChannel(int currentModule, int currentPaModule, int currentPaChannelModule) {
+int setPaChannel(float value, int currentModule, int currentPaModule, int currentPaChannelModule) {
     /* A temporary variable to hold the scaled data before assigning it to the
        correct pot. */
     unsigned char scaledData = 0;
@@ -1105,7 +1110,7 @@ int setPaChannel(int currentModule, int currentPaModule, int currentPaChannelMod
             } else if (currentPaChannelModule == PA_CHANNEL_DRAIN_VOLTAGE) {
                 currentPaChannelModule = PA_CHANNEL_GATE_VOLTAGE;
                 // Alternate scaling for the payload:
-                scaledData = LO_PA_POT_TELEDNE_BASE_V_SCALE(CONV_FLOAT);
+                scaledData = LO_PA_POT_TELEDNE_BASE_V_SCALE(value);
             }
 
             /* Assign the scaled data to the correct pot.
@@ -1120,14 +1125,14 @@ int setPaChannel(int currentModule, int currentPaModule, int currentPaChannelMod
                     loRegisters[currentModule].paPotReg.bitField.pot0 = scaledData;
                     // collector voltage:
                     loRegisters[currentModule].paPotReg.bitField.pot1 =
-                        (CONV_FLOAT > 0) ? frontend.cartridge[currentModule].lo.pa.teledyneCollectorByte[0] : 0;
+                        (value > 0) ? frontend.cartridge[currentModule].lo.pa.teledyneCollectorByte[0] : 0;
                     break;
                 case POT2:
                     // base voltage:
                     loRegisters[currentModule].paPotReg.bitField.pot2 = scaledData;
                     // collector voltage:
                     loRegisters[currentModule].paPotReg.bitField.pot3 =
-                        (CONV_FLOAT > 0) ? frontend.cartridge[currentModule].lo.pa.teledyneCollectorByte[1] : 0;
+                        (value > 0) ? frontend.cartridge[currentModule].lo.pa.teledyneCollectorByte[1] : 0;
                     break;
                 default:
                     break;
@@ -1139,10 +1144,10 @@ int setPaChannel(int currentModule, int currentPaModule, int currentPaChannelMod
             /* 2b - Original scaling and pot assignment for the PA chips */
             switch (currentPaChannelModule) {
                 case PA_CHANNEL_GATE_VOLTAGE:
-                    scaledData = LO_PA_POT_GATE_V_SCALE(CONV_FLOAT);
+                    scaledData = LO_PA_POT_GATE_V_SCALE(value);
                     break;
                 case PA_CHANNEL_DRAIN_VOLTAGE:
-                    scaledData = LO_PA_POT_DRAIN_V_SCALE(CONV_FLOAT);
+                    scaledData = LO_PA_POT_DRAIN_V_SCALE(value);
                     break;
                 default:
                     break;
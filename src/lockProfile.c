@@ -0,0 +1,322 @@
+/*! \file   lockProfile.c
+    \brief  Lock contention profiler
+
+    This file contains the functions to measure the contention on the serial
+    ports locks and on the one wire bus lock. When enabled, every acquisition
+    through \ref lockMux records the time spent waiting for the lock, the
+    thread that was holding it and, on release, the time it was held. Waits
+    and holds are collected in logarithmic histograms.
+
+    The uncontended path costs one pthread_mutex_trylock and two clock reads,
+    the disabled path a single relaxed load: the profiler can be left running
+    in operation. */
+
+/* Includes */
+#include "lockProfile.h"
+
+#include <stdio.h>  /* printf */
+#include <stdlib.h> /* qsort */
+#include <string.h> /* memset */
+#include <time.h>
+
+#include "error_local.h"
+#include "packet.h"
+
+/* Globals */
+/* Externs */
+atomic_int lockProfileEnabled = 0;
+LOCK_PROFILE lockProfiles[LOCK_PROFILE_LOCKS];
+
+/* Statics */
+static _Thread_local unsigned char lockProfileCurrentThread = LOCK_THREAD_MESSAGES;  // Thread calling the wrappers
+static unsigned long long lockProfileStart = 0;  // Time the profiler was enabled (ns)
+
+/* Ranked readout */
+static pthread_mutex_t lockProfileReadoutLock = PTHREAD_MUTEX_INITIALIZER;
+static LOCK_PROFILE lockProfileRanked[LOCK_PROFILE_LOCKS];  // Statistics copied by the last status request
+static unsigned char lockProfileRank[LOCK_PROFILE_LOCKS];   // Lock numbers sorted by wait time
+static unsigned char lockProfileRankDone = FALSE;           // A status request ranked the locks
+static const LOCK_PROFILE *lockProfileSorted;               // Statistics being sorted by lockProfileCompare
+
+static const char *lockProfileThreadNames[LOCK_PROFILE_THREADS] = {"messages", "cryostat", "cartridge", "fetim",
+                                                                   "owb"};
+
+/* Monotonic time in ns */
+static inline unsigned long long lockProfileTime(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/* Histogram bucket of a duration: <1us, [1,2)us, [2,4)us ... >=16ms */
+static inline unsigned char lockProfileBucket(unsigned long long ns) {
+    unsigned long long us = ns / 1000;
+    unsigned char bucket = 0;
+
+    while (us > 0 && bucket < LOCK_PROFILE_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/* Helper to saturate a value to 16 bits */
+static inline unsigned int lockProfileSaturate(unsigned long long value) {
+    return value > 0xFFFF ? 0xFFFF : (unsigned int)value;
+}
+
+/*! This function takes the lock and updates its statistics. It is called by
+    \ref lockMux when the profiler is enabled.
+    \param lock     port number or \ref LOCK_PROFILE_OWB */
+void lockProfileAcquire(unsigned int lock) {
+    LOCK_PROFILE *profile = &lockProfiles[lock];
+    pthread_mutex_t *mutex = lockProfileMutex(lock);
+    unsigned long long start, wait = 0;
+    unsigned char holder = LOCK_PROFILE_THREADS;
+
+    if (pthread_mutex_trylock(mutex) != 0) {
+        holder = atomic_load_explicit(&profile->owner, memory_order_relaxed);
+        start = lockProfileTime();
+        pthread_mutex_lock(mutex);
+        profile->acquiredAt = lockProfileTime();
+        wait = profile->acquiredAt - start;
+    } else {
+        profile->acquiredAt = lockProfileTime();
+    }
+
+    /* From here on the statistics are protected by the lock itself */
+    profile->held = TRUE;
+    atomic_store_explicit(&profile->owner, lockProfileCurrentThread, memory_order_relaxed);
+    profile->acquisitions++;
+
+    if (holder < LOCK_PROFILE_THREADS) {
+        profile->contended++;
+        profile->blockedBy[holder]++;
+        profile->waitBy[lockProfileCurrentThread] += wait;
+        profile->waitTotal += wait;
+        if (wait > profile->waitMax) {
+            profile->waitMax = wait;
+        }
+        profile->waitHistogram[lockProfileBucket(wait)]++;
+    }
+}
+
+/*! This function updates the hold time statistics of the lock and releases
+    it. It is called by \ref unlockMux for locks taken by
+    \ref lockProfileAcquire.
+    \param lock     port number or \ref LOCK_PROFILE_OWB */
+void lockProfileRelease(unsigned int lock) {
+    LOCK_PROFILE *profile = &lockProfiles[lock];
+    unsigned long long hold = lockProfileTime() - profile->acquiredAt;
+
+    profile->holdTotal += hold;
+    if (hold > profile->holdMax) {
+        profile->holdMax = hold;
+    }
+    profile->holdHistogram[lockProfileBucket(hold)]++;
+    profile->held = FALSE;
+
+    pthread_mutex_unlock(lockProfileMutex(lock));
+}
+
+/*! This function declares which thread is calling the lock wrappers. Threads
+    that don't call it are accounted as \ref LOCK_THREAD_MESSAGES.
+    \param thread   one of the LOCK_THREAD_xxx values */
+void lockProfileThread(unsigned char thread) {
+    if (thread < LOCK_PROFILE_THREADS) {
+        lockProfileCurrentThread = thread;
+    }
+}
+
+/*! This function starts the profiler from clean statistics or stops it. The
+    statistics collected are kept until the next start.
+    \param enable   \ref ENABLE or \ref DISABLE */
+void lockProfileEnable(unsigned char enable) {
+    unsigned int lock;
+
+    if (enable == DISABLE) {
+        atomic_store(&lockProfileEnabled, 0);
+        return;
+    }
+
+    if (atomic_load(&lockProfileEnabled)) {
+        return;
+    }
+
+    /* Each lock is taken to clear its statistics: the profiler is disabled
+       so it cannot be held through the profiled path. */
+    for (lock = 0; lock < LOCK_PROFILE_LOCKS; lock++) {
+        pthread_mutex_lock(lockProfileMutex(lock));
+        memset(&lockProfiles[lock], 0, sizeof(LOCK_PROFILE));
+        pthread_mutex_unlock(lockProfileMutex(lock));
+    }
+    lockProfileStart = lockProfileTime();
+    atomic_store(&lockProfileEnabled, 1);
+}
+
+/* Helper to sort the locks by decreasing time spent waiting */
+static int lockProfileCompare(const void *a, const void *b) {
+    const LOCK_PROFILE *first = &lockProfileSorted[*(const unsigned char *)a];
+    const LOCK_PROFILE *second = &lockProfileSorted[*(const unsigned char *)b];
+
+    if (first->waitTotal != second->waitTotal) {
+        return first->waitTotal < second->waitTotal ? 1 : -1;
+    }
+    return (int)*(const unsigned char *)a - (int)*(const unsigned char *)b;
+}
+
+/* Helper to copy the statistics to ranked and sort the lock numbers in rank.
+   The caller holds lockProfileReadoutLock. */
+static void lockProfileRankLocks(LOCK_PROFILE *ranked, unsigned char *rank) {
+    unsigned int lock;
+
+    for (lock = 0; lock < LOCK_PROFILE_LOCKS; lock++) {
+        pthread_mutex_lock(lockProfileMutex(lock));
+        memcpy(&ranked[lock], &lockProfiles[lock], sizeof(LOCK_PROFILE));
+        pthread_mutex_unlock(lockProfileMutex(lock));
+        rank[lock] = lock;
+    }
+    lockProfileSorted = ranked;
+    qsort(rank, LOCK_PROFILE_LOCKS, sizeof(rank[0]), lockProfileCompare);
+}
+
+/* Helper returning the thread that most often held a lock when it was contended */
+static unsigned char lockProfileTopHolder(const LOCK_PROFILE *profile) {
+    unsigned char thread, top = 0;
+
+    for (thread = 1; thread < LOCK_PROFILE_THREADS; thread++) {
+        if (profile->blockedBy[thread] > profile->blockedBy[top]) {
+            top = thread;
+        }
+    }
+    return top;
+}
+
+/* Helper to print a histogram */
+static void lockProfilePrintHistogram(const char *name, const unsigned long *histogram) {
+    unsigned char bucket;
+
+    printf("   %s:", name);
+    for (bucket = 0; bucket < LOCK_PROFILE_BUCKETS; bucket++) {
+        printf(" %lu", histogram[bucket]);
+    }
+    printf("\n");
+}
+
+int lockProfileReport(void) {
+    LOCK_PROFILE ranked[LOCK_PROFILE_LOCKS];  // Own copy: the report doesn't touch the ranking read over CAN
+    unsigned char rank[LOCK_PROFILE_LOCKS];
+    const LOCK_PROFILE *profile;
+    unsigned char index, thread, lock;
+
+    pthread_mutex_lock(&lockProfileReadoutLock);
+    lockProfileRankLocks(ranked, rank);
+
+    printf("\nLock contention report: %s, %.1f s, ranked by time spent waiting\n",
+           atomic_load(&lockProfileEnabled) ? "running" : "stopped",
+           lockProfileStart ? (lockProfileTime() - lockProfileStart) / 1e9 : 0.0);
+    printf(" Histogram buckets: <1us, then [2^(n-1), 2^n) us up to >=%dus\n", 1 << (LOCK_PROFILE_BUCKETS - 2));
+
+    for (index = 0; index < LOCK_PROFILE_LOCKS; index++) {
+        lock = rank[index];
+        profile = &ranked[lock];
+
+        if (lock == LOCK_PROFILE_OWB) {
+            printf(" owb    ");
+        } else {
+            printf(" ssc[%d] ", lock);
+        }
+        printf("acquisitions:%lu contended:%lu wait total:%.3fms max:%.1fus hold mean:%.1fus max:%.1fus\n",
+               profile->acquisitions, profile->contended, profile->waitTotal / 1e6, profile->waitMax / 1e3,
+               profile->acquisitions ? profile->holdTotal / 1e3 / profile->acquisitions : 0.0, profile->holdMax / 1e3);
+
+        if (profile->contended == 0) {
+            continue;
+        }
+        for (thread = 0; thread < LOCK_PROFILE_THREADS; thread++) {
+            if (profile->blockedBy[thread] != 0 || profile->waitBy[thread] != 0) {
+                printf("   %-9s held it %lu times when contended, waited %.3fms\n", lockProfileThreadNames[thread],
+                       profile->blockedBy[thread], profile->waitBy[thread] / 1e6);
+            }
+        }
+        lockProfilePrintHistogram("wait", profile->waitHistogram);
+        lockProfilePrintHistogram("hold", profile->holdHistogram);
+    }
+    printf("\n");
+
+    pthread_mutex_unlock(&lockProfileReadoutLock);
+
+    return NO_ERROR;
+}
+
+/*! This function ranks the locks by time spent waiting. The ranking is kept
+    until the next request and read by \ref lockProfileReadEntry.
+    \param data     The 8 bytes buffer to fill with: enabled (1), number of
+                    locks (1), profiling time in s (2), total contended
+                    acquisitions (2) and total wait in ms (2), big endian and
+                    saturated to 0xFFFF */
+void lockProfileStatus(unsigned char *data) {
+    unsigned long long contended = 0, wait = 0, elapsed = 0;
+    unsigned int lock;
+
+    pthread_mutex_lock(&lockProfileReadoutLock);
+    lockProfileRankLocks(lockProfileRanked, lockProfileRank);
+    lockProfileRankDone = TRUE;
+    for (lock = 0; lock < LOCK_PROFILE_LOCKS; lock++) {
+        contended += lockProfileRanked[lock].contended;
+        wait += lockProfileRanked[lock].waitTotal;
+    }
+    if (lockProfileStart) {
+        elapsed = (lockProfileTime() - lockProfileStart) / 1000000000ULL;
+    }
+    pthread_mutex_unlock(&lockProfileReadoutLock);
+
+    data[0] = atomic_load(&lockProfileEnabled) ? ENABLE : DISABLE;
+    data[1] = LOCK_PROFILE_LOCKS;
+    data[2] = (unsigned char)(lockProfileSaturate(elapsed) >> 8);
+    data[3] = (unsigned char)lockProfileSaturate(elapsed);
+    data[4] = (unsigned char)(lockProfileSaturate(contended) >> 8);
+    data[5] = (unsigned char)lockProfileSaturate(contended);
+    data[6] = (unsigned char)(lockProfileSaturate(wait / 1000000) >> 8);
+    data[7] = (unsigned char)lockProfileSaturate(wait / 1000000);
+}
+
+/*! This function returns the lock with the given rank in the ranking done by
+    the last \ref lockProfileStatus, rank 0 being the most contended. No state
+    is kept between requests so any number of clients can read the ranking.
+    \param rank     The rank of the lock, 0 to \ref LOCK_PROFILE_LOCKS - 1
+    \param data     The 8 bytes buffer to fill with: lock (1, port number or
+                    \ref LOCK_PROFILE_OWB), thread most often holding it when
+                    contended (1), contended acquisitions (2), total wait in
+                    ms (2) and longest wait in us (2), big endian and saturated
+                    to 0xFFFF
+    \return
+        - \ref NO_ERROR -> if the entry was returned
+        - \ref ERROR    -> if the rank is out of range or the locks were not
+                           ranked yet. The buffer is filled with 0xFF. */
+int lockProfileReadEntry(unsigned char rank, unsigned char *data) {
+    const LOCK_PROFILE *profile;
+    unsigned char lock;
+
+    pthread_mutex_lock(&lockProfileReadoutLock);
+    if (!lockProfileRankDone || rank >= LOCK_PROFILE_LOCKS) {
+        pthread_mutex_unlock(&lockProfileReadoutLock);
+        memset(data, 0xFF, CAN_FULL_SIZE);
+        return ERROR;
+    }
+    lock = lockProfileRank[rank];
+    profile = &lockProfileRanked[lock];
+
+    data[0] = lock;
+    data[1] = lockProfileTopHolder(profile);
+    data[2] = (unsigned char)(lockProfileSaturate(profile->contended) >> 8);
+    data[3] = (unsigned char)lockProfileSaturate(profile->contended);
+    data[4] = (unsigned char)(lockProfileSaturate(profile->waitTotal / 1000000) >> 8);
+    data[5] = (unsigned char)lockProfileSaturate(profile->waitTotal / 1000000);
+    data[6] = (unsigned char)(lockProfileSaturate(profile->waitMax / 1000) >> 8);
+    data[7] = (unsigned char)lockProfileSaturate(profile->waitMax / 1000);
+    pthread_mutex_unlock(&lockProfileReadoutLock);
+
+    return NO_ERROR;
+}
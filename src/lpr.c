@@ -202,3 +202,11 @@ int lprStop(void) {
 
     return NO_ERROR;
 }
+
+/* LPR async */
+/*! This function performs the LPR operations that are not completed within
+    the CAN request: it drives the queued optical switch port moves. It is
+    called by the cartridge async thread. */
+void lprAsync(void) {
+    opticalSwitchAsync();
+}
@@ -188,10 +188,11 @@ int getLprTemp(int currentLprModule) {
         -# If no error occurs, update AREG and the frontend variable with the
            new state
 
+    \param port     The port to select (\ref BAND1 through \ref BAND10)
     \return
         - \ref NO_ERROR -> if no error occurred
         - \ref ERROR    -> if something wrong happened */
-int setOpticalSwitchPort(void) {
+int setOpticalSwitchPort(unsigned char port) {
     /* Store the current value of the optical switch port in a temporary
        variable. We use a temporary variable so that if any error occurs during
        the update of the hardware state, we don't end up with an AREG describing
@@ -199,7 +200,7 @@ int setOpticalSwitchPort(void) {
     int tempAReg = lprRegisters.aReg.integer;
     if (frontend.mode != SIMULATION_MODE) {
         /* Update AREG */
-        lprRegisters.aReg.bitField.port = LPR_AREG_SWITCH_PORT(CAN_BYTE);
+        lprRegisters.aReg.bitField.port = LPR_AREG_SWITCH_PORT(port);
 
         /* Get the LPR states. */
         if (getLprStates() == ERROR) {
@@ -238,7 +239,7 @@ int setOpticalSwitchPort(void) {
     }
     /* Since there is no real hardware read back, if no error occurred the
        current state is updated to reflect the issued command. */
-    frontend.lpr.opticalSwitch.port = CAN_BYTE;
+    frontend.lpr.opticalSwitch.port = port;
 
     return NO_ERROR;
 }
@@ -25,7 +25,10 @@
 #include "fetim.h"
 #include "globalDefinitions.h"
 #include "globalOperations.h"
+#include "lockProfile.h"
+#include "lpr.h"
 #include "packet.h"
+#include "powerDistribution.h"
 #include "serialMux.h"
 #include "timer.h"
 #include "version.h"
@@ -214,6 +217,7 @@ void create_socket() {
 }
 
 void *cryostatAsyncWrapper(void *arg) {
+    lockProfileThread(LOCK_THREAD_CRYOSTAT);
     for (;;) {
         cryostatAsync();
     }
@@ -221,13 +225,21 @@ void *cryostatAsyncWrapper(void *arg) {
 }
 
 void *cartridgeAsyncWrapper(void *arg) {
+    lockProfileThread(LOCK_THREAD_CARTRIDGE);
     for (;;) {
         cartridgeAsync();
+        sisSweepAsync();
+        sisMagnetRampAsync();
+        pllLockSearchAsync();
+        lprAsync();
+        bandSelectAsync();
+        pdSweepAsync();
     }
     return NULL;
 }
 
 void *fetimAsyncWrapper(void *arg) {
+    lockProfileThread(LOCK_THREAD_FETIM);
     for (;;) {
         fetimAsync();
     }
@@ -46,12 +46,12 @@ void miDacResetStrobeHandler(void) {
     /* Check direction and perform the required operation */
     if (CAN_SIZE) {  // If control (size !=0)
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.lpr.edfa.modulationInput.miSpecialMsgs.miDac.lastResetStrobe)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.lpr.lastControl.miDacResetStrobe)
 
         /* Send the strobe */
         if (setLprDacStrobe() == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.lpr.edfa.modulationInput.miSpecialMsgs.miDac.lastResetStrobe.status = ERROR;
+            frontend.lpr.lastControl.miDacResetStrobe.status = ERROR;
 
             return;
         }
@@ -60,7 +60,7 @@ void miDacResetStrobeHandler(void) {
     /* If it's a monitor message on a control RCA */
     if (currentClass == CONTROL_CLASS) {  // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.lpr.edfa.modulationInput.miSpecialMsgs.miDac.lastResetStrobe)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.lpr.lastControl.miDacResetStrobe)
         return;
     }
 
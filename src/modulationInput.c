@@ -54,7 +54,7 @@ void modulationInputValueHandler(void) {
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.lpr.edfa.modulationInput.lastValue)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.lpr.lastControl.modulationInputValue)
 
         /* Extract the float from the can message. */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -63,7 +63,7 @@ void modulationInputValueHandler(void) {
            then return. */
         if (setModulationInputValue() == ERROR) {
             /* Store the ERROR state in the last control message varibale */
-            frontend.lpr.edfa.modulationInput.lastValue.status = ERROR;
+            frontend.lpr.lastControl.modulationInputValue.status = ERROR;
 
             return;
         }
@@ -75,7 +75,7 @@ void modulationInputValueHandler(void) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.lpr.edfa.modulationInput.lastValue)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.lpr.lastControl.modulationInputValue)
         return;
     }
 
@@ -85,7 +85,7 @@ void modulationInputValueHandler(void) {
        updated when a new modulation input value is sent with a control
        message. */
     /* Extract the float from the last CAN message data. */
-    changeEndian(CONV_CHR_ADD, frontend.lpr.edfa.modulationInput.lastValue.data);
+    changeEndian(CONV_CHR_ADD, frontend.lpr.lastControl.modulationInputValue.data);
     /* Copy the last issued message to the current value */
     frontend.lpr.edfa.modulationInput.value = CONV_FLOAT;
 
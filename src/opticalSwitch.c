@@ -8,19 +8,35 @@
     events. */
 
 /* Includes */
-#include <stdio.h>  /* printf */
-#include <string.h> /* memcpy */
+#include <pthread.h> /* pthread_mutex_t */
+#include <stdio.h>   /* printf */
+#include <string.h>  /* memcpy */
+#include <time.h>    /* clock_gettime */
 
 #include "debug.h"
 #include "error_local.h"
 #include "frontend.h"
 #include "lprSerialInterface.h"
 #include "packet.h"
+#include "timer.h"
 
 /* Statics */
 static HANDLER opticalSwitchModulesHandler[OPTICAL_SWITCH_MODULES_NUMBER] = {
     portHandler, shutterHandler, forceShutterHandler, stateHandler, busyHandler};
 
+/* Port move. It is queued by the CAN thread and driven by lprAsync. The lock
+   is held while the async thread talks to the switch so that a shutter
+   request never interleaves with a move. */
+static pthread_mutex_t opticalSwitchMoveLock = PTHREAD_MUTEX_INITIALIZER;
+static struct {
+    unsigned char state;  // See OPTICAL_SWITCH_MOVE_xxx
+    unsigned char port;   // The requested port
+    signed char status;   // Completion status, NO_ERROR or one of the HARDW_xxx codes
+    double queued;        // Time the move was queued (ms)
+    double issued;        // Time the strobe was sent (ms)
+    double elapsed;       // Time from queuing to completion (ms)
+} opticalSwitchMove;
+
 /* Optical switch handler */
 /*! This function will be called by the CAN message handler when the received
     message is pertinent to the optical switch. */
@@ -54,7 +70,7 @@ void portHandler(void) {
     /* If control (size!=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.lpr.opticalSwitch.lastPort)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.lpr.lastControl.opticalSwitchPort)
 
         /* Since the payload is just a byte, there is no need to convert the
            received data from the CAN message to any particular format, the
@@ -63,26 +79,21 @@ void portHandler(void) {
             storeError(ERR_OPTICAL_SWITCH, ERC_COMMAND_VAL);  // Selected port set value out of range
 
             /* Store error in the last control message variable */
-            frontend.lpr.opticalSwitch.lastPort.status = CON_ERROR_RNG;
+            frontend.lpr.lastControl.opticalSwitchPort.status = CON_ERROR_RNG;
 
             return;
         }
 
-        /* Set the LPR port. If an error occurs then store the state and
-           return. */
-        if (setOpticalSwitchPort() == ERROR) {
+        /* Queue the port move. It is issued by the LPR async process as soon
+           as the switch is idle and its completion is stored in the last
+           control message variable. */
+        if (opticalSwitchMoveStart(CAN_BYTE) == ERROR) {
             /* Store the error state in the last control message variable. */
-            frontend.lpr.opticalSwitch.lastPort.status = ERROR;
+            frontend.lpr.lastControl.opticalSwitchPort.status = ERROR;
 
             return;
         }
 
-        /* If everything went fine modify the current state of the shutter: it's
-           not enable anymore since we selected a new channel. This
-           automatically removes the shutter so, the effective state should be
-           updated. */
-        frontend.lpr.opticalSwitch.shutter = SHUTTER_DISABLE;
-
         /* Now we can return */
 
         return;
@@ -91,7 +102,7 @@ void portHandler(void) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {  // If monitor on control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.lpr.opticalSwitch.lastPort)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.lpr.lastControl.opticalSwitchPort)
         return;
     }
 
@@ -113,13 +124,16 @@ void shutterHandler(void) {
     /* If it's a control message (size!=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.lpr.opticalSwitch.lastShutter)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.lpr.lastControl.opticalSwitchShutter)
+
+        /* The shutter supersedes any pending port move */
+        opticalSwitchMoveCancel();
 
         /* The shutter is enable everytime a message is received independently
            of the payload. */
         if (setOpticalSwitchShutter(STANDARD) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.lpr.opticalSwitch.lastShutter.status = ERROR;
+            frontend.lpr.lastControl.opticalSwitchShutter.status = ERROR;
 
             return;
         }
@@ -134,7 +148,7 @@ void shutterHandler(void) {
     /* If it's a monitor message on a control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.lpr.opticalSwitch.lastShutter)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.lpr.lastControl.opticalSwitchShutter)
         return;
     }
 
@@ -155,13 +169,16 @@ void forceShutterHandler(void) {
     /* If it's a control message (size!=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.lpr.opticalSwitch.lastForceShutter)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.lpr.lastControl.opticalSwitchForceShutter)
+
+        /* The shutter supersedes any pending port move */
+        opticalSwitchMoveCancel();
 
         /* The shutter is enable everytime a message is received independently
            of the payload. */
         if (setOpticalSwitchShutter(FORCED) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.lpr.opticalSwitch.lastForceShutter.status = ERROR;
+            frontend.lpr.lastControl.opticalSwitchForceShutter.status = ERROR;
 
             return;
         }
@@ -176,7 +193,7 @@ void forceShutterHandler(void) {
     /* If it's a monitor message on a control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.lpr.opticalSwitch.lastForceShutter)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.lpr.lastControl.opticalSwitchForceShutter)
         return;
     }
 
@@ -263,3 +280,177 @@ void busyHandler(void) {
     CAN_BYTE = frontend.lpr.opticalSwitch.busy;
     CAN_SIZE = CAN_BOOLEAN_SIZE;
 }
+
+/* Current time for the port moves in ms */
+static double opticalSwitchTime(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+/* TRUE if the port move is still in progress. Called with the lock held. */
+static int opticalSwitchMovePending(void) {
+    return (opticalSwitchMove.state == OPTICAL_SWITCH_MOVE_QUEUED) ||
+           (opticalSwitchMove.state == OPTICAL_SWITCH_MOVE_MOVING);
+}
+
+/* Terminate the port move. Called with the lock held. */
+static void opticalSwitchMoveEnd(unsigned char state, int status) {
+    opticalSwitchMove.state = state;
+    opticalSwitchMove.status = status;
+    opticalSwitchMove.elapsed = opticalSwitchTime() - opticalSwitchMove.queued;
+    frontend.lpr.lastControl.opticalSwitchPort.status = status;
+
+#ifdef DEBUG_LPR
+    printf(" Optical switch port %d: state=%d status=%d in %.0f ms\n", opticalSwitchMove.port, state, status,
+           opticalSwitchMove.elapsed);
+#endif /* DEBUG_LPR */
+}
+
+/* Start an optical switch port move */
+/*! This function queues a port move and returns immediately. The move is
+    issued by \ref opticalSwitchAsync as soon as the switch is idle, so the
+    client doesn't have to retry while a previous move is in progress. A new
+    request replaces a move that wasn't issued yet.
+    \param port    The port to select (\ref BAND1 through \ref BAND10)
+    \return
+        - \ref NO_ERROR -> if the move was queued
+        - \ref ERROR    -> if the port is out of range */
+int opticalSwitchMoveStart(unsigned char port) {
+    if (checkRange(BAND1, port, BAND10)) {
+        storeError(ERR_OPTICAL_SWITCH, ERC_COMMAND_VAL);  // Selected port set value out of range
+        return ERROR;
+    }
+
+    pthread_mutex_lock(&opticalSwitchMoveLock);
+    opticalSwitchMove.state = OPTICAL_SWITCH_MOVE_QUEUED;
+    opticalSwitchMove.port = port;
+    opticalSwitchMove.status = NO_ERROR;
+    opticalSwitchMove.queued = opticalSwitchTime();
+    opticalSwitchMove.elapsed = 0.0;
+    pthread_mutex_unlock(&opticalSwitchMoveLock);
+
+    return NO_ERROR;
+}
+
+/* Cancel an optical switch port move */
+/*! This function drops a port move that wasn't issued yet and stops tracking
+    one in progress. It has to be called before operating the shutter. */
+void opticalSwitchMoveCancel(void) {
+    pthread_mutex_lock(&opticalSwitchMoveLock);
+    if (opticalSwitchMovePending()) {
+        storeError(ERR_OPTICAL_SWITCH, ERC_HARDWARE_BLOCKED);  // Port move superseded by the shutter
+        opticalSwitchMoveEnd(OPTICAL_SWITCH_MOVE_FAILED, HARDW_BLKD_ERR);
+    }
+    pthread_mutex_unlock(&opticalSwitchMoveLock);
+}
+
+/* Optical switch port move state */
+/*! \param port    Returns the port of the last move
+    \return the state of the last move, see OPTICAL_SWITCH_MOVE_xxx */
+int opticalSwitchMoveState(unsigned char *port) {
+    int state;
+
+    pthread_mutex_lock(&opticalSwitchMoveLock);
+    state = opticalSwitchMove.state;
+    *port = opticalSwitchMove.port;
+    pthread_mutex_unlock(&opticalSwitchMoveLock);
+
+    return state;
+}
+
+/* Optical switch async */
+/*! This function drives the queued port move. It waits for the switch to be
+    idle, issues the move and then polls the busy state until the switch has
+    settled. A move that doesn't complete within \ref TIMER_LPR_TO_SWITCH_RDY
+    fails. */
+void opticalSwitchAsync(void) {
+    double now;
+
+    pthread_mutex_lock(&opticalSwitchMoveLock);
+    if (!opticalSwitchMovePending()) {
+        pthread_mutex_unlock(&opticalSwitchMoveLock);
+        return;
+    }
+
+    if (getLprStates() == ERROR) {
+        opticalSwitchMoveEnd(OPTICAL_SWITCH_MOVE_FAILED, ERROR);
+        pthread_mutex_unlock(&opticalSwitchMoveLock);
+        return;
+    }
+
+    now = opticalSwitchTime();
+    switch (opticalSwitchMove.state) {
+        case OPTICAL_SWITCH_MOVE_QUEUED:
+            /* Wait for the previous move to complete */
+            if (frontend.lpr.opticalSwitch.busy == OPTICAL_SWITCH_BUSY) {
+                break;
+            }
+
+            if (setOpticalSwitchPort(opticalSwitchMove.port) == ERROR) {
+                opticalSwitchMoveEnd(OPTICAL_SWITCH_MOVE_FAILED, ERROR);
+                break;
+            }
+
+            /* Selecting a port removes the shutter, the effective state
+               should be updated. */
+            frontend.lpr.opticalSwitch.shutter = SHUTTER_DISABLE;
+            opticalSwitchMove.state = OPTICAL_SWITCH_MOVE_MOVING;
+            opticalSwitchMove.issued = now;
+            break;
+
+        case OPTICAL_SWITCH_MOVE_MOVING:
+            if (frontend.lpr.opticalSwitch.state != OPTICAL_SWITCH_IDLE) {
+                storeError(ERR_OPTICAL_SWITCH, ERC_HARDWARE_ERROR);  // Optical switch error
+                opticalSwitchMoveEnd(OPTICAL_SWITCH_MOVE_FAILED, HARDW_ERROR);
+                break;
+            }
+
+            /* The busy state may not be asserted right after the strobe */
+            if (frontend.lpr.opticalSwitch.busy != OPTICAL_SWITCH_BUSY &&
+                now - opticalSwitchMove.issued >= OPTICAL_SWITCH_MOVE_SETTLE) {
+                opticalSwitchMoveEnd(OPTICAL_SWITCH_MOVE_DONE, NO_ERROR);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if (opticalSwitchMovePending() && now - opticalSwitchMove.queued > TIMER_LPR_TO_SWITCH_RDY) {
+        storeError(ERR_OPTICAL_SWITCH, ERC_HARDWARE_TIMEOUT);  // Optical switch move timed out
+        opticalSwitchMoveEnd(OPTICAL_SWITCH_MOVE_FAILED, HARDW_ERROR);
+    }
+    pthread_mutex_unlock(&opticalSwitchMoveLock);
+}
+
+/* Optical switch port move status */
+/*! This function returns the completion status of the last port move:
+        - byte 0: state, see OPTICAL_SWITCH_MOVE_xxx
+        - byte 1: requested port
+        - byte 2: completion status, NO_ERROR or one of the HARDW_xxx codes
+        - byte 3: current port (\ref PORT_SHUTTERED if the shutter is enabled)
+        - bytes 4-7: time from queuing to completion in ms (big endian). While
+          the move is pending, this is the time since it was queued.
+    \param data    The 8 bytes buffer to fill */
+void opticalSwitchMoveStatus(unsigned char *data) {
+    unsigned long elapsed;
+
+    pthread_mutex_lock(&opticalSwitchMoveLock);
+    if (opticalSwitchMovePending()) {
+        elapsed = (unsigned long)(opticalSwitchTime() - opticalSwitchMove.queued);
+    } else {
+        elapsed = (unsigned long)opticalSwitchMove.elapsed;
+    }
+
+    data[0] = opticalSwitchMove.state;
+    data[1] = opticalSwitchMove.port;
+    data[2] = (unsigned char)opticalSwitchMove.status;
+    data[3] = frontend.lpr.opticalSwitch.port;
+    data[4] = (unsigned char)(elapsed >> 24);
+    data[5] = (unsigned char)(elapsed >> 16);
+    data[6] = (unsigned char)(elapsed >> 8);
+    data[7] = (unsigned char)elapsed;
+    pthread_mutex_unlock(&opticalSwitchMoveLock);
+}
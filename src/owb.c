@@ -10,14 +10,17 @@
 /*  Includes */
 #include "owb.h"
 
-#include <stdio.h>  /* printf */
+#include <pthread.h>
+#include <stdio.h>  /* printf, fopen */
 #include <stdlib.h> /* rand, srand */
+#include <string.h> /* memcmp, memcpy */
 #include <time.h>   /* clock, time */
 
 #include "debug.h"
 #include "error_local.h"
 #include "globalDefinitions.h"
 #include "iniWrapper.h"
+#include "lockProfile.h"
 #include "serialMux.h"
 #include "timer.h"
 
@@ -35,8 +38,14 @@ int inp(unsigned int cmd) {
     return owb_mem[OWM_READREG];
 }
 
-unsigned char esnDevicesFound = {0};
-unsigned char ESNS[MAX_DEVICES_NUMBER][SERIAL_NUMBER_SIZE] = {0};
+/* ESNs being served. They are changed by the background search of the bus:
+   use \ref owbEsnsFound and \ref owbEsnRead to access them. */
+static pthread_mutex_t esnLock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned char esnDevicesFound = 0;                                  // Number of devices with ESN found
+static unsigned char ESNS[MAX_DEVICES_NUMBER][SERIAL_NUMBER_SIZE] = {{0}};  // ESNs of the found devices
+static unsigned char esnGeneration = 0;                // Incremented every time the list changes
+static unsigned char esnScanState = OWB_SCAN_PENDING;  // State of the background search
+static unsigned char esnCacheValid = FALSE;            // The ESN cache file holds the list being served
 
 /*! This function initializes the OWB and evaluates if the simulator should be
     used or not.
@@ -53,13 +62,9 @@ int owbInit(void) {
     return NO_ERROR;
 }
 
-/*! This fuction actually gather the ESNs from the OWB. If a simulator is used
-    it will generate the ESN from the information contained in the configuration
-    file.
-    \return
-        - \ref NO_ERROR -> if no error occurred
-        - \ref ERROR    -> if something wrong happened */
-int owbGetEsn(void) {
+/* Helper to search the bus for devices. The ESNs found are stored in esns and
+   their number in found. The bus is held for the whole search. */
+static int owbSearchBus(unsigned char esns[][SERIAL_NUMBER_SIZE], unsigned char *found) {
     /* A few local to deal with the initialization */
     unsigned char device;
     unsigned char loop;
@@ -71,6 +76,13 @@ int owbGetEsn(void) {
     printf("Gathering ESN... ");
 #endif
 
+#ifdef SIMULATED_HARDWARE
+    /* There is no one wire master behind the simulated registers: waiting for
+       the bus reset would only time out. Report an empty bus. */
+    *found = 0;
+    return NO_ERROR;
+#endif /* SIMULATED_HARDWARE */
+
 #ifdef DEBUG_OWB
     printf("done!\n");
 #endif /* DEBUG_OWB */
@@ -201,7 +213,7 @@ int owbGetEsn(void) {
         printf("     - Check state of search tree...");
 #endif /* DEBUG_OWB */
 
-        if (RecoverROM(RData, TData, ESNS[device]) == TRUE) {
+        if (RecoverROM(RData, TData, esns[device]) == TRUE) {
 #ifdef DEBUG_OWB
             printf("done!\n");       // Search tree state
             printf("     done!\n");  // Searching device No.x
@@ -224,27 +236,184 @@ int owbGetEsn(void) {
 #endif /* DEBUG_OWB */
 
     /* If the maximum number of devices was reached, it is likely that there is
-       a problem with the bus. Notify the system and set the number of found
-       devices to 0. */
+       a problem with the bus. Notify the system and discard the search. */
     if (device == MAX_DEVICES_NUMBER) {
 #ifdef DEBUG_STARTUP
         printf("\n\nWARNING - Maximum number of ESN devices reached.\n\n");
 #endif /* DEBUG_STARTUP */
 
         storeError(ERR_OWB, ERC_NO_MEMORY);  // Maximum number of devices reached
-        esnDevicesFound = 0;
-    } else {
-        /* If not, store the number of devices found. */
-        esnDevicesFound = device + 1;
+        return ERROR;
+    }
+
+    /* If not, store the number of devices found. */
+    *found = device + 1;
+
+    return NO_ERROR;
+}
+
+/* Helper to compute the CRC-32 (IEEE 802.3) of the ESN cache file entries */
+static uint32_t owbEsnCacheCrc(unsigned char esns[][SERIAL_NUMBER_SIZE], unsigned char devices) {
+    const unsigned char *data = (const unsigned char *)esns;
+    uint32_t crc = 0xFFFFFFFF;
+    unsigned int i, bit;
+
+    for (i = 0; i < (unsigned int)devices * SERIAL_NUMBER_SIZE; i++) {
+        crc ^= data[i];
+        for (bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
     }
+    return ~crc;
+}
+
+/* Helper to convert a field of the ESN cache file header between the host and
+   the file (big endian) byte order. The conversion is its own inverse. */
+static uint32_t owbEsnCacheOrder(uint32_t value) {
+    const unsigned char *bytes = (const unsigned char *)&value;
 
-    printf("OWB - Devices found: %d\n", esnDevicesFound);
+    return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3];
+}
+
+/* Helper to write the list of ESNs to the ESN cache file */
+static int owbSaveEsnCache(unsigned char esns[][SERIAL_NUMBER_SIZE], unsigned char devices) {
+    OWB_ESN_CACHE_HEADER header;
+    FILE *file;
+    int ret = ERROR;
+
+    header.magic = owbEsnCacheOrder(OWB_ESN_CACHE_MAGIC);
+    header.version = owbEsnCacheOrder(OWB_ESN_CACHE_VERSION);
+    header.devices = owbEsnCacheOrder(devices);
+    header.crc = owbEsnCacheOrder(owbEsnCacheCrc(esns, devices));
+
+    /* Write a temporary file and replace the old one only when complete */
+    if ((file = fopen(OWB_ESN_CACHE_TEMP_FILE, "wb"))) {
+        if (fwrite(&header, sizeof(header), 1, file) == 1 &&
+            fwrite(esns, SERIAL_NUMBER_SIZE, devices, file) == devices) {
+            ret = NO_ERROR;
+        }
+        if (fclose(file) != 0) {
+            ret = ERROR;
+        }
+        if (ret == NO_ERROR && rename(OWB_ESN_CACHE_TEMP_FILE, OWB_ESN_CACHE_FILE) != 0) {
+            ret = ERROR;
+        }
+        if (ret == ERROR) {
+            remove(OWB_ESN_CACHE_TEMP_FILE);
+        }
+    }
+
+#ifdef DEBUG_OWB
+    printf("owbSaveEsnCache: file=%s devices=%d %s\n", OWB_ESN_CACHE_FILE, devices,
+           ret == NO_ERROR ? "written" : "failed");
+#endif /* DEBUG_OWB */
+
+    return ret;
+}
+
+/* Helper to print the list of ESNs */
+static void owbPrintEsns(const char *source, unsigned char esns[][SERIAL_NUMBER_SIZE], unsigned char devices) {
+    unsigned char device;
+
+    printf("OWB - Devices %s: %d\n", source, devices);
 
     /* Print devices list */
-    for (device = 0; device < esnDevicesFound; device++) {
-        printf("    - ESN%d: %02X %02X %02X %02X %02X %02X %02X %02X\n", device, ESNS[device][0], ESNS[device][1],
-               ESNS[device][2], ESNS[device][3], ESNS[device][4], ESNS[device][5], ESNS[device][6], ESNS[device][7]);
+    for (device = 0; device < devices; device++) {
+        printf("    - ESN%d: %02X %02X %02X %02X %02X %02X %02X %02X\n", device, esns[device][0], esns[device][1],
+               esns[device][2], esns[device][3], esns[device][4], esns[device][5], esns[device][6], esns[device][7]);
+    }
+}
+
+/*! This function loads the list of ESNs found during the last successful
+    search of the bus from the ESN cache file, so that it can be served while
+    the bus is searched again by \ref owbStartScan.
+    \return
+        - \ref NO_ERROR -> if the cached list was loaded
+        - \ref ERROR    -> if the cache file is missing or not valid */
+int owbLoadEsnCache(void) {
+    OWB_ESN_CACHE_HEADER header;
+    unsigned char esns[MAX_DEVICES_NUMBER][SERIAL_NUMBER_SIZE];
+    FILE *file;
+    int ret = ERROR;
+
+    if (!(file = fopen(OWB_ESN_CACHE_FILE, "rb"))) {
+        return ERROR;
+    }
+
+    /* A short file leaves a zero, not valid, magic */
+    if (fread(&header, sizeof(header), 1, file) != 1) {
+        memset(&header, 0, sizeof(header));
     }
+    header.magic = owbEsnCacheOrder(header.magic);
+    header.version = owbEsnCacheOrder(header.version);
+    header.devices = owbEsnCacheOrder(header.devices);
+    header.crc = owbEsnCacheOrder(header.crc);
+
+    if (header.magic == OWB_ESN_CACHE_MAGIC &&
+        header.version == OWB_ESN_CACHE_VERSION && header.devices <= MAX_DEVICES_NUMBER &&
+        fread(esns, SERIAL_NUMBER_SIZE, header.devices, file) == header.devices &&
+        owbEsnCacheCrc(esns, header.devices) == header.crc) {
+        pthread_mutex_lock(&esnLock);
+        memcpy(ESNS, esns, header.devices * SERIAL_NUMBER_SIZE);
+        esnDevicesFound = header.devices;
+        esnCacheValid = TRUE;
+        pthread_mutex_unlock(&esnLock);
+        ret = NO_ERROR;
+    }
+
+    fclose(file);
+
+    if (ret == NO_ERROR) {
+        owbPrintEsns("cached", esns, header.devices);
+    }
+
+    return ret;
+}
+
+/*! This fuction actually gather the ESNs from the OWB and reconciles them with
+    the list being served. If the list changed, the generation counter returned
+    by \ref owbEsnsFound is incremented and the ESN cache file is updated. If
+    the search fails, the list being served is left untouched.
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int owbGetEsn(void) {
+    unsigned char esns[MAX_DEVICES_NUMBER][SERIAL_NUMBER_SIZE];
+    unsigned char found = 0;
+    unsigned char changed, save;
+    int ret;
+
+    lockMux(LOCK_PROFILE_OWB);
+    ret = owbSearchBus(esns, &found);
+    unlockMux(LOCK_PROFILE_OWB);
+
+    pthread_mutex_lock(&esnLock);
+    if (ret == ERROR) {
+        esnScanState = OWB_SCAN_ERROR;
+        found = esnDevicesFound;
+        pthread_mutex_unlock(&esnLock);
+
+        printf("OWB - Search failed, devices cached: %d\n", found);
+        return ERROR;
+    }
+
+    changed = found != esnDevicesFound || memcmp(esns, ESNS, found * SERIAL_NUMBER_SIZE) != 0;
+    if (changed) {
+        memcpy(ESNS, esns, found * SERIAL_NUMBER_SIZE);
+        esnDevicesFound = found;
+        esnGeneration++;
+    }
+    save = changed || !esnCacheValid;
+    esnCacheValid = TRUE;
+    esnScanState = OWB_SCAN_DONE;
+    pthread_mutex_unlock(&esnLock);
+
+    owbPrintEsns("found", esns, found);
+
+    if (save && owbSaveEsnCache(esns, found) == ERROR) {
+        printf("OWB - Unable to write %s\n", OWB_ESN_CACHE_FILE);
+    }
+
 #ifdef DEBUG_OWB
     printf("done!\n\n");
 #endif
@@ -252,6 +421,78 @@ int owbGetEsn(void) {
     return NO_ERROR;
 }
 
+/* Background search of the bus */
+static void *owbScanThread(void *arg) {
+    lockProfileThread(LOCK_THREAD_OWB);
+    owbGetEsn();
+    return NULL;
+}
+
+/*! This function starts the search of the bus in a background thread. The list
+    of ESNs loaded by \ref owbLoadEsnCache is served until the search is done.
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if the thread could not be started */
+int owbStartScan(void) {
+    pthread_t tid;
+
+    pthread_mutex_lock(&esnLock);
+    esnScanState = OWB_SCAN_PENDING;
+    pthread_mutex_unlock(&esnLock);
+
+    if (pthread_create(&tid, NULL, &owbScanThread, NULL) != 0) {
+        storeError(ERR_OWB, ERC_HARDWARE_ERROR);  // Unable to start the background search
+        pthread_mutex_lock(&esnLock);
+        esnScanState = OWB_SCAN_ERROR;
+        pthread_mutex_unlock(&esnLock);
+        return ERROR;
+    }
+    pthread_detach(tid);
+
+    return NO_ERROR;
+}
+
+/*! This function returns the number of ESNs being served.
+    \param generation   if not NULL, returns the generation of the list: it is
+                        incremented every time a search changes the list
+    \param state        if not NULL, returns the state of the background search
+                        (OWB_SCAN_PENDING, OWB_SCAN_DONE or OWB_SCAN_ERROR)
+    \return             the number of ESNs */
+unsigned char owbEsnsFound(unsigned char *generation, unsigned char *state) {
+    unsigned char found;
+
+    pthread_mutex_lock(&esnLock);
+    found = esnDevicesFound;
+    if (generation) {
+        *generation = esnGeneration;
+    }
+    if (state) {
+        *state = esnScanState;
+    }
+    pthread_mutex_unlock(&esnLock);
+
+    return found;
+}
+
+/*! This function copies one of the ESNs being served.
+    \param device   index of the ESN in the list
+    \param esn      buffer of \ref SERIAL_NUMBER_SIZE bytes for the ESN
+    \return
+        - \ref NO_ERROR -> if the ESN was copied
+        - \ref ERROR    -> if there is no ESN with the given index */
+int owbEsnRead(unsigned char device, unsigned char *esn) {
+    int ret = ERROR;
+
+    pthread_mutex_lock(&esnLock);
+    if (device < esnDevicesFound) {
+        memcpy(esn, ESNS[device], SERIAL_NUMBER_SIZE);
+        ret = NO_ERROR;
+    }
+    pthread_mutex_unlock(&esnLock);
+
+    return ret;
+}
+
 /* Write to the one wire bus */
 int writeOwb(int data) {
     /* Write the data on the bus */
@@ -60,20 +60,19 @@ void paGateVoltageHandler(int currentModule, int currentPaModule, int currentPaC
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                      .lo.pa.paChannel[currentPaChannel(currentModule, currentPaModule)]
-                                      .lastGateVoltage)
+        SAVE_LAST_CONTROL_MESSAGE(
+            frontend.cartridge[currentModule]
+                .lastControl.paChannelGateVoltage[currentPaChannel(currentModule, currentPaModule)])
 
         /* Extract the float from the can message */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
 
         /* Set the PA channel gate voltage. If an error occurs then store the
            state and return the error state then return. */
-        if (setPaChannel(currentModule, currentPaModule, currentPaChannelModule) == ERROR) {
+        if (setPaChannel(CONV_FLOAT, currentModule, currentPaModule, currentPaChannelModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
             frontend.cartridge[currentModule]
-                .lo.pa.paChannel[currentPaChannel(currentModule, currentPaModule)]
-                .lastGateVoltage.status = ERROR;
+                .lastControl.paChannelGateVoltage[currentPaChannel(currentModule, currentPaModule)].status = ERROR;
             return;
         }
         /* If everything went fine, it's a control message, we're done. */
@@ -83,9 +82,9 @@ void paGateVoltageHandler(int currentModule, int currentPaModule, int currentPaC
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {  // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                        .lo.pa.paChannel[currentPaChannel(currentModule, currentPaModule)]
-                                        .lastGateVoltage)
+        RETURN_LAST_CONTROL_MESSAGE(
+            frontend.cartridge[currentModule]
+                .lastControl.paChannelGateVoltage[currentPaChannel(currentModule, currentPaModule)])
         return;
     }
 
@@ -161,16 +160,16 @@ void paDrainVoltageHandler(int currentModule, int currentPaModule, int currentPa
 
             // Store the status in the last control message:
             frontend.cartridge[currentModule]
-                .lo.pa.paChannel[currentPaChannel(currentModule, currentPaModule)]
-                .lastDrainVoltage.status = HARDW_BLKD_ERR;
+                .lastControl.paChannelDrainVoltage[currentPaChannel(currentModule, currentPaModule)]
+                .status = HARDW_BLKD_ERR;
 
             return;
         }
 
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                      .lo.pa.paChannel[currentPaChannel(currentModule, currentPaModule)]
-                                      .lastDrainVoltage)
+        SAVE_LAST_CONTROL_MESSAGE(
+            frontend.cartridge[currentModule]
+                .lastControl.paChannelDrainVoltage[currentPaChannel(currentModule, currentPaModule)])
 
         /* Extract the float from the can message */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -190,25 +189,22 @@ void paDrainVoltageHandler(int currentModule, int currentPaModule, int currentPa
 
             /* save the modified command setting to the "last control message" location */
             changeEndian(frontend.cartridge[currentModule]
-                             .lo.pa.paChannel[currentPaChannel(currentModule, currentPaModule)]
-                             .lastDrainVoltage.data,
+                             .lastControl.paChannelDrainVoltage[currentPaChannel(currentModule, currentPaModule)].data,
                          CONV_CHR_ADD);
         }
 
         /* Set the PA channel drain voltage. If an error occurs then store the
            state and then return. */
-        if (setPaChannel(currentModule, currentPaModule, currentPaChannelModule) == ERROR) {
+        if (setPaChannel(CONV_FLOAT, currentModule, currentPaModule, currentPaChannelModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
             frontend.cartridge[currentModule]
-                .lo.pa.paChannel[currentPaChannel(currentModule, currentPaModule)]
-                .lastDrainVoltage.status = ERROR;
+                .lastControl.paChannelDrainVoltage[currentPaChannel(currentModule, currentPaModule)].status = ERROR;
             return;
         }
 
         /* if limitSafePaDrainVoltage() above returned a problem, we want to save that error status */
         frontend.cartridge[currentModule]
-            .lo.pa.paChannel[currentPaChannel(currentModule, currentPaModule)]
-            .lastDrainVoltage.status = ret;
+            .lastControl.paChannelDrainVoltage[currentPaChannel(currentModule, currentPaModule)].status = ret;
 
         /* If everything went fine, it's a control message, we're done. */
         return;
@@ -217,9 +213,9 @@ void paDrainVoltageHandler(int currentModule, int currentPaModule, int currentPa
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {  // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                        .lo.pa.paChannel[currentPaChannel(currentModule, currentPaModule)]
-                                        .lastDrainVoltage)
+        RETURN_LAST_CONTROL_MESSAGE(
+            frontend.cartridge[currentModule]
+                .lastControl.paChannelDrainVoltage[currentPaChannel(currentModule, currentPaModule)])
         return;
     }
 
@@ -9,6 +9,7 @@
 #include "frontend.h"
 #include "globalDefinitions.h"
 #include "globalOperations.h"
+#include "lockProfile.h"
 #include "main.h"
 #include "owb.h"
 #include "serialMux.h"
@@ -132,7 +133,8 @@ void standardRCAsHandler(void) {
 
 /* Special messages handler */
 void specialRCAsHandler(void) {
-    /* A static to take care of the ESNs monitoring */
+    /* Cursor of the sequential ESNs readout (GET_ESNS). The indexed readout
+       (GET_ESN) does not use it. */
     static unsigned char device = 0;
 
     /* Return code from stdlib calls: */
@@ -212,15 +214,15 @@ void specialRCAsHandler(void) {
                 printf("  0x%lX->GET_ESNS_FOUND\n\n", GET_ESNS_FOUND);
 #endif                       /* DEBUG_CAN */
                 device = 0;  // Reset the device index to the beginning of the list
-                CAN_BYTE = esnDevicesFound;
-                CAN_SIZE = CAN_BOOLEAN_SIZE;
+                CAN_DATA(0) = owbEsnsFound(&CAN_DATA(1), &CAN_DATA(2));
+                CAN_SIZE = CAN_ESNS_FOUND_SIZE;
                 break;
             case GET_ESNS:  // 0x2000B -> Return the list of ESNs found
 #ifdef DEBUG_CAN
                 printf("  0x%lX->GET_ESNS\n\n", GET_ESNS);
 #endif /* DEBUG_CAN */
                 /* If no devices were found return error */
-                if (esnDevicesFound == 0) {
+                if (owbEsnsFound(NULL, NULL) == 0) {
                     CAN_DATA(7) = 0xFF;
                     CAN_DATA(6) = 0xFF;
                     CAN_DATA(5) = 0xFF;
@@ -235,7 +237,7 @@ void specialRCAsHandler(void) {
 
                 /* If last found device was already reported, return zero
                    and reset the count. */
-                if (device == esnDevicesFound) {
+                if (owbEsnRead(device, CAN_DATA_ADD) == ERROR) {
                     CAN_DATA(7) = 0;
                     CAN_DATA(6) = 0;
                     CAN_DATA(5) = 0;
@@ -249,15 +251,7 @@ void specialRCAsHandler(void) {
                     break;
                 }
 
-                /* Return the next available ESN */
-                CAN_DATA(7) = ESNS[device][7];
-                CAN_DATA(6) = ESNS[device][6];
-                CAN_DATA(5) = ESNS[device][5];
-                CAN_DATA(4) = ESNS[device][4];
-                CAN_DATA(3) = ESNS[device][3];
-                CAN_DATA(2) = ESNS[device][2];
-                CAN_DATA(1) = ESNS[device][1];
-                CAN_DATA(0) = ESNS[device][0];
+                /* The next available ESN was returned */
                 CAN_SIZE = CAN_FULL_SIZE;
                 device++;
                 break;
@@ -321,10 +315,106 @@ void specialRCAsHandler(void) {
                 }
                 break;
 
+            case GET_SIS_IV_SWEEP_STATUS:  // 0x20020 -> Returns the SIS I-V sweep state
+                sisSweepStatus(CAN_DATA_ADD);
+                CAN_SIZE = CAN_FULL_SIZE;
+                break;
+
+            case GET_SIS_MAGNET_RAMP_STATUS:  // 0x20022 -> Returns the SIS magnet ramp state
+                sisMagnetRampStatus(CAN_DATA_ADD);
+                CAN_SIZE = CAN_FULL_SIZE;
+                break;
+
+            case GET_BAND_SELECT_STATUS:  // 0x20024 -> Returns the band select progress
+                bandSelectStatus(CAN_DATA_ADD);
+                CAN_SIZE = CAN_FULL_SIZE;
+                break;
+
+            case GET_LPR_SWITCH_MOVE_STATUS:  // 0x20025 -> Returns the optical switch port move status
+                opticalSwitchMoveStatus(CAN_DATA_ADD);
+                CAN_SIZE = CAN_FULL_SIZE;
+                break;
+
+            case GET_PLL_LOCK_SEARCH_STATUS:  // 0x20026 -> Returns the PLL lock search state
+                pllLockSearchStatus(CAN_DATA_ADD);
+                CAN_SIZE = CAN_FULL_SIZE;
+                break;
+
+            case GET_FE_SNAPSHOT:  // 0x20028 -> Captures a snapshot of the frontend state
+                frontendSnapshotCapture(CAN_DATA_ADD);
+                CAN_SIZE = CAN_FULL_SIZE;
+                break;
+
+            case GET_LOCK_PROFILE:  // 0x2002A -> Ranks the locks by contention
+                lockProfileStatus(CAN_DATA_ADD);
+                CAN_SIZE = CAN_FULL_SIZE;
+                break;
+
             /* This will take care also of all the monitor request on
                special CAN control RCAs. It should be replaced by a proper
                structure as the one used for standard RCAs */
             default:
+                /* 0x20100 through 0x20122 -> Returns the ESN with the index
+                   encoded in the RCA: 0xFF if no devices were found, zero if
+                   the index is past the end of the list. No state is kept
+                   between requests. */
+                if (CAN_ADDRESS >= GET_ESN && CAN_ADDRESS < GET_ESN + MAX_DEVICES_NUMBER) {
+                    if (owbEsnRead((unsigned char)(CAN_ADDRESS - GET_ESN), CAN_DATA_ADD) == ERROR) {
+                        memset(CAN_DATA_ADD, owbEsnsFound(NULL, NULL) == 0 ? 0xFF : 0, CAN_FULL_SIZE);
+                    }
+                    CAN_SIZE = CAN_FULL_SIZE;
+                    break;
+                }
+
+                /* 0x20140 through 0x2014A -> Returns the lock with the rank
+                   encoded in the RCA in the last contention ranking. No state
+                   is kept between requests. */
+                if (CAN_ADDRESS >= GET_LOCK_PROFILE_ENTRY &&
+                    CAN_ADDRESS < GET_LOCK_PROFILE_ENTRY + LOCK_PROFILE_LOCKS) {
+                    lockProfileReadEntry((unsigned char)(CAN_ADDRESS - GET_LOCK_PROFILE_ENTRY), CAN_DATA_ADD);
+                    CAN_SIZE = CAN_FULL_SIZE;
+                    break;
+                }
+
+                /* 0x20180 through 0x201FF -> Returns the FETIM interlock
+                   event after the one with the sequence low bits encoded in
+                   the RCA. No state is kept between requests. */
+                if (CAN_ADDRESS >= GET_FETIM_INTERLOCK_EVENT &&
+                    CAN_ADDRESS <= GET_FETIM_INTERLOCK_EVENT + FETIM_EVENT_SEQUENCE_MASK) {
+                    fetimReadEvent((unsigned char)(CAN_ADDRESS - GET_FETIM_INTERLOCK_EVENT), CAN_DATA_ADD);
+                    CAN_SIZE = CAN_FULL_SIZE;
+                    break;
+                }
+
+                /* 0x20200 through 0x203FF -> Returns the SIS I-V sweep point
+                   with the index encoded in the RCA. No state is kept between
+                   requests. */
+                if (CAN_ADDRESS >= GET_SIS_IV_SWEEP_POINT &&
+                    CAN_ADDRESS < GET_SIS_IV_SWEEP_POINT + SIS_SWEEP_MAX_POINTS) {
+                    sisSweepReadPoint((unsigned int)(CAN_ADDRESS - GET_SIS_IV_SWEEP_POINT), CAN_DATA_ADD);
+                    CAN_SIZE = CAN_FULL_SIZE;
+                    break;
+                }
+
+                /* 0x20400 through 0x205FF -> Returns the SIS magnet ramp
+                   sample with the index encoded in the RCA. No state is kept
+                   between requests. */
+                if (CAN_ADDRESS >= GET_SIS_MAGNET_RAMP_SAMPLE &&
+                    CAN_ADDRESS < GET_SIS_MAGNET_RAMP_SAMPLE + SIS_MAGNET_RAMP_MAX_SAMPLES) {
+                    sisMagnetRampReadSample((unsigned int)(CAN_ADDRESS - GET_SIS_MAGNET_RAMP_SAMPLE), CAN_DATA_ADD);
+                    CAN_SIZE = CAN_FULL_SIZE;
+                    break;
+                }
+
+                /* 0x20600 through 0x20FFF -> Returns the frontend snapshot
+                   chunk with the index encoded in the RCA. No state is kept
+                   between requests. */
+                if (CAN_ADDRESS >= GET_FE_SNAPSHOT_CHUNK && CAN_ADDRESS <= LAST_SPECIAL_MONITOR_RCA) {
+                    frontendSnapshotRead((unsigned int)(CAN_ADDRESS - GET_FE_SNAPSHOT_CHUNK), CAN_DATA_ADD);
+                    CAN_SIZE = CAN_FULL_SIZE;
+                    break;
+                }
+
                 storeError(ERR_CAN,
                            ERC_RCA_RANGE);  // Special Monitor RCA out of range
                 CAN_STATUS = MON_CAN_RNG;   // Message out of range
@@ -431,6 +521,127 @@ void specialRCAsHandler(void) {
                 }
                 break;
 
+            case SET_LO_SET_PA_LIMITS_ENTRIES + 0:
+            case SET_LO_SET_PA_LIMITS_ENTRIES + 1:
+            case SET_LO_SET_PA_LIMITS_ENTRIES + 2:
+            case SET_LO_SET_PA_LIMITS_ENTRIES + 3:
+            case SET_LO_SET_PA_LIMITS_ENTRIES + 4:
+            case SET_LO_SET_PA_LIMITS_ENTRIES + 5:
+            case SET_LO_SET_PA_LIMITS_ENTRIES + 6:
+            case SET_LO_SET_PA_LIMITS_ENTRIES + 7:
+            case SET_LO_SET_PA_LIMITS_ENTRIES + 8:
+            case SET_LO_SET_PA_LIMITS_ENTRIES + 9:
+                // bulk upload of packed PA limits table entries, also allowed
+                //  when the cartridge is powered off.
+                loAddPaLimitsEntries((unsigned char)(CAN_ADDRESS - SET_LO_SET_PA_LIMITS_ENTRIES), CAN_DATA_ADD,
+                                     CAN_SIZE);
+                break;
+
+            case SET_SIS_IV_SWEEP + 0:
+            case SET_SIS_IV_SWEEP + 1:
+            case SET_SIS_IV_SWEEP + 2:
+            case SET_SIS_IV_SWEEP + 3:
+            case SET_SIS_IV_SWEEP + 4:
+            case SET_SIS_IV_SWEEP + 5:
+            case SET_SIS_IV_SWEEP + 6:
+            case SET_SIS_IV_SWEEP + 7:
+            case SET_SIS_IV_SWEEP + 8:
+            case SET_SIS_IV_SWEEP + 9:
+                // the sweep itself is executed by the cartridge async process
+                sisSweepStart((int)(CAN_ADDRESS - SET_SIS_IV_SWEEP), CAN_DATA_ADD, CAN_SIZE);
+                break;
+
+            case SET_SIS_IV_SWEEP_ABORT:  // 0x2105A -> Abort the SIS I-V sweep
+                sisSweepAbort();
+                break;
+
+            case SET_SIS_MAGNET_RAMP + 0:
+            case SET_SIS_MAGNET_RAMP + 1:
+            case SET_SIS_MAGNET_RAMP + 2:
+            case SET_SIS_MAGNET_RAMP + 3:
+            case SET_SIS_MAGNET_RAMP + 4:
+            case SET_SIS_MAGNET_RAMP + 5:
+            case SET_SIS_MAGNET_RAMP + 6:
+            case SET_SIS_MAGNET_RAMP + 7:
+            case SET_SIS_MAGNET_RAMP + 8:
+            case SET_SIS_MAGNET_RAMP + 9:
+                // the ramp itself is executed by the cartridge async process
+                sisMagnetRampStart((int)(CAN_ADDRESS - SET_SIS_MAGNET_RAMP), CAN_DATA_ADD, CAN_SIZE);
+                break;
+
+            case SET_SIS_MAGNET_RAMP_ABORT:  // 0x2106A -> Abort the SIS magnet ramps
+                sisMagnetRampAbort();
+                break;
+
+            case SET_LNA_BIAS_STAGE + 0:
+            case SET_LNA_BIAS_STAGE + 1:
+            case SET_LNA_BIAS_STAGE + 2:
+            case SET_LNA_BIAS_STAGE + 3:
+            case SET_LNA_BIAS_STAGE + 4:
+            case SET_LNA_BIAS_STAGE + 5:
+            case SET_LNA_BIAS_STAGE + 6:
+            case SET_LNA_BIAS_STAGE + 7:
+            case SET_LNA_BIAS_STAGE + 8:
+            case SET_LNA_BIAS_STAGE + 9:
+                lnaBiasStage((int)(CAN_ADDRESS - SET_LNA_BIAS_STAGE), CAN_DATA_ADD, CAN_SIZE);
+                break;
+
+            case SET_LNA_BIAS_APPLY + 0:
+            case SET_LNA_BIAS_APPLY + 1:
+            case SET_LNA_BIAS_APPLY + 2:
+            case SET_LNA_BIAS_APPLY + 3:
+            case SET_LNA_BIAS_APPLY + 4:
+            case SET_LNA_BIAS_APPLY + 5:
+            case SET_LNA_BIAS_APPLY + 6:
+            case SET_LNA_BIAS_APPLY + 7:
+            case SET_LNA_BIAS_APPLY + 8:
+            case SET_LNA_BIAS_APPLY + 9:
+                lnaBiasApply((int)(CAN_ADDRESS - SET_LNA_BIAS_APPLY), CAN_DATA_ADD, CAN_SIZE);
+                break;
+
+            case SET_BAND_SELECT + 0:
+            case SET_BAND_SELECT + 1:
+            case SET_BAND_SELECT + 2:
+            case SET_BAND_SELECT + 3:
+            case SET_BAND_SELECT + 4:
+            case SET_BAND_SELECT + 5:
+            case SET_BAND_SELECT + 6:
+            case SET_BAND_SELECT + 7:
+            case SET_BAND_SELECT + 8:
+            case SET_BAND_SELECT + 9:
+                // the cartridge readiness is awaited by the cartridge async process
+                bandSelectStart((int)(CAN_ADDRESS - SET_BAND_SELECT));
+                break;
+
+            case SET_PLL_LOCK_SEARCH + 0:
+            case SET_PLL_LOCK_SEARCH + 1:
+            case SET_PLL_LOCK_SEARCH + 2:
+            case SET_PLL_LOCK_SEARCH + 3:
+            case SET_PLL_LOCK_SEARCH + 4:
+            case SET_PLL_LOCK_SEARCH + 5:
+            case SET_PLL_LOCK_SEARCH + 6:
+            case SET_PLL_LOCK_SEARCH + 7:
+            case SET_PLL_LOCK_SEARCH + 8:
+            case SET_PLL_LOCK_SEARCH + 9:
+                // the search itself is executed by the cartridge async process
+                pllLockSearchStart((int)(CAN_ADDRESS - SET_PLL_LOCK_SEARCH), CAN_DATA_ADD, CAN_SIZE);
+                break;
+
+            case SET_PLL_LOCK_SEARCH_ABORT:  // 0x210AA -> Abort the PLL lock search
+                pllLockSearchAbort();
+                break;
+
+            case SET_LOCK_PROFILE:  // 0x210B0 -> Start or stop the lock contention profiler
+                if (CAN_BYTE == ENABLE) {
+                    lockProfileEnable(ENABLE);
+                } else if (CAN_BYTE == DISABLE) {
+                    lockProfileEnable(DISABLE);
+                    lockProfileReport();
+                } else {
+                    storeError(ERR_CAN, ERC_COMMAND_VAL);  // Illegal profiler state
+                }
+                break;
+
             default:
                 storeError(ERR_CAN,
                            ERC_RCA_RANGE);  // Special Control RCA out of range
@@ -64,21 +64,17 @@ void pdVoltageHandler(int currentPowerDistributionModule, int currentPdModuleMod
         return;
     }
 
-    /* Monitor the voltage for the desired channel */
-    if (getPdChannel(currentPowerDistributionModule, currentPdModuleModule, currentPdChannelModule) == ERROR) {
+    /* Return the reading of the background sweep if recent enough, otherwise
+       monitor the voltage for the desired channel */
+    if (!pdChannelsCached(currentPowerDistributionModule) &&
+        getPdChannel(currentPowerDistributionModule, currentPdModuleModule, currentPdChannelModule) == ERROR) {
         /* If error during monitoring, store the ERROR state in the outgoing
            CAN message state. */
         CAN_STATUS = ERROR;
-        /* Store the last known value in the outgoing message */
-        CONV_FLOAT = frontend.powerDistribution.pdModule[currentPowerDistributionModule]
-                         .pdChannel[currentPdModuleModule]
-                         .voltage;
-    } else {
-        /* If no error during monitor pocess, gather the stored data */
-        CONV_FLOAT = frontend.powerDistribution.pdModule[currentPowerDistributionModule]
-                         .pdChannel[currentPdModuleModule]
-                         .voltage;
     }
+    /* Store the last known value in the outgoing message */
+    CONV_FLOAT =
+        frontend.powerDistribution.pdModule[currentPowerDistributionModule].pdChannel[currentPdModuleModule].voltage;
     /* Load the CAN message payload with the returned value and set the
        size. The value has to be converted from little endian (Intel) to
        big endian (CAN). It is done directly instead of using a function
@@ -109,21 +105,17 @@ void pdCurrentHandler(int currentPowerDistributionModule, int currentPdModuleMod
         return;
     }
 
-    /* Monitor the current for the desired channel */
-    if (getPdChannel(currentPowerDistributionModule, currentPdModuleModule, currentPdChannelModule) == ERROR) {
+    /* Return the reading of the background sweep if recent enough, otherwise
+       monitor the current for the desired channel */
+    if (!pdChannelsCached(currentPowerDistributionModule) &&
+        getPdChannel(currentPowerDistributionModule, currentPdModuleModule, currentPdChannelModule) == ERROR) {
         /* If error during monitoring, store the ERROR state in the outgoing
            CAN message state. */
         CAN_STATUS = ERROR;
-        /* Store the last known value in the outgoing message */
-        CONV_FLOAT = frontend.powerDistribution.pdModule[currentPowerDistributionModule]
-                         .pdChannel[currentPdModuleModule]
-                         .current;
-    } else {
-        /* If no error during monitor pocess, gather the stored data */
-        CONV_FLOAT = frontend.powerDistribution.pdModule[currentPowerDistributionModule]
-                         .pdChannel[currentPdModuleModule]
-                         .current;
     }
+    /* Store the last known value in the outgoing message */
+    CONV_FLOAT =
+        frontend.powerDistribution.pdModule[currentPowerDistributionModule].pdChannel[currentPdModuleModule].current;
     /* Load the CAN message payload with the returned value and set the
        size. The value has to be converted from little endian (Intel) to
        big endian (CAN). It is done directly instead of using a function
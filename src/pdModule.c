@@ -8,8 +8,9 @@
     cartridge power distribution system. */
 
 /* Includes */
-#include <stdio.h>  /* printf */
-#include <string.h> /* memcpy */
+#include <stdatomic.h> /* atomic_compare_exchange_weak */
+#include <stdio.h>     /* printf */
+#include <string.h>    /* memcpy */
 
 #include "async.h"
 #include "debug.h"
@@ -57,25 +58,116 @@ int allowStandby2(int module) {
     return FALSE;
 }
 
+/* Reserve a slot for a powered or STANDBY2 cartridge */
+/*! Allow up to four to be powered on, so long as one of them is in STANDBY2
+    mode. The check and the increment of the counter are a single
+    compare-and-swap so that the CAN and the cartridge async threads can never
+    push the counters beyond the limits. The slot is returned by
+    \ref pdModuleRelease when the cartridge is stopped.
+    \param module      The cartridge to power on
+    \param standby2    TRUE to reserve a STANDBY2 slot
+    \return
+        - \ref TRUE     -> if the slot was reserved
+        - \ref FALSE    -> if the max number of cartridges was reached */
 int allowPowerOn(int module, int standby2) {
-    // Allow up to four to be powered on, so long as one of them is in STANDBY2 mode.
-
-    int avail = frontend.powerDistribution.maxPoweredModules - frontend.powerDistribution.poweredModules;
+    _Atomic unsigned char *count;
+    unsigned char max, current;
+
+    if (standby2) {
+        // going to STANDBY2 mode, either from OFF or ON...
+        count = &frontend.powerDistribution.standby2Modules;
+        max = MAX_STANDBY2_BANDS_OPERATIONAL;
+    } else {
+        count = &frontend.powerDistribution.poweredModules;
+        max = frontend.powerDistribution.maxPoweredModules;
+    }
 
-    // not going to STANDBY2 mode so the simple check is enough:
-    if (!standby2) {
-        if (avail > 0)
-            return TRUE;
-        else
+    current = atomic_load(count);
+    do {
+        if (current >= max) {
             return FALSE;
+        }
+    } while (!atomic_compare_exchange_weak(count, &current, current + 1));
+
+    return TRUE;
+}
+
+/* Return the slot reserved by allowPowerOn */
+void pdModuleRelease(unsigned char standby2) {
+    if (standby2) {
+        atomic_fetch_sub(&frontend.powerDistribution.standby2Modules, 1);
+    } else {
+        atomic_fetch_sub(&frontend.powerDistribution.poweredModules, 1);
+    }
+}
+
+/* Take a slot regardless of the limits, for a cartridge whose power state is
+   unknown after an error */
+void pdModuleHold(unsigned char standby2) {
+    if (standby2) {
+        atomic_fetch_add(&frontend.powerDistribution.standby2Modules, 1);
+    } else {
+        atomic_fetch_add(&frontend.powerDistribution.poweredModules, 1);
     }
+}
 
-    // going to STANDBY2 mode, either from OFF or ON...
-    // Allow STANDBY2 if we are below the max allowed:
-    if (frontend.powerDistribution.standby2Modules < MAX_STANDBY2_BANDS_OPERATIONAL)
-        return TRUE;
-    else
-        return FALSE;
+/* Update the max number of powered cartridges depending on the FE mode */
+static void updateMaxPoweredModules(void) {
+    switch (frontend.mode) {
+        case TROUBLESHOOTING_MODE:
+            frontend.powerDistribution.maxPoweredModules = MAX_POWERED_BANDS_TROUBLESHOOTING;
+            break;
+        default:
+            frontend.powerDistribution.maxPoweredModules = MAX_POWERED_BANDS_OPERATIONAL;
+            break;
+    }
+}
+
+/* Power on a cartridge */
+/*! This function powers on a cartridge that is currently off, either fully or
+    in STANDBY2 mode. The cartridge is left in the \ref CARTRIDGE_ON state so
+    that the initialization is performed by the cartridge async routine.
+    \param module      The cartridge to power on
+    \param standby2    TRUE to power on in STANDBY2 mode
+    \return
+        - \ref NO_ERROR       -> if the cartridge was powered on
+        - \ref HARDW_BLKD_ERR -> if the max number of powered bands was reached
+        - \ref ERROR          -> if something wrong happened */
+int pdModulePowerOn(int module, unsigned char standby2) {
+    updateMaxPoweredModules();
+
+    // Reserve one of the powered on OR STANDBY2 cartridges.
+    // This is done here since the initialization is
+    //  going to be performed asynchronously.
+    // This prevents turning on too many cartridges
+    //  before each initialization is completed.
+    if (!allowPowerOn(module, standby2)) {
+        // max number of bands powered on:
+        storeError(ERR_PD_MODULE, ERC_HARDWARE_BLOCKED);
+        return HARDW_BLKD_ERR;
+    }
+
+    // Turn on the cartridge:
+    if (setPdModuleEnable(PD_MODULE_ENABLE, module) == ERROR) {
+        pdModuleRelease(standby2);
+        return ERROR;
+    }
+
+    // Set the state of the cartridge to CARTRIDGE_ON (powered but not
+    // yet initialized) and its STANDBY2 state. This state will trigger the
+    // initialization by the cartridge async routine.
+    if (!cartridgePowerOn(module, standby2)) {
+        // The cartridge was not off: the slot is already held
+        pdModuleRelease(standby2);
+        storeError(ERR_PD_MODULE, ERC_HARDWARE_BLOCKED);
+        return HARDW_BLKD_ERR;
+    }
+
+#ifdef DEBUG_POWERDIS
+    printPoweredModuleCounts();
+#endif /* DEBUG_POWERDIS */
+
+    return NO_ERROR;
 }
 
 void printPoweredModuleCounts(void) {
@@ -108,7 +200,7 @@ void pdEnableHandler(int currentPowerDistributionModule, int currentPdModuleModu
     /* If it's a control message (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.powerDistribution.pdModule[currentPowerDistributionModule].lastEnable)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.powerDistribution.lastControl.pdModuleEnable[currentPowerDistributionModule])
 
         // If the command is to one of the powered on states:
         if (CAN_BYTE) {
@@ -123,7 +215,7 @@ void pdEnableHandler(int currentPowerDistributionModule, int currentPdModuleModu
             // Disallow if the cartridge is in the error state:
             //  only allowed action is to power off
             if ((frontend.cartridge[currentPowerDistributionModule].state == CARTRIDGE_ERROR)) {
-                frontend.powerDistribution.pdModule[currentPowerDistributionModule].lastEnable.status =
+                frontend.powerDistribution.lastControl.pdModuleEnable[currentPowerDistributionModule].status =
                     HARDW_ERROR;  // Store in the last CAN message variable
                 return;
             }
@@ -143,7 +235,7 @@ void pdEnableHandler(int currentPowerDistributionModule, int currentPdModuleModu
                         storeError(ERR_PD_MODULE, ERC_COMMAND_VAL);
 
                         // Store error in the last CAN message variable:
-                        frontend.powerDistribution.pdModule[currentPowerDistributionModule].lastEnable.status =
+                        frontend.powerDistribution.lastControl.pdModuleEnable[currentPowerDistributionModule].status =
                             HARDW_BLKD_ERR;
                         return;
                     }
@@ -155,7 +247,8 @@ void pdEnableHandler(int currentPowerDistributionModule, int currentPdModuleModu
 
                     // Store error in the last CAN message variable:
                     // Its not a HARDW_BLKD_ERR just an illegal value so ERROR.
-                    frontend.powerDistribution.pdModule[currentPowerDistributionModule].lastEnable.status = ERROR;
+                    frontend.powerDistribution.lastControl
+                        .pdModuleEnable[currentPowerDistributionModule].status = ERROR;
                     return;
             }
 
@@ -189,68 +282,14 @@ void pdEnableHandler(int currentPowerDistributionModule, int currentPdModuleModu
 #endif /* DEBUG_POWERDIS */
 
             // Update maxPoweredModules depending on the FE mode:
-            switch (frontend.mode) {
-                case TROUBLESHOOTING_MODE:
-                    frontend.powerDistribution.maxPoweredModules = MAX_POWERED_BANDS_TROUBLESHOOTING;
-                    break;
-                default:
-                    frontend.powerDistribution.maxPoweredModules = MAX_POWERED_BANDS_OPERATIONAL;
-                    break;
-            }
+            updateMaxPoweredModules();
 
             // State transitions power-off to any:
             if (cmdStateTransition == ST_CARTRIDGE_OFF__CARTRIDGE_ON ||
                 cmdStateTransition == ST_CARTRIDGE_OFF__STANDBY2) {
-                // Check max number powered on:
-                if (!allowPowerOn(currentPowerDistributionModule, cmdStandby2)) {
-                    // max number of bands powered on:
-                    storeError(ERR_PD_MODULE, ERC_HARDWARE_BLOCKED);
-
-                    // Store error in the last CAN message variable:
-                    frontend.powerDistribution.pdModule[currentPowerDistributionModule].lastEnable.status =
-                        HARDW_BLKD_ERR;
-
-                    return;
-                }
-
-                // Turn on the cartridge:
-                if (setPdModuleEnable(PD_MODULE_ENABLE, currentPowerDistributionModule) == ERROR) {
-                    // Store error in the last CAN message variable:
-                    frontend.powerDistribution.pdModule[currentPowerDistributionModule].lastEnable.status = ERROR;
-
-                    return;
-                }
-
-                // Set the state of the cartridge to CARTRIDGE_ON (powered but not
-                // yet initialized. This state will trigger the initialization by
-                // the cartridge async routine.
-                frontend.cartridge[currentPowerDistributionModule].state = CARTRIDGE_ON;
-
-                // Increse the number of currently turned on cartridges.
-                //  OR STANDBY2 cartridges.
-                // This is done here since the initialization is
-                //  going to be performed asynchronously.
-                // This prevents turning on too many cartridges
-                //  before each initialization is completed.
-                if (cmdStandby2) {
-                    // Set the STANDBY2 state to the cartidge:
-                    frontend.cartridge[currentPowerDistributionModule].standby2 = TRUE;
-
-                    // Increase the number of STANDBY2 cartridges:
-                    frontend.powerDistribution.standby2Modules++;
-
-#ifdef DEBUG_POWERDIS
-                    printPoweredModuleCounts();
-#endif /* DEBUG_POWERDIS */
-
-                } else {
-                    // Increase the number of powered on cartridges:
-                    frontend.powerDistribution.poweredModules++;
-
-#ifdef DEBUG_POWERDIS
-                    printPoweredModuleCounts();
-#endif /* DEBUG_POWERDIS */
-                }
+                // Turn on the cartridge, store any error in the last CAN message variable:
+                frontend.powerDistribution.lastControl.pdModuleEnable[currentPowerDistributionModule].status =
+                    pdModulePowerOn(currentPowerDistributionModule, cmdStandby2);
                 return;
             }
 
@@ -269,7 +308,7 @@ void pdEnableHandler(int currentPowerDistributionModule, int currentPdModuleModu
                         storeError(ERR_PD_MODULE, ERC_HARDWARE_BLOCKED);
 
                         // Store error in the last CAN message variable:
-                        frontend.powerDistribution.pdModule[currentPowerDistributionModule].lastEnable.status =
+                        frontend.powerDistribution.lastControl.pdModuleEnable[currentPowerDistributionModule].status =
                             HARDW_BLKD_ERR;
 
                         return;
@@ -278,11 +317,8 @@ void pdEnableHandler(int currentPowerDistributionModule, int currentPdModuleModu
                     // Clear the STANDBY2 state of the cartidge:
                     frontend.cartridge[currentPowerDistributionModule].standby2 = FALSE;
 
-                    // Decrease the number of STANDBY2 cartridges:
-                    frontend.powerDistribution.standby2Modules--;
-
-                    // Increase the number of powered cartridges:
-                    frontend.powerDistribution.poweredModules++;
+                    // Return the STANDBY2 slot, the powered one was reserved above:
+                    pdModuleRelease(TRUE);
 
 #ifdef DEBUG_POWERDIS
                     printPoweredModuleCounts();
@@ -298,12 +334,12 @@ void pdEnableHandler(int currentPowerDistributionModule, int currentPdModuleModu
                     // after:   on=2, standby2=1  ALLOWED
 
                     // Disallow STANDBY2 if we are at the max allowed:
-                    if (frontend.powerDistribution.standby2Modules >= MAX_STANDBY2_BANDS_OPERATIONAL) {
+                    if (!allowPowerOn(currentPowerDistributionModule, TRUE)) {
                         // max number of bands powered on:
                         storeError(ERR_PD_MODULE, ERC_HARDWARE_BLOCKED);
 
                         // Store error in the last CAN message variable:
-                        frontend.powerDistribution.pdModule[currentPowerDistributionModule].lastEnable.status =
+                        frontend.powerDistribution.lastControl.pdModuleEnable[currentPowerDistributionModule].status =
                             HARDW_BLKD_ERR;
 
                         return;
@@ -311,20 +347,30 @@ void pdEnableHandler(int currentPowerDistributionModule, int currentPdModuleModu
                     // Set the STANDBY2 state of the cartidge:
                     frontend.cartridge[currentPowerDistributionModule].standby2 = TRUE;
 
-                    // Increase the number of STANDBY2 cartridges:
-                    frontend.powerDistribution.standby2Modules++;
+                    // Set the state of the cartridge to CARTRIDGE_GO_STANDBY2
+                    // This state will trigger shutting down cold electronics in
+                    // the cartridge async routine. Only a ready cartridge can
+                    // go to STANDBY2: one still initializing is busy.
+                    if (!cartridgeSetState(currentPowerDistributionModule, CARTRIDGE_READY, CARTRIDGE_GO_STANDBY2)) {
+                        frontend.cartridge[currentPowerDistributionModule].standby2 = FALSE;
+                        pdModuleRelease(TRUE);
+                        storeError(ERR_PD_MODULE, ERC_HARDWARE_WAIT);
+
+                        // Store error in the last CAN message variable:
+                        frontend.powerDistribution.lastControl.pdModuleEnable[currentPowerDistributionModule].status =
+                            HARDW_BLKD_ERR;
+
+                        return;
+                    }
 
-                    // Decrease the number of powered cartridges:
-                    frontend.powerDistribution.poweredModules--;
+                    // Return the powered slot, the STANDBY2 one was reserved above:
+                    pdModuleRelease(FALSE);
 
 #ifdef DEBUG_POWERDIS
                     printPoweredModuleCounts();
 #endif /* DEBUG_POWERDIS */
 
-                    // Set the state of the cartridge to CARTRIDGE_GO_STANDBY2
-                    // This state will trigger shutting down cold electronics in
-                    // the cartridge async routine.
-                    frontend.cartridge[currentPowerDistributionModule].state = CARTRIDGE_GO_STANDBY2;
+                    return;
 
                 default:
                     // illegal state transtition.  Should never happen.
@@ -346,36 +392,28 @@ void pdEnableHandler(int currentPowerDistributionModule, int currentPdModuleModu
             // Cache whether the cartridge was in STANDBY2 mode prior to cartridgeStop()
             cmdStandby2 = frontend.cartridge[currentPowerDistributionModule].standby2;
 
-            // Stop the cartridge.
+            // Stop the cartridge. This returns its slot.
             if (cartridgeStop(currentPowerDistributionModule) == ERROR) {
                 // If an error occurs while stopping
                 //  store the Error state in the last control message variable:
-                frontend.powerDistribution.pdModule[currentPowerDistributionModule].lastEnable.status = ERROR;
+                frontend.powerDistribution.lastControl.pdModuleEnable[currentPowerDistributionModule].status = ERROR;
             }
 
             // Turn off the power distributrion module.
             if (setPdModuleEnable(PD_MODULE_DISABLE, currentPowerDistributionModule) == ERROR) {
                 // If an error occurs while stopping
                 //  store the Error state in the last control message variable:
-                frontend.powerDistribution.pdModule[currentPowerDistributionModule].lastEnable.status = ERROR;
+                frontend.powerDistribution.lastControl.pdModuleEnable[currentPowerDistributionModule].status = ERROR;
 
                 /* Set the state of the cartridge to 'error'. If this occurs then
                    the knowledge of the state of the hardware is compromised and
                    the only allowed action should be to try again to turn off the
-                   cartridge. */
-                frontend.cartridge[currentPowerDistributionModule].state = CARTRIDGE_ERROR;
+                   cartridge. The cartridge takes its slot back until then. */
+                cartridgeFault(currentPowerDistributionModule, cmdStandby2);
 
                 return;
             }
 
-            // Decrement the counter of currently turned on cartridges.
-            if (cmdStandby2) {
-                frontend.powerDistribution.standby2Modules--;
-
-            } else {
-                frontend.powerDistribution.poweredModules--;
-            }
-
 #ifdef DEBUG_POWERDIS
             printPoweredModuleCounts();
 #endif /* DEBUG_POWERDIS */
@@ -386,7 +424,8 @@ void pdEnableHandler(int currentPowerDistributionModule, int currentPdModuleModu
     /* If it's a monitor message on a control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.powerDistribution.pdModule[currentPowerDistributionModule].lastEnable)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.powerDistribution.lastControl
+                                        .pdModuleEnable[currentPowerDistributionModule])
         return;
     }
 
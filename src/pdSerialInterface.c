@@ -20,6 +20,7 @@
 /* Includes */
 #include "pdSerialInterface.h"
 
+#include <pthread.h>
 #include <stdio.h> /* printf */
 #include <time.h>
 #include <unistd.h>
@@ -32,6 +33,14 @@
 
 PD_REGISTERS pdRegisters;
 
+/* The CAN handlers and the background sweep share the registers: a monitor
+   sequence or an AREG update is performed with the lock held. */
+static pthread_mutex_t pdRegistersLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Time (ms) of the last complete read of the channels of each module. 0 if
+   the readings are not valid. */
+static double pdChannelsTime[PD_MODULES_NUMBER];
+
 /* Power distribution analog monitor request core.
    This function performs the core operations that are common to all the analog
    monitor request for the power distribution module:
@@ -160,7 +169,10 @@ int setPdModuleEnable(unsigned char enable, int currentPowerDistributionModule)
        a temporary variable so that if any error occurs during the update of
        the hardware state, we don't end up with an AREG describing a different
        state than the hardware one. */
-    int tempAReg = pdRegisters.aReg;
+    int tempAReg;
+
+    pthread_mutex_lock(&pdRegistersLock);
+    tempAReg = pdRegisters.aReg;
 
     if (frontend.mode != SIMULATION_MODE) {
         /* Update AREG */
@@ -177,6 +189,7 @@ int setPdModuleEnable(unsigned char enable, int currentPowerDistributionModule)
                          PD_AREG_SHIFT_DIR, SERIAL_WRITE, POWER_DIST_MODULE, 0) == ERROR) {
             /* Restore AREG to its original saved value */
             pdRegisters.aReg = tempAReg;
+            pthread_mutex_unlock(&pdRegistersLock);
 
             return ERROR;
         }
@@ -187,25 +200,15 @@ int setPdModuleEnable(unsigned char enable, int currentPowerDistributionModule)
     frontend.powerDistribution.pdModule[currentPowerDistributionModule].enable =
         (enable == PD_MODULE_ENABLE) ? PD_MODULE_ENABLE : PD_MODULE_DISABLE;
 
+    /* The channels readings belong to the previous state */
+    pdChannelsTime[currentPowerDistributionModule] = 0.0;
+    pthread_mutex_unlock(&pdRegistersLock);
+
     return NO_ERROR;
 }
 
-/* Get Power Distribution Channel */
-/*! This function monitors the voltage and current of the currently selected
-    power distribution channel.
-
-    This function will perform the following operations:
-        -# Set the desired monitor point by:
-            - updating BREG
-        -# Execute the core get functions common to all the analog monitor
-           requests for the power distribution module.
-        -# Scale the raw binary data with the correct unit and store the results
-           in the \ref frontend variable.
-
-    \return
-        - \ref NO_ERROR -> if no error occurred
-        - \ref ERROR    -> if something wrong happened */
-int getPdChannel(int currentPowerDistributionModule, int currentPdModuleModule, int currentPdChannelModule) {
+/* Read one channel with the registers lock held */
+static int readPdChannel(int currentPowerDistributionModule, int currentPdModuleModule, int currentPdChannelModule) {
     /* A float to hold the scaling factor */
     float scale = 0.0;
 
@@ -325,3 +328,94 @@ int getPdChannel(int currentPowerDistributionModule, int currentPdModuleModule,
     }
     return NO_ERROR;
 }
+
+/* Get Power Distribution Channel */
+/*! This function monitors the voltage and current of the currently selected
+    power distribution channel.
+
+    This function will perform the following operations:
+        -# Set the desired monitor point by:
+            - updating BREG
+        -# Execute the core get functions common to all the analog monitor
+           requests for the power distribution module.
+        -# Scale the raw binary data with the correct unit and store the results
+           in the \ref frontend variable.
+
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int getPdChannel(int currentPowerDistributionModule, int currentPdModuleModule, int currentPdChannelModule) {
+    int ret;
+
+    pthread_mutex_lock(&pdRegistersLock);
+    ret = readPdChannel(currentPowerDistributionModule, currentPdModuleModule, currentPdChannelModule);
+    pthread_mutex_unlock(&pdRegistersLock);
+
+    return ret;
+}
+
+/* Current time for the channels readings in ms */
+static double pdChannelsNow(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+/* Get all the Power Distribution Channels of a module */
+/*! This function monitors the voltage and current of all the channels of the
+    selected power distribution module in one pass, holding the registers for
+    the whole pass so that no CAN monitor request is interleaved. The readings
+    are stored in the \ref frontend variable and timestamped for
+    \ref pdChannelsCached.
+
+    \param currentPowerDistributionModule  This is the module to monitor.
+
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened. The readings of the
+                           module are marked as not valid. */
+int getPdChannels(int currentPowerDistributionModule) {
+    int currentPdModuleModule, currentPdChannelModule;
+
+    pthread_mutex_lock(&pdRegistersLock);
+    for (currentPdModuleModule = 0; currentPdModuleModule < PD_CHANNELS_NUMBER; currentPdModuleModule++) {
+        for (currentPdChannelModule = 0; currentPdChannelModule < PD_CHANNEL_MODULES_NUMBER;
+             currentPdChannelModule++) {
+            if (readPdChannel(currentPowerDistributionModule, currentPdModuleModule, currentPdChannelModule) ==
+                ERROR) {
+                pdChannelsTime[currentPowerDistributionModule] = 0.0;
+                pthread_mutex_unlock(&pdRegistersLock);
+
+                return ERROR;
+            }
+        }
+    }
+    pdChannelsTime[currentPowerDistributionModule] = pdChannelsNow();
+    pthread_mutex_unlock(&pdRegistersLock);
+
+    return NO_ERROR;
+}
+
+/* Power Distribution Channels cached */
+/*! This function tells if the channels readings of the selected module stored
+    in the \ref frontend variable by \ref getPdChannels can be returned
+    without monitoring the hardware again.
+
+    \param currentPowerDistributionModule  This is the module to check.
+
+    \return
+        - \ref TRUE     -> if the module is enabled and the readings are not
+                           older than \ref PD_CHANNELS_CACHE_AGE
+        - \ref FALSE    -> otherwise */
+int pdChannelsCached(int currentPowerDistributionModule) {
+    int cached;
+
+    pthread_mutex_lock(&pdRegistersLock);
+    cached = (frontend.powerDistribution.pdModule[currentPowerDistributionModule].enable == PD_MODULE_ENABLE) &&
+             (pdChannelsTime[currentPowerDistributionModule] != 0.0) &&
+             (pdChannelsNow() - pdChannelsTime[currentPowerDistributionModule] <= PD_CHANNELS_CACHE_AGE);
+    pthread_mutex_unlock(&pdRegistersLock);
+
+    return cached;
+}
@@ -92,7 +92,7 @@ void conversionCoeffHandler(void) {
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.lpr.edfa.photoDetector.lastCoeff)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.lpr.lastControl.photoDetectorCoeff)
 
         /* Extract the float from the can message. */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -105,7 +105,7 @@ void conversionCoeffHandler(void) {
     /* If monitor on a control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.lpr.edfa.photoDetector.lastCoeff)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.lpr.lastControl.photoDetectorCoeff)
         return;
     }
 
@@ -53,13 +53,13 @@ void pmxEnableHandler(int currentModule) {
     /* Check direction and perform the required operation */
     if (CAN_SIZE) {  // If control (size !=0)
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.photomixer.lastEnable)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.photomixerEnable)
 
         /* Change the status of the photomixer according to the content of the
            CAN message. */
         if (setPhotomixerEnable(CAN_BYTE ? PHOTOMIXER_ENABLE : PHOTOMIXER_DISABLE, currentModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].lo.photomixer.lastEnable.status = ERROR;
+            frontend.cartridge[currentModule].lastControl.photomixerEnable.status = ERROR;
 
             return;
         }
@@ -71,7 +71,7 @@ void pmxEnableHandler(int currentModule) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.photomixer.lastEnable)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.photomixerEnable)
         return;
     }
 
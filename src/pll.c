@@ -7,8 +7,11 @@
     This file contains all the functions necessary to handle the PLL events. */
 
 /* Includes */
-#include <stdio.h>  /* printf */
-#include <string.h> /* memcpy */
+#include <math.h>    /* fabsf */
+#include <pthread.h> /* pthread_mutex_t */
+#include <stdio.h>   /* printf */
+#include <string.h>  /* memcpy */
+#include <time.h>    /* clock_gettime */
 
 #include "debug.h"
 #include "error_local.h"
@@ -29,6 +32,27 @@ static HANDLER_INT pllModulesHandler[PLL_MODULES_NUMBER] = {lockDetectVoltageHan
                                                             sidebandLockPolaritySelectHandler,
                                                             nullLoopIntegratorHandler};
 
+/* Lock search. It is started by the CAN thread and executed by the cartridge
+   async thread. */
+static pthread_mutex_t pllLockSearchLock = PTHREAD_MUTEX_INITIALIZER;
+static struct {
+    unsigned char state;   // See PLL_LOCK_SEARCH_xxx
+    unsigned char phase;   // Step being executed, see the async function
+    int module;            // The band being locked
+    int center;            // YTO coarse tune around which the lock is searched
+    int span;              // Max distance (counts) from the center
+    int step;              // Distance (counts) between the tried tunings
+    int candidate;         // Index of the tried tuning: center, +1, -1, +2, -2...
+    int yto;               // Current YTO coarse tune
+    int restoreYto;        // YTO coarse tune before the search
+    int steps;             // Number of YTO tunings issued
+    int refine;            // Number of centering steps
+    float tolerance;       // Correction voltage tolerance (V)
+    double settle;         // Settle time after each tuning (ms)
+    double deadline;       // End of the current settle time (ms)
+    signed char status;    // Final status, NO_ERROR or one of the HARDW_xxx codes
+} pllLockSearch;
+
 /* PLL handler */
 /*! This function will be called by the CAN message handler when the received
     message is pertinent to the PLL. */
@@ -368,13 +392,13 @@ void clearUnlockDetectLatchHandler(int currentModule) {
     /* Check direction and perform the required operation */
     if (CAN_SIZE) {  // If control (size !=0)
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pll.lastClearUnlockDetectLatch)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.pllClearUnlockDetectLatch)
 
         /* Change the status of the PLL unlock detect latch according to the
            content of the CAN message. */
         if (setClearUnlockDetectLatch(currentModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].lo.pll.lastClearUnlockDetectLatch.status = ERROR;
+            frontend.cartridge[currentModule].lastControl.pllClearUnlockDetectLatch.status = ERROR;
 
             return;
         }
@@ -386,7 +410,7 @@ void clearUnlockDetectLatchHandler(int currentModule) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pll.lastClearUnlockDetectLatch)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.pllClearUnlockDetectLatch)
         return;
     }
 
@@ -407,13 +431,13 @@ void loopBandwidthSelectHandler(int currentModule) {
     /* Check direction and perform the required operation */
     if (CAN_SIZE) {  // If control (size !=0)
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pll.lastLoopBandwidthSelect)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.pllLoopBandwidthSelect)
 
         /* Change the status of the PLL loop BW according to the content of the CAN message. */
         if (setLoopBandwidthSelect(CAN_BYTE ? PLL_LOOP_BANDWIDTH_ALTERNATE : PLL_LOOP_BANDWIDTH_DEFAULT,
                                    currentModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].lo.pll.lastLoopBandwidthSelect.status = ERROR;
+            frontend.cartridge[currentModule].lastControl.pllLoopBandwidthSelect.status = ERROR;
 
             return;
         }
@@ -425,7 +449,7 @@ void loopBandwidthSelectHandler(int currentModule) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pll.lastLoopBandwidthSelect)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.pllLoopBandwidthSelect)
         return;
     }
 
@@ -449,14 +473,14 @@ void sidebandLockPolaritySelectHandler(int currentModule) {
     /* Check direction and perform the required operation */
     if (CAN_SIZE) {  // If control (size !=0)
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pll.lastSidebandLockPolaritySelect)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.pllSidebandLockPolaritySelect)
 
         /* Change the status of the PLL unlock detect latch according to the
            content of the CAN message. */
         if (setSidebandLockPolaritySelect(CAN_BYTE ? PLL_SIDEBAND_LOCK_POLARITY_USB : PLL_SIDEBAND_LOCK_POLARITY_LSB,
                                           currentModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].lo.pll.lastSidebandLockPolaritySelect.status = ERROR;
+            frontend.cartridge[currentModule].lastControl.pllSidebandLockPolaritySelect.status = ERROR;
 
             return;
         }
@@ -468,7 +492,7 @@ void sidebandLockPolaritySelectHandler(int currentModule) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pll.lastSidebandLockPolaritySelect)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.pllSidebandLockPolaritySelect)
         return;
     }
 
@@ -492,14 +516,14 @@ void nullLoopIntegratorHandler(int currentModule) {
     /* Check direction and perform the required operation */
     if (CAN_SIZE) {  // If control (size !=0)
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pll.lastNullLoopIntegrator)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.pllNullLoopIntegrator)
 
         /* Change the status of the PLL unlock detect latch according to the
            content of the CAN message. */
         if (setNullLoopIntegrator(CAN_BYTE ? PLL_NULL_LOOP_INTEGRATOR_NULL : PLL_NULL_LOOP_INTEGRATOR_OPERATE,
                                   currentModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].lo.pll.lastNullLoopIntegrator.status = ERROR;
+            frontend.cartridge[currentModule].lastControl.pllNullLoopIntegrator.status = ERROR;
 
             return;
         }
@@ -511,7 +535,7 @@ void nullLoopIntegratorHandler(int currentModule) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pll.lastNullLoopIntegrator)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.pllNullLoopIntegrator)
         return;
     }
 
@@ -523,3 +547,323 @@ void nullLoopIntegratorHandler(int currentModule) {
     CAN_BYTE = frontend.cartridge[currentModule].lo.pll.nullLoopIntegrator;
     CAN_SIZE = CAN_BOOLEAN_SIZE;
 }
+
+/* Current time for the lock search in ms */
+static double pllLockSearchTime(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+/* Tune the YTO as the coarse tune handler does: the LO PA drain voltages are
+   limited to the max safe level table first, unless in troubleshooting
+   mode. The values are passed to the setters directly: the conversion buffer
+   belongs to the message loop. */
+static int pllLockSearchTuneYto(int currentModule, int yto) {
+    int ret = NO_ERROR;
+
+    if (frontend.mode != TROUBLESHOOTING_MODE) {
+        ret = limitSafeYtoTuning(yto, currentModule);
+    }
+    if (ret == ERROR) {
+        return ERROR;
+    }
+    if (ret == HARDW_BLKD_ERR) {
+        storeError(ERR_YTO, ERC_HARDWARE_BLOCKED);  // LO PA drain voltages were limited before YTO tuning
+    }
+
+    if (setYtoCoarseTune(yto, currentModule) == ERROR) {
+        frontend.cartridge[currentModule].lastControl.ytoCoarseTune.status = ERROR;
+        return ERROR;
+    }
+
+    /* Update the last control message as if the tuning was received on the
+       standard RCA. */
+    frontend.cartridge[currentModule].lastControl.ytoCoarseTune.size = CAN_INT_SIZE;
+    frontend.cartridge[currentModule].lastControl.ytoCoarseTune.data[0] = (unsigned char)(yto >> 8);
+    frontend.cartridge[currentModule].lastControl.ytoCoarseTune.data[1] = (unsigned char)yto;
+    frontend.cartridge[currentModule].lastControl.ytoCoarseTune.status = ret;
+    pllLockSearch.yto = yto;
+    pllLockSearch.steps++;
+
+    return NO_ERROR;
+}
+
+/* YTO coarse tune of the next candidate of the sweep. The candidates are
+   tried moving away from the center on alternate sides. Returns ERROR when
+   the sweep is exhausted. Called with the lock held. */
+static int pllLockSearchNextCandidate(int *yto) {
+    int offset;
+
+    for (;;) {
+        pllLockSearch.candidate++;
+        offset = ((pllLockSearch.candidate + 1) / 2) * pllLockSearch.step;
+        if (offset > pllLockSearch.span) {
+            return ERROR;
+        }
+        *yto = pllLockSearch.center + ((pllLockSearch.candidate & 1) ? offset : -offset);
+        if (!checkRange(YTO_COARSE_SET_MIN, *yto, YTO_COARSE_SET_MAX)) {
+            return NO_ERROR;
+        }
+    }
+}
+
+/* Terminate the lock search. Called with the lock held. */
+static void pllLockSearchEnd(unsigned char state, int status) {
+    int currentModule = pllLockSearch.module;
+
+    /* If no lock was obtained, return to the original tuning with the loop
+       integrator operating. */
+    if (state != PLL_LOCK_SEARCH_LOCKED && pllLockSearch.yto != pllLockSearch.restoreYto) {
+        if (pllLockSearchTuneYto(currentModule, pllLockSearch.restoreYto) == ERROR) {
+            status = ERROR;
+        }
+    }
+    if (frontend.cartridge[currentModule].lo.pll.nullLoopIntegrator != PLL_NULL_LOOP_INTEGRATOR_OPERATE) {
+        setNullLoopIntegrator(PLL_NULL_LOOP_INTEGRATOR_OPERATE, currentModule);
+    }
+
+    pllLockSearch.state = state;
+    pllLockSearch.status = status;
+
+#ifdef DEBUG
+    printf(" PLL lock search band %d: state=%d status=%d yto=%d after %d steps\n", currentModule + 1, state, status,
+           pllLockSearch.yto, pllLockSearch.steps);
+#endif /* DEBUG */
+}
+
+/* Start a PLL lock search */
+/*! This function validates a lock search request and hands it over to
+    \ref pllLockSearchAsync. The request is a full 8 bytes payload:
+        - bytes 0-1: YTO coarse tune around which to search (big endian)
+        - bytes 2-3: max distance (counts) from the center (big endian)
+        - byte 4: distance (counts) between the tried tunings, at least 1
+        - byte 5: settle time (ms) after each tuning, 0 for the default
+        - byte 6: correction voltage tolerance (0.1 V), 0 for the default
+        - byte 7: reserved, must be 0
+    \param currentModule   The band whose PLL has to be locked
+    \param data            The request payload
+    \param size            The request size
+    \return
+        - \ref NO_ERROR -> if the lock search was started
+        - \ref ERROR    -> if the request was refused */
+int pllLockSearchStart(int currentModule, const unsigned char *data, unsigned char size) {
+    int center, span;
+
+    /* The lock search drives the hardware, block it in maintenance mode as
+       for the standard control RCAs. */
+    if (frontend.mode == MAINTENANCE_MODE) {
+        storeError(ERR_CAN, ERC_MAINT_MODE);  // Front End in maintenance mode
+        return ERROR;
+    }
+
+    if (frontend.cartridge[currentModule].available == UNAVAILABLE) {
+        storeError(ERR_PLL, ERC_MODULE_ABSENT);  // Cartridge not installed
+        return ERROR;
+    }
+
+    if (frontend.cartridge[currentModule].state != CARTRIDGE_READY) {
+        storeError(ERR_PLL, ERC_MODULE_POWER);  // Cartridge not ready
+        return ERROR;
+    }
+
+    center = (data[0] << 8) | data[1];
+    span = (data[2] << 8) | data[3];
+    if (size != CAN_FULL_SIZE || data[4] == 0 || data[7] != 0 ||
+        checkRange(YTO_COARSE_SET_MIN, center, YTO_COARSE_SET_MAX)) {
+        storeError(ERR_PLL, ERC_COMMAND_VAL);  // Malformed lock search request
+        return ERROR;
+    }
+
+    pthread_mutex_lock(&pllLockSearchLock);
+    if (pllLockSearch.state == PLL_LOCK_SEARCH_RUNNING) {
+        pthread_mutex_unlock(&pllLockSearchLock);
+        storeError(ERR_PLL, ERC_HARDWARE_WAIT);  // Lock search already in progress
+        return ERROR;
+    }
+
+    pllLockSearch.module = currentModule;
+    pllLockSearch.center = center;
+    pllLockSearch.span = span;
+    pllLockSearch.step = data[4];
+    pllLockSearch.settle = data[5] ? data[5] : PLL_LOCK_SEARCH_SETTLE_DFLT;
+    pllLockSearch.tolerance = data[6] ? data[6] * PLL_LOCK_SEARCH_TOLERANCE_SCALE : PLL_LOCK_SEARCH_TOLERANCE_DFLT;
+    pllLockSearch.candidate = 0;
+    pllLockSearch.yto = frontend.cartridge[currentModule].lo.yto.ytoCoarseTune;
+    pllLockSearch.restoreYto = pllLockSearch.yto;
+    pllLockSearch.steps = 0;
+    pllLockSearch.refine = 0;
+    pllLockSearch.status = NO_ERROR;
+    pllLockSearch.phase = 0;
+    pllLockSearch.state = PLL_LOCK_SEARCH_RUNNING;
+    pthread_mutex_unlock(&pllLockSearchLock);
+
+    return NO_ERROR;
+}
+
+/* Cancel the PLL lock search of a band */
+/*! This function stops the lock search of the band without restoring the YTO
+    tuning. It is called before a direct YTO coarse tune so that the command
+    isn't overwritten by the search. */
+void pllLockSearchCancel(int currentModule) {
+    pthread_mutex_lock(&pllLockSearchLock);
+    if (pllLockSearch.state == PLL_LOCK_SEARCH_RUNNING && pllLockSearch.module == currentModule) {
+        pllLockSearch.restoreYto = pllLockSearch.yto;
+        pllLockSearchEnd(PLL_LOCK_SEARCH_ABORTED, HARDW_BLKD_ERR);
+    }
+    pthread_mutex_unlock(&pllLockSearchLock);
+}
+
+/* Abort the PLL lock search */
+/*! This function aborts the running lock search and restores the YTO tuning
+    found before the search started. */
+void pllLockSearchAbort(void) {
+    pthread_mutex_lock(&pllLockSearchLock);
+    if (pllLockSearch.state == PLL_LOCK_SEARCH_RUNNING) {
+        pllLockSearchEnd(PLL_LOCK_SEARCH_ABORTED, NO_ERROR);
+    }
+    pthread_mutex_unlock(&pllLockSearchLock);
+}
+
+/* PLL lock search async */
+/*! This function executes one step of the lock search. It is called by the
+    cartridge async thread and never waits: the settle time after each tuning
+    is checked on the next call.
+
+    The search has two phases:
+        - sweep: for each candidate tuning, starting from the center and
+          moving away on alternate sides, the loop integrator is nulled, the
+          YTO is tuned and the integrator is released. After the settle time
+          the lock detect voltage is checked.
+        - centering: once locked, the YTO is moved one count at a time in the
+          direction of the correction voltage until it is within tolerance.
+          If the lock is lost the sweep resumes from the next candidate.
+
+    If no lock is found, the YTO tuning found before the search is
+    restored. */
+void pllLockSearchAsync(void) {
+    enum { PLL_LOCK_SEARCH_TUNE, PLL_LOCK_SEARCH_SETTLE, PLL_LOCK_SEARCH_CENTER };
+    int currentModule, yto;
+    PLL *pll;
+
+    pthread_mutex_lock(&pllLockSearchLock);
+    if (pllLockSearch.state != PLL_LOCK_SEARCH_RUNNING) {
+        pthread_mutex_unlock(&pllLockSearchLock);
+        return;
+    }
+
+    currentModule = pllLockSearch.module;
+    pll = &frontend.cartridge[currentModule].lo.pll;
+
+    /* The cartridge could have been turned off in the meantime */
+    if (frontend.cartridge[currentModule].state != CARTRIDGE_READY) {
+        storeError(ERR_PLL, ERC_MODULE_POWER);  // Cartridge not ready
+        pllLockSearch.state = PLL_LOCK_SEARCH_FAILED;
+        pllLockSearch.status = HARDW_BLKD_ERR;
+        pthread_mutex_unlock(&pllLockSearchLock);
+        return;
+    }
+
+    switch (pllLockSearch.phase) {
+        case PLL_LOCK_SEARCH_TUNE:
+            /* Try the next candidate with the integrator nulled */
+            yto = pllLockSearch.center;
+            if (pllLockSearch.steps != 0 && pllLockSearchNextCandidate(&yto) == ERROR) {
+                storeError(ERR_PLL, ERC_HARDWARE_ERROR);  // No lock found
+                pllLockSearchEnd(PLL_LOCK_SEARCH_FAILED, HARDW_ERROR);
+                break;
+            }
+            if (setNullLoopIntegrator(PLL_NULL_LOOP_INTEGRATOR_NULL, currentModule) == ERROR ||
+                pllLockSearchTuneYto(currentModule, yto) == ERROR ||
+                setNullLoopIntegrator(PLL_NULL_LOOP_INTEGRATOR_OPERATE, currentModule) == ERROR) {
+                pllLockSearchEnd(PLL_LOCK_SEARCH_FAILED, ERROR);
+                break;
+            }
+            pllLockSearch.deadline = pllLockSearchTime() + pllLockSearch.settle;
+            pllLockSearch.phase = PLL_LOCK_SEARCH_SETTLE;
+            break;
+
+        case PLL_LOCK_SEARCH_SETTLE:
+        case PLL_LOCK_SEARCH_CENTER:
+            if (pllLockSearchTime() < pllLockSearch.deadline) {
+                break;
+            }
+            if (getPll(PLL_LOCK_DETECT_VOLTAGE, currentModule) == ERROR ||
+                getPll(PLL_CORRECTION_VOLTAGE, currentModule) == ERROR) {
+                pllLockSearchEnd(PLL_LOCK_SEARCH_FAILED, ERROR);
+                break;
+            }
+
+            /* Not locked: move on to the next candidate */
+            if (pll->lockDetectVoltage < PLL_LOCK_SEARCH_LOCK_V) {
+                pllLockSearch.phase = PLL_LOCK_SEARCH_TUNE;
+                break;
+            }
+
+            /* Locked and centered: clear the latched unlock so that the
+               latch reflects the new lock. */
+            if (fabsf(pll->correctionVoltage) <= pllLockSearch.tolerance) {
+                if (setClearUnlockDetectLatch(currentModule) == ERROR || getPllStates(currentModule) == ERROR) {
+                    pllLockSearchEnd(PLL_LOCK_SEARCH_LOCKED, ERROR);
+                    break;
+                }
+                pllLockSearchEnd(PLL_LOCK_SEARCH_LOCKED, NO_ERROR);
+                break;
+            }
+
+            /* Locked but not centered: a positive correction voltage means
+               the YTO is tuned low. Give up centering, still locked, after
+               too many steps or at the end of the tuning range. */
+            yto = pllLockSearch.yto + ((pll->correctionVoltage > 0.0) ? 1 : -1);
+            if (pllLockSearch.refine >= PLL_LOCK_SEARCH_MAX_REFINE ||
+                checkRange(YTO_COARSE_SET_MIN, yto, YTO_COARSE_SET_MAX)) {
+                storeError(ERR_PLL, ERC_HARDWARE_ERROR);  // Correction voltage could not be centered
+                pllLockSearchEnd(PLL_LOCK_SEARCH_LOCKED, HARDW_RNG_ERR);
+                break;
+            }
+            if (pllLockSearchTuneYto(currentModule, yto) == ERROR) {
+                pllLockSearchEnd(PLL_LOCK_SEARCH_FAILED, ERROR);
+                break;
+            }
+            pllLockSearch.refine++;
+            pllLockSearch.deadline = pllLockSearchTime() + pllLockSearch.settle;
+            pllLockSearch.phase = PLL_LOCK_SEARCH_CENTER;
+            break;
+
+        default:
+            break;
+    }
+    pthread_mutex_unlock(&pllLockSearchLock);
+}
+
+/* PLL lock search status */
+/*! This function returns the state of the last lock search:
+        - byte 0: state, see PLL_LOCK_SEARCH_xxx
+        - byte 1: band (0-9)
+        - bytes 2-3: current YTO coarse tune (big endian)
+        - byte 4: last lock detect voltage (0.1 V, unsigned)
+        - byte 5: last correction voltage (0.1 V, signed)
+        - byte 6: number of YTO tunings issued (saturated at 255)
+        - byte 7: final status: NO_ERROR, HARDW_RNG_ERR if locked but not
+          centered, HARDW_BLKD_ERR if superseded, ERROR or HARDW_ERROR
+    \param data    The 8 bytes buffer to fill */
+void pllLockSearchStatus(unsigned char *data) {
+    PLL *pll;
+    float lockDetect, correction;
+
+    pthread_mutex_lock(&pllLockSearchLock);
+    pll = &frontend.cartridge[pllLockSearch.module].lo.pll;
+    lockDetect = pll->lockDetectVoltage * PLL_LOCK_SEARCH_V_SCALE;
+    correction = pll->correctionVoltage * PLL_LOCK_SEARCH_V_SCALE;
+
+    data[0] = pllLockSearch.state;
+    data[1] = (unsigned char)pllLockSearch.module;
+    data[2] = (unsigned char)(pllLockSearch.yto >> 8);
+    data[3] = (unsigned char)pllLockSearch.yto;
+    data[4] = (unsigned char)((lockDetect > 255.0) ? 255.0 : (lockDetect < 0.0) ? 0.0 : lockDetect);
+    data[5] = (unsigned char)(signed char)((correction > 127.0) ? 127.0 : (correction < -128.0) ? -128.0 : correction);
+    data[6] = (unsigned char)((pllLockSearch.steps > 255) ? 255 : pllLockSearch.steps);
+    data[7] = (unsigned char)pllLockSearch.status;
+    pthread_mutex_unlock(&pllLockSearchLock);
+}
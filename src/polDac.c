@@ -55,18 +55,14 @@ void polDacResetStrobeHandler(int currentModule, int currentBiasModule, int curr
     if (CAN_SIZE) {  // If control (size !=0)
         // save the incoming message:
         SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                      .polarization[currentBiasModule]
-                                      .polSpecialMsgs.polDac[currentPolSpecialMsgsModule]
-                                      .lastResetStrobe)
+                                      .lastControl.polDacResetStrobe[currentBiasModule][currentPolSpecialMsgsModule])
 
         /* Send the strobe */
         if (setBiasDacStrobe(currentModule, currentBiasModule, currentPolarizationModule, currentPolSpecialMsgsModule,
                              currentPolDacModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
             frontend.cartridge[currentModule]
-                .polarization[currentBiasModule]
-                .polSpecialMsgs.polDac[currentPolSpecialMsgsModule]
-                .lastResetStrobe.status = ERROR;
+                .lastControl.polDacResetStrobe[currentBiasModule][currentPolSpecialMsgsModule].status = ERROR;
 
             return;
         }
@@ -76,9 +72,7 @@ void polDacResetStrobeHandler(int currentModule, int currentBiasModule, int curr
     if (currentClass == CONTROL_CLASS) {  // If monitor on a control RCA
         // return the last control message and status
         RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                        .polarization[currentBiasModule]
-                                        .polSpecialMsgs.polDac[currentPolSpecialMsgsModule]
-                                        .lastResetStrobe)
+                                        .lastControl.polDacResetStrobe[currentBiasModule][currentPolSpecialMsgsModule])
         return;
     }
 
@@ -109,18 +103,14 @@ void polDacClearStrobeHandler(int currentModule, int currentBiasModule, int curr
     if (CAN_SIZE) {  // If control (size !=0)
         // save the incoming message:
         SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                      .polarization[currentBiasModule]
-                                      .polSpecialMsgs.polDac[currentPolSpecialMsgsModule]
-                                      .lastClearStrobe)
+                                      .lastControl.polDacClearStrobe[currentBiasModule][currentPolSpecialMsgsModule])
 
         /* Send the strobe */
         if (setBiasDacStrobe(currentModule, currentBiasModule, currentPolarizationModule, currentPolSpecialMsgsModule,
                              currentPolDacModule) == ERROR) {
             /* Store the ERROR state in the last control message variable. */
             frontend.cartridge[currentModule]
-                .polarization[currentBiasModule]
-                .polSpecialMsgs.polDac[currentPolSpecialMsgsModule]
-                .lastClearStrobe.status = ERROR;
+                .lastControl.polDacClearStrobe[currentBiasModule][currentPolSpecialMsgsModule].status = ERROR;
 
             return;
         }
@@ -130,9 +120,7 @@ void polDacClearStrobeHandler(int currentModule, int currentBiasModule, int curr
     if (currentClass == CONTROL_CLASS) {  // If monitor on a control RCA
         // return the last control message and status
         RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                        .polarization[currentBiasModule]
-                                        .polSpecialMsgs.polDac[currentPolSpecialMsgsModule]
-                                        .lastClearStrobe)
+                                        .lastControl.polDacClearStrobe[currentBiasModule][currentPolSpecialMsgsModule])
     }
 
     /* If monitor on monitor RCA: this should never happen because there are
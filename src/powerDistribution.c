@@ -8,11 +8,14 @@
     events. */
 
 /* Includes */
-#include <stdio.h> /* printf */
+#include <pthread.h> /* pthread_mutex_t */
+#include <stdio.h>   /* printf */
+#include <time.h>    /* clock_gettime */
 
 #include "debug.h"
 #include "error_local.h"
 #include "frontend.h"
+#include "ifSerialInterface.h"
 #include "pdSerialInterface.h"
 
 /* Statics */
@@ -20,6 +23,25 @@ static HANDLER_INT powerDistributionModulesHandler[POWER_DISTRIBUTION_MODULES_NU
     pdModuleHandler, pdModuleHandler, pdModuleHandler, pdModuleHandler, pdModuleHandler,      pdModuleHandler,
     pdModuleHandler, pdModuleHandler, pdModuleHandler, pdModuleHandler, poweredModulesHandler};
 
+/* Band select transaction. It is started by the CAN thread and completed by
+   the cartridge async thread. */
+static pthread_mutex_t bandSelectLock = PTHREAD_MUTEX_INITIALIZER;
+static struct {
+    unsigned char state;  // See BAND_SELECT_xxx
+    unsigned char band;   // The band being selected
+    unsigned char steps;  // Completed steps, see BAND_SELECT_STEP_xxx
+    signed char status;   // Failure status, NO_ERROR or one of the HARDW_xxx codes
+    double start;         // Start time (ms)
+    double elapsed;       // Time taken by the transaction (ms)
+} bandSelect;
+
+/* Background sweep of the power distribution channels. Only used by the
+   cartridge async thread. */
+static struct {
+    int module;    // Next module to read in the current cycle
+    double start;  // Start time (ms) of the current cycle
+} pdSweep;
+
 /* Power distribution handler */
 /*! This function will be called by the CAN message handler when the received
     message is pertinent to the power distribution. */
@@ -135,3 +157,234 @@ int powerDistributionStop(void) {
 
     return NO_ERROR;
 }
+
+/* Current time for the band select and the channels sweep in ms */
+static double powerDistributionTime(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+/* Store a band select step in a last control message, as if it was received
+   on the standard RCA. */
+static void bandSelectLastControl(LAST_CONTROL_MESSAGE *last, unsigned char value, int status) {
+    last->size = CAN_BYTE_SIZE;
+    last->data[0] = value;
+    last->status = status;
+}
+
+/* Terminate the band select. Called with the lock held. */
+static void bandSelectEnd(unsigned char state, int status) {
+    bandSelect.state = state;
+    bandSelect.status = status;
+    bandSelect.elapsed = powerDistributionTime() - bandSelect.start;
+
+#ifdef DEBUG_POWERDIS
+    printf(" Band select %d: state=%d steps=0x%02X status=%d in %.0f ms\n", bandSelect.band + 1, state,
+           bandSelect.steps, status, bandSelect.elapsed);
+#endif /* DEBUG_POWERDIS */
+}
+
+/* Start a band select */
+/*! This function switches the front end to the selected band in a single
+    request. It replaces the client side sequence of powering the band,
+    waiting for the cartridge to be ready and then moving the LPR optical
+    switch and the IF switch.
+
+    The steps that don't depend on each other are overlapped: the band is
+    powered, the IF switch is set and the optical switch move is queued right
+    away, then \ref bandSelectAsync waits for the optical switch to settle
+    while the cartridge initialization proceeds. The progress is returned by
+    \ref bandSelectStatus.
+
+    A band already powered is not power cycled. A band in STANDBY2 has to be
+    brought to the powered state with the standard enable RCA first. Other
+    powered bands are left untouched, so the limit on the number of powered
+    bands applies.
+    \param band    The band to select (\ref BAND1 through \ref BAND10)
+    \return
+        - \ref NO_ERROR -> if the band select was started
+        - \ref ERROR    -> if the request was refused or a step failed */
+int bandSelectStart(int band) {
+    int status;
+
+    /* The band select drives the hardware, block it in maintenance mode as
+       for the standard control RCAs. */
+    if (frontend.mode == MAINTENANCE_MODE) {
+        storeError(ERR_CAN, ERC_MAINT_MODE);  // Front End in maintenance mode
+        return ERROR;
+    }
+
+    if (frontend.cartridge[band].available == UNAVAILABLE) {
+        storeError(ERR_POWER_DISTRIBUTION, ERC_MODULE_ABSENT);  // Cartridge not installed
+        return ERROR;
+    }
+
+    pthread_mutex_lock(&bandSelectLock);
+    if (bandSelect.state == BAND_SELECT_RUNNING) {
+        pthread_mutex_unlock(&bandSelectLock);
+        storeError(ERR_POWER_DISTRIBUTION, ERC_HARDWARE_WAIT);  // Band select already in progress
+        return ERROR;
+    }
+
+    bandSelect.state = BAND_SELECT_RUNNING;
+    bandSelect.band = band;
+    bandSelect.steps = 0;
+    bandSelect.status = NO_ERROR;
+    bandSelect.start = powerDistributionTime();
+    bandSelect.elapsed = 0.0;
+
+    /* 1 - Power the band */
+    if (frontend.cartridge[band].state == CARTRIDGE_ERROR || frontend.cartridge[band].standby2) {
+        storeError(ERR_POWER_DISTRIBUTION, ERC_HARDWARE_BLOCKED);  // Band in error or STANDBY2
+        bandSelectEnd(BAND_SELECT_FAILED, HARDW_BLKD_ERR);
+        pthread_mutex_unlock(&bandSelectLock);
+        return ERROR;
+    }
+    if (frontend.cartridge[band].state == CARTRIDGE_OFF) {
+        status = pdModulePowerOn(band, FALSE);
+        bandSelectLastControl(&frontend.powerDistribution.lastControl.pdModuleEnable[band], PD_MODULE_ENABLE, status);
+        if (status != NO_ERROR) {
+            bandSelectEnd(BAND_SELECT_FAILED, status);
+            pthread_mutex_unlock(&bandSelectLock);
+            return ERROR;
+        }
+    }
+    bandSelect.steps |= BAND_SELECT_STEP_POWER;
+
+    /* 2 - Set the IF switch */
+    if (setIfSwitchBandSelect(band) == ERROR) {
+        bandSelectLastControl(&frontend.ifSwitch.lastControl.bandSelect, band, ERROR);
+        bandSelectEnd(BAND_SELECT_FAILED, ERROR);
+        pthread_mutex_unlock(&bandSelectLock);
+        return ERROR;
+    }
+    bandSelectLastControl(&frontend.ifSwitch.lastControl.bandSelect, band, NO_ERROR);
+    bandSelect.steps |= BAND_SELECT_STEP_IF_SWITCH;
+
+    /* 3 - Queue the optical switch move, the LPR async process issues it as
+       soon as the switch is idle. */
+    if (opticalSwitchMoveStart(band) == ERROR) {
+        bandSelectLastControl(&frontend.lpr.lastControl.opticalSwitchPort, band, ERROR);
+        bandSelectEnd(BAND_SELECT_FAILED, ERROR);
+        pthread_mutex_unlock(&bandSelectLock);
+        return ERROR;
+    }
+    bandSelectLastControl(&frontend.lpr.lastControl.opticalSwitchPort, band, NO_ERROR);
+    bandSelect.steps |= BAND_SELECT_STEP_LPR_MOVE;
+    pthread_mutex_unlock(&bandSelectLock);
+
+    return NO_ERROR;
+}
+
+/* Band select async */
+/*! This function completes the band select started by \ref bandSelectStart.
+    It is called by the cartridge async thread, after \ref cartridgeAsync and
+    \ref lprAsync have had the chance to advance the cartridge initialization
+    and the optical switch move. It waits for both to complete. */
+void bandSelectAsync(void) {
+    int state, moveState;
+    unsigned char port;
+
+    pthread_mutex_lock(&bandSelectLock);
+    if (bandSelect.state != BAND_SELECT_RUNNING) {
+        pthread_mutex_unlock(&bandSelectLock);
+        return;
+    }
+
+    /* Optical switch: wait for the queued move to complete. A port or
+       shutter request received in the meantime supersedes the band select. */
+    if (!(bandSelect.steps & BAND_SELECT_STEP_LPR_PORT)) {
+        moveState = opticalSwitchMoveState(&port);
+        if (port != bandSelect.band || moveState == OPTICAL_SWITCH_MOVE_FAILED) {
+            storeError(ERR_POWER_DISTRIBUTION, ERC_HARDWARE_ERROR);  // Optical switch move failed
+            bandSelectEnd(BAND_SELECT_FAILED, HARDW_ERROR);
+            pthread_mutex_unlock(&bandSelectLock);
+            return;
+        }
+        if (moveState == OPTICAL_SWITCH_MOVE_DONE) {
+            bandSelect.steps |= BAND_SELECT_STEP_LPR_PORT;
+        }
+    }
+
+    /* Cartridge: wait for the initialization to complete */
+    state = frontend.cartridge[bandSelect.band].state;
+    if (state == CARTRIDGE_READY) {
+        bandSelect.steps |= BAND_SELECT_STEP_READY;
+    } else if (state == CARTRIDGE_ERROR || state == CARTRIDGE_OFF) {
+        storeError(ERR_POWER_DISTRIBUTION, ERC_HARDWARE_ERROR);  // Cartridge failed or powered off
+        bandSelectEnd(BAND_SELECT_FAILED, HARDW_ERROR);
+        pthread_mutex_unlock(&bandSelectLock);
+        return;
+    }
+
+    if (bandSelect.steps == BAND_SELECT_STEPS_ALL) {
+        bandSelectEnd(BAND_SELECT_DONE, NO_ERROR);
+    } else if (powerDistributionTime() - bandSelect.start > BAND_SELECT_TIMEOUT) {
+        storeError(ERR_POWER_DISTRIBUTION, ERC_HARDWARE_TIMEOUT);  // Band select timed out
+        bandSelectEnd(BAND_SELECT_FAILED, HARDW_ERROR);
+    }
+    pthread_mutex_unlock(&bandSelectLock);
+}
+
+/* Band select status */
+/*! This function returns the progress of the last band select:
+        - byte 0: state, see BAND_SELECT_xxx
+        - byte 1: band (0-9)
+        - byte 2: completed steps, see BAND_SELECT_STEP_xxx
+        - byte 3: failure status, NO_ERROR or one of the HARDW_xxx codes
+        - bytes 4-7: elapsed time in ms (big endian). While running, this is
+          the time since the start of the band select.
+    \param data    The 8 bytes buffer to fill */
+void bandSelectStatus(unsigned char *data) {
+    unsigned long elapsed;
+
+    pthread_mutex_lock(&bandSelectLock);
+    if (bandSelect.state == BAND_SELECT_RUNNING) {
+        elapsed = (unsigned long)(powerDistributionTime() - bandSelect.start);
+    } else {
+        elapsed = (unsigned long)bandSelect.elapsed;
+    }
+
+    data[0] = bandSelect.state;
+    data[1] = bandSelect.band;
+    data[2] = bandSelect.steps;
+    data[3] = (unsigned char)bandSelect.status;
+    data[4] = (unsigned char)(elapsed >> 24);
+    data[5] = (unsigned char)(elapsed >> 16);
+    data[6] = (unsigned char)(elapsed >> 8);
+    data[7] = (unsigned char)elapsed;
+    pthread_mutex_unlock(&bandSelectLock);
+}
+
+/* Power distribution channels sweep */
+/*! This function reads all the channels of the enabled power distribution
+    modules every \ref PD_SWEEP_PERIOD, one module per call, so that the
+    channel monitor RCAs can be served from the swept readings. The sweep is
+    suspended in maintenance mode to leave the hardware to the operator. */
+void pdSweepAsync(void) {
+    if (frontend.mode == MAINTENANCE_MODE) {
+        return;
+    }
+
+    /* Wait for the next cycle */
+    if (pdSweep.module == 0) {
+        if (powerDistributionTime() - pdSweep.start < PD_SWEEP_PERIOD) {
+            return;
+        }
+        pdSweep.start = powerDistributionTime();
+    }
+
+    /* Read the next enabled module. Errors were already stored by the serial interface. */
+    while ((pdSweep.module < PD_MODULES_NUMBER) &&
+           (frontend.powerDistribution.pdModule[pdSweep.module].enable != PD_MODULE_ENABLE)) {
+        pdSweep.module++;
+    }
+    if (pdSweep.module < PD_MODULES_NUMBER) {
+        getPdChannels(pdSweep.module++);
+    }
+    if (pdSweep.module >= PD_MODULES_NUMBER) {
+        pdSweep.module = 0;
+    }
+}
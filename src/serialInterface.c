@@ -24,6 +24,45 @@
 #include "frontend.h"
 #include "serialMux.h"
 
+/* Serial port */
+/*! Figure out the port on the serial mux board.
+    Every cartridge has two port, the bias and the lo. If a cartridge is
+    addressed then the port is given by the cartridge number multiplied by a
+    factor of two plus the index to the cartridge subsystem (1 -> Bias,
+    0 -> Lo).
+    On the other end if any other module is addressed, the port is offsetted
+    respect to the addressed module by the number of cartridges given their
+    doublefolded nature. */
+static unsigned int serialPort(int currentModule, int localCartSubsystem) {
+    if (currentModule < CARTRIDGES_NUMBER) {
+        return localCartSubsystem;
+    }
+    return currentModule - 8;
+}
+
+/* Format write data */
+/*! Copy \p reg into the data words of \p frame applying the requested
+    shift. Store 3 words, even if the register is smaller, it doesn't matter
+    since the frame data length is going to take care of the actual size. */
+static void serialFormatWrite(FRAME *frame, int *reg, unsigned char shiftAmount, unsigned char shiftDir) {
+    long long intermediateBuffer;
+
+    /* Copy the data to the intermediate buffer. */
+    memcpy(&intermediateBuffer, reg, sizeof(intermediateBuffer));
+
+    /* If some shifting was required, it is performed before writing the
+       data to the hardware. */
+    if (shiftAmount) {
+        if (shiftDir == SHIFT_RIGHT) {  // 0 -> Left, 1 -> Right
+            intermediateBuffer = intermediateBuffer >> shiftAmount;
+        } else {
+            intermediateBuffer = intermediateBuffer << shiftAmount;
+        }
+    }
+
+    memcpy(frame->data, &intermediateBuffer, FRAME_DATA_LENGTH_BYTES);
+}
+
 /* Serial Access */
 /*! This function perform all the data manipulation necessary to fill up the
     \ref FRAME that will be utilized by the low level driver to communicate with
@@ -72,21 +111,9 @@ int serialAccess(unsigned int command, int *reg, unsigned char regSize, unsigned
         return ERROR;
     }
 
-    /* Figure out the port on the serial mux board.
-       Every cartridge has two port, the bias and the lo. If a cartridge is
-       addressed then the port is given by the cartridge number multiplied by a
-       factor of two plus the index to the cartridge subsystem (1 -> Bias,
-       0 -> Lo).
-       On the other end if any other module is addressed, the port is offsetted
-       respect to the addressed module by the number of cartridges given their
-       doublefolded nature. */
+    /* Figure out the port on the serial mux board. */
     FRAME frame;
-    unsigned int port;
-    if (currentModule < CARTRIDGES_NUMBER) {
-        port = localCartSubsystem;
-    } else {
-        port = currentModule - 8;
-    }
+    unsigned int port = serialPort(currentModule, localCartSubsystem);
 
     /* Store the command in the outgoing frame */
     frame.command = command;
@@ -100,23 +127,8 @@ int serialAccess(unsigned int command, int *reg, unsigned char regSize, unsigned
 
     /* Perform differently if read or write */
     if (write == SERIAL_WRITE) {  // If it's a WRITE operation
-        /* Copy the data to the intermediate buffer. */
-        memcpy(&intermediateBuffer, reg, sizeof(intermediateBuffer));
-
-        /* If some shifting was required, it is performed before writing the
-           data to the hardware. */
-        if (shiftAmount) {
-            if (shiftDir == SHIFT_RIGHT) {  // 0 -> Left, 1 -> Right
-                intermediateBuffer = intermediateBuffer >> shiftAmount;
-            } else {
-                intermediateBuffer = intermediateBuffer << shiftAmount;
-            }
-        }
-
-        /* Store the register in the frame. Store 3 words, even if the register
-           is smaller, it doesn't matter since the variable regSize is going to
-           take care of the actual size. */
-        memcpy(frame.data, &intermediateBuffer, FRAME_DATA_LENGTH_BYTES);
+        /* Shift the data and store it in the frame. */
+        serialFormatWrite(&frame, reg, shiftAmount, shiftDir);
 
         /* Call the hardware writing function */
         if (writeMux(port, &frame) == ERROR) {
@@ -146,3 +158,68 @@ int serialAccess(unsigned int command, int *reg, unsigned char regSize, unsigned
 
     return NO_ERROR;
 }
+
+/* Empty a serial write list */
+void serialListInit(SERIAL_LIST *list) {
+    list->framesNumber = 0;
+}
+
+/* Append a write to a serial write list */
+/*! This function formats one write exactly as \ref serialAccess would and
+    appends it to \p list instead of sending it. All the frames in a list
+    must address the same port, the one of the first frame added.
+
+    \param list     The list to append the write to
+    \param reg      The data to send. It is copied, so it can be reused as
+                    soon as the function returns.
+
+    The remaining parameters are the same as for \ref serialAccess.
+
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if the command, the port or the list size is out
+                           of range */
+int serialListAdd(SERIAL_LIST *list, unsigned int command, int *reg, unsigned char regSize, unsigned char shiftAmount,
+                  unsigned char shiftDir, int currentModule, int localCartSubsystem) {
+    unsigned int port = serialPort(currentModule, localCartSubsystem);
+    FRAME *frame;
+
+    /* Check that the command word size is ok */
+    if (command > COMMAND_WORD_SIZE) {
+        storeError(ERR_SERIAL_INTERFACE,
+                   ERC_MODULE_RANGE);  // Command out of range
+        return ERROR;
+    }
+
+    /* Check that there is room left and that the port is the same */
+    if (list->framesNumber >= SERIAL_LIST_SIZE || (list->framesNumber > 0 && port != list->port)) {
+        storeError(ERR_SERIAL_INTERFACE, ERC_MODULE_RANGE);  // List out of range
+        return ERROR;
+    }
+
+    list->port = port;
+    frame = &list->frame[list->framesNumber++];
+    frame->command = command;
+    frame->dataLength = regSize;
+    serialFormatWrite(frame, reg, shiftAmount, shiftDir);
+
+    return NO_ERROR;
+}
+
+/* Send a serial write list */
+/*! This function sends all the frames in \p list to the port back to back
+    with a single acquisition of the port, then empties the list.
+
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int serialListWrite(SERIAL_LIST *list) {
+    int ret = NO_ERROR;
+
+    if (list->framesNumber > 0) {
+        ret = writeMuxList(list->port, list->frame, list->framesNumber);
+    }
+    list->framesNumber = 0;
+
+    return ret;
+}
@@ -24,6 +24,7 @@
 #include "debug.h"
 #include "error_local.h"
 #include "globalDefinitions.h"
+#include "lockProfile.h"
 #include "timer.h"
 
 int LATCH_DEBUG_SERIAL_WRITE;
@@ -35,6 +36,34 @@ static inline int check_done(unsigned int port) {
     return NO_ERROR;
 }
 
+/* Write one frame through the Mux board: the caller holds the port lock */
+static inline void writeMuxFrame(unsigned int port, FRAME *frame) {
+    /* 1 - Load the data registers. */
+    ssc_mem[port][SSC_DATAWR] = frame->data[FRAME_DATA_LSW];
+
+    /* 2 - Write the outgoing data lenght register with the number of bits to be
+           sent. */
+    ssc_mem[port][SSC_LENGTH] = frame->dataLength;
+
+    /* 3 - Write the command register. This will initiate the transmission of
+           data. */
+    ssc_mem[port][SSC_COMMAND] = frame->command;
+    ssc_mem[port][SSC_STATUS] = WR_SSC;
+
+#ifdef DEBUG_SERIAL_WRITE
+    if (LATCH_DEBUG_SERIAL_WRITE) {
+        LATCH_DEBUG_SERIAL_WRITE = 0;
+        printf("            (0x%04X) <- Frame.port: 0x%04X\n", MUX_PORT_ADD, frame.port);
+        printf("            (0x%04X) <- Frame.data[LSW]: 0x%04X\n", MUX_DATA_ADD(FRAME_DATA_LSW),
+               frame.data[FRAME_DATA_LSW]);
+        printf("            (0x%04X) <- Frame.dataLength: 0x%04X\n", MUX_WLENGTH_ADD, frame.dataLength);
+        printf("            (0x%04X) <- Frame.command: 0x%04X\n", MUX_COMMAND_ADD, frame.command);
+    }
+#endif /* DEBUG_SERIAL_WRITE */
+
+    check_done(port);
+}
+
 /* Write the data through the Mux board */
 /*! This function will trasmit the current courrent \ref frame content to the
     selected device.
@@ -63,34 +92,48 @@ inline int writeMux(unsigned int port, FRAME *frame) {
         return ERROR;
     }
 
-    pthread_mutex_lock(&(ssc_lock[port]));
+    lockMux(port);
 
-    /* 1 - Load the data registers. */
-    ssc_mem[port][SSC_DATAWR] = frame->data[FRAME_DATA_LSW];
+    writeMuxFrame(port, frame);
 
-    /* 2 - Write the outgoing data lenght register with the number of bits to be
-           sent. */
-    ssc_mem[port][SSC_LENGTH] = frame->dataLength;
+    unlockMux(port);
 
-    /* 3 - Write the command register. This will initiate the transmission of
-           data. */
-    ssc_mem[port][SSC_COMMAND] = frame->command;
-    ssc_mem[port][SSC_STATUS] = WR_SSC;
+    return NO_ERROR;
+}
 
-#ifdef DEBUG_SERIAL_WRITE
-    if (LATCH_DEBUG_SERIAL_WRITE) {
-        LATCH_DEBUG_SERIAL_WRITE = 0;
-        printf("            (0x%04X) <- Frame.port: 0x%04X\n", MUX_PORT_ADD, frame.port);
-        printf("            (0x%04X) <- Frame.data[LSW]: 0x%04X\n", MUX_DATA_ADD(FRAME_DATA_LSW),
-               frame.data[FRAME_DATA_LSW]);
-        printf("            (0x%04X) <- Frame.dataLength: 0x%04X\n", MUX_WLENGTH_ADD, frame.dataLength);
-        printf("            (0x%04X) <- Frame.command: 0x%04X\n", MUX_COMMAND_ADD, frame.command);
+/* Write a list of frames through the Mux board */
+/*! This function will transmit \p framesNumber frames to the selected device
+    back to back while holding the port for the whole list, so that no other
+    thread can interleave its own cycles in between. The frames are checked
+    before the first one is sent: either the whole list is transmitted or
+    nothing is.
+
+    \param port         The port/device to address
+    \param frame        The frames to transmit, in order
+    \param framesNumber The number of frames in the list
+
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int writeMuxList(unsigned int port, FRAME *frame, int framesNumber) {
+    int i;
+
+    /* Check if the lenghts are within the hardware limit (40 bits) */
+    for (i = 0; i < framesNumber; i++) {
+        if (frame[i].dataLength > FRAME_DATA_BIT_SIZE) {
+            storeError(ERR_SERIAL_MUX, ERC_COMMAND_VAL);  // Data length out of
+                                                          // range
+            return ERROR;
+        }
     }
-#endif /* DEBUG_SERIAL_WRITE */
 
-    check_done(port);
+    lockMux(port);
 
-    pthread_mutex_unlock(&ssc_lock[port]);
+    for (i = 0; i < framesNumber; i++) {
+        writeMuxFrame(port, &frame[i]);
+    }
+
+    unlockMux(port);
 
     return NO_ERROR;
 }
@@ -124,7 +167,7 @@ inline int readMux(unsigned int port, FRAME *frame) {
         return ERROR;
     }
 
-    pthread_mutex_lock(&ssc_lock[port]);
+    lockMux(port);
     /* 1 - Write the incoming data lenght register with the number of bits to be
            received. */
     ssc_mem[port][SSC_LENGTH] = frame->dataLength;
@@ -146,12 +189,31 @@ inline int readMux(unsigned int port, FRAME *frame) {
     frame->data[FRAME_DATA_MSW] = ssc_mem[port][SSC_DATARD1] & 0xFF;
     frame->data[FRAME_DATA_LSW] = ssc_mem[port][SSC_DATARD0];
 
-    pthread_mutex_unlock(&ssc_lock[port]);
+    unlockMux(port);
 
     return NO_ERROR;
 }
 
+/* Map the PicoZed register file */
+/*! This function maps the serial controllers and the OWB master registers in
+    the programmable logic into the process address space.
+
+    When built with \ref SIMULATED_HARDWARE the register file is backed by
+    plain zeroed memory instead of /dev/mem. All the status registers then read
+    as idle so the firmware can run, together with \ref SIMULATION_MODE, on a
+    machine without the FEMC hardware (e.g. to benchmark the socket server).
+
+    \return
+        - 0 -> if the registers were mapped */
 unsigned char init_mem_map(void) {
+#ifdef SIMULATED_HARDWARE
+    main_map = calloc(MAP_SIZE / sizeof(unsigned int), sizeof(unsigned int));
+    if (main_map == NULL) {
+        fprintf(stderr, "Error at line %d, file %s (%d) [%s]\n", __LINE__, __FILE__, errno, strerror(errno));
+        exit(1);
+    }
+    printf("Simulated registers allocated at address %p.\n", main_map);
+#else
     int fd_mem;
     if ((fd_mem = open("/dev/mem", O_RDWR | O_SYNC)) == -1) {
         fprintf(stderr, "Error at line %d, file %s (%d) [%s]\n", __LINE__, __FILE__, errno, strerror(errno));
@@ -166,6 +228,7 @@ unsigned char init_mem_map(void) {
         exit(1);
     }
     printf("Memory mapped at address %p.\n", main_map);
+#endif /* SIMULATED_HARDWARE */
 
     owb_mem = main_map;
     for (unsigned char i = 0; i < NUMBER_OF_DEVICES; i++) {
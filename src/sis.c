@@ -37,18 +37,44 @@
                       updated. */
 
 /* Includes */
-#include <stdio.h>  /* printf */
-#include <string.h> /* memcpy */
+#include <pthread.h> /* pthread_mutex_t */
+#include <stdio.h>   /* printf */
+#include <stdlib.h>  /* labs */
+#include <string.h>  /* memcpy */
 
+#include "async.h"
 #include "biasSerialInterface.h"
 #include "debug.h"
 #include "error_local.h"
 #include "frontend.h"
+#include "timer.h"
 
 /* Statics */
 static HANDLER_INT_INT_INT sisModulesHandler[SIS_MODULES_NUMBER] = {senseResistorHandler, sisVoltageHandler,
                                                                     sisCurrentHandler, openLoopHandler};
 
+/* I-V sweep engine. The sweep is requested from the CAN thread and executed
+   one step at a time by sisSweepAsync in the cartridge async thread. The lock
+   only protects the bookkeeping and the result buffer, never the hardware
+   access. */
+static pthread_mutex_t sisSweepLock = PTHREAD_MUTEX_INITIALIZER;
+static struct {
+    unsigned char state;      // One of the SIS_SWEEP_xxx states
+    unsigned char abort;      // Abort requested by command
+    int module;               // Swept cartridge
+    int biasModule;           // Swept polarization
+    int polarizationModule;   // Swept sideband
+    unsigned char averaging;  // Readings averaged for each point
+    unsigned char settle;     // Settling time in ms after each voltage step
+    unsigned char restore;    // TRUE if the previous set point has to be restored
+    float restoreVoltage;     // Set point to restore at the end of the sweep
+    float start;              // First voltage set point in mV
+    float step;               // Signed voltage step in mV
+    unsigned int points;      // Number of points in the sweep
+    unsigned int done;        // Number of points acquired so far
+} sisSweep = {SIS_SWEEP_IDLE};
+static SIS_SWEEP_POINT sisSweepBuffer[SIS_SWEEP_MAX_POINTS];
+
 /* SIS handler */
 /*! This function will be called by the CAN message handling subroutine when the
     received message is pertinent to the SIS. */
@@ -92,9 +118,7 @@ void senseResistorHandler(int currentModule, int currentBiasModule, int currentP
     if (CAN_SIZE) {
         // save the incoming message:
         SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                      .polarization[currentBiasModule]
-                                      .sideband[currentPolarizationModule]
-                                      .sis.lastSenseResistor)
+                                      .lastControl.sisSenseResistor[currentBiasModule][currentPolarizationModule])
 
         /* Extract the floating data from the CAN message */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -114,9 +138,7 @@ void senseResistorHandler(int currentModule, int currentBiasModule, int currentP
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
         RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                        .polarization[currentBiasModule]
-                                        .sideband[currentPolarizationModule]
-                                        .sis.lastSenseResistor)
+                                        .lastControl.sisSenseResistor[currentBiasModule][currentPolarizationModule])
         return;
     }
 
@@ -146,9 +168,7 @@ void sisVoltageHandler(int currentModule, int currentBiasModule, int currentPola
     if (CAN_SIZE) {
         // save the incoming message:
         SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                      .polarization[currentBiasModule]
-                                      .sideband[currentPolarizationModule]
-                                      .sis.lastVoltage)
+                                      .lastControl.sisVoltage[currentBiasModule][currentPolarizationModule])
 
         /* Extract the floating data from the CAN message */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -157,20 +177,16 @@ void sisVoltageHandler(int currentModule, int currentBiasModule, int currentPola
         if (frontend.cartridge[currentModule].standby2) {
             /* Store the ERROR state in the last control message variable */
             frontend.cartridge[currentModule]
-                .polarization[currentBiasModule]
-                .sideband[currentPolarizationModule]
-                .sis.lastVoltage.status = HARDW_BLKD_ERR;
+                .lastControl.sisVoltage[currentBiasModule][currentPolarizationModule].status = HARDW_BLKD_ERR;
             return;
         }
 
         /* Set the SIS mixer bias voltage. If an error occurs, store the state
            and then return. */
-        if (setSisMixerBias(currentModule, currentBiasModule, currentPolarizationModule) == ERROR) {
+        if (setSisMixerBias(CONV_FLOAT, currentModule, currentBiasModule, currentPolarizationModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
             frontend.cartridge[currentModule]
-                .polarization[currentBiasModule]
-                .sideband[currentPolarizationModule]
-                .sis.lastVoltage.status = ERROR;
+                .lastControl.sisVoltage[currentBiasModule][currentPolarizationModule].status = ERROR;
             return;
         }
         /* If everything went fine, it's a control message, we're done. */
@@ -181,9 +197,7 @@ void sisVoltageHandler(int currentModule, int currentBiasModule, int currentPola
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
         RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                        .polarization[currentBiasModule]
-                                        .sideband[currentPolarizationModule]
-                                        .sis.lastVoltage)
+                                        .lastControl.sisVoltage[currentBiasModule][currentPolarizationModule])
         return;
     }
 
@@ -271,17 +285,13 @@ void openLoopHandler(int currentModule, int currentBiasModule, int currentPolari
     if (CAN_SIZE) {
         // save the incoming message:
         SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                      .polarization[currentBiasModule]
-                                      .sideband[currentPolarizationModule]
-                                      .sis.lastOpenLoop)
+                                      .lastControl.sisOpenLoop[currentBiasModule][currentPolarizationModule])
 
         // If we are in STANDBY2 mode, return HARDW_BLKD_ERR
         if (frontend.cartridge[currentModule].standby2) {
             /* Store the ERROR state in the last control message variable */
             frontend.cartridge[currentModule]
-                .polarization[currentBiasModule]
-                .sideband[currentPolarizationModule]
-                .sis.lastOpenLoop.status = HARDW_BLKD_ERR;
+                .lastControl.sisOpenLoop[currentBiasModule][currentPolarizationModule].status = HARDW_BLKD_ERR;
             return;
         }
 
@@ -291,9 +301,7 @@ void openLoopHandler(int currentModule, int currentBiasModule, int currentPolari
                             currentBiasModule, currentPolarizationModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
             frontend.cartridge[currentModule]
-                .polarization[currentBiasModule]
-                .sideband[currentPolarizationModule]
-                .sis.lastOpenLoop.status = ERROR;
+                .lastControl.sisOpenLoop[currentBiasModule][currentPolarizationModule].status = ERROR;
             return;
         }
         /* If everything went fine, it's a control message, we're done. */
@@ -304,9 +312,7 @@ void openLoopHandler(int currentModule, int currentBiasModule, int currentPolari
     if (currentClass == CONTROL_CLASS) {  // If monitor on a control RCA
         // return the last control message and status
         RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                        .polarization[currentBiasModule]
-                                        .sideband[currentPolarizationModule]
-                                        .sis.lastOpenLoop)
+                                        .lastControl.sisOpenLoop[currentBiasModule][currentPolarizationModule])
         return;
     }
 
@@ -322,30 +328,304 @@ void openLoopHandler(int currentModule, int currentBiasModule, int currentPolari
     CAN_SIZE = CAN_BOOLEAN_SIZE;
 }
 
-// set the specified SIS to STANDBY2 mode
-void sisGoStandby2(int currentModule, int currentBiasModule, int currentPolarizationModule) {
-    /* Check if the selected sideband is outfitted with the desired SIS */
-    if (frontend.cartridge[currentModule]
-            .polarization[currentBiasModule]
-            .sideband[currentPolarizationModule]
-            .sis.available == UNAVAILABLE) {
-        // nothing to do:
-        return;
+/* Start an I-V sweep */
+/*! This function validates a sweep request and hands it over to
+    \ref sisSweepAsync. The request is a full 8 bytes payload:
+        - byte 0: bit 7 polarization, bit 6 sideband, bits 5-0 number of
+                  readings to average minus one
+        - bytes 1-2: start voltage in uV (signed, big endian)
+        - bytes 3-4: stop voltage in uV (signed, big endian)
+        - bytes 5-6: voltage step in uV (unsigned, big endian)
+        - byte 7: settling time in ms after each step
+
+    The last point is the last step not beyond the stop voltage.
+    \param currentModule   The cartridge to sweep
+    \param data            The request payload
+    \param size            The request size
+    \return
+        - \ref NO_ERROR -> if the sweep was started
+        - \ref ERROR    -> if the request was refused */
+int sisSweepStart(int currentModule, const unsigned char *data, unsigned char size) {
+    int biasModule, polarizationModule;
+    long start, stop, step;
+    unsigned int points;
+    LAST_CONTROL_MESSAGE *lastVoltage;
+    CONVERSION restore;
+
+    if (size != CAN_FULL_SIZE) {
+        storeError(ERR_SIS, ERC_COMMAND_VAL);  // Malformed sweep request
+        return ERROR;
+    }
+
+    /* The sweep drives the hardware, block it in maintenance mode as for the
+       standard control RCAs. */
+    if (frontend.mode == MAINTENANCE_MODE) {
+        storeError(ERR_CAN, ERC_MAINT_MODE);  // Front End in maintenance mode
+        return ERROR;
+    }
+
+    biasModule = (data[0] & SIS_SWEEP_POL_BIT) ? POLARIZATION1 : POLARIZATION0;
+    polarizationModule = (data[0] & SIS_SWEEP_SB_BIT) ? SIDEBAND1 : SIDEBAND0;
+    start = (short)((data[1] << 8) | data[2]);
+    stop = (short)((data[3] << 8) | data[4]);
+    step = (data[5] << 8) | data[6];
+
+    if (frontend.cartridge[currentModule].available == UNAVAILABLE ||
+        frontend.cartridge[currentModule]
+                .polarization[biasModule]
+                .sideband[polarizationModule]
+                .sis.available == UNAVAILABLE) {
+        storeError(ERR_SIS, ERC_MODULE_ABSENT);  // SIS not installed
+        return ERROR;
+    }
+
+    if (frontend.cartridge[currentModule].state != CARTRIDGE_READY || frontend.cartridge[currentModule].standby2) {
+        storeError(ERR_SIS, ERC_MODULE_POWER);  // Cartridge not ready for biasing
+        return ERROR;
+    }
+
+    /* A single point sweep is allowed with a zero step */
+    if (step == 0) {
+        if (start != stop) {
+            storeError(ERR_SIS, ERC_COMMAND_VAL);  // Null step
+            return ERROR;
+        }
+        points = 1;
+    } else {
+        points = (unsigned int)(labs(stop - start) / step) + 1;
+    }
+    if (points > SIS_SWEEP_MAX_POINTS) {
+        storeError(ERR_SIS, ERC_COMMAND_VAL);  // Too many points
+        return ERROR;
+    }
+
+    pthread_mutex_lock(&sisSweepLock);
+    if (sisSweep.state == SIS_SWEEP_RUNNING) {
+        pthread_mutex_unlock(&sisSweepLock);
+        storeError(ERR_SIS, ERC_HARDWARE_WAIT);  // Another sweep is running
+        return ERROR;
+    }
+
+    /* Restore the last commanded set point at the end of the sweep */
+    lastVoltage =
+        &frontend.cartridge[currentModule].lastControl.sisVoltage[biasModule][polarizationModule];
+    sisSweep.restore = (lastVoltage->size == CAN_FLOAT_SIZE && lastVoltage->status == NO_ERROR);
+    if (sisSweep.restore) {
+        changeEndian(restore.chr, lastVoltage->data);
+        sisSweep.restoreVoltage = restore.flt;
+    }
+
+    sisSweep.module = currentModule;
+    sisSweep.biasModule = biasModule;
+    sisSweep.polarizationModule = polarizationModule;
+    sisSweep.averaging = (data[0] & SIS_SWEEP_AVERAGING_MASK) + 1;
+    sisSweep.settle = data[7];
+    sisSweep.start = start * SIS_SWEEP_VOLTAGE_SCALE;
+    sisSweep.step = (stop < start ? -step : step) * SIS_SWEEP_VOLTAGE_SCALE;
+    sisSweep.points = points;
+    sisSweep.done = 0;
+    sisSweep.abort = FALSE;
+    sisSweep.state = SIS_SWEEP_RUNNING;
+    pthread_mutex_unlock(&sisSweepLock);
+
+#ifdef DEBUG_SIS_SWEEP
+    printf(" - sisSweepStart band=%d pol=%d sb=%d points=%u\n", currentModule + 1, biasModule, polarizationModule,
+           points);
+#endif /* DEBUG_SIS_SWEEP */
+
+    return NO_ERROR;
+}
+
+/* Abort the I-V sweep */
+/*! The running sweep is stopped at the next step of \ref sisSweepAsync. The
+    points acquired so far remain available. */
+void sisSweepAbort(void) {
+    pthread_mutex_lock(&sisSweepLock);
+    if (sisSweep.state == SIS_SWEEP_RUNNING) {
+        sisSweep.abort = TRUE;
+    }
+    pthread_mutex_unlock(&sisSweepLock);
+}
+
+/* I-V sweep status */
+/*! This function returns the state of the I-V sweep:
+        - byte 0: sweep state (SIS_SWEEP_xxx)
+        - byte 1: cartridge
+        - byte 2: polarization
+        - byte 3: sideband
+        - bytes 4-5: points acquired (big endian)
+        - bytes 6-7: points requested (big endian)
+    \param data    The 8 bytes buffer to fill */
+void sisSweepStatus(unsigned char *data) {
+    pthread_mutex_lock(&sisSweepLock);
+    data[0] = sisSweep.state;
+    data[1] = (unsigned char)sisSweep.module;
+    data[2] = (unsigned char)sisSweep.biasModule;
+    data[3] = (unsigned char)sisSweep.polarizationModule;
+    data[4] = (unsigned char)(sisSweep.done >> 8);
+    data[5] = (unsigned char)sisSweep.done;
+    data[6] = (unsigned char)(sisSweep.points >> 8);
+    data[7] = (unsigned char)sisSweep.points;
+    pthread_mutex_unlock(&sisSweepLock);
+}
+
+/* Read an I-V sweep point */
+/*! This function returns the acquired point with the given index. The point is
+    returned as two big endian floats, voltage (mV) and current (mA). Points can
+    be read while the sweep is still running. No state is kept between requests
+    so any number of clients can read the sweep in any order.
+    \param index   The index of the point in the sweep
+    \param data    The 8 bytes buffer to fill
+    \return
+        - \ref NO_ERROR -> if the point was returned
+        - \ref ERROR    -> if the point was not acquired yet. The buffer is
+                           filled with 0xFF (two NaN). */
+int sisSweepReadPoint(unsigned int index, unsigned char *data) {
+    CONVERSION value;
+
+    pthread_mutex_lock(&sisSweepLock);
+    if (index >= sisSweep.done) {
+        pthread_mutex_unlock(&sisSweepLock);
+        memset(data, 0xFF, CAN_FULL_SIZE);
+        return ERROR;
+    }
+    value.flt = sisSweepBuffer[index].voltage;
+    changeEndian(data, value.chr);
+    value.flt = sisSweepBuffer[index].current;
+    changeEndian(data + CAN_FLOAT_SIZE, value.chr);
+    pthread_mutex_unlock(&sisSweepLock);
+
+    return NO_ERROR;
+}
+
+/* Terminate the I-V sweep */
+static void sisSweepEnd(unsigned char state) {
+    /* Put back the set point that was there before the sweep */
+    if (sisSweep.restore && frontend.cartridge[sisSweep.module].state == CARTRIDGE_READY &&
+        !frontend.cartridge[sisSweep.module].standby2) {
+        setSisMixerBias(sisSweep.restoreVoltage, sisSweep.module, sisSweep.biasModule, sisSweep.polarizationModule);
+    }
+
+    pthread_mutex_lock(&sisSweepLock);
+    sisSweep.state = state;
+    pthread_mutex_unlock(&sisSweepLock);
+
+#ifdef DEBUG_SIS_SWEEP
+    printf(" - sisSweepEnd state=%d points=%u\n", state, sisSweep.done);
+#endif /* DEBUG_SIS_SWEEP */
+}
+
+/* I-V sweep async */
+/*! This function executes the next step of the running I-V sweep: set the
+    voltage, wait for the settling time, average the readings and store the
+    point. The sweep is stopped if the cartridge leaves the ready state.
+    \return
+        - \ref NO_ERROR     -> if the sweep is in progress
+        - \ref ASYNC_DONE   -> if there is no sweep in progress
+        - \ref ERROR        -> if something went wrong */
+int sisSweepAsync(void) {
+    /* A static enum to track the state of the sweep step */
+    static enum {
+        ASYNC_SIS_SWEEP_SET,
+        ASYNC_SIS_SWEEP_SETTLE,
+        ASYNC_SIS_SWEEP_MEASURE
+    } asyncSisSweepState = ASYNC_SIS_SWEEP_SET;
+    unsigned char abort;
+
+    pthread_mutex_lock(&sisSweepLock);
+    if (sisSweep.state != SIS_SWEEP_RUNNING) {
+        pthread_mutex_unlock(&sisSweepLock);
+        return ASYNC_DONE;
+    }
+    abort = sisSweep.abort;
+    pthread_mutex_unlock(&sisSweepLock);
+
+    /* Stop if aborted or if the cartridge is no longer available for biasing */
+    if (abort || frontend.cartridge[sisSweep.module].state != CARTRIDGE_READY ||
+        frontend.cartridge[sisSweep.module].standby2) {
+        stopAsyncTimer(TIMER_BIAS_SIS_SWEEP);
+        asyncSisSweepState = ASYNC_SIS_SWEEP_SET;
+        sisSweepEnd(abort ? SIS_SWEEP_ABORTED : SIS_SWEEP_ERROR);
+        return ASYNC_DONE;
+    }
+
+    switch (asyncSisSweepState) {
+        case ASYNC_SIS_SWEEP_SET:
+            /* Set the voltage of the next point */
+            if (setSisMixerBias(sisSweep.start + sisSweep.step * sisSweep.done, sisSweep.module, sisSweep.biasModule,
+                                sisSweep.polarizationModule) == ERROR) {
+                sisSweepEnd(SIS_SWEEP_ERROR);
+                return ERROR;
+            }
+
+            /* Setup timer to wait for the bias to settle */
+            if (startAsyncTimer(TIMER_BIAS_SIS_SWEEP, sisSweep.settle, FALSE) == ERROR) {
+                sisSweepEnd(SIS_SWEEP_ERROR);
+                return ERROR;
+            }
+
+            asyncSisSweepState = ASYNC_SIS_SWEEP_SETTLE;
+            break;
+
+        case ASYNC_SIS_SWEEP_SETTLE: {
+            /* A temporary variable to deal with the timer */
+            int timedOut = queryAsyncTimer(TIMER_BIAS_SIS_SWEEP);
+
+            if (timedOut == ERROR) {
+                asyncSisSweepState = ASYNC_SIS_SWEEP_SET;
+                sisSweepEnd(SIS_SWEEP_ERROR);
+                return ERROR;
+            }
+
+            /* Wait until timer expires. The timer is cleared by queryAsyncTimer. */
+            if (timedOut == TIMER_EXPIRED) {
+                asyncSisSweepState = ASYNC_SIS_SWEEP_MEASURE;
+            }
+            break;
+        }
+
+        case ASYNC_SIS_SWEEP_MEASURE: {
+            SIS *sis = &frontend.cartridge[sisSweep.module]
+                            .polarization[sisSweep.biasModule]
+                            .sideband[sisSweep.polarizationModule]
+                            .sis;
+            float voltage = 0.0, current = 0.0;
+            unsigned char reading;
+
+            asyncSisSweepState = ASYNC_SIS_SWEEP_SET;
+
+            /* Average the requested number of readings */
+            for (reading = 0; reading < sisSweep.averaging; reading++) {
+                if (getSisMixerBias(SIS_MIXER_BIAS_VOLTAGE, sisSweep.module, sisSweep.biasModule,
+                                    sisSweep.polarizationModule) == ERROR ||
+                    getSisMixerBias(SIS_MIXER_BIAS_CURRENT, sisSweep.module, sisSweep.biasModule,
+                                    sisSweep.polarizationModule) == ERROR) {
+                    sisSweepEnd(SIS_SWEEP_ERROR);
+                    return ERROR;
+                }
+                voltage += sis->voltage;
+                current += sis->current;
+            }
+
+            /* Store the point */
+            pthread_mutex_lock(&sisSweepLock);
+            sisSweepBuffer[sisSweep.done].voltage = voltage / sisSweep.averaging;
+            sisSweepBuffer[sisSweep.done].current = current / sisSweep.averaging;
+            sisSweep.done++;
+            pthread_mutex_unlock(&sisSweepLock);
+
+            if (sisSweep.done == sisSweep.points) {
+                sisSweepEnd(SIS_SWEEP_DONE);
+                return ASYNC_DONE;
+            }
+            break;
+        }
+
+        default:
+            asyncSisSweepState = ASYNC_SIS_SWEEP_SET;
+            return ERROR;
+            break;
     }
 
-#ifdef DEBUG_GO_STANDBY2
-    int ret;
-    printf(" - sisGoStandby2 pol=%d sb=%d\n", currentBiasModule, currentPolarizationModule);
-    // set the SIS voltage to 0:
-    CONV_FLOAT = 0.0;
-    ret = setSisMixerBias(currentModule, currentBiasModule, currentPolarizationModule);
-#else
-    // set the SIS voltage to 0:
-    CONV_FLOAT = 0.0;
-    setSisMixerBias(currentModule, currentBiasModule, currentPolarizationModule);
-#endif  // DEBUG_GO_STANDBY2
-
-#ifdef DEBUG_GO_STANDBY2
-    if (ret) printf(" -- ret=%d\n", ret);
-#endif  // DEBUG_GO_STANDBY2
+    return NO_ERROR;
 }
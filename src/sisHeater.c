@@ -58,12 +58,12 @@ void sisHeaterEnableHandler(int currentModule, int currentBiasModule, int curren
     if (CAN_SIZE) {
         // save the incoming message:
         SAVE_LAST_CONTROL_MESSAGE(
-            frontend.cartridge[currentModule].polarization[currentBiasModule].sisHeater.lastEnable)
+            frontend.cartridge[currentModule].lastControl.sisHeaterEnable[currentBiasModule])
 
         // If we are in STANDBY2 mode, return HARDW_BLKD_ERR
         if (frontend.cartridge[currentModule].standby2) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].polarization[currentBiasModule].sisHeater.lastEnable.status =
+            frontend.cartridge[currentModule].lastControl.sisHeaterEnable[currentBiasModule].status =
                 HARDW_BLKD_ERR;
 
             return;
@@ -85,14 +85,14 @@ void sisHeaterEnableHandler(int currentModule, int currentBiasModule, int curren
                     break;
                 case TIMER_RUNNING:
                     /* Mark hardware as blocked */
-                    frontend.cartridge[currentModule].polarization[currentBiasModule].sisHeater.lastEnable.status =
+                    frontend.cartridge[currentModule].lastControl.sisHeaterEnable[currentBiasModule].status =
                         HARDW_BLKD_ERR;
                     /* Signal error and bail out */
                     storeError(ERR_SIS_HEATER, ERC_HARDWARE_BLOCKED);  // Hardware blocked error
                     return;
                     break;
                 default:
-                    frontend.cartridge[currentModule].polarization[currentBiasModule].sisHeater.lastEnable.status =
+                    frontend.cartridge[currentModule].lastControl.sisHeaterEnable[currentBiasModule].status =
                         ERROR;
                     return;
                     break;
@@ -104,7 +104,7 @@ void sisHeaterEnableHandler(int currentModule, int currentBiasModule, int curren
         if (setSisHeaterEnable(CAN_BYTE ? SIS_HEATER_ENABLE : SIS_HEATER_DISABLE, currentModule, currentBiasModule,
                                currentPolarizationModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].polarization[currentBiasModule].sisHeater.lastEnable.status = ERROR;
+            frontend.cartridge[currentModule].lastControl.sisHeaterEnable[currentBiasModule].status = ERROR;
 
             return;
         }
@@ -116,7 +116,7 @@ void sisHeaterEnableHandler(int currentModule, int currentBiasModule, int curren
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
         RETURN_LAST_CONTROL_MESSAGE(
-            frontend.cartridge[currentModule].polarization[currentBiasModule].sisHeater.lastEnable)
+            frontend.cartridge[currentModule].lastControl.sisHeaterEnable[currentBiasModule])
         return;
     }
 
@@ -8,9 +8,13 @@
     events. */
 
 /* Includes */
-#include <stdio.h>  /* printf */
-#include <string.h> /* memcpy */
+#include <math.h>    /* fabsf, isfinite */
+#include <pthread.h> /* pthread_mutex_t */
+#include <stdio.h>   /* printf */
+#include <string.h>  /* memcpy */
+#include <time.h>    /* clock_gettime */
 
+#include "async.h"
 #include "biasSerialInterface.h"
 #include "debug.h"
 #include "error_local.h"
@@ -20,6 +24,34 @@
 static HANDLER_INT_INT_INT sisMagnetModulesHandler[SIS_MAGNET_MODULES_NUMBER] = {sisMagnetVoltageHandler,
                                                                                  sisMagnetCurrentHandler};
 
+/* Current ramp engine. Ramps are requested from the CAN thread and executed by
+   sisMagnetRampAsync in the cartridge async thread, each magnet on its own
+   schedule. The set point is computed from the elapsed time so late steps
+   don't slow the ramp down. The lock is held across the DAC write so that a
+   cancelled ramp never writes after the command that cancelled it. */
+typedef struct {
+    unsigned char state;       // One of the SIS_MAGNET_RAMP_xxx states
+    unsigned char abort;       // Abort requested by command
+    unsigned char sample;      // TRUE if this ramp records samples
+    unsigned char startKnown;  // TRUE if the starting current was known at request time
+    unsigned char running;     // TRUE once the first step has been executed
+    unsigned int generation;   // Incremented at every request to discard stale steps
+    unsigned int period;       // Step period in ms
+    float start;               // Starting current in mA
+    float setPoint;            // Last current written to the DAC in mA
+    float target;              // Target current in mA
+    float rate;                // Ramp rate in mA/ms
+    double startTime;          // Time of the first step in ms
+    double nextTime;           // Time of the next step in ms
+} SIS_MAGNET_RAMP;
+
+static pthread_mutex_t sisMagnetRampLock = PTHREAD_MUTEX_INITIALIZER;
+static SIS_MAGNET_RAMP sisMagnetRamp[CARTRIDGES_NUMBER][POLARIZATIONS_NUMBER][SIDEBANDS_NUMBER];
+static int sisMagnetRampLast[3];                     // Cartridge, polarization and sideband of the last request
+static SIS_MAGNET_RAMP *sisMagnetRampSampled = NULL;  // Ramp owning the sample buffer
+static SIS_MAGNET_RAMP_SAMPLE sisMagnetRampSamples[SIS_MAGNET_RAMP_MAX_SAMPLES];
+static unsigned int sisMagnetRampSamplesNumber = 0;  // Samples stored
+
 /* SIS magnet handler */
 /*! This function will be called by the CAN message handling subroutine when the
     received message is pertinent to the SIS magnet. */
@@ -112,11 +144,12 @@ void sisMagnetCurrentHandler(int currentModule, int currentBiasModule, int curre
 
     /* If control (size !=0) */
     if (CAN_SIZE) {
+        // a direct set point overrides a running ramp:
+        sisMagnetRampCancel(currentModule, currentBiasModule, currentPolarizationModule);
+
         // save the incoming message:
         SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                      .polarization[currentBiasModule]
-                                      .sideband[currentPolarizationModule]
-                                      .sisMagnet.lastCurrent)
+                                      .lastControl.sisMagnetCurrent[currentBiasModule][currentPolarizationModule])
 
         /* Extract the floating data from the CAN message */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -125,21 +158,17 @@ void sisMagnetCurrentHandler(int currentModule, int currentBiasModule, int curre
         if (frontend.cartridge[currentModule].standby2) {
             /* Store the ERROR state in the last control message variable */
             frontend.cartridge[currentModule]
-                .polarization[currentBiasModule]
-                .sideband[currentPolarizationModule]
-                .sisMagnet.lastCurrent.status = HARDW_BLKD_ERR;
+                .lastControl.sisMagnetCurrent[currentBiasModule][currentPolarizationModule].status = HARDW_BLKD_ERR;
 
             return;
         }
 
         /* Set the SIS magnet bias current. If an error occurs, then store the
            state and report the error. */
-        if (setSisMagnetBias(currentModule, currentBiasModule, currentPolarizationModule) == ERROR) {
+        if (setSisMagnetBias(CONV_FLOAT, currentModule, currentBiasModule, currentPolarizationModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
             frontend.cartridge[currentModule]
-                .polarization[currentBiasModule]
-                .sideband[currentPolarizationModule]
-                .sisMagnet.lastCurrent.status = ERROR;
+                .lastControl.sisMagnetCurrent[currentBiasModule][currentPolarizationModule].status = ERROR;
 
             return;
         }
@@ -152,9 +181,7 @@ void sisMagnetCurrentHandler(int currentModule, int currentBiasModule, int curre
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
         RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule]
-                                        .polarization[currentBiasModule]
-                                        .sideband[currentPolarizationModule]
-                                        .sisMagnet.lastCurrent)
+                                        .lastControl.sisMagnetCurrent[currentBiasModule][currentPolarizationModule])
         return;
     }
 
@@ -185,30 +212,398 @@ void sisMagnetCurrentHandler(int currentModule, int currentBiasModule, int curre
     CAN_SIZE = CAN_FLOAT_SIZE;
 }
 
-// set the specified SIS magnet to STANDBY2 mode.
-void sisMagnetGoStandby2(int currentModule, int currentBiasModule, int currentPolarizationModule) {
-    /* Check if the selected sideband is outfitted with the desired SIS */
-    if (frontend.cartridge[currentModule]
-            .polarization[currentBiasModule]
-            .sideband[currentPolarizationModule]
-            .sisMagnet.available == UNAVAILABLE) {
-        // nothing to do:
-        return;
+/* Current time for the ramp schedule in ms */
+static double sisMagnetRampTime(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+/* Start a SIS magnet current ramp */
+/*! This function validates a ramp request and hands it over to
+    \ref sisMagnetRampAsync. The request is a full 8 bytes payload:
+        - byte 0: bit 7 polarization, bit 6 sideband, bit 0 sample the magnet
+                  voltage and current at every step
+        - bytes 1-4: target current in mA (float, big endian), within
+                     \ref SIS_MAGNET_CURRENT_SET_MIN and \ref SIS_MAGNET_CURRENT_SET_MAX
+        - bytes 5-6: ramp rate in uA/s (unsigned, big endian)
+        - byte 7: step period in ms
+
+    The ramp starts from the last commanded current or, if unknown, from the
+    measured one. A new request on a magnet already ramping continues from
+    the current set point. While the ramp is running the SIS magnet current
+    last control message holds the target with status \ref HARDW_BLKD_ERR, at
+    the end it holds the reached current and the final status.
+    \param currentModule   The cartridge hosting the magnet
+    \param data            The request payload
+    \param size            The request size
+    \return
+        - \ref NO_ERROR -> if the ramp was started
+        - \ref ERROR    -> if the request was refused */
+int sisMagnetRampStart(int currentModule, const unsigned char *data, unsigned char size) {
+    int biasModule, polarizationModule;
+    unsigned int rate;
+    CONVERSION target, last;
+    LAST_CONTROL_MESSAGE *lastCurrent;
+    SIS_MAGNET_RAMP *ramp;
+
+    if (size != CAN_FULL_SIZE) {
+        storeError(ERR_SIS_MAGNET, ERC_COMMAND_VAL);  // Malformed ramp request
+        return ERROR;
+    }
+
+    /* The ramp drives the hardware, block it in maintenance mode as for the
+       standard control RCAs. */
+    if (frontend.mode == MAINTENANCE_MODE) {
+        storeError(ERR_CAN, ERC_MAINT_MODE);  // Front End in maintenance mode
+        return ERROR;
+    }
+
+    biasModule = (data[0] & SIS_MAGNET_RAMP_POL_BIT) ? POLARIZATION1 : POLARIZATION0;
+    polarizationModule = (data[0] & SIS_MAGNET_RAMP_SB_BIT) ? SIDEBAND1 : SIDEBAND0;
+    changeEndian(target.chr, (unsigned char *)data + 1);
+    rate = (data[5] << 8) | data[6];
+
+    if (frontend.cartridge[currentModule].available == UNAVAILABLE ||
+        frontend.cartridge[currentModule]
+                .polarization[biasModule]
+                .sideband[polarizationModule]
+                .sisMagnet.available == UNAVAILABLE) {
+        storeError(ERR_SIS_MAGNET, ERC_MODULE_ABSENT);  // SIS magnet not installed
+        return ERROR;
+    }
+
+    if (frontend.cartridge[currentModule].state != CARTRIDGE_READY || frontend.cartridge[currentModule].standby2) {
+        storeError(ERR_SIS_MAGNET, ERC_MODULE_POWER);  // Cartridge not ready for biasing
+        return ERROR;
+    }
+
+    if (!isfinite(target.flt) ||
+        checkRange(SIS_MAGNET_CURRENT_SET_MIN, target.flt, SIS_MAGNET_CURRENT_SET_MAX) || rate == 0 ||
+        data[7] == 0) {
+        storeError(ERR_SIS_MAGNET, ERC_COMMAND_VAL);  // Invalid ramp parameters
+        return ERROR;
+    }
+
+    lastCurrent = &frontend.cartridge[currentModule].lastControl.sisMagnetCurrent[biasModule][polarizationModule];
+    ramp = &sisMagnetRamp[currentModule][biasModule][polarizationModule];
+
+    pthread_mutex_lock(&sisMagnetRampLock);
+
+    /* Only one ramp at a time can record samples */
+    if ((data[0] & SIS_MAGNET_RAMP_SAMPLE_BIT) && sisMagnetRampSampled != NULL && sisMagnetRampSampled != ramp) {
+        pthread_mutex_unlock(&sisMagnetRampLock);
+        storeError(ERR_SIS_MAGNET, ERC_HARDWARE_WAIT);  // Sample buffer in use
+        return ERROR;
+    }
+
+    /* Find the starting current */
+    if (ramp->state == SIS_MAGNET_RAMP_RUNNING && ramp->running) {
+        ramp->start = ramp->setPoint;
+        ramp->startKnown = TRUE;
+    } else if (lastCurrent->size == CAN_FLOAT_SIZE && lastCurrent->status == NO_ERROR) {
+        changeEndian(last.chr, lastCurrent->data);
+        ramp->start = last.flt;
+        ramp->startKnown = TRUE;
+    } else {
+        ramp->startKnown = FALSE;
+    }
+
+    ramp->generation++;
+    ramp->target = target.flt;
+    ramp->rate = rate * SIS_MAGNET_RAMP_RATE_SCALE / 1000.0;
+    ramp->period = data[7];
+    ramp->running = FALSE;
+    ramp->abort = FALSE;
+    ramp->sample = (data[0] & SIS_MAGNET_RAMP_SAMPLE_BIT) ? TRUE : FALSE;
+    ramp->state = SIS_MAGNET_RAMP_RUNNING;
+
+    if (ramp->sample) {
+        sisMagnetRampSampled = ramp;
+        sisMagnetRampSamplesNumber = 0;
+    } else if (sisMagnetRampSampled == ramp) {
+        sisMagnetRampSampled = NULL;
+    }
+
+    sisMagnetRampLast[0] = currentModule;
+    sisMagnetRampLast[1] = biasModule;
+    sisMagnetRampLast[2] = polarizationModule;
+
+    /* Report the ramp in progress through the last control message */
+    lastCurrent->size = CAN_FLOAT_SIZE;
+    memcpy(lastCurrent->data, data + 1, CAN_FLOAT_SIZE);
+    lastCurrent->status = HARDW_BLKD_ERR;
+
+    pthread_mutex_unlock(&sisMagnetRampLock);
+
+#ifdef DEBUG_SIS_MAGNET_RAMP
+    printf(" - sisMagnetRampStart band=%d pol=%d sb=%d target=%f rate=%u\n", currentModule + 1, biasModule,
+           polarizationModule, target.flt, rate);
+#endif /* DEBUG_SIS_MAGNET_RAMP */
+
+    return NO_ERROR;
+}
+
+/* Terminate a ramp. Must be called with the lock held. */
+static void sisMagnetRampEnd(SIS_MAGNET_RAMP *ramp, LAST_CONTROL_MESSAGE *lastCurrent, unsigned char state) {
+    CONVERSION reached;
+
+    ramp->state = state;
+    if (sisMagnetRampSampled == ramp) {
+        sisMagnetRampSampled = NULL;
+    }
+
+    /* Final status in the last control message. The reported current is the
+       last one actually written to the DAC. */
+    if (ramp->running) {
+        reached.flt = ramp->setPoint;
+        changeEndian(lastCurrent->data, reached.chr);
+    }
+    lastCurrent->status = (state == SIS_MAGNET_RAMP_ERROR) ? ERROR : NO_ERROR;
+
+#ifdef DEBUG_SIS_MAGNET_RAMP
+    printf(" - sisMagnetRampEnd state=%d setPoint=%f\n", state, ramp->setPoint);
+#endif /* DEBUG_SIS_MAGNET_RAMP */
+}
+
+/* Cancel a SIS magnet ramp */
+/*! This function stops the ramp running on the selected magnet immediately.
+    It is used when a new set point is commanded directly, the ramp leaves
+    the last control message to the new command. */
+void sisMagnetRampCancel(int currentModule, int currentBiasModule, int currentPolarizationModule) {
+    SIS_MAGNET_RAMP *ramp = &sisMagnetRamp[currentModule][currentBiasModule][currentPolarizationModule];
+
+    pthread_mutex_lock(&sisMagnetRampLock);
+    if (ramp->state == SIS_MAGNET_RAMP_RUNNING) {
+        ramp->generation++;
+        ramp->state = SIS_MAGNET_RAMP_ABORTED;
+        if (sisMagnetRampSampled == ramp) {
+            sisMagnetRampSampled = NULL;
+        }
+    }
+    pthread_mutex_unlock(&sisMagnetRampLock);
+}
+
+/* Abort the SIS magnet ramps */
+/*! All the running ramps are stopped at their next step, leaving the magnets
+    at the reached current. */
+void sisMagnetRampAbort(void) {
+    int module, pol, sb;
+
+    pthread_mutex_lock(&sisMagnetRampLock);
+    for (module = 0; module < CARTRIDGES_NUMBER; module++) {
+        for (pol = 0; pol < POLARIZATIONS_NUMBER; pol++) {
+            for (sb = 0; sb < SIDEBANDS_NUMBER; sb++) {
+                if (sisMagnetRamp[module][pol][sb].state == SIS_MAGNET_RAMP_RUNNING) {
+                    sisMagnetRamp[module][pol][sb].abort = TRUE;
+                }
+            }
+        }
+    }
+    pthread_mutex_unlock(&sisMagnetRampLock);
+}
+
+/* SIS magnet ramp status */
+/*! This function returns the state of the last requested ramp:
+        - byte 0: ramp state (SIS_MAGNET_RAMP_xxx)
+        - byte 1: cartridge
+        - byte 2: polarization
+        - byte 3: sideband
+        - byte 4: progress in percent
+        - byte 5: number of ramps running
+        - bytes 6-7: samples stored (big endian)
+    \param data    The 8 bytes buffer to fill */
+void sisMagnetRampStatus(unsigned char *data) {
+    SIS_MAGNET_RAMP *ramp;
+    unsigned char running = 0;
+    float span, progress = 0.0;
+    int module, pol, sb;
+
+    pthread_mutex_lock(&sisMagnetRampLock);
+    ramp = &sisMagnetRamp[sisMagnetRampLast[0]][sisMagnetRampLast[1]][sisMagnetRampLast[2]];
+    for (module = 0; module < CARTRIDGES_NUMBER; module++) {
+        for (pol = 0; pol < POLARIZATIONS_NUMBER; pol++) {
+            for (sb = 0; sb < SIDEBANDS_NUMBER; sb++) {
+                running += (sisMagnetRamp[module][pol][sb].state == SIS_MAGNET_RAMP_RUNNING);
+            }
+        }
+    }
+    if (ramp->state == SIS_MAGNET_RAMP_DONE) {
+        progress = 100.0;
+    } else if (ramp->running) {
+        span = fabsf(ramp->target - ramp->start);
+        progress = (span > 0.0) ? 100.0 * fabsf(ramp->setPoint - ramp->start) / span : 100.0;
+    }
+
+    data[0] = ramp->state;
+    data[1] = (unsigned char)sisMagnetRampLast[0];
+    data[2] = (unsigned char)sisMagnetRampLast[1];
+    data[3] = (unsigned char)sisMagnetRampLast[2];
+    data[4] = (unsigned char)progress;
+    data[5] = running;
+    data[6] = (unsigned char)(sisMagnetRampSamplesNumber >> 8);
+    data[7] = (unsigned char)sisMagnetRampSamplesNumber;
+    pthread_mutex_unlock(&sisMagnetRampLock);
+}
+
+/* Read a SIS magnet ramp sample */
+/*! This function returns the sample with the given index recorded while
+    ramping. The sample is returned as two big endian floats, voltage (mV) and
+    current (mA). No state is kept between requests so any number of clients
+    can read the samples in any order.
+    \param index   The index of the sample in the ramp
+    \param data    The 8 bytes buffer to fill
+    \return
+        - \ref NO_ERROR -> if the sample was returned
+        - \ref ERROR    -> if the sample was not recorded yet. The buffer is
+                           filled with 0xFF (two NaN). */
+int sisMagnetRampReadSample(unsigned int index, unsigned char *data) {
+    CONVERSION value;
+
+    pthread_mutex_lock(&sisMagnetRampLock);
+    if (index >= sisMagnetRampSamplesNumber) {
+        pthread_mutex_unlock(&sisMagnetRampLock);
+        memset(data, 0xFF, CAN_FULL_SIZE);
+        return ERROR;
+    }
+    value.flt = sisMagnetRampSamples[index].voltage;
+    changeEndian(data, value.chr);
+    value.flt = sisMagnetRampSamples[index].current;
+    changeEndian(data + CAN_FLOAT_SIZE, value.chr);
+    pthread_mutex_unlock(&sisMagnetRampLock);
+
+    return NO_ERROR;
+}
+
+/* Execute one step of a ramp if it is due. Must be called with the lock held. */
+static int sisMagnetRampStep(int currentModule, int currentBiasModule, int currentPolarizationModule, double now,
+                             unsigned char *stepped) {
+    SIS_MAGNET_RAMP *ramp = &sisMagnetRamp[currentModule][currentBiasModule][currentPolarizationModule];
+    SIS_MAGNET *magnet = &frontend.cartridge[currentModule]
+                              .polarization[currentBiasModule]
+                              .sideband[currentPolarizationModule]
+                              .sisMagnet;
+    LAST_CONTROL_MESSAGE *lastCurrent =
+        &frontend.cartridge[currentModule].lastControl.sisMagnetCurrent[currentBiasModule][currentPolarizationModule];
+    float delta, span;
+
+    /* Stop if aborted or if the cartridge is no longer available for biasing */
+    if (ramp->abort) {
+        sisMagnetRampEnd(ramp, lastCurrent, SIS_MAGNET_RAMP_ABORTED);
+        return NO_ERROR;
+    }
+    if (frontend.cartridge[currentModule].state != CARTRIDGE_READY || frontend.cartridge[currentModule].standby2) {
+        sisMagnetRampEnd(ramp, lastCurrent, SIS_MAGNET_RAMP_ERROR);
+        return NO_ERROR;
+    }
+
+    /* First step: find the starting current if it wasn't known */
+    if (!ramp->running) {
+        if (!ramp->startKnown) {
+            if (getSisMagnetBias(SIS_MAGNET_BIAS_CURRENT, currentModule, currentBiasModule,
+                                 currentPolarizationModule) == ERROR) {
+                sisMagnetRampEnd(ramp, lastCurrent, SIS_MAGNET_RAMP_ERROR);
+                return ERROR;
+            }
+            ramp->start = magnet->current;
+        }
+        ramp->startTime = now;
+        ramp->nextTime = now;
+    }
+
+    if (now < ramp->nextTime) {
+        return NO_ERROR;
+    }
+
+    /* Set point from the elapsed time, clamped to the target */
+    span = ramp->target - ramp->start;
+    delta = ramp->rate * (now - ramp->startTime);
+    ramp->setPoint = (delta >= fabsf(span)) ? ramp->target : ramp->start + (span < 0.0 ? -delta : delta);
+
+    if (setSisMagnetBias(ramp->setPoint, currentModule, currentBiasModule, currentPolarizationModule) == ERROR) {
+        sisMagnetRampEnd(ramp, lastCurrent, SIS_MAGNET_RAMP_ERROR);
+        return ERROR;
+    }
+    ramp->running = TRUE;
+    *stepped = TRUE;
+
+    /* Schedule the next step, skipping the missed ones */
+    ramp->nextTime += ramp->period;
+    if (ramp->nextTime < now) {
+        ramp->nextTime = now + ramp->period;
+    }
+
+    return NO_ERROR;
+}
+
+/* SIS magnet ramp async */
+/*! This function executes the steps of all the running ramps that are due:
+    write the next set point and, for the sampled ramp, read back the magnet
+    voltage and current.
+    \return
+        - \ref NO_ERROR     -> if at least a ramp is in progress
+        - \ref ASYNC_DONE   -> if there are no ramps in progress
+        - \ref ERROR        -> if something went wrong */
+int sisMagnetRampAsync(void) {
+    int module, pol, sb, ret = ASYNC_DONE;
+    unsigned int generation;
+    unsigned char stepped, sampled, sampleError;
+    SIS_MAGNET_RAMP *ramp;
+    SIS_MAGNET *magnet;
+    LAST_CONTROL_MESSAGE *lastCurrent;
+    double now = sisMagnetRampTime();
+
+    for (module = 0; module < CARTRIDGES_NUMBER; module++) {
+        for (pol = 0; pol < POLARIZATIONS_NUMBER; pol++) {
+            for (sb = 0; sb < SIDEBANDS_NUMBER; sb++) {
+                ramp = &sisMagnetRamp[module][pol][sb];
+                magnet = &frontend.cartridge[module].polarization[pol].sideband[sb].sisMagnet;
+                lastCurrent = &frontend.cartridge[module].lastControl.sisMagnetCurrent[pol][sb];
+
+                pthread_mutex_lock(&sisMagnetRampLock);
+                if (ramp->state != SIS_MAGNET_RAMP_RUNNING) {
+                    pthread_mutex_unlock(&sisMagnetRampLock);
+                    continue;
+                }
+                stepped = FALSE;
+                if (sisMagnetRampStep(module, pol, sb, now, &stepped) == ERROR) {
+                    ret = ERROR;
+                }
+                sampled = stepped && sisMagnetRampSampled == ramp;
+                generation = ramp->generation;
+                pthread_mutex_unlock(&sisMagnetRampLock);
+
+                /* Sample the magnet outside the lock */
+                sampleError = FALSE;
+                if (sampled) {
+                    sampleError = (getSisMagnetBias(SIS_MAGNET_BIAS_VOLTAGE, module, pol, sb) == ERROR ||
+                                   getSisMagnetBias(SIS_MAGNET_BIAS_CURRENT, module, pol, sb) == ERROR);
+                }
+
+                pthread_mutex_lock(&sisMagnetRampLock);
+                /* Skip if the ramp was cancelled or restarted in the meantime */
+                if (ramp->generation == generation && ramp->state == SIS_MAGNET_RAMP_RUNNING) {
+                    if (sampleError) {
+                        sisMagnetRampEnd(ramp, lastCurrent, SIS_MAGNET_RAMP_ERROR);
+                        ret = ERROR;
+                    } else {
+                        if (sampled && sisMagnetRampSamplesNumber < SIS_MAGNET_RAMP_MAX_SAMPLES) {
+                            sisMagnetRampSamples[sisMagnetRampSamplesNumber].voltage = magnet->voltage;
+                            sisMagnetRampSamples[sisMagnetRampSamplesNumber].current = magnet->current;
+                            sisMagnetRampSamplesNumber++;
+                        }
+                        if (stepped && ramp->setPoint == ramp->target) {
+                            sisMagnetRampEnd(ramp, lastCurrent, SIS_MAGNET_RAMP_DONE);
+                        } else if (ret != ERROR) {
+                            ret = NO_ERROR;
+                        }
+                    }
+                }
+                pthread_mutex_unlock(&sisMagnetRampLock);
+            }
+        }
     }
 
-#ifdef DEBUG_GO_STANDBY2
-    int ret;
-    printf(" - sisMagnetGoStandby2 pol=%d sb=%d\n", currentBiasModule, currentPolarizationModule);
-    // set the SIS magnet current to 0:
-    CONV_FLOAT = 0.0;
-    ret = setSisMagnetBias(currentModule, currentBiasModule, currentPolarizationModule);
-#else
-    // set the SIS magnet current to 0:
-    CONV_FLOAT = 0.0;
-    setSisMagnetBias(currentModule, currentBiasModule, currentPolarizationModule);
-#endif  // DEBUG_GO_STANDBY2
-
-#ifdef DEBUG_GO_STANDBY2
-    if (ret) printf(" -- ret=%d\n", ret);
-#endif  // DEBUG_GO_STANDBY2
+    return ret;
 }
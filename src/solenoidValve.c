@@ -45,7 +45,7 @@ void solenoidValveStateHandler(void) {
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.solenoidValve.lastState)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.lastControl.solenoidValveState)
 
         /* Check if the backing pump is enabled. If it's not then the electronics to
            control the solenoid valve is off. In that case, return the
@@ -53,7 +53,7 @@ void solenoidValveStateHandler(void) {
         if (frontend.cryostat.backingPump.enable == BACKING_PUMP_DISABLE) {
             storeError(ERR_SOLENOID_VALVE, ERC_MODULE_POWER);  // Backing Pump off -> Solenoid valve disabled
 
-            frontend.cryostat.solenoidValve.lastState.status = HARDW_BLKD_ERR;
+            frontend.cryostat.lastControl.solenoidValveState.status = HARDW_BLKD_ERR;
             return;
         }
 
@@ -61,7 +61,7 @@ void solenoidValveStateHandler(void) {
            CAN message. */
         if (setSolenoidValveState(CAN_BYTE ? SOLENOID_VALVE_OPEN : SOLENOID_VALVE_CLOSE) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cryostat.solenoidValve.lastState.status = ERROR;
+            frontend.cryostat.lastControl.solenoidValveState.status = ERROR;
 
             return;
         }
@@ -72,7 +72,7 @@ void solenoidValveStateHandler(void) {
     /* If monitor on a control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.solenoidValve.lastState)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.lastControl.solenoidValveState)
         return;
     }
 
@@ -29,13 +29,13 @@ void teledynePaHandler(int currentModule) {
 void hasTeledynePaHandler(int currentModule, int currentTeledynePaModule) {
     if (CAN_SIZE) {  // If control (size !=0)
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pa.lastHasTeledynePa)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.paHasTeledynePa)
 
         // Check for other than band 7:
         if (currentModule != 6) {
             /* Store the HARDW_BLKD_ERR state in the last control message variable */
             storeError(ERR_PA_CHANNEL, ERC_COMMAND_VAL);
-            frontend.cartridge[currentModule].lo.pa.lastHasTeledynePa.status = HARDW_BLKD_ERR;
+            frontend.cartridge[currentModule].lastControl.paHasTeledynePa.status = HARDW_BLKD_ERR;
             return;
         }
 
@@ -47,7 +47,7 @@ void hasTeledynePaHandler(int currentModule, int currentTeledynePaModule) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pa.lastHasTeledynePa)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.paHasTeledynePa)
         return;
     }
 
@@ -62,13 +62,13 @@ void collectorByteHandler(int currentModule, int currentTeledynePaModule) {
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pa.lastTeledyneCollectorByte[pol])
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.paTeledyneCollectorByte[pol])
 
         // Check for other than band 7:
         if (currentModule != 6) {
             /* Store the HARDW_BLKD_ERR state in the last control message variable */
             storeError(ERR_PA_CHANNEL, ERC_COMMAND_VAL);
-            frontend.cartridge[currentModule].lo.pa.lastHasTeledynePa.status = HARDW_BLKD_ERR;
+            frontend.cartridge[currentModule].lastControl.paHasTeledynePa.status = HARDW_BLKD_ERR;
             return;
         }
 
@@ -80,7 +80,7 @@ void collectorByteHandler(int currentModule, int currentTeledynePaModule) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pa.lastTeledyneCollectorByte[pol])
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.paTeledyneCollectorByte[pol])
         return;
     }
 
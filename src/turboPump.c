@@ -57,13 +57,13 @@ void turboPumpEnableHandler(void) {
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.turboPump.lastEnable)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.lastControl.turboPumpEnable)
 
         /* Check if the backing pump is enabled. If it's not then the electronics to
            control the turbo pump are off.  Store HARDW_BLKD_ERR and return. */
 
         if (frontend.cryostat.backingPump.enable == BACKING_PUMP_DISABLE) {
-            frontend.cryostat.turboPump.lastEnable.status =
+            frontend.cryostat.lastControl.turboPumpEnable.status =
                 HARDW_BLKD_ERR;  // Store the status in the last control message
 
             // if the command was to enable, register an error too:
@@ -79,7 +79,7 @@ void turboPumpEnableHandler(void) {
                 (frontend.fetim.compressor.temp[FETIM_EXT_SENSOR_TURBO].temp > TURBO_PUMP_MAX_TEMPERATURE)) {
                 storeError(ERR_TURBO_PUMP,
                            ERC_HARDWARE_BLOCKED);  // Temperature below allowed range -> Turbo pump disabled
-                frontend.cryostat.turboPump.lastEnable.status =
+                frontend.cryostat.lastControl.turboPumpEnable.status =
                     HARDW_BLKD_ERR;  // Store the status in the last control message
 
                 frontend.cryostat.turboPump.enable = TURBO_PUMP_DISABLE;
@@ -91,7 +91,7 @@ void turboPumpEnableHandler(void) {
            CAN message. */
         if (setTurboPumpEnable(CAN_BYTE ? TURBO_PUMP_ENABLE : TURBO_PUMP_DISABLE) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cryostat.turboPump.lastEnable.status = ERROR;
+            frontend.cryostat.lastControl.turboPumpEnable.status = ERROR;
 
             return;
         }
@@ -102,7 +102,7 @@ void turboPumpEnableHandler(void) {
     /* If monitor on a control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.turboPump.lastEnable)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.lastControl.turboPumpEnable)
         return;
     }
 
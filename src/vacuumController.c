@@ -57,13 +57,13 @@ void vacuumControllerEnableHandler(int currentVacuumControllerModule) {
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.vacuumController.lastEnable)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.lastControl.vacuumControllerEnable)
 
         /* Change the status of the vacuum controller according to the content of
           the CAN message. */
         if (setVacuumControllerEnable(CAN_BYTE ? VACUUM_CONTROLLER_ENABLE : VACUUM_CONTROLLER_DISABLE) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cryostat.vacuumController.lastEnable.status = ERROR;
+            frontend.cryostat.lastControl.vacuumControllerEnable.status = ERROR;
 
             return;
         }
@@ -75,7 +75,7 @@ void vacuumControllerEnableHandler(int currentVacuumControllerModule) {
     /* If monitor on a control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.vacuumController.lastEnable)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.lastControl.vacuumControllerEnable)
         return;
     }
 
@@ -54,7 +54,7 @@ void ytoCoarseTuneHandler(int currentModule) {
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.yto.lastYtoCoarseTune)
+        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.ytoCoarseTune)
 
         /* Extract the unsigned int from the CAN message. */
         changeEndianInt(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -64,16 +64,19 @@ void ytoCoarseTuneHandler(int currentModule) {
             storeError(ERR_YTO, ERC_COMMAND_VAL);  // YTO coarse tune set value out of range
 
             /* Store the error in the last control message variable */
-            frontend.cartridge[currentModule].lo.yto.lastYtoCoarseTune.status = CON_ERROR_RNG;
+            frontend.cartridge[currentModule].lastControl.ytoCoarseTune.status = CON_ERROR_RNG;
 
             return;
         }
 
+        /* A direct tuning supersedes a running lock search */
+        pllLockSearchCancel(currentModule);
+
         // if not in TROUBLESHOOTING mode, check that the LO PA setting is safe for the new YTO tuning:
         if (frontend.mode == TROUBLESHOOTING_MODE)
             ret = NO_ERROR;
         else
-            ret = limitSafeYtoTuning(currentModule);
+            ret = limitSafeYtoTuning(CONV_UINT(0), currentModule);
 
         if (ret == HARDW_BLKD_ERR) {
             // report that the limit was violated:
@@ -82,18 +85,18 @@ void ytoCoarseTuneHandler(int currentModule) {
 
         if (ret == ERROR) {
             // some other error.   Don't retune!
-            frontend.cartridge[currentModule].lo.yto.lastYtoCoarseTune.status = ERROR;
+            frontend.cartridge[currentModule].lastControl.ytoCoarseTune.status = ERROR;
             return;
         }
 
         /* Set the YTO coarse tune. If an error occurs then store the state and return. */
-        if (setYtoCoarseTune(currentModule) == ERROR) {
+        if (setYtoCoarseTune(CONV_UINT(0), currentModule) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].lo.yto.lastYtoCoarseTune.status = ERROR;
+            frontend.cartridge[currentModule].lastControl.ytoCoarseTune.status = ERROR;
 
             /* if limitSafeYtoTuning() above returned a problem, we want to save that error status */
         } else {
-            frontend.cartridge[currentModule].lo.yto.lastYtoCoarseTune.status = ret;
+            frontend.cartridge[currentModule].lastControl.ytoCoarseTune.status = ret;
         }
 
         /* If everything went fine, it's a control message, we're done. */
@@ -103,7 +106,7 @@ void ytoCoarseTuneHandler(int currentModule) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.yto.lastYtoCoarseTune)
+        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lastControl.ytoCoarseTune)
         return;
     }
 